@@ -0,0 +1,82 @@
+/**
+ * Measures the cost of sampling random actions. The baseline builds a
+ * std::random_device and a std::mt19937 for every action, the way
+ * ScalarDiscreteSpace::sample used to. It is compared with sampling
+ * one action at a time from the thread engine, with sampling into a
+ * buffer through sample_n() and with the seeded overload.
+ *
+ * Usage: ./bench_action_sampling [number of actions]
+ * No server is needed.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/space_type.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cstdlib>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+
+///
+/// \brief Run the sample function n_actions times and print the
+/// actions per second
+///
+template<typename SampleFn>
+void run(const std::string& label, uint_t n_actions, SampleFn sample_fn){
+
+	const auto start = std::chrono::steady_clock::now();
+	sample_fn(n_actions);
+	const std::chrono::duration<real_t> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout<<label<<n_actions / elapsed.count()<<" actions/sec"<<std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+
+	typedef rlenvscpp::envs::ScalarDiscreteSpace<0, 4> action_space;
+
+	const uint_t n_actions = argc > 1 ? std::atoll(argv[1]) : 2000000;
+
+	uint_t checksum = 0;
+
+	run("random_device + mt19937: ", n_actions, [&](uint_t n){
+		for(uint_t i=0; i<n; ++i){
+			std::uniform_int_distribution<> dist(0, 3);
+			std::random_device rd;
+			std::mt19937 gen(rd());
+			checksum += dist(gen);
+		}
+	});
+
+	run("sample():                ", n_actions, [&](uint_t n){
+		for(uint_t i=0; i<n; ++i){
+			checksum += action_space::sample(false);
+		}
+	});
+
+	run("sample(seed):            ", n_actions, [&](uint_t n){
+		for(uint_t i=0; i<n; ++i){
+			checksum += action_space::sample(i, false);
+		}
+	});
+
+	std::vector<uint_t> actions(4096);
+	run("sample_n():              ", n_actions, [&](uint_t n){
+		for(uint_t i=0; i<n; i += actions.size()){
+			action_space::sample_n(actions, false);
+			checksum += actions[0];
+		}
+	});
+
+	std::cout<<"(checksum "<<checksum<<")"<<std::endl;
+	return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * Compares the time per tick when N copies of CartPole
+ * are stepped one after the other with step() against
+ * keeping all N requests in flight with async_step() from
+ * the same thread.
+ *
+ * Usage: ./bench_async_step [server url] [number of copies] [number of ticks]
+ * The REST API server should be running at the given url.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+
+	using rlenvscpp::uint_t;
+	using rlenvscpp::real_t;
+	using rlenvscpp::envs::gymnasium::CartPole;
+	using rlenvscpp::envs::RESTApiServerWrapper;
+
+	const std::string url = argc > 1 ? argv[1] : "http://0.0.0.0:8001/api";
+	const uint_t n_copies = argc > 2 ? std::atoi(argv[2]) : 64;
+	const uint_t n_ticks = argc > 3 ? std::atoi(argv[3]) : 100;
+
+	RESTApiServerWrapper server(url);
+
+	std::vector<CartPole> envs;
+	envs.reserve(n_copies);
+	
+	for(uint_t c=0; c<n_copies; ++c){
+		envs.push_back(CartPole(server, c));
+		envs.back().make("v1", std::unordered_map<std::string, std::any>());
+		envs.back().reset();
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint_t t=0; t<n_ticks; ++t){
+		for(auto& env : envs){
+			env.step(0);
+		}
+	}
+	const std::chrono::duration<real_t, std::milli> blocking = std::chrono::steady_clock::now() - start;
+
+	std::vector<std::future<CartPole::time_step_type> > time_steps(n_copies);
+	
+	start = std::chrono::steady_clock::now();
+	for(uint_t t=0; t<n_ticks; ++t){
+		
+		for(uint_t c=0; c<n_copies; ++c){
+			time_steps[c] = envs[c].async_step(0);
+		}
+		
+		for(auto& time_step : time_steps){
+			time_step.get();
+		}
+	}
+	const std::chrono::duration<real_t, std::milli> in_flight = std::chrono::steady_clock::now() - start;
+
+	for(auto& env : envs){
+		env.close();
+	}
+
+	std::cout<<"Copies:                    "<<n_copies<<std::endl;
+	std::cout<<"Ticks:                     "<<n_ticks<<std::endl;
+	std::cout<<"Blocking step:             "<<blocking.count() / n_ticks<<" ms/tick"<<std::endl;
+	std::cout<<"async_step:                "<<in_flight.count() / n_ticks<<" ms/tick"<<std::endl;
+	std::cout<<"Speedup:                   "<<blocking.count() / in_flight.count()<<std::endl;
+	return 0;
+}
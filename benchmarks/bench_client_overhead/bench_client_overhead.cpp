@@ -0,0 +1,80 @@
+/**
+ * Measures the client side cost of stepping a CartPole environment
+ * against the in-process MockEnvServer, so that connection handling,
+ * response parsing and TimeStep construction are timed without the
+ * Python server. Compares a connection per request against the
+ * keep-alive pool and the JSON against the binary wire format.
+ *
+ * Usage: ./bench_client_overhead [number of steps]
+ * No server is needed.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/api_server/wire_format.h"
+#include "rlenvs/envs/api_server/mock_server/mock_env_server.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+namespace bench_client_overhead{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gymnasium::CartPole;
+using rlenvscpp::envs::RESTApiServerWrapper;
+using rlenvscpp::envs::MockEnvServer;
+using rlenvscpp::envs::WireFormat;
+
+real_t
+us_per_step(const RESTApiServerWrapper& server, WireFormat format, const uint_t n_steps){
+
+	CartPole env(server);
+	env.set_wire_format(format);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	auto time_step = env.reset();
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for(uint_t s=0; s<n_steps; ++s){
+
+		if(time_step.last()){
+			time_step = env.reset();
+		}
+
+		time_step = env.step(s % 2);
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const std::chrono::duration<real_t, std::micro> elapsed = end - start;
+
+	env.close();
+	return elapsed.count() / static_cast<real_t>(n_steps);
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_client_overhead;
+
+	const uint_t n_steps = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+	MockEnvServer mock_server;
+
+	RESTApiServerWrapper per_request_server(mock_server.url(), true, false);
+	RESTApiServerWrapper keep_alive_server(mock_server.url(), true, true);
+
+	std::cout<<"Steps: "<<n_steps<<std::endl;
+	std::cout<<"Connection per request, JSON:   "<<us_per_step(per_request_server, WireFormat::JSON, n_steps)<<" us/step"<<std::endl;
+	std::cout<<"Connection per request, binary: "<<us_per_step(per_request_server, WireFormat::BINARY, n_steps)<<" us/step"<<std::endl;
+	std::cout<<"Keep-alive, JSON:               "<<us_per_step(keep_alive_server, WireFormat::JSON, n_steps)<<" us/step"<<std::endl;
+	std::cout<<"Keep-alive, binary:             "<<us_per_step(keep_alive_server, WireFormat::BINARY, n_steps)<<" us/step"<<std::endl;
+	std::cout<<"Requests served: "<<mock_server.n_requests()<<" connections: "<<mock_server.n_connections()<<std::endl;
+	return 0;
+}
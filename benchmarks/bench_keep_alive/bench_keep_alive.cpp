@@ -0,0 +1,70 @@
+/**
+ * Compares the steps per second achieved by a CartPole
+ * environment when the RESTApiServerWrapper opens a new
+ * connection for every request against reusing the
+ * pooled keep-alive connections.
+ *
+ * Usage: ./bench_keep_alive [server url] [number of steps]
+ * The REST API server should be running at the given url.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+namespace bench_keep_alive{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gymnasium::CartPole;
+using rlenvscpp::envs::RESTApiServerWrapper;
+
+real_t
+steps_per_second(const RESTApiServerWrapper& server, const uint_t n_steps){
+
+	CartPole env(server);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset();
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for(uint_t s=0; s<n_steps; ++s){
+		env.step(s % 2);
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const std::chrono::duration<real_t> elapsed = end - start;
+
+	env.close();
+	return static_cast<real_t>(n_steps) / elapsed.count();
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_keep_alive;
+
+	const std::string url = argc > 1 ? argv[1] : "http://0.0.0.0:8001/api";
+	const uint_t n_steps = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+	RESTApiServerWrapper per_request_server(url, true, false);
+	RESTApiServerWrapper keep_alive_server(url, true, true);
+
+	const auto per_request = steps_per_second(per_request_server, n_steps);
+	const auto keep_alive = steps_per_second(keep_alive_server, n_steps);
+
+	std::cout<<"Steps:                       "<<n_steps<<std::endl;
+	std::cout<<"Connection per request:      "<<per_request<<" steps/sec"<<std::endl;
+	std::cout<<"Keep-alive connection pool:  "<<keep_alive<<" steps/sec"<<std::endl;
+	std::cout<<"Connections opened (pool):   "<<keep_alive_server.connection_pool().n_opened_connections()<<std::endl;
+	std::cout<<"Speedup:                     "<<keep_alive / per_request<<std::endl;
+	return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * Measures the steps per second of the native CartPole environment,
+ * both through step(), which builds a TimeStep for every step, and
+ * through step_state(), which only advances the state.
+ *
+ * Usage: ./bench_native_cart_pole [number of steps]
+ * No server is needed.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+
+	using rlenvscpp::uint_t;
+	using rlenvscpp::real_t;
+	using rlenvscpp::TimeStepTp;
+	using rlenvscpp::envs::native::CartPole;
+
+	const uint_t n_steps = argc > 1 ? std::atoll(argv[1]) : 20000000;
+
+	CartPole env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset();
+
+	real_t checksum = 0.0;
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint_t s=0; s<n_steps; ++s){
+		checksum += env.step(s & 1).reward();
+	}
+	const std::chrono::duration<real_t> time_step_elapsed = std::chrono::steady_clock::now() - start;
+
+	env.reset();
+
+	start = std::chrono::steady_clock::now();
+	for(uint_t s=0; s<n_steps; ++s){
+		checksum += env.step_state(s & 1) == TimeStepTp::LAST ? 1.0 : env.state()[0];
+	}
+	const std::chrono::duration<real_t> state_elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout<<"Steps:        "<<n_steps<<std::endl;
+	std::cout<<"step():       "<<n_steps / time_step_elapsed.count()<<" steps/sec"<<std::endl;
+	std::cout<<"step_state(): "<<n_steps / state_elapsed.count()<<" steps/sec"<<std::endl;
+	std::cout<<"(checksum "<<checksum<<")"<<std::endl;
+	return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * Counts the heap allocations per step of the native CartPole, of
+ * FixedCartPole, whose std::array observation needs no heap, of
+ * Connect2 and of a batch of 64 AcrobotV instances, through step(),
+ * which returns a new time step, and through step_into(), which refills
+ * one time step, or one BatchTimeStep, in place. The allocations are
+ * counted by replacing the global operator new. The steady-state
+ * step_into() loop should not allocate.
+ *
+ * Usage: ./bench_step_allocations [number of steps]
+ * No server is needed.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/connect2/connect2_env.h"
+#include "rlenvs/envs/native/acrobot_vec_env.h"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <vector>
+#include <algorithm>
+#include <bitset>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace{
+
+std::atomic<std::size_t> n_allocations{0};
+
+}
+
+void* operator new(std::size_t size){
+
+	n_allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void* ptr = std::malloc(size == 0 ? 1 : size)){
+		return ptr;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr)noexcept{std::free(ptr);}
+void operator delete(void* ptr, std::size_t)noexcept{std::free(ptr);}
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+
+///
+/// \brief Run the step function n_steps times and print the
+/// allocations per step and the steps per second
+///
+template<typename StepFn>
+void run(const std::string& label, uint_t n_steps, StepFn step_fn){
+
+	const auto allocations = n_allocations.load();
+	const auto start = std::chrono::steady_clock::now();
+
+	for(uint_t s=0; s<n_steps; ++s){
+		step_fn(s);
+	}
+
+	const std::chrono::duration<real_t> elapsed = std::chrono::steady_clock::now() - start;
+	const auto n_step_allocations = n_allocations.load() - allocations;
+
+	std::cout<<label<<static_cast<real_t>(n_step_allocations) / static_cast<real_t>(n_steps)<<" allocations/step, "
+	         <<n_steps / elapsed.count()<<" steps/sec"<<std::endl;
+}
+
+///
+/// \brief The first valid move or 0 if there is none
+///
+uint_t first_valid_move(const std::bitset<4>& mask){
+
+	for(uint_t i=0; i<mask.size(); ++i){
+		if(mask[i]){
+			return i;
+		}
+	}
+
+	return 0;
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using rlenvscpp::envs::native::CartPole;
+	using rlenvscpp::envs::native::FixedCartPole;
+	using rlenvscpp::envs::connect2::Connect2;
+	using rlenvscpp::envs::native::AcrobotV;
+
+	const uint_t n_steps = argc > 1 ? std::atoll(argv[1]) : 5000000;
+
+	real_t checksum = 0.0;
+
+	CartPole cart_pole;
+	cart_pole.make("v1", std::unordered_map<std::string, std::any>());
+	cart_pole.reset();
+
+	run("CartPole step():      ", n_steps, [&](uint_t s){checksum += cart_pole.step(s & 1).observation()[0];});
+
+	cart_pole.reset();
+	CartPole::time_step_type cart_pole_step;
+
+	// the first step sizes the observation
+	cart_pole.step_into(0, cart_pole_step);
+	run("CartPole step_into(): ", n_steps, [&](uint_t s){
+		cart_pole.step_into(s & 1, cart_pole_step);
+		checksum += cart_pole_step.observation()[0];
+	});
+
+	// the observation is held inline in the time step
+	FixedCartPole fixed_cart_pole;
+	fixed_cart_pole.make("v1", std::unordered_map<std::string, std::any>());
+	fixed_cart_pole.reset();
+
+	run("FixedCartPole step(): ", n_steps, [&](uint_t s){checksum += fixed_cart_pole.step(s & 1).observation()[0];});
+
+	// player 1 plays the first valid move
+	Connect2 connect2;
+	connect2.make("v1", std::unordered_map<std::string, std::any>());
+	connect2.reset();
+
+	uint_t action = 0;
+	run("Connect2 step():      ", n_steps, [&](uint_t){
+		auto time_step = connect2.step(action);
+		action = first_valid_move(time_step.typed_info().action_mask);
+		checksum += time_step.reward();
+	});
+
+	connect2.reset();
+	Connect2::time_step_type connect2_step;
+
+	connect2.step_into(0, connect2_step);
+	action = first_valid_move(connect2_step.typed_info().action_mask);
+	run("Connect2 step_into(): ", n_steps, [&](uint_t){
+		connect2.step_into(action, connect2_step);
+		action = first_valid_move(connect2_step.typed_info().action_mask);
+		checksum += connect2_step.reward();
+	});
+
+	// the batch runs 64 instances per step
+	const uint_t n_envs = 64;
+	const uint_t n_batch_steps = std::max<uint_t>(n_steps / n_envs, 1);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs;
+
+	AcrobotV acrobot;
+	acrobot.make("v1", options);
+	acrobot.reset(42, std::unordered_map<std::string, std::any>());
+
+	std::vector<uint_t> actions(n_envs, 1);
+	run("AcrobotV step():      ", n_batch_steps, [&](uint_t){checksum += acrobot.step(actions).rewards()[0];});
+
+	AcrobotV::batch_time_step_type acrobot_batch;
+	acrobot.reset_into(42, acrobot_batch);
+	run("AcrobotV step_into(): ", n_batch_steps, [&](uint_t){
+		acrobot.step_into(actions, acrobot_batch);
+		checksum += acrobot_batch.observations_matrix()(0, 0);
+	});
+
+	std::cout<<"(checksum "<<checksum<<")"<<std::endl;
+	return 0;
+}
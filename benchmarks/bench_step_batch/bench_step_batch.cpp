@@ -0,0 +1,82 @@
+/**
+ * Compares the time per tick when N copies of CartPole
+ * are stepped one request per copy against stepping all the
+ * copies with a single /step-batch request.
+ *
+ * Usage: ./bench_step_batch [server url] [number of copies] [number of ticks]
+ * The REST API server should be running at the given url.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+namespace bench_step_batch{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gymnasium::CartPole;
+using rlenvscpp::envs::RESTApiServerWrapper;
+
+std::vector<CartPole>
+create_copies(const RESTApiServerWrapper& server, const uint_t n_copies){
+
+	std::vector<CartPole> envs;
+	envs.reserve(n_copies);
+	
+	for(uint_t c=0; c<n_copies; ++c){
+		envs.push_back(CartPole(server, c));
+		envs.back().make("v1", std::unordered_map<std::string, std::any>());
+		envs.back().reset();
+	}
+	
+	return envs;
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_step_batch;
+
+	const std::string url = argc > 1 ? argv[1] : "http://0.0.0.0:8001/api";
+	const uint_t n_copies = argc > 2 ? std::atoi(argv[2]) : 64;
+	const uint_t n_ticks = argc > 3 ? std::atoi(argv[3]) : 100;
+
+	RESTApiServerWrapper server(url);
+	auto envs = create_copies(server, n_copies);
+	std::vector<CartPole::action_type> actions(n_copies, 0);
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint_t t=0; t<n_ticks; ++t){
+		for(uint_t c=0; c<n_copies; ++c){
+			envs[c].step(actions[c]);
+		}
+	}
+	const std::chrono::duration<real_t, std::milli> per_copy = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for(uint_t t=0; t<n_ticks; ++t){
+		CartPole::step_batch(envs, actions);
+	}
+	const std::chrono::duration<real_t, std::milli> batched = std::chrono::steady_clock::now() - start;
+
+	for(auto& env : envs){
+		env.close();
+	}
+
+	std::cout<<"Copies:                    "<<n_copies<<std::endl;
+	std::cout<<"Ticks:                     "<<n_ticks<<std::endl;
+	std::cout<<"One request per copy:      "<<per_copy.count() / n_ticks<<" ms/tick"<<std::endl;
+	std::cout<<"One request per tick:      "<<batched.count() / n_ticks<<" ms/tick"<<std::endl;
+	std::cout<<"Speedup:                   "<<per_copy.count() / batched.count()<<std::endl;
+	return 0;
+}
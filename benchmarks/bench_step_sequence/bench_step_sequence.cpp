@@ -0,0 +1,77 @@
+/**
+ * Compares the steps per second of an open-loop action
+ * sequence applied to MountainCar one step at a time against
+ * applying it with step_sequence, i.e. with pipelined requests.
+ *
+ * Usage: ./bench_step_sequence [server url] [number of steps] [max in flight]
+ * The REST API server should be running at the given url.
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/mountain_car_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+namespace bench_step_sequence{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gymnasium::MountainCar;
+using rlenvscpp::envs::RESTApiServerWrapper;
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_step_sequence;
+
+	const std::string url = argc > 1 ? argv[1] : "http://0.0.0.0:8001/api";
+	const uint_t n_steps = argc > 2 ? std::atoi(argv[2]) : 2000;
+	const uint_t max_in_flight = argc > 3 ? std::atoi(argv[3]) : 32;
+
+	RESTApiServerWrapper server(url);
+	MountainCar env(server);
+	env.make("v0", std::unordered_map<std::string, std::any>());
+
+	// MountainCar is truncated after 200 steps so
+	// apply the sequence in episodes of 200 actions
+	const uint_t episode_length = 200;
+	std::vector<MountainCar::action_type> actions(episode_length);
+	for(uint_t a=0; a<episode_length; ++a){
+		actions[a] = (a / 20) % 2 == 0 ? 0 : 2;
+	}
+
+	const auto n_episodes = n_steps / episode_length;
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint_t e=0; e<n_episodes; ++e){
+		env.reset();
+		for(const auto action : actions){
+			env.step(action);
+		}
+	}
+	const std::chrono::duration<real_t> sequential = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for(uint_t e=0; e<n_episodes; ++e){
+		env.reset();
+		env.step_sequence(actions, max_in_flight);
+	}
+	const std::chrono::duration<real_t> pipelined = std::chrono::steady_clock::now() - start;
+
+	env.close();
+
+	const auto total = static_cast<real_t>(n_episodes * episode_length);
+	std::cout<<"Steps:      "<<n_episodes * episode_length<<std::endl;
+	std::cout<<"Sequential: "<<total / sequential.count()<<" steps/sec"<<std::endl;
+	std::cout<<"Pipelined:  "<<total / pipelined.count()<<" steps/sec (max in flight "<<max_in_flight<<")"<<std::endl;
+	std::cout<<"Speedup:    "<<sequential.count() / pipelined.count()<<std::endl;
+	return 0;
+}
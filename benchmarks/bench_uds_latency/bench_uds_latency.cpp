@@ -0,0 +1,89 @@
+/**
+ * Compares the step latency of a CartPole environment served
+ * over TCP loopback against the same environment served over
+ * a Unix domain socket.
+ *
+ * Usage: ./bench_uds_latency [tcp url] [unix url] [number of steps]
+ * Two REST API servers should be running, e.g.
+ *     ./start_uvicorn.sh
+ *     ./start_uvicorn.sh --uds /tmp/rlenvs.sock
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <any>
+#include <cstdlib>
+
+namespace bench_uds_latency{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gymnasium::CartPole;
+using rlenvscpp::envs::RESTApiServerWrapper;
+
+///
+/// \brief Returns the sorted latencies of n_steps steps in microseconds
+///
+std::vector<real_t>
+step_latencies(const std::string& url, const uint_t n_steps){
+
+	RESTApiServerWrapper server(url);
+	CartPole env(server);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset();
+
+	std::vector<real_t> latencies;
+	latencies.reserve(n_steps);
+
+	for(uint_t s=0; s<n_steps; ++s){
+
+		const auto start = std::chrono::steady_clock::now();
+		env.step(s % 2);
+		const std::chrono::duration<real_t, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		latencies.push_back(elapsed.count());
+	}
+
+	env.close();
+	std::sort(latencies.begin(), latencies.end());
+	return latencies;
+}
+
+real_t
+percentile(const std::vector<real_t>& sorted, real_t p){
+	return sorted[static_cast<uint_t>(p * static_cast<real_t>(sorted.size() - 1))];
+}
+
+void
+report(const std::string& name, const std::vector<real_t>& latencies){
+	std::cout<<name<<" p50: "<<percentile(latencies, 0.5)<<" us"
+	         <<" p99: "<<percentile(latencies, 0.99)<<" us"
+			 <<" max: "<<latencies.back()<<" us"<<std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_uds_latency;
+
+	const std::string tcp_url = argc > 1 ? argv[1] : "http://127.0.0.1:8001/api";
+	const std::string unix_url = argc > 2 ? argv[2] : "unix:///tmp/rlenvs.sock:/api";
+	const uint_t n_steps = argc > 3 ? std::atoi(argv[3]) : 2000;
+
+	const auto tcp = step_latencies(tcp_url, n_steps);
+	const auto uds = step_latencies(unix_url, n_steps);
+
+	std::cout<<"Steps: "<<n_steps<<std::endl;
+	report("TCP loopback", tcp);
+	report("Unix socket ", uds);
+	std::cout<<"Median speedup: "<<percentile(tcp, 0.5) / percentile(uds, 0.5)<<std::endl;
+	return 0;
+}
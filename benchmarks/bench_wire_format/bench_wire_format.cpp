@@ -0,0 +1,107 @@
+/**
+ * Compares the client side cost of decoding an AcrobotV like
+ * vector time step from JSON against decoding it from the
+ * binary wire format. No server is needed.
+ *
+ * Usage: ./bench_wire_format [number of copies] [number of iterations]
+ *
+ */
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/vector_time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/api_server/wire_format.h"
+#include "rlenvs/extern/nlohmann/json/json.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+namespace bench_wire_format{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::VectorTimeStep;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::TimeStepEnumUtils;
+
+typedef VectorTimeStep<std::vector<real_t> > time_step_type;
+
+const uint_t OBS_SIZE = 6;
+
+time_step_type
+from_json(const std::string& body){
+
+	auto response = nlohmann::json::parse(body);
+	auto time_step = response["time_step"];
+
+	auto step_types = time_step["step_types"].template get<std::vector<uint_t> >();
+	std::vector<TimeStepTp> types(step_types.size());
+	for(uint_t i=0; i<step_types.size(); ++i){
+		types[i] = TimeStepEnumUtils::time_step_type_from_int(step_types[i]);
+	}
+
+	auto rewards = time_step["rewards"].template get<std::vector<real_t> >();
+	auto discounts = time_step["discounts"].template get<std::vector<real_t> >();
+	auto obs = time_step["observations"].template get<std::vector<std::vector<real_t> > >();
+	return time_step_type(types, rewards, obs, discounts);
+}
+
+}
+
+int main(int argc, char** argv){
+
+	using namespace bench_wire_format;
+	namespace wire_format = rlenvscpp::envs::wire_format;
+
+	const uint_t n_copies = argc > 1 ? std::atoi(argv[1]) : 16;
+	const uint_t n_iterations = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+	std::vector<TimeStepTp> types(n_copies, TimeStepTp::MID);
+	std::vector<real_t> rewards(n_copies, -1.0);
+	std::vector<real_t> discounts(n_copies, 1.0);
+	std::vector<real_t> obs(n_copies * OBS_SIZE);
+	for(uint_t i=0; i<obs.size(); ++i){
+		obs[i] = 0.123456789 * static_cast<real_t>(i);
+	}
+
+	nlohmann::json time_step;
+	time_step["step_types"] = std::vector<uint_t>(n_copies, 1);
+	time_step["rewards"] = rewards;
+	time_step["discounts"] = discounts;
+	time_step["infos"] = nlohmann::json::array();
+
+	std::vector<std::vector<real_t> > observations;
+	for(uint_t c=0; c<n_copies; ++c){
+		observations.emplace_back(obs.begin() + c * OBS_SIZE, obs.begin() + (c + 1) * OBS_SIZE);
+	}
+
+	time_step["observations"] = observations;
+
+	nlohmann::json response;
+	response["time_step"] = time_step;
+
+	const auto json_body = response.dump();
+	const auto binary_body = wire_format::encode_vector_time_step(types, rewards, discounts, obs.data(), OBS_SIZE);
+
+	real_t checksum = 0.0;
+
+	auto start = std::chrono::steady_clock::now();
+	for(uint_t i=0; i<n_iterations; ++i){
+		checksum += from_json(json_body).rewards()[0];
+	}
+	auto json_time = std::chrono::duration<real_t, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for(uint_t i=0; i<n_iterations; ++i){
+		checksum += wire_format::decode_time_step<time_step_type>(binary_body).rewards()[0];
+	}
+	auto binary_time = std::chrono::duration<real_t, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout<<"Copies: "<<n_copies<<" observation size: "<<OBS_SIZE<<std::endl;
+	std::cout<<"JSON   body: "<<json_body.size()<<" bytes, "<<json_time / n_iterations<<" us per decode"<<std::endl;
+	std::cout<<"Binary body: "<<binary_body.size()<<" bytes, "<<binary_time / n_iterations<<" us per decode"<<std::endl;
+	std::cout<<"Speedup: "<<json_time / binary_time<<" (checksum "<<checksum<<")"<<std::endl;
+	return 0;
+}
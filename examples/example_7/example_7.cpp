@@ -40,7 +40,7 @@ int main(){
 	std::cout<<"Observation vector..."<<time_step.observation()<<std::endl;
 	
 	// what are the valid moves remaining?
-	auto val_moves = time_step.template get_extra<std::vector<int>>("valid_moves");
+	auto val_moves = env.get_valid_moves();
 	
 	std::cout<<"Valid moves remaining..."<<val_moves<<std::endl;
 	
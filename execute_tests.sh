@@ -41,3 +41,93 @@ cd test_acrobot
 ./test_acrobot
 cd ..
 
+
+echo "Running HTTPConnection tests"
+cd test_http_connection
+./test_http_connection
+cd ..
+
+echo "Running SharedMemoryChannel tests"
+cd test_shm_channel
+./test_shm_channel
+cd ..
+
+echo "Running APIServerStats tests"
+cd test_apiserver_stats
+./test_apiserver_stats
+cd ..
+
+echo "Running MockEnvServer tests"
+cd test_mock_server
+./test_mock_server
+cd ..
+
+echo "Running native CartPole tests"
+cd test_native_cart_pole
+./test_native_cart_pole
+cd ..
+
+echo "Running native FrozenLake tests"
+cd test_native_frozen_lake
+./test_native_frozen_lake
+cd ..
+
+echo "Running native Taxi tests"
+cd test_native_taxi
+./test_native_taxi
+cd ..
+
+echo "Running native CliffWorld tests"
+cd test_native_cliff_world
+./test_native_cliff_world
+cd ..
+
+echo "Running native BlackJack tests"
+cd test_native_black_jack
+./test_native_black_jack
+cd ..
+
+echo "Running native MountainCar tests"
+cd test_native_mountain_car
+./test_native_mountain_car
+cd ..
+
+echo "Running native Pendulum tests"
+cd test_native_pendulum
+./test_native_pendulum
+cd ..
+
+echo "Running native Acrobot tests"
+cd test_native_acrobot
+./test_native_acrobot
+cd ..
+
+echo "Running GymWalk tests"
+cd test_gym_walk
+./test_gym_walk
+cd ..
+
+echo "Running environment factory tests"
+cd test_env_factory
+./test_env_factory
+cd ..
+
+echo "Running environment snapshot tests"
+cd test_env_snapshot
+./test_env_snapshot
+cd ..
+
+echo "Running time step tests"
+cd test_time_step
+./test_time_step
+cd ..
+
+echo "Running batch time step tests"
+cd test_batch_time_step
+./test_batch_time_step
+cd ..
+
+echo "Running space sampling tests"
+cd test_space_sampling
+./test_space_sampling
+cd ..
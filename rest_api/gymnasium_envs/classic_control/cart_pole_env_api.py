@@ -1,10 +1,10 @@
 import gymnasium as gym
 from typing import Any
 from loguru import logger
-from fastapi import APIRouter, Body, status
+from fastapi import APIRouter, Body, Header, status
 from fastapi.responses import JSONResponse
 from fastapi import HTTPException
-from time_step_response import TimeStep, TimeStepType
+from time_step_response import TimeStep, TimeStepType, time_step_response
 
 cart_pole_router = APIRouter(prefix="/gymnasium/cart-pole-env", tags=["cart-pole-env"])
 
@@ -96,7 +96,8 @@ async def make(version: str = Body(default="v1"),
 @cart_pole_router.post("/reset")
 async def reset(seed: int = Body(default=42),
                 cidx: int = Body(...),
-                options: dict[str, Any] = Body(default={})) -> JSONResponse:
+                options: dict[str, Any] = Body(default={}),
+                accept: str | None = Header(default=None)) -> JSONResponse:
     """Reset the environment
 
     :return:
@@ -115,16 +116,36 @@ async def reset(seed: int = Body(default=42),
                             info=info,
                             discount=1.0)
             logger.info(f'Reset environment {ENV_NAME}  and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return time_step_response(step, accept, status.HTTP_202_ACCEPTED)
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail={"message": f"Environment {ENV_NAME} is not initialized."
                                            " Have you called make()?"})
 
 
-@cart_pole_router.post("/step")
-async def step(action: int = Body(...), cidx: int = Body(...)) -> JSONResponse:
+def _validate_step(action: int, cidx: int) -> None:
+    """Check that the action can be executed on the environment
+    copy with index cidx without executing it
+
+    :return:
+    """
+
+    global envs
+    if envs.get(cidx) is None:
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Environment {ENV_NAME} and index {cidx} is not initialized. "
+                                   f"Have you called make()?")
+
+    if action not in ACTIONS_SPACE:
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Action {action} not in {list(ACTIONS_SPACE.keys())}")
+
+
+def _step(action: int, cidx: int) -> TimeStep:
+    """Execute the action on the environment copy with index cidx
+
+    :return: The resulting TimeStep
+    """
 
     if action not in ACTIONS_SPACE:
         raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
@@ -149,13 +170,46 @@ async def step(action: int = Body(...), cidx: int = Body(...)) -> JSONResponse:
                             discount=1.0)
 
             logger.info(f'Step in environment {ENV_NAME} and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return step
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail=f"Environment {ENV_NAME} is not initialized. Have you called make()?")
 
 
+@cart_pole_router.post("/step")
+async def step(action: int = Body(...), cidx: int = Body(...),
+               accept: str | None = Header(default=None)) -> JSONResponse:
+    step = _step(action=action, cidx=cidx)
+    return time_step_response(step, accept, status.HTTP_202_ACCEPTED)
+
+
+@cart_pole_router.post("/step-batch")
+async def step_batch(actions: list[dict[str, Any]] = Body(..., embed=True)) -> JSONResponse:
+    """Step in several copies of the environment with one request.
+    Every entry in actions has the form {"cidx": int, "action": action}.
+    The time steps are returned in the order of the actions
+
+    :return:
+    """
+
+    # validate the whole batch before any copy is stepped
+    # so that an invalid entry does not leave it half executed
+    for entry in actions:
+        if "cidx" not in entry or "action" not in entry:
+            raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                                detail="Every entry in actions needs a cidx and an action")
+
+        _validate_step(action=entry["action"], cidx=entry["cidx"])
+
+    time_steps = []
+    for entry in actions:
+        step = _step(action=entry["action"], cidx=entry["cidx"])
+        time_steps.append({"cidx": entry["cidx"], "time_step": step.model_dump()})
+
+    return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
+                        content={"time_steps": time_steps})
+
+
 @cart_pole_router.post("/sync")
 async def sync(cidx: int = Body(...), options: dict[str, Any] = Body(default={})) -> JSONResponse:
     return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
@@ -8,10 +8,10 @@ from loguru import logger
 import gymnasium as gym
 from typing import Any
 import sys
-from fastapi import APIRouter, Body, status
+from fastapi import APIRouter, Body, Header, status
 from fastapi import HTTPException
 from fastapi.responses import JSONResponse
-from time_step_response import TimeStep, TimeStepType
+from time_step_response import TimeStep, TimeStepType, time_step_response
 
 pendulum_router = APIRouter(prefix="/gymnasium/pendulum-env",
                             tags=["pendulum-env"])
@@ -109,7 +109,8 @@ async def make(version: str = Body(default="v1"),
 @pendulum_router.post("/reset")
 async def reset(seed: int = Body(default=42),
                 cidx: int = Body(...),
-                options: dict[str, Any] = Body(default={})) -> JSONResponse:
+                options: dict[str, Any] = Body(default={}),
+                accept: str | None = Header(default=None)) -> JSONResponse:
     """Reset the environment
 
     :return:
@@ -129,16 +130,37 @@ async def reset(seed: int = Body(default=42),
                             info=info,
                             discount=1.0)
             logger.info(f'Reset environment {ENV_NAME}  and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return time_step_response(step, accept, status.HTTP_202_ACCEPTED)
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail={"message": f"Environment {ENV_NAME} is not initialized."
                                            " Have you called make()?"})
 
 
-@pendulum_router.post("/step")
-async def step(action: float = Body(...), cidx: int = Body(...)) -> JSONResponse:
+def _validate_step(action: float, cidx: int) -> None:
+    """Check that the action can be executed on the environment
+    copy with index cidx without executing it
+
+    :return:
+    """
+
+    global envs
+    if envs.get(cidx) is None:
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Environment {ENV_NAME} and index {cidx} is not initialized. "
+                                   f"Have you called make()?")
+
+    if not (action >= -2.0 and action <= 2.0):
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Action {action} not in {ACTIONS_SPACE}")
+
+
+def _step(action: float, cidx: int) -> TimeStep:
+    """Execute the action on the environment copy with index cidx
+
+    :return: The resulting TimeStep
+    """
+
     if not (action >= -2.0 and action <= 2.0):
         raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                             detail=f"Action {action} not in {ACTIONS_SPACE}")
@@ -161,13 +183,46 @@ async def step(action: float = Body(...), cidx: int = Body(...)) -> JSONResponse
                             info=info,
                             discount=1.0)
             logger.info(f'Step in environment {ENV_NAME} and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return step
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail=f"Environment {ENV_NAME} is not initialized. Have you called make()?")
 
 
+@pendulum_router.post("/step")
+async def step(action: float = Body(...), cidx: int = Body(...),
+               accept: str | None = Header(default=None)) -> JSONResponse:
+    step = _step(action=action, cidx=cidx)
+    return time_step_response(step, accept, status.HTTP_202_ACCEPTED)
+
+
+@pendulum_router.post("/step-batch")
+async def step_batch(actions: list[dict[str, Any]] = Body(..., embed=True)) -> JSONResponse:
+    """Step in several copies of the environment with one request.
+    Every entry in actions has the form {"cidx": int, "action": action}.
+    The time steps are returned in the order of the actions
+
+    :return:
+    """
+
+    # validate the whole batch before any copy is stepped
+    # so that an invalid entry does not leave it half executed
+    for entry in actions:
+        if "cidx" not in entry or "action" not in entry:
+            raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                                detail="Every entry in actions needs a cidx and an action")
+
+        _validate_step(action=entry["action"], cidx=entry["cidx"])
+
+    time_steps = []
+    for entry in actions:
+        step = _step(action=entry["action"], cidx=entry["cidx"])
+        time_steps.append({"cidx": entry["cidx"], "time_step": step.model_dump()})
+
+    return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
+                        content={"time_steps": time_steps})
+
+
 @pendulum_router.post("/sync")
 async def sync(cidx: int = Body(...), options: dict[str, Any] = Body(default={})) -> JSONResponse:
     return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
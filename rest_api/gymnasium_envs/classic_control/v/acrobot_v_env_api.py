@@ -7,10 +7,11 @@ import sys
 import gymnasium as gym
 from typing import Any, List
 from loguru import logger
-from fastapi import APIRouter, Body, status
-from fastapi.responses import JSONResponse
+from fastapi import APIRouter, Body, Header, status
+from fastapi.responses import JSONResponse, Response
 from fastapi import HTTPException
-from time_step_response import TimeStepType, TimeStepV
+from time_step_response import TimeStepType, TimeStepV, time_step_response
+from shm_channel import ShmChannel, SHM_SLOT_MEDIA_TYPE, accepts_shm
 
 acrobot_v_router = APIRouter(prefix="/gymnasium/acrobot-env/v", tags=["Acrobot Vector env API"])
 
@@ -24,6 +25,12 @@ envs = {
     0: None
 }
 
+# the shared memory channels attached per copy index
+shm_channels = {}
+
+# the size of the observations
+OBS_SIZE = 6
+
 
 # actions that the environment accepts
 ACTIONS_SPACE = {0: "apply -1 torque to the actuated joint",
@@ -31,6 +38,21 @@ ACTIONS_SPACE = {0: "apply -1 torque to the actuated joint",
                  2: "apply 1 torque to the actuated joint"}
 
 
+def _time_step_response(step: TimeStepV, cidx: int, accept: str | None) -> Response:
+    """Write the time step into the shared memory channel of the copy if
+    attached and requested. Otherwise return it in the requested encoding
+
+    """
+    if cidx in shm_channels and accepts_shm(accept):
+        seq = shm_channels[cidx].write(step.step_types, step.rewards,
+                                       step.discounts, step.observations)
+        return Response(status_code=status.HTTP_202_ACCEPTED,
+                        content=f'{{"seq": {seq}}}',
+                        media_type=SHM_SLOT_MEDIA_TYPE)
+
+    return time_step_response(step, accept, status.HTTP_202_ACCEPTED)
+
+
 def numpy_arr_to_arr(observations: List[List]) -> list[list[float]]:
     observations_ar = []
     for obs in observations:
@@ -75,6 +97,10 @@ async def close(cidx: int) -> JSONResponse:
         if env is not None:
             envs[cidx].close()
             envs[cidx] = None
+
+            if cidx in shm_channels:
+                shm_channels.pop(cidx).close()
+
             logger.info(f'Closed environment {ENV_NAME}  and index {cidx}')
             return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
                                 content={"message": f"Environment {ENV_NAME} and index {cidx} is closed"})
@@ -129,7 +155,8 @@ async def make(version: str = Body(default="v1"),
 
 @acrobot_v_router.post("/reset")
 async def reset(seed: int = Body(default=42), cidx: int = Body(...),
-                options: dict[str, Any] = Body(default={})) -> JSONResponse:
+                options: dict[str, Any] = Body(default={}),
+                accept: str | None = Header(default=None)) -> JSONResponse:
     """Reset the environment
 
     :return:
@@ -154,8 +181,7 @@ async def reset(seed: int = Body(default=42), cidx: int = Body(...),
                              infos=[],
                              discounts=[1.0] * NUM_COPIES)
             logger.info(f'Reset environment {ENV_NAME}  and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return _time_step_response(step, cidx, accept)
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail={"message": f"Environment {ENV_NAME} is not initialized."
@@ -163,7 +189,8 @@ async def reset(seed: int = Body(default=42), cidx: int = Body(...),
 
 
 @acrobot_v_router.post("/step")
-async def step(action: dict[str, list[int]] = Body(title='actions'), cidx: int = Body(...)) -> JSONResponse:
+async def step(action: dict[str, list[int]] = Body(title='actions'), cidx: int = Body(...),
+               accept: str | None = Header(default=None)) -> JSONResponse:
 
     global NUM_COPIES
 
@@ -205,13 +232,44 @@ async def step(action: dict[str, list[int]] = Body(title='actions'), cidx: int =
                              discounts=[1.0] * NUM_COPIES)
 
             logger.info(f'Step in environment {ENV_NAME} and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return _time_step_response(step, cidx, accept)
+
+    raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                        detail=f"Environment {ENV_NAME} is not initialized. Have you called make()?")
+
+
+@acrobot_v_router.post("/attach-shm")
+async def attach_shm(cidx: int = Body(...), n_slots: int = Body(default=8)) -> JSONResponse:
+    """Write the time steps of the copy cidx into a shared memory
+    ring of n_slots slots. Only clients on the same host can use it
+
+    """
+    global envs
+    if cidx in envs and envs[cidx] is not None:
+
+        if cidx in shm_channels:
+            shm_channels.pop(cidx).close()
+
+        channel = ShmChannel(ENV_NAME, cidx, NUM_COPIES, OBS_SIZE, n_slots)
+        shm_channels[cidx] = channel
+        logger.info(f'Attached shared memory {channel.name} to environment {ENV_NAME} and index {cidx}')
+        return JSONResponse(status_code=status.HTTP_201_CREATED,
+                            content={"name": channel.name, "n_envs": NUM_COPIES,
+                                     "obs_size": OBS_SIZE, "n_slots": n_slots})
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail=f"Environment {ENV_NAME} is not initialized. Have you called make()?")
 
 
+@acrobot_v_router.post("/detach-shm")
+async def detach_shm(cidx: int = Body(..., embed=True)) -> JSONResponse:
+    if cidx in shm_channels:
+        shm_channels.pop(cidx).close()
+
+    return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
+                        content={"message": "OK"})
+
+
 @acrobot_v_router.post("/sync")
 async def sync(cidx: int = Body(...), options: dict[str, Any] = Body(default={})) -> JSONResponse:
     return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
@@ -123,8 +123,30 @@ async def reset(seed: int = Body(default=42), cidx: int = Body(...),
                                            " Have you called make()?"})
 
 
-@frozenlake_router.post("/step")
-async def step(action: int = Body(...), cidx: int = Body(...)) -> JSONResponse:
+def _validate_step(action: int, cidx: int) -> None:
+    """Check that the action can be executed on the environment
+    copy with index cidx without executing it
+
+    :return:
+    """
+
+    global envs
+    if envs.get(cidx) is None:
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Environment {ENV_NAME} and index {cidx} is not initialized. "
+                                   f"Have you called make()?")
+
+    if not envs[cidx].action_space.contains(action):
+        raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                            detail=f"Action {action} not in {envs[cidx].action_space}")
+
+
+def _step(action: int, cidx: int) -> TimeStep:
+    """Execute the action on the environment copy with index cidx
+
+    :return: The resulting TimeStep
+    """
+
     global envs
 
     if cidx in envs:
@@ -143,13 +165,46 @@ async def step(action: int = Body(...), cidx: int = Body(...)) -> JSONResponse:
                             info=info,
                             discount=1.0)
             logger.info(f'Step in environment {ENV_NAME} and index {cidx}')
-            return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
-                                content={"time_step": step.model_dump()})
+            return step
 
     raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
                         detail={"message": "Environment FrozenLake is not initialized. Have you called make()?"})
 
 
+@frozenlake_router.post("/step")
+async def step(action: int = Body(...), cidx: int = Body(...)) -> JSONResponse:
+    step = _step(action=action, cidx=cidx)
+    return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
+                        content={"time_step": step.model_dump()})
+
+
+@frozenlake_router.post("/step-batch")
+async def step_batch(actions: list[dict[str, Any]] = Body(..., embed=True)) -> JSONResponse:
+    """Step in several copies of the environment with one request.
+    Every entry in actions has the form {"cidx": int, "action": action}.
+    The time steps are returned in the order of the actions
+
+    :return:
+    """
+
+    # validate the whole batch before any copy is stepped
+    # so that an invalid entry does not leave it half executed
+    for entry in actions:
+        if "cidx" not in entry or "action" not in entry:
+            raise HTTPException(status_code=status.HTTP_400_BAD_REQUEST,
+                                detail="Every entry in actions needs a cidx and an action")
+
+        _validate_step(action=entry["action"], cidx=entry["cidx"])
+
+    time_steps = []
+    for entry in actions:
+        step = _step(action=entry["action"], cidx=entry["cidx"])
+        time_steps.append({"cidx": entry["cidx"], "time_step": step.model_dump()})
+
+    return JSONResponse(status_code=status.HTTP_202_ACCEPTED,
+                        content={"time_steps": time_steps})
+
+
 @frozenlake_router.get("/dynamics")
 async def get_dynamics(cidx: int, stateId: int, actionId: int = None) -> JSONResponse:
     global envs
@@ -0,0 +1,94 @@
+"""Shared memory data plane for vector environments served on the
+same host as the client. The time steps are written into a ring of
+fixed size slots in a POSIX shared memory object and the HTTP response
+only carries the sequence number of the slot.
+The layout must match src/rlenvs/envs/api_server/shm_channel.h
+
+"""
+import struct
+import uuid
+from typing import Optional
+import numpy as np
+from multiprocessing import shared_memory
+
+SHM_SLOT_MEDIA_TYPE = "application/x-rlenvs-shm-slot"
+
+MAGIC = 0x48534C52
+VERSION = 1
+HEADER_SIZE = 64
+LAST_SEQ_OFFSET = 24
+
+
+def accepts_shm(accept: Optional[str]) -> bool:
+    """Returns True if the Accept header asks for the time step
+    to be written into the shared memory channel
+
+    """
+    if accept is None:
+        return False
+
+    return any(media.split(';')[0].strip() == SHM_SLOT_MEDIA_TYPE for media in accept.split(','))
+
+
+def slot_size(n_envs: int, obs_size: int) -> int:
+    return 8 + (n_envs + 7) // 8 * 8 + (2 * n_envs + n_envs * obs_size) * 8
+
+
+class ShmChannel:
+    """Ring of time step slots in shared memory. The server
+    owns the memory and removes it on close()
+
+    """
+
+    def __init__(self, env_name: str, cidx: int, n_envs: int, obs_size: int, n_slots: int):
+        self.n_envs = n_envs
+        self.obs_size = obs_size
+        self.n_slots = n_slots
+        self.slot_size = slot_size(n_envs, obs_size)
+        name = f"rlenvs_{env_name.lower()}_{cidx}_{uuid.uuid4().hex[:8]}"
+        self.shm = shared_memory.SharedMemory(name=name, create=True,
+                                              size=HEADER_SIZE + n_slots * self.slot_size)
+        struct.pack_into('<IIIIIIQ', self.shm.buf, 0, MAGIC, VERSION, n_envs,
+                         obs_size, n_slots, self.slot_size, 0)
+        self.last_seq = 0
+
+    @property
+    def name(self) -> str:
+        """The name the client passes to shm_open
+
+        """
+        return "/" + self.shm.name
+
+    def write(self, step_types, rewards, discounts, observations) -> int:
+        """Write the time step into the next slot and
+        return its sequence number
+
+        """
+        seq = self.last_seq + 1
+        offset = HEADER_SIZE + (seq % self.n_slots) * self.slot_size
+        buf = self.shm.buf
+        n = self.n_envs
+
+        # clear the sequence number of the slot first, so a client still
+        # reading the time step it held sees that it was overwritten
+        struct.pack_into('<Q', buf, offset, 0)
+
+        buf[offset + 8: offset + 8 + n] = bytes(int(step_type) for step_type in step_types)
+
+        values = offset + 8 + (n + 7) // 8 * 8
+        slot = np.ndarray((2 * n + n * self.obs_size,), dtype='<f8', buffer=buf, offset=values)
+        slot[0: n] = rewards
+        slot[n: 2 * n] = discounts
+        slot[2 * n:] = np.asarray(observations, dtype='<f8').ravel()
+        del slot
+
+        # the slot is published before the sequence number. The client
+        # reads the slot only after it has received the HTTP response
+        struct.pack_into('<Q', buf, offset, seq)
+        struct.pack_into('<Q', buf, LAST_SEQ_OFFSET, seq)
+        self.last_seq = seq
+        return seq
+
+    def close(self) -> None:
+        self.shm.close()
+        self.shm.unlink()
@@ -1 +1,15 @@
-uvicorn main:app --port=8001 --host='0.0.0.0' --reload
+# Usage: bash start_uvicorn.sh [--uds [socket path] | --port port]
+# With --uds the server listens on a Unix domain socket
+# (default /tmp/rlenvs.sock) instead of TCP port 8001.
+# Connect to it with the URL unix:///tmp/rlenvs.sock:/api
+# With --port the server listens on the given TCP port. Start
+# one server per port to shard the environments over them
+if [ "$1" == "--uds" ]; then
+  SOCKET_PATH=${2:-/tmp/rlenvs.sock}
+  rm -f "$SOCKET_PATH"
+  uvicorn main:app --uds="$SOCKET_PATH" --reload
+elif [ "$1" == "--port" ]; then
+  uvicorn main:app --port="${2:-8001}" --host='0.0.0.0' --reload
+else
+  uvicorn main:app --port=8001 --host='0.0.0.0' --reload
+fi
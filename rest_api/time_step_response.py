@@ -1,8 +1,11 @@
 import enum
 import copy
+import struct
 from typing import Generic, Optional, TypeVar
 from pydantic import BaseModel, Field, Extra
 import numpy as np
+from fastapi import Response
+from fastapi.responses import JSONResponse
 
 _Reward = TypeVar('_Reward')
 _Discount = TypeVar('_Discount')
@@ -68,3 +71,54 @@ class TimeStepV(BaseModel, Generic[_Reward, _Discount, _Observation]):
     discounts: Optional[list[_Discount]] = Field(title='discounts')
     observations: Optional[list[_Observation]] = Field(title="observations")
     infos: list[dict] = Field(title="infos")
+
+
+# media type of the compact binary encoding of the time steps.
+# Clients ask for it with the Accept header. Layout (little endian):
+# TimeStep:  u8 step_type, f64 reward, f64 discount, f64[] observation
+# TimeStepV: u32 n, u32 d, u8[n] step_types, f64[n] rewards,
+#            f64[n] discounts, f64[n * d] observations
+# The info is not transferred
+BINARY_TIME_STEP_MEDIA_TYPE = "application/x-rlenvs-time-step"
+
+
+def accepts_binary(accept: Optional[str]) -> bool:
+    """Returns True if the Accept header asks for the binary encoding
+
+    """
+    if accept is None:
+        return False
+
+    return any(media.split(';')[0].strip() == BINARY_TIME_STEP_MEDIA_TYPE for media in accept.split(','))
+
+
+def encode_time_step(step: TimeStep) -> bytes:
+    observation = np.asarray(step.observation, dtype='<f8').ravel()
+    reward = 0.0 if step.reward is None else float(step.reward)
+    discount = 1.0 if step.discount is None else float(step.discount)
+    return struct.pack('<Bdd', int(step.step_type), reward, discount) + observation.tobytes()
+
+
+def encode_time_step_v(step: TimeStepV) -> bytes:
+    observations = np.asarray(step.observations, dtype='<f8')
+    n_envs = len(step.step_types)
+    obs_size = observations.shape[1] if observations.ndim > 1 else 1
+    return (struct.pack('<II', n_envs, obs_size) +
+            bytes(int(step_type) for step_type in step.step_types) +
+            np.asarray(step.rewards, dtype='<f8').tobytes() +
+            np.asarray(step.discounts, dtype='<f8').tobytes() +
+            observations.tobytes())
+
+
+def time_step_response(step: TimeStep | TimeStepV, accept: Optional[str], status_code: int) -> Response:
+    """Build the response for the given time step in the encoding
+    requested by the Accept header
+
+    """
+    if accepts_binary(accept):
+        content = encode_time_step_v(step) if isinstance(step, TimeStepV) else encode_time_step(step)
+        return Response(status_code=status_code, content=content,
+                        media_type=BINARY_TIME_STEP_MEDIA_TYPE)
+
+    return JSONResponse(status_code=status_code,
+                        content={"time_step": step.model_dump()})
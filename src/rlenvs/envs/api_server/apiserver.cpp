@@ -1,6 +1,5 @@
 #include "rlenvs/envs/api_server/apiserver.h"
 #include "rlenvs/rlenvs_consts.h"
-#include "rlenvs/extern/HTTPRequest.hpp"
 #include "rlenvs/extern/nlohmann/json/json.hpp"
 
 #include <string>
@@ -9,17 +8,44 @@
 namespace rlenvscpp{
 namespace envs{
 
-RESTApiServerWrapper::RESTApiServerWrapper(const std::string& url, const bool initialize)
+RESTApiServerWrapper::RESTApiServerWrapper(const std::string& url, 
+                                           const bool initialize,
+										   const bool keep_alive)
 :
 url_(url),
 is_init_(false),
-envs_()
+envs_(),
+pools_(1, std::make_shared<HTTPConnectionPool>(url, keep_alive)),
+router_(std::make_shared<ShardRouter>(std::vector<std::string>(1, url))),
+stats_(std::make_shared<APIServerStats>())
 {
   if(initialize){
 	  init_();
   }
 }
 
+RESTApiServerWrapper::RESTApiServerWrapper(const std::vector<std::string>& urls,
+                                           const ShardPolicy policy,
+                                           const bool initialize,
+										   const bool keep_alive)
+:
+url_(urls.empty() ? std::string() : urls.front()),
+is_init_(false),
+envs_(),
+pools_(),
+router_(std::make_shared<ShardRouter>(urls, policy)),
+stats_(std::make_shared<APIServerStats>())
+{
+  pools_.reserve(urls.size());
+  for(const auto& url : urls){
+	  pools_.push_back(std::make_shared<HTTPConnectionPool>(url, keep_alive));
+  }
+  
+  if(initialize){
+	  init_();
+  }
+}
+
 void 
 RESTApiServerWrapper::init_(){
 	
@@ -36,6 +62,45 @@ RESTApiServerWrapper::init_(){
 	
 }
 
+HTTPResponse
+RESTApiServerWrapper::send_request_(const uint_t shard,
+                                    const std::string& env_name,
+                                    const std::string& endpoint,
+                                    const std::string& method,
+                                    const std::string& url,
+									const std::string& body,
+									const http_header_fields& headers)const{
+	
+	auto& pool = *pools_[shard];
+	
+	if(!stats_ -> is_enabled()){
+		return pool.request(method, url, body, headers);
+	}
+	
+	HTTPRequestTiming timing;
+	
+	try{
+		auto response = pool.request(method, url, body, headers, &timing);
+		stats_ -> record(env_name, endpoint, timing, response.status >= 400);
+		return response;
+	}
+	catch(...){
+		stats_ -> record(env_name, endpoint, timing, true);
+		throw;
+	}
+}
+
+nlohmann::json
+RESTApiServerWrapper::parse_json_(const std::string& env_name,
+                                  const std::string& endpoint,
+								  const HTTPResponse& response)const{
+	
+	StopWatch watch;
+	auto json = nlohmann::json::parse(response.body);
+	stats_ -> record_parse(env_name, endpoint, watch.elapsed());
+	return json;
+}
+
 void 
 RESTApiServerWrapper::register_new(const std::string& name, const std::string& uri){
 	
@@ -87,25 +152,44 @@ RESTApiServerWrapper::get_env_url(const std::string& name)const noexcept{
 	return get_url() + uri_;
 }
 
-nlohmann::json 
-RESTApiServerWrapper::is_alive(const std::string& env_name, 
-                               const uint_t cidx)const{
+std::string 
+RESTApiServerWrapper::get_env_url(const std::string& name, const uint_t cidx)const{
 	
-	// find the source
-	auto url_ = get_env_url(env_name);
+	auto uri_ = get_uri(name);
+	
+	if(uri_ == rlenvscpp::consts::INVALID_STR){
+		return rlenvscpp::consts::INVALID_STR;
+	}
 	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
+	return router_ -> url(router_ -> shard(name, cidx)) + uri_;
+}
+
+std::pair<uint_t, std::string>
+RESTApiServerWrapper::route_(const std::string& env_name, const uint_t cidx)const{
+	
+	auto uri_ = get_uri(env_name);
+	
+	if(uri_ == rlenvscpp::consts::INVALID_STR){
 		throw std::logic_error("Environment: " + env_name + " is not registered");
 	}
 	
+	const auto shard = router_ -> shard(env_name, cidx);
+	return {shard, router_ -> url(shard) + uri_};
+}
+
+nlohmann::json 
+RESTApiServerWrapper::is_alive(const std::string& env_name, 
+                               const uint_t cidx)const{
+	
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
 	
 	auto copy_idx_str = std::to_string(cidx);
 	
-    http::Request request{url_ + "/is-alive?cidx="+copy_idx_str};
-    const auto response = request.send("GET");
+    const auto response = send_request_(shard, env_name, "/is-alive", "GET", url_ + "/is-alive?cidx="+copy_idx_str);
     
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
+    nlohmann::json j = parse_json_(env_name, "/is-alive", response);
 	return j;	
 
 }
@@ -114,22 +198,18 @@ nlohmann::json
 RESTApiServerWrapper::close(const std::string& env_name, 
                             const uint_t cidx)const{
 	
-	// find the source
-	auto url_ = get_env_url(env_name);
-	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
-		throw std::logic_error("Environment: " + env_name + " is not registered");
-	}
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
 	
-    http::Request request{url_ + "/close?cidx="+std::to_string(cidx)};
-    const auto response = request.send("POST");
+    const auto response = send_request_(shard, env_name, "/close", "POST", url_ + "/close?cidx="+std::to_string(cidx));
     
-	if(response.status.code != 201){
+	if(response.status != 201 && response.status != 202){
         throw std::runtime_error("Could not close environment " + env_name);
     }
 	
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
+	router_ -> release(env_name, cidx);
+	
+    nlohmann::json j = parse_json_(env_name, "/close", response);
 	return j;	
 }
 
@@ -139,34 +219,69 @@ RESTApiServerWrapper::reset(const std::string& env_name,
                             const uint_t seed,
 	                        const nlohmann::json& options)const{
 								
+	const auto response = reset_raw(env_name, cidx, seed, options);
+    nlohmann::json j = parse_json_(env_name, "/reset", response);
+	return j;							
+}
+
+HTTPResponse 
+RESTApiServerWrapper::reset_raw(const std::string& env_name, 
+                                const uint_t cidx,
+                                const uint_t seed,
+	                            const nlohmann::json& options,
+								const http_header_fields& headers)const{
+								
 	
-    // find the source
-	auto url_ = get_env_url(env_name);
-	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
-		throw std::logic_error("Environment: " + env_name + " is not registered");
-	}
+    // find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
 
 	const auto request_url = url_ + "/reset";
-    http::Request request{request_url};
 
     nlohmann::json request_body;
     request_body["seed"] = seed;
 	request_body["cidx"] = cidx;
 	request_body["options"] = options;
 	
-    const auto response = request.send("POST", request_body.dump());
+    auto response = send_request_(shard, env_name, "/reset", "POST", request_url, request_body.dump(), headers);
 
-     if(response.status.code != 202){
+     if(response.status != 202){
         throw std::runtime_error("Environment server failed to reset environment");
     }
 								
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
-	return j;							
+	return response;							
 								
 }
 
+std::future<nlohmann::json> 
+RESTApiServerWrapper::async_reset(const std::string& env_name, 
+                                  const uint_t cidx,
+                                  const uint_t seed,
+	                              const nlohmann::json& options)const{
+	
+	return async_reset(env_name, cidx, seed, options, 
+	                   [](const nlohmann::json& response){return response;});
+}
+
+std::future<HTTPResponse> 
+RESTApiServerWrapper::async_reset_raw(const std::string& env_name, 
+                                      const uint_t cidx,
+                                      const uint_t seed,
+	                                  const nlohmann::json& options,
+									  const http_header_fields& headers)const{
+	
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	nlohmann::json body;
+    body["seed"] = seed;
+	body["cidx"] = cidx;
+	body["options"] = options;
+	
+	return async_send_raw_request_(shard, env_name, "/reset", "POST", url_ + "/reset", body.dump(), headers, 202,
+	                               "Environment server failed to reset environment", 
+							       [](HTTPResponse&& response){return std::move(response);});
+}
+
 
 nlohmann::json 
 RESTApiServerWrapper::make(const std::string& env_name, 
@@ -175,53 +290,103 @@ RESTApiServerWrapper::make(const std::string& env_name,
 						   const nlohmann::json& options)const{
 
 	// find the source
-	auto url_ = get_env_url(env_name);
+	auto uri_ = get_uri(env_name);
 	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
+	if(uri_ == rlenvscpp::consts::INVALID_STR){
 		throw std::logic_error("Environment: " + env_name + " is not registered");
 	}
 	
-	const auto request_url = url_ + "/make";
-    http::Request request{request_url};
+	// place the copy on a server. Every other
+	// request for the copy is sent there
+	const auto shard = router_ -> assign(env_name, cidx);
+	const auto request_url = router_ -> url(shard) + uri_ + "/make";
 	
     nlohmann::json request_body;
     request_body["version"] = version;
 	request_body["cidx"] = cidx;
 	request_body["options"] = options;
 	
-    const auto response = request.send("POST", request_body.dump());
+	HTTPResponse response;
+	
+	try{
+		response = send_request_(shard, env_name, "/make", "POST", request_url, request_body.dump());
+	}
+	catch(...){
+		router_ -> release(env_name, cidx);
+		throw;
+	}
 
-    if(response.status.code != 201){
+    if(response.status != 201){
+		router_ -> release(env_name, cidx);
         throw std::runtime_error("Environment server failed to create Environment");
     }
 	
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
+    nlohmann::json j = parse_json_(env_name, "/make", response);
 	return j;	
 								
 }
 
+nlohmann::json 
+RESTApiServerWrapper::attach_shm(const std::string& env_name,
+                                 const uint_t cidx,
+								 const uint_t n_slots)const{
+									 
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	const auto request_url = url_ + "/attach-shm";
+	
+    nlohmann::json request_body;
+	request_body["cidx"] = cidx;
+	request_body["n_slots"] = n_slots;
+	
+    const auto response = send_request_(shard, env_name, "/attach-shm", "POST", request_url, request_body.dump());
+
+    if(response.status != 201){
+        throw std::runtime_error("Environment server failed to attach shared memory");
+    }
+	
+    nlohmann::json j = parse_json_(env_name, "/attach-shm", response);
+	return j;
+}
+
+nlohmann::json 
+RESTApiServerWrapper::detach_shm(const std::string& env_name,
+                                 const uint_t cidx)const{
+									 
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	const auto request_url = url_ + "/detach-shm";
+	
+    nlohmann::json request_body;
+	request_body["cidx"] = cidx;
+	
+    const auto response = send_request_(shard, env_name, "/detach-shm", "POST", request_url, request_body.dump());
+
+    if(response.status != 202){
+        throw std::runtime_error("Environment server failed to detach shared memory");
+    }
+	
+    nlohmann::json j = parse_json_(env_name, "/detach-shm", response);
+	return j;
+}
+
 nlohmann::json 
 RESTApiServerWrapper::dynamics(const std::string& env_name, 
 							   const uint_t cidx,
 	                           const uint_t sidx, 
 							   const uint_t aidx)const{
 								   
-	// find the source
-	auto url_ = get_env_url(env_name);
-	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
-		throw std::logic_error("Environment: " + env_name + " is not registered");
-	}
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
 	
 	const auto request_url = url_ + "/dynamics?cidx="+std::to_string(cidx)
 	                                                +"&stateId="+std::to_string(sidx)
 													+"&actionId="+std::to_string(aidx);
-    http::Request request{request_url};
-    const auto response = request.send("GET");
+    const auto response = send_request_(shard, env_name, "/dynamics", "GET", request_url);
 	
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
+    nlohmann::json j = parse_json_(env_name, "/dynamics", response);
 	return j;	
 }
 
@@ -229,10 +394,9 @@ bool
 RESTApiServerWrapper::has_gymnasium()const{
 
     const auto request_url = url_ + "/api-info/gymnasium";
-    http::Request request{request_url};
 
-    const auto response = request.send("GET");
-    return response.status.code == 200;
+    const auto response = send_request_(0, "", "/api-info/gymnasium", "GET", request_url);
+    return response.status == 200;
 
 }
 
@@ -240,17 +404,15 @@ std::vector<std::string>
 RESTApiServerWrapper::gymnasium_envs()const{
 
     const auto request_url = url_ + "/api-info/gymnasium/envs";
-    http::Request request{request_url};
 
-    const auto response = request.send("GET");
+    const auto response = send_request_(0, "", "/api-info/gymnasium/envs", "GET", request_url);
 
-    if(response.status.code != 200){
+    if(response.status != 200){
         throw std::runtime_error("Environment server responded with error");
     }
 
-    auto str_response = std::string(response.body.begin(), response.body.end());
     using json = nlohmann::json;
-    json j = json::parse(str_response);
+    json j = json::parse(response.body);
     return j["envs"];
 }
 
@@ -6,11 +6,18 @@
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/rlenvs_consts.h"
 #include "rlenvs/extern/nlohmann/json/json.hpp"
-#include "rlenvs/extern/HTTPRequest.hpp"
+#include "rlenvs/envs/api_server/http_connection.h"
+#include "rlenvs/envs/api_server/apiserver_stats.h"
+#include "rlenvs/envs/api_server/shard_router.h"
 #include <string>
 #include <vector>
 #include <any>
+#include <memory>
+#include <future>
+#include <type_traits>
 #include <unordered_map>
+#include <map>
+#include <utility>
 
 ///
 /// todo write docs
@@ -30,10 +37,27 @@ class RESTApiServerWrapper
 public:
 
     ///
-    /// \brief Constructor
+    /// \brief Constructor. If keep_alive is true the requests
+    /// are sent over a pool of persistent connections that is
+    /// shared by all the copies of this wrapper. Otherwise
+    /// a new connection is opened for every request. A server
+    /// on the same host can be reached over a Unix domain socket
+    /// with a URL such as unix:///tmp/rlenvs.sock:/api
     ///
     explicit RESTApiServerWrapper(const std::string& url="http://0.0.0.0:8001/api",
-	                              const bool initialize=true);
+	                              const bool initialize=true,
+								  const bool keep_alive=true);
+								  
+	///
+	/// \brief Constructor. The copies of the environments are spread
+	/// over the servers at the given urls according to the policy. Every
+	/// server should expose the same environments. make places a copy
+	/// on a server and every other request for it is sent there
+	///
+	explicit RESTApiServerWrapper(const std::vector<std::string>& urls,
+	                              const ShardPolicy policy=ShardPolicy::CONSISTENT_HASH,
+	                              const bool initialize=true,
+								  const bool keep_alive=true);
 								  
 	///
 	/// \brief Returns true if the server is initialised
@@ -41,16 +65,70 @@ public:
 	bool is_inisialised()const noexcept{return is_init_;}
 	
 	///
-	/// \brief Returns the remote url
+	/// \brief Returns the remote url. With several
+	/// servers this is the url of the first one
 	///
 	std::string get_url()const noexcept{return url_;}
 	
+	///
+	/// \brief Returns the url of every server
+	///
+	const std::vector<std::string>& get_urls()const noexcept{return router_ -> urls();}
+	
+	///
+	/// \brief Returns the number of servers
+	///
+	uint_t n_shards()const noexcept{return router_ -> n_shards();}
+	
+	///
+	/// \brief Returns the index of the server that owns
+	/// the copy cidx of the given environment
+	///
+	uint_t shard(const std::string& env_name, const uint_t cidx)const{return router_ -> shard(env_name, cidx);}
+	
+	///
+	/// \brief Returns the router that maps the
+	/// environment copies to the servers
+	///
+	const ShardRouter& shard_router()const noexcept{return *router_;}
+	
+	///
+	/// \brief Returns true if connections to the
+	/// remote server are reused
+	///
+	bool keep_alive()const noexcept{return pools_.front() -> keep_alive();}
+	
+	///
+	/// \brief Returns the pool of connections to the given server
+	///
+	HTTPConnectionPool& connection_pool(const uint_t shard=0)const{return *pools_.at(shard);}
+	
+	///
+	/// \brief Returns a snapshot of the request statistics per
+	/// environment name and endpoint collected by this wrapper
+	/// and its copies
+	///
+	APIServerStats::snapshot_type stats()const{return stats_ -> snapshot();}
+	
+	///
+	/// \brief Returns the collector of the request statistics. Use it
+	/// to enable or disable the recording or to dump the statistics
+	/// periodically to a CSV file
+	///
+	APIServerStats& stats_collector()const noexcept{return *stats_;}
+	
 	///
 	/// \brief Return the url for the environment
 	/// with the given name
 	///
 	std::string get_env_url(const std::string& name)const noexcept;
 	
+	///
+	/// \brief Return the url for the environment with the given
+	/// name on the server that owns the copy cidx
+	///
+	std::string get_env_url(const std::string& name, const uint_t cidx)const;
+	
 	///
 	/// \brief Returns the URI of the environment
 	/// with the given name Returns INVALID_STR
@@ -81,7 +159,7 @@ public:
 	///
 	/// \brief Close the environment with the given name.
 	/// Throws std::logic_error is the environment is not registered
-	/// Throws std::runtime_error if the server response is not 201
+	/// Throws std::runtime_error if the server response is not 201 or 202
 	///
 	nlohmann::json close(const std::string& env_name, 
 	                     const uint_t cidx)const;
@@ -98,6 +176,59 @@ public:
 	                    const uint_t cidx,
 	                    const ActionType& action)const;
 						
+	///
+	/// \brief As step but returns the HTTP response without parsing
+	/// it. The given header fields are sent with the request, which
+	/// allows negotiating the format of the response
+	///
+	template<typename ActionType>
+	HTTPResponse step_raw(const std::string& env_name, 
+	                      const uint_t cidx,
+	                      const ActionType& action,
+						  const http_header_fields& headers=http_header_fields())const;
+	
+	///
+	/// \brief Execute the actions one after the other on the environment
+	/// with the given name and copy index. The step requests are pipelined
+	/// over one keep-alive connection, up to max_in_flight at a time, so
+	/// the throughput is bounded by the server and not by the round trip
+	/// time. Returns the server responses in the order of the actions.
+	/// Every action is executed, also those after a LAST time step
+	/// Throws std::logic_error is the environment is not registered
+	/// Throws std::runtime_error if a server response is not 202
+	/// Throws HTTPSequenceInterrupted if the server closes the connection
+	/// while steps are in flight. Steps are never sent twice
+	///
+	template<typename ActionType>
+	std::vector<nlohmann::json> step_sequence(const std::string& env_name, 
+	                                          const uint_t cidx,
+	                                          const std::vector<ActionType>& actions,
+											  const uint_t max_in_flight=32)const;
+											  
+	///
+	/// \brief As step_sequence but returns the HTTP responses without
+	/// parsing them. See step_raw
+	///
+	template<typename ActionType>
+	std::vector<HTTPResponse> step_sequence_raw(const std::string& env_name, 
+	                                            const uint_t cidx,
+	                                            const std::vector<ActionType>& actions,
+												const http_header_fields& headers=http_header_fields(),
+												const uint_t max_in_flight=32)const;
+	
+	///
+	/// \brief Step in several copies of the environment with the
+	/// given name using a single request. Every entry in actions holds
+	/// the copy index and the action to execute on that copy.
+	/// Returns the JSON array of the time steps in the order of
+	/// the actions. Every element has the form {"cidx": cidx, "time_step": {...}}
+	/// Throws std::logic_error is the environment is not registered
+	/// Throws std::runtime_error if the server response is not 202
+	///
+	template<typename ActionType>
+	nlohmann::json step_batch(const std::string& env_name,
+	                          const std::vector<std::pair<uint_t, ActionType> >& actions)const;
+						
 	///
 	/// \brief Reset the the environment with the given name
 	/// and the given copy index executing action.
@@ -109,6 +240,81 @@ public:
 	                     const uint_t seed,
 						 const nlohmann::json& options)const;
 						 
+	///
+	/// \brief As reset but returns the HTTP response without parsing it.
+	/// See step_raw
+	///
+	HTTPResponse reset_raw(const std::string& env_name, 
+	                       const uint_t cidx,
+	                       const uint_t seed,
+						   const nlohmann::json& options,
+						   const http_header_fields& headers=http_header_fields())const;
+	
+	///
+	/// \brief Asynchronous version of step. The request is
+	/// sent without blocking the calling thread and the returned
+	/// future holds the server response. The future throws
+	/// std::runtime_error if the server response is not 202
+	/// Throws std::logic_error is the environment is not registered
+	///
+	template<typename ActionType>
+	std::future<nlohmann::json> async_step(const std::string& env_name, 
+	                                       const uint_t cidx,
+	                                       const ActionType& action)const;
+	
+	///
+	/// \brief As async_step above. The handler is applied to the
+	/// server response on the event loop thread and the returned
+	/// future holds its result. The handler should not block
+	///
+	template<typename ActionType, typename HandlerType>
+	std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+	async_step(const std::string& env_name, 
+	           const uint_t cidx,
+	           const ActionType& action,
+			   HandlerType handler)const;
+			   
+	///
+	/// \brief As async_step but the future holds the HTTP response
+	/// without parsing it. See step_raw
+	///
+	template<typename ActionType>
+	std::future<HTTPResponse> async_step_raw(const std::string& env_name, 
+	                                         const uint_t cidx,
+	                                         const ActionType& action,
+											 const http_header_fields& headers=http_header_fields())const;
+			   
+	///
+	/// \brief Asynchronous version of reset. 
+	/// See async_step for the semantics
+	///
+	std::future<nlohmann::json> async_reset(const std::string& env_name, 
+	                                        const uint_t cidx,
+	                                        const uint_t seed,
+						                    const nlohmann::json& options)const;
+	
+	///
+	/// \brief Asynchronous version of reset. 
+	/// See async_step for the semantics
+	///
+	template<typename HandlerType>
+	std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+	async_reset(const std::string& env_name, 
+	            const uint_t cidx,
+	            const uint_t seed,
+				const nlohmann::json& options,
+				HandlerType handler)const;
+				
+	///
+	/// \brief As async_reset but the future holds the HTTP
+	/// response without parsing it. See step_raw
+	///
+	std::future<HTTPResponse> async_reset_raw(const std::string& env_name, 
+	                                          const uint_t cidx,
+	                                          const uint_t seed,
+						                      const nlohmann::json& options,
+											  const http_header_fields& headers=http_header_fields())const;
+						 
 	///
 	/// \brief Make the the environment with the given name
 	/// and the given copy index executing action.
@@ -130,6 +336,27 @@ public:
 	                        const uint_t sidx, 
 							const uint_t aidx)const;
 	
+	///
+	/// \brief Ask the server to write the time steps of the environment
+	/// copy cidx into a shared memory ring with n_slots slots. Returns
+	/// the server response that holds the name of the shared memory
+	/// object. Only environments on the same host support this.
+	/// Throws std::logic_error is the environment is not registered
+	/// Throws std::runtime_error if the server response is not 201
+	///
+	nlohmann::json attach_shm(const std::string& env_name,
+	                          const uint_t cidx,
+							  const uint_t n_slots)const;
+	
+	///
+	/// \brief Stop writing the time steps of the environment copy
+	/// cidx into shared memory. 
+	/// Throws std::logic_error is the environment is not registered
+	/// Throws std::runtime_error if the server response is not 202
+	///
+	nlohmann::json detach_shm(const std::string& env_name,
+	                          const uint_t cidx)const;
+	
 	///
 	/// \brief Make the cidx copy of the environment
 	///
@@ -166,11 +393,92 @@ private:
 	/// respective URI on the remote server
 	///
 	std::unordered_map<std::string, std::string> envs_;
+	
+	///
+	/// \brief The connections to every remote server. Shared by
+	/// the copies of this wrapper
+	///
+	std::vector<std::shared_ptr<HTTPConnectionPool> > pools_;
+	
+	///
+	/// \brief Maps the environment copies to the servers. Shared
+	/// by the copies of this wrapper
+	///
+	std::shared_ptr<ShardRouter> router_;
+	
+	///
+	/// \brief The request statistics. Shared by
+	/// the copies of this wrapper
+	///
+	std::shared_ptr<APIServerStats> stats_;
 
 	///
 	/// \brief Initialzes the available environments
 	///
 	void init_();
+	
+	///
+	/// \brief Returns the server that owns the copy cidx of the environment
+	/// and the url of the environment on that server. Throws std::logic_error
+	/// if the environment is not registered
+	///
+	std::pair<uint_t, std::string> route_(const std::string& env_name, const uint_t cidx)const;
+	
+	///
+	/// \brief Send a request to the given url over the connection pool of
+	/// the given server. The request is recorded under the given
+	/// environment and endpoint
+	///
+	HTTPResponse send_request_(const uint_t shard,
+	                           const std::string& env_name,
+	                           const std::string& endpoint,
+	                           const std::string& method,
+	                           const std::string& url,
+							   const std::string& body="",
+							   const http_header_fields& headers=http_header_fields())const;
+							   
+	///
+	/// \brief Parse the JSON body of the response recording the time it takes
+	///
+	nlohmann::json parse_json_(const std::string& env_name,
+	                           const std::string& endpoint,
+							   const HTTPResponse& response)const;
+							   
+	///
+	/// \brief Send a request to the given url over the event loop of the
+	/// connection pool of the given server. The handler
+	/// is applied to the JSON response if the status is the expected one.
+	/// The time from the submission until the response arrives is recorded
+	/// as wait time and only the bodies are counted as bytes
+	///
+	template<typename HandlerType>
+	std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+	async_send_request_(const uint_t shard,
+	                    const std::string& env_name,
+	                    const std::string& endpoint,
+	                    const std::string& method,
+	                    const std::string& url,
+						const std::string& body,
+						const int expected_status,
+						const std::string& error_message,
+						HandlerType handler)const;
+						
+	///
+	/// \brief As async_send_request_ but the handler is applied
+	/// to the HTTP response, which is not parsed
+	///
+	template<typename HandlerType>
+	std::future<std::invoke_result_t<HandlerType, HTTPResponse&&> >
+	async_send_raw_request_(const uint_t shard,
+	                        const std::string& env_name,
+	                        const std::string& endpoint,
+	                        const std::string& method,
+	                        const std::string& url,
+						    const std::string& body,
+						    const http_header_fields& headers,
+						    const int expected_status,
+						    const std::string& error_message,
+						    HandlerType handler)const;
 };
 
 template<typename ActionType>
@@ -178,31 +486,295 @@ nlohmann::json
 RESTApiServerWrapper::step(const std::string& env_name, const uint_t cidx,
 	                       const ActionType& action)const{
 							   
+	const auto response = step_raw(env_name, cidx, action);
+	return parse_json_(env_name, "/step", response);
+							   
+}
+
+template<typename ActionType>
+HTTPResponse 
+RESTApiServerWrapper::step_raw(const std::string& env_name, const uint_t cidx,
+	                           const ActionType& action,
+							   const http_header_fields& headers)const{
+							   
 		
-	// find the source
-	auto url_ = get_env_url(env_name);
-	
-	if(url_ == rlenvscpp::consts::INVALID_STR){
-		throw std::logic_error("Environment: " + env_name + " is not registered");
-	}
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
 	
 	const auto request_url = url_ + "/step";
-    http::Request request{request_url};
 	
 	nlohmann::json body;
 	body["cidx"] = cidx;
 	body["action"] = action;
 	
-	const auto response = request.send("POST", body.dump());
+	auto response = send_request_(shard, env_name, "/step", "POST", request_url, body.dump(), headers);
 
-    if(response.status.code != 202){
+    if(response.status != 202){
         throw std::runtime_error("Environment server failed to step environment");
     }
 	
-	auto str_response = std::string(response.body.begin(), response.body.end());
-    nlohmann::json j = nlohmann::json::parse(str_response);
-	return j;
+	return response;
+							   
+}
+
+template<typename ActionType>
+std::vector<HTTPResponse> 
+RESTApiServerWrapper::step_sequence_raw(const std::string& env_name, 
+                                        const uint_t cidx,
+	                                    const std::vector<ActionType>& actions,
+										const http_header_fields& headers,
+										const uint_t max_in_flight)const{
+											
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	const auto request_url = url_ + "/step";
+	
+	std::vector<std::string> bodies;
+	bodies.reserve(actions.size());
+	
+	for(const auto& action : actions){
+		
+		nlohmann::json body;
+		body["cidx"] = cidx;
+		body["action"] = action;
+		bodies.push_back(body.dump());
+	}
+	
+	std::vector<HTTPRequestTiming> timings;
+	auto responses = pools_[shard] -> request_sequence("POST", request_url, bodies, headers, max_in_flight,
+	                                                   stats_ -> is_enabled() ? &timings : nullptr);
+	
+	for(uint_t i=0; i<timings.size(); ++i){
+		stats_ -> record(env_name, "/step", timings[i], responses[i].status >= 400);
+	}
+	
+	for(const auto& response : responses){
+		if(response.status != 202){
+			throw std::runtime_error("Environment server failed to step environment");
+		}
+	}
+	
+	return responses;
+}
+
+template<typename ActionType>
+std::vector<nlohmann::json> 
+RESTApiServerWrapper::step_sequence(const std::string& env_name, 
+                                    const uint_t cidx,
+	                                const std::vector<ActionType>& actions,
+									const uint_t max_in_flight)const{
+	
+	const auto responses = step_sequence_raw(env_name, cidx, actions, http_header_fields(), max_in_flight);
+	
+	std::vector<nlohmann::json> time_steps;
+	time_steps.reserve(responses.size());
+	
+	for(const auto& response : responses){
+		time_steps.push_back(parse_json_(env_name, "/step", response));
+	}
+	
+	return time_steps;
+}
+
+template<typename ActionType>
+nlohmann::json 
+RESTApiServerWrapper::step_batch(const std::string& env_name, 
+                                 const std::vector<std::pair<uint_t, ActionType> >& actions)const{
 							   
+	if(get_uri(env_name) == rlenvscpp::consts::INVALID_STR){
+		throw std::logic_error("Environment: " + env_name + " is not registered");
+	}
+	
+	// group the actions by the server that owns the copy. 
+	// Every server receives a single request
+	std::map<uint_t, std::vector<uint_t> > groups;
+	for(uint_t i=0; i<actions.size(); ++i){
+		groups[shard(env_name, actions[i].first)].push_back(i);
+	}
+	
+	std::vector<nlohmann::json> time_steps(actions.size());
+	
+	for(const auto& [shard, indices] : groups){
+		
+		const auto request_url = get_env_url(env_name, actions[indices.front()].first) + "/step-batch";
+		
+		nlohmann::json body;
+		body["actions"] = nlohmann::json::array();
+		
+		for(const auto idx : indices){
+			
+			nlohmann::json entry;
+			entry["cidx"] = actions[idx].first;
+			entry["action"] = actions[idx].second;
+			body["actions"].push_back(entry);
+		}
+		
+		const auto response = send_request_(shard, env_name, "/step-batch", "POST", request_url, body.dump());
+
+		if(response.status != 202){
+			throw std::runtime_error("Environment server failed to step environments");
+		}
+		
+		nlohmann::json j = parse_json_(env_name, "/step-batch", response);
+		const auto& shard_time_steps = j["time_steps"];
+		
+		if(shard_time_steps.size() != indices.size()){
+			throw std::runtime_error("Environment server returned " + std::to_string(shard_time_steps.size()) + 
+			                         " time steps for " + std::to_string(indices.size()) + " actions");
+		}
+		
+		for(uint_t k=0; k<indices.size(); ++k){
+			time_steps[indices[k]] = shard_time_steps[k];
+		}
+	}
+	
+	return nlohmann::json(time_steps);
+}
+
+template<typename HandlerType>
+std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+RESTApiServerWrapper::async_send_request_(const uint_t shard,
+                                          const std::string& env_name,
+                                          const std::string& endpoint,
+                                          const std::string& method,
+										  const std::string& url,
+										  const std::string& body,
+										  const int expected_status,
+										  const std::string& error_message,
+										  HandlerType handler)const{
+	
+	return async_send_raw_request_(shard, env_name, endpoint, method, url, body, 
+	                               http_header_fields(), expected_status, error_message,
+	                               [stats=stats_, env_name, endpoint, 
+								    handler=std::move(handler)](HTTPResponse&& response) mutable{
+		
+		StopWatch watch;
+		auto json = nlohmann::json::parse(response.body);
+		stats -> record_parse(env_name, endpoint, watch.elapsed());
+		
+		return handler(json);
+	});
+}
+
+template<typename HandlerType>
+std::future<std::invoke_result_t<HandlerType, HTTPResponse&&> >
+RESTApiServerWrapper::async_send_raw_request_(const uint_t shard,
+                                              const std::string& env_name,
+                                              const std::string& endpoint,
+                                              const std::string& method,
+										      const std::string& url,
+										      const std::string& body,
+											  const http_header_fields& headers,
+										      const int expected_status,
+										      const std::string& error_message,
+										      HandlerType handler)const{
+	
+	typedef std::invoke_result_t<HandlerType, HTTPResponse&&> result_type;
+	
+	auto promise = std::make_shared<std::promise<result_type> >();
+	auto future = promise -> get_future();
+	
+	const auto submitted = std::chrono::steady_clock::now();
+	const auto bytes_sent = body.size();
+	
+	pools_[shard] -> async_request(method, url, body, headers,
+	                       [promise, expected_status, error_message, 
+						    stats=stats_, env_name, endpoint, submitted, bytes_sent,
+						    handler=std::move(handler)](HTTPResponse&& response, std::exception_ptr error) mutable{
+		
+		HTTPRequestTiming timing;
+		timing.wait = std::chrono::steady_clock::now() - submitted;
+		timing.bytes_sent = bytes_sent;
+		timing.bytes_received = response.body.size();
+		stats -> record(env_name, endpoint, timing, error || response.status >= 400);
+		
+		try{
+			
+			if(error){
+				std::rethrow_exception(error);
+			}
+			
+			if(response.status != expected_status){
+				throw std::runtime_error(error_message);
+			}
+			
+			promise -> set_value(handler(std::move(response)));
+		}
+		catch(...){
+			promise -> set_exception(std::current_exception());
+		}
+	});
+	
+	return future;
+}
+
+template<typename ActionType>
+std::future<nlohmann::json>
+RESTApiServerWrapper::async_step(const std::string& env_name, 
+	                             const uint_t cidx,
+	                             const ActionType& action)const{
+	
+	return async_step(env_name, cidx, action, [](const nlohmann::json& response){return response;});
+}
+
+template<typename ActionType, typename HandlerType>
+std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+RESTApiServerWrapper::async_step(const std::string& env_name, 
+	                             const uint_t cidx,
+	                             const ActionType& action,
+								 HandlerType handler)const{
+	
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	nlohmann::json body;
+	body["cidx"] = cidx;
+	body["action"] = action;
+	
+	return async_send_request_(shard, env_name, "/step", "POST", url_ + "/step", body.dump(), 202,
+	                           "Environment server failed to step environment", 
+							   std::move(handler));
+}
+
+template<typename ActionType>
+std::future<HTTPResponse>
+RESTApiServerWrapper::async_step_raw(const std::string& env_name, 
+	                                 const uint_t cidx,
+	                                 const ActionType& action,
+									 const http_header_fields& headers)const{
+	
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	nlohmann::json body;
+	body["cidx"] = cidx;
+	body["action"] = action;
+	
+	return async_send_raw_request_(shard, env_name, "/step", "POST", url_ + "/step", body.dump(), headers, 202,
+	                               "Environment server failed to step environment", 
+							       [](HTTPResponse&& response){return std::move(response);});
+}
+
+template<typename HandlerType>
+std::future<std::invoke_result_t<HandlerType, const nlohmann::json&> >
+RESTApiServerWrapper::async_reset(const std::string& env_name, 
+	                              const uint_t cidx,
+	                              const uint_t seed,
+				                  const nlohmann::json& options,
+				                  HandlerType handler)const{
+	
+	// find the server and the source
+	const auto [shard, url_] = route_(env_name, cidx);
+	
+	nlohmann::json body;
+    body["seed"] = seed;
+	body["cidx"] = cidx;
+	body["options"] = options;
+	
+	return async_send_request_(shard, env_name, "/reset", "POST", url_ + "/reset", body.dump(), 202,
+	                           "Environment server failed to reset environment", 
+							   std::move(handler));
 }
 
 
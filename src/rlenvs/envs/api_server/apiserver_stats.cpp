@@ -0,0 +1,303 @@
+#include "rlenvs/envs/api_server/apiserver_stats.h"
+#include "rlenvs/utils/io/csv_file_writer.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+// number of sub-buckets in every power of two above SUB_BUCKET_COUNT
+const std::uint64_t HALF_COUNT = LatencyHistogram::SUB_BUCKET_COUNT / 2;
+const std::uint64_t HALF_BITS = std::countr_zero(HALF_COUNT);
+
+std::uint64_t
+bucket_index(std::uint64_t value){
+
+	if(value < LatencyHistogram::SUB_BUCKET_COUNT){
+		return value;
+	}
+
+	const std::uint64_t magnitude = std::bit_width(value) - 1;
+	const std::uint64_t shift = magnitude - HALF_BITS;
+	return shift * HALF_COUNT + (value >> shift);
+}
+
+std::uint64_t
+bucket_upper_bound(std::uint64_t index){
+
+	if(index < LatencyHistogram::SUB_BUCKET_COUNT){
+		return index;
+	}
+
+	const std::uint64_t shift = index / HALF_COUNT - 1;
+	const std::uint64_t sub = index % HALF_COUNT + HALF_COUNT;
+	return ((sub + 1) << shift) - 1;
+}
+
+std::string
+format_us(std::uint64_t ns){
+
+	std::ostringstream out;
+	out << static_cast<real_t>(ns) / 1000.0;
+	return out.str();
+}
+
+std::string
+format_us(real_t ns){
+
+	std::ostringstream out;
+	out << ns / 1000.0;
+	return out.str();
+}
+
+}
+
+LatencyHistogram::LatencyHistogram()
+:
+counts_(bucket_index(MAX_VALUE) + 1, 0)
+{}
+
+void
+LatencyHistogram::record(std::uint64_t value)noexcept{
+
+	value = std::min(value, MAX_VALUE);
+
+	counts_[bucket_index(value)] += 1;
+	min_ = count_ == 0 ? value : std::min(min_, value);
+	max_ = std::max(max_, value);
+	sum_ += value;
+	count_ += 1;
+}
+
+void
+LatencyHistogram::record(std::chrono::nanoseconds value)noexcept{
+	record(static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(value.count(), 0)));
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other)noexcept{
+
+	if(other.count_ == 0){
+		return;
+	}
+
+	for(uint_t i=0; i<counts_.size(); ++i){
+		counts_[i] += other.counts_[i];
+	}
+
+	min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+	max_ = std::max(max_, other.max_);
+	sum_ += other.sum_;
+	count_ += other.count_;
+}
+
+void
+LatencyHistogram::clear()noexcept{
+
+	std::fill(counts_.begin(), counts_.end(), 0);
+	count_ = 0;
+	min_ = 0;
+	max_ = 0;
+	sum_ = 0.0;
+}
+
+real_t
+LatencyHistogram::mean()const noexcept{
+
+	if(count_ == 0){
+		return 0.0;
+	}
+
+	return static_cast<real_t>(sum_ / count_);
+}
+
+std::uint64_t
+LatencyHistogram::value_at_quantile(real_t q)const noexcept{
+
+	if(count_ == 0){
+		return 0;
+	}
+
+	q = std::clamp(q, 0.0, 1.0);
+	const auto rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(q * count_)), 1);
+
+	std::uint64_t seen = 0;
+	for(uint_t i=0; i<counts_.size(); ++i){
+
+		seen += counts_[i];
+
+		if(seen >= rank){
+			return std::clamp(bucket_upper_bound(i), min(), max_);
+		}
+	}
+
+	return max_;
+}
+
+APIServerStats::~APIServerStats(){
+	stop_csv_dump();
+}
+
+void
+APIServerStats::record(const std::string& env_name,
+                       const std::string& endpoint,
+					   const HTTPRequestTiming& timing,
+					   bool error){
+
+	if(!enabled_){
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto& stats = stats_[{env_name, endpoint}];
+
+	stats.n_requests += 1;
+	stats.n_errors += error ? 1 : 0;
+	stats.bytes_sent += timing.bytes_sent;
+	stats.bytes_received += timing.bytes_received;
+	stats.latency.record(timing.total());
+	stats.connect.record(timing.connect);
+	stats.send.record(timing.send);
+	stats.wait.record(timing.wait);
+}
+
+void
+APIServerStats::record_parse(const std::string& env_name,
+                             const std::string& endpoint,
+							 std::chrono::nanoseconds duration){
+
+	if(!enabled_){
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	stats_[{env_name, endpoint}].parse.record(duration);
+}
+
+APIServerStats::snapshot_type
+APIServerStats::snapshot()const{
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+void
+APIServerStats::clear(){
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	stats_.clear();
+}
+
+std::vector<std::string>
+APIServerStats::csv_column_names(){
+
+	std::vector<std::string> names = {"time", "env", "endpoint", "n_requests",
+	                                  "n_errors", "bytes_sent", "bytes_received"};
+
+	for(const auto* phase : {"latency", "connect", "send", "wait", "parse"}){
+		for(const auto* value : {"mean", "p50", "p99", "p999", "max"}){
+			names.push_back(std::string(phase) + "_" + value + "_us");
+		}
+	}
+
+	return names;
+}
+
+void
+APIServerStats::write_csv(rlenvscpp::utils::io::CSVWriter& writer, real_t time)const{
+
+	const auto stats = snapshot();
+
+	for(const auto& [key, value] : stats){
+
+		std::ostringstream t;
+		t << time;
+
+		std::vector<std::string> row = {t.str(), key.first, key.second,
+		                                std::to_string(value.n_requests),
+										std::to_string(value.n_errors),
+										std::to_string(value.bytes_sent),
+										std::to_string(value.bytes_received)};
+
+		for(const auto* histogram : {&value.latency, &value.connect, &value.send,
+		                             &value.wait, &value.parse}){
+
+			row.push_back(format_us(histogram -> mean()));
+			row.push_back(format_us(histogram -> value_at_quantile(0.5)));
+			row.push_back(format_us(histogram -> value_at_quantile(0.99)));
+			row.push_back(format_us(histogram -> value_at_quantile(0.999)));
+			row.push_back(format_us(histogram -> max()));
+		}
+
+		writer.write_row(row);
+	}
+}
+
+void
+APIServerStats::start_csv_dump(const std::string& filename, std::chrono::milliseconds period){
+
+	if(period.count() <= 0){
+		throw std::logic_error("The dump period should be positive");
+	}
+
+	stop_csv_dump();
+
+	// open the file here so that errors reach the caller
+	auto writer = std::make_shared<rlenvscpp::utils::io::CSVWriter>(filename);
+	writer -> open();
+
+	if(!writer -> is_open()){
+		throw std::runtime_error("Failed to open " + filename);
+	}
+
+	writer -> write_column_names(csv_column_names());
+
+	{
+		std::lock_guard<std::mutex> lock(dump_mutex_);
+		stop_dump_ = false;
+	}
+
+	dump_thread_ = std::thread([this, writer, period](){
+
+		const auto start = std::chrono::steady_clock::now();
+		auto elapsed = [start](){
+			return std::chrono::duration<real_t>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		std::unique_lock<std::mutex> lock(dump_mutex_);
+		while(!dump_cv_.wait_for(lock, period, [this](){return stop_dump_;})){
+
+			lock.unlock();
+			write_csv(*writer, elapsed());
+			lock.lock();
+		}
+
+		lock.unlock();
+		write_csv(*writer, elapsed());
+		writer -> close();
+	});
+}
+
+void
+APIServerStats::stop_csv_dump(){
+
+	if(!dump_thread_.joinable()){
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dump_mutex_);
+		stop_dump_ = true;
+	}
+
+	dump_cv_.notify_all();
+	dump_thread_.join();
+}
+
+}
+}
@@ -0,0 +1,288 @@
+#ifndef APISERVER_STATS_H
+#define APISERVER_STATS_H
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/api_server/http_connection.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+
+namespace rlenvscpp{
+namespace utils{
+namespace io{
+class CSVWriter;
+}
+}
+
+namespace envs{
+
+///
+/// \brief Latency histogram with logarithmic buckets that are linearly
+/// subdivided, in the spirit of HdrHistogram. Values are recorded in
+/// nanoseconds with a relative error below 1.6% up to about 4.9 hours
+///
+class LatencyHistogram
+{
+public:
+
+	///
+	/// \brief Constructor
+	///
+	LatencyHistogram();
+
+	///
+	/// \brief Record a value in nanoseconds
+	///
+	void record(std::uint64_t value)noexcept;
+
+	///
+	/// \brief Record the given duration
+	///
+	void record(std::chrono::nanoseconds value)noexcept;
+
+	///
+	/// \brief Add the counts of another histogram
+	///
+	void merge(const LatencyHistogram& other)noexcept;
+
+	///
+	/// \brief Remove all the recorded values
+	///
+	void clear()noexcept;
+
+	///
+	/// \brief The number of recorded values
+	///
+	std::uint64_t count()const noexcept{return count_;}
+
+	///
+	/// \brief The smallest recorded value. Zero if empty
+	///
+	std::uint64_t min()const noexcept{return count_ == 0 ? 0 : min_;}
+
+	///
+	/// \brief The largest recorded value
+	///
+	std::uint64_t max()const noexcept{return max_;}
+
+	///
+	/// \brief The mean of the recorded values
+	///
+	real_t mean()const noexcept;
+
+	///
+	/// \brief The value below which the fraction q of the recorded
+	/// values fall, e.g. q=0.99 for the 99th percentile. The value is
+	/// the upper bound of its bucket. Zero if empty
+	///
+	std::uint64_t value_at_quantile(real_t q)const noexcept;
+
+	///
+	/// \brief Values below this are recorded exactly
+	///
+	static constexpr std::uint64_t SUB_BUCKET_COUNT = 128;
+
+	///
+	/// \brief Larger values are clamped to this
+	///
+	static constexpr std::uint64_t MAX_VALUE = (std::uint64_t(1) << 44) - 1;
+
+private:
+
+	std::vector<std::uint64_t> counts_;
+	std::uint64_t count_{0};
+	std::uint64_t min_{0};
+	std::uint64_t max_{0};
+	long double sum_{0.0};
+};
+
+///
+/// \brief Statistics of the requests to one endpoint of one environment
+///
+struct EndpointStats
+{
+	///
+	/// \brief The number of requests sent
+	///
+	uint_t n_requests{0};
+
+	///
+	/// \brief The number of requests that failed or were
+	/// answered with a status of 400 or above
+	///
+	uint_t n_errors{0};
+
+	///
+	/// \brief Total bytes sent
+	///
+	uint_t bytes_sent{0};
+
+	///
+	/// \brief Total bytes received
+	///
+	uint_t bytes_received{0};
+
+	///
+	/// \brief Latency of the request, i.e. connect + send + wait
+	///
+	LatencyHistogram latency;
+
+	///
+	/// \brief Latency split in phases
+	///
+	LatencyHistogram connect;
+	LatencyHistogram send;
+	LatencyHistogram wait;
+
+	///
+	/// \brief Time to decode the response body into JSON or
+	/// into a time step. Recorded separately by whoever decodes it
+	///
+	LatencyHistogram parse;
+};
+
+///
+/// \brief Thread-safe collection of EndpointStats keyed
+/// by environment name and endpoint, e.g. ("CartPole", "/step")
+///
+class APIServerStats
+{
+public:
+
+	///
+	/// \brief The key of the statistics
+	///
+	typedef std::pair<std::string, std::string> key_type;
+
+	///
+	/// \brief The statistics snapshot type
+	///
+	typedef std::map<key_type, EndpointStats> snapshot_type;
+
+	///
+	/// \brief Constructor
+	///
+	APIServerStats()=default;
+
+	///
+	/// \brief Destructor. Stops the periodic dump
+	///
+	~APIServerStats();
+
+	APIServerStats(const APIServerStats&)=delete;
+	APIServerStats& operator=(const APIServerStats&)=delete;
+
+	///
+	/// \brief Enable or disable the recording
+	///
+	void enable(bool flag)noexcept{enabled_ = flag;}
+
+	///
+	/// \brief Returns true if requests are recorded
+	///
+	bool is_enabled()const noexcept{return enabled_;}
+
+	///
+	/// \brief Record a request
+	///
+	void record(const std::string& env_name,
+	            const std::string& endpoint,
+				const HTTPRequestTiming& timing,
+				bool error=false);
+
+	///
+	/// \brief Record the time it took to decode a response
+	///
+	void record_parse(const std::string& env_name,
+	                  const std::string& endpoint,
+					  std::chrono::nanoseconds duration);
+
+	///
+	/// \brief Returns a copy of the statistics collected so far
+	///
+	snapshot_type snapshot()const;
+
+	///
+	/// \brief Remove all the statistics
+	///
+	void clear();
+
+	///
+	/// \brief The column names of write_csv
+	///
+	static std::vector<std::string> csv_column_names();
+
+	///
+	/// \brief Write one row per environment and endpoint. Latencies
+	/// are in microseconds. time is written in the first column
+	///
+	void write_csv(rlenvscpp::utils::io::CSVWriter& writer, real_t time=0.0)const;
+
+	///
+	/// \brief Append a snapshot to the given CSV file every period
+	/// from a background thread. The first column holds the seconds
+	/// since the dump started. Any dump in progress is stopped first
+	///
+	void start_csv_dump(const std::string& filename, std::chrono::milliseconds period);
+
+	///
+	/// \brief Stop the periodic dump. A last snapshot is written
+	///
+	void stop_csv_dump();
+
+private:
+
+	std::atomic<bool> enabled_{true};
+	mutable std::mutex mutex_;
+	snapshot_type stats_;
+
+	std::mutex dump_mutex_;
+	std::condition_variable dump_cv_;
+	bool stop_dump_{false};
+	std::thread dump_thread_;
+};
+
+///
+/// \brief Measures the time between construction and a call to elapsed()
+///
+class StopWatch
+{
+public:
+
+	StopWatch():start_(std::chrono::steady_clock::now()){}
+
+	///
+	/// \brief The time since construction or the last restart
+	///
+	std::chrono::nanoseconds elapsed()const{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+	}
+
+	///
+	/// \brief Start measuring again. Returns the time measured so far
+	///
+	std::chrono::nanoseconds restart(){
+		const auto now = std::chrono::steady_clock::now();
+		const auto result = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+		start_ = now;
+		return result;
+	}
+
+private:
+
+	std::chrono::steady_clock::time_point start_;
+};
+
+}
+}
+
+#endif // APISERVER_STATS_H
@@ -0,0 +1,884 @@
+#include "rlenvs/envs/api_server/http_connection.h"
+#include "rlenvs/envs/api_server/http_event_loop.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cctype>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+const std::string CRLF = "\r\n";
+const std::string HEADER_END = "\r\n\r\n";
+
+std::string
+to_lower(std::string str){
+	std::transform(str.begin(), str.end(), str.begin(),
+	               [](unsigned char c){return static_cast<char>(std::tolower(c));});
+	return str;
+}
+
+std::string
+trim(const std::string& str){
+
+	const auto begin = str.find_first_not_of(" \t");
+	if(begin == std::string::npos){
+		return std::string();
+	}
+
+	const auto end = str.find_last_not_of(" \t");
+	return str.substr(begin, end - begin + 1);
+}
+
+}
+
+HTTPEndpoint
+HTTPEndpoint::parse(const std::string& url){
+
+	const auto scheme_end = url.find("://");
+
+	if(scheme_end == std::string::npos){
+		throw std::logic_error("Invalid URL: " + url);
+	}
+
+	const auto scheme = url.substr(0, scheme_end);
+
+	if(scheme == "unix"){
+
+		// unix:///path/to.sock[:/api/path]
+		HTTPEndpoint endpoint;
+		endpoint.host = "localhost";
+		endpoint.port = "";
+
+		auto socket_path = url.substr(scheme_end + 3);
+		const auto path_begin = socket_path.find(':');
+
+		if(path_begin != std::string::npos){
+			endpoint.path = socket_path.substr(path_begin + 1);
+			socket_path = socket_path.substr(0, path_begin);
+		}
+
+		if(socket_path.empty() || socket_path.size() >= sizeof(sockaddr_un::sun_path)){
+			throw std::logic_error("Invalid Unix domain socket path. URL: " + url);
+		}
+
+		endpoint.socket_path = socket_path;
+		return endpoint;
+	}
+
+	if(scheme != "http"){
+		throw std::logic_error("Only the HTTP and unix schemes are supported. URL: " + url);
+	}
+
+	HTTPEndpoint endpoint;
+	const auto authority_begin = scheme_end + 3;
+	const auto path_begin = url.find('/', authority_begin);
+
+	const auto authority = url.substr(authority_begin,
+	                                  path_begin == std::string::npos ? std::string::npos : path_begin - authority_begin);
+
+	if(path_begin != std::string::npos){
+		endpoint.path = url.substr(path_begin);
+	}
+
+	const auto port_begin = authority.find(':');
+
+	if(port_begin != std::string::npos){
+		endpoint.host = authority.substr(0, port_begin);
+		endpoint.port = authority.substr(port_begin + 1);
+	}
+	else{
+		endpoint.host = authority;
+	}
+
+	if(endpoint.host.empty()){
+		throw std::logic_error("Invalid URL: " + url);
+	}
+
+	return endpoint;
+}
+
+int
+http_connect_unix_socket(const std::string& socket_path, bool non_blocking){
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+
+	if(socket_path.size() >= sizeof(address.sun_path)){
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+	const auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | (non_blocking ? SOCK_NONBLOCK : 0), 0);
+
+	if(fd == -1){
+		return -1;
+	}
+
+	if(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 &&
+	   !(non_blocking && errno == EINPROGRESS)){
+		const auto error = errno;
+		::close(fd);
+		errno = error;
+		return -1;
+	}
+
+	return fd;
+}
+
+std::string
+HTTPResponse::header(const std::string& name)const{
+
+	for(const auto& [field, value] : headers){
+		if(field == name){
+			return value;
+		}
+	}
+
+	return std::string();
+}
+
+bool
+http_is_idempotent_method(const std::string& method){
+
+	return method == "GET" || method == "HEAD" || method == "OPTIONS" ||
+	       method == "PUT" || method == "DELETE";
+}
+
+bool
+http_socket_closed(int fd)noexcept{
+
+	if(fd == -1){
+		return true;
+	}
+
+	char byte;
+	while(true){
+
+		const auto n = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+
+		if(n == -1 && errno == EINTR){
+			continue;
+		}
+
+		// nothing to read means the connection is still usable. An
+		// idle connection should never have bytes waiting to be read
+		return !(n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK));
+	}
+}
+
+HTTPConnection::HTTPConnection(const HTTPEndpoint& endpoint)
+:
+endpoint_(endpoint),
+fd_(-1),
+n_requests_(0),
+buffer_()
+{}
+
+HTTPConnection::~HTTPConnection(){
+	close();
+}
+
+void
+HTTPConnection::connect(){
+
+	if(is_open()){
+		return;
+	}
+
+	if(endpoint_.is_unix()){
+
+		const auto fd = http_connect_unix_socket(endpoint_.socket_path);
+
+		if(fd == -1){
+			throw std::runtime_error("Failed to connect to " + endpoint_.authority() + ": " + std::strerror(errno));
+		}
+
+		fd_ = fd;
+		buffer_.clear();
+		return;
+	}
+
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo* info = nullptr;
+	const auto status = ::getaddrinfo(endpoint_.host.c_str(), endpoint_.port.c_str(), &hints, &info);
+
+	if(status != 0){
+		throw std::runtime_error("Failed to resolve host " + endpoint_.host + ": " + ::gai_strerror(status));
+	}
+
+	std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> addresses(info, &::freeaddrinfo);
+
+	for(auto address = addresses.get(); address != nullptr; address = address -> ai_next){
+
+		const auto fd = ::socket(address -> ai_family, address -> ai_socktype, address -> ai_protocol);
+
+		if(fd == -1){
+			continue;
+		}
+
+		if(::connect(fd, address -> ai_addr, address -> ai_addrlen) == 0){
+
+			// requests are small and latency bound
+			int flag = 1;
+			::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+			fd_ = fd;
+			buffer_.clear();
+			return;
+		}
+
+		::close(fd);
+	}
+
+	throw std::runtime_error("Failed to connect to " + endpoint_.authority());
+}
+
+void
+HTTPConnection::close()noexcept{
+
+	if(fd_ != -1){
+		::close(fd_);
+		fd_ = -1;
+	}
+
+	buffer_.clear();
+}
+
+bool
+HTTPConnection::is_stale()const noexcept{
+	return !buffer_.empty() || http_socket_closed(fd_);
+}
+
+void
+HTTPConnection::write_all_(const std::string& data){
+
+	std::size_t sent = 0;
+	while(sent < data.size()){
+
+		const auto n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+
+		if(n == -1){
+
+			if(errno == EINTR){
+				continue;
+			}
+
+			const auto error = errno;
+			close();
+
+			if(error == EPIPE || error == ECONNRESET){
+				throw HTTPConnectionClosed("Connection closed by " + endpoint_.authority());
+			}
+
+			throw std::runtime_error("Failed to write to " + endpoint_.authority() + ": " + std::strerror(error));
+		}
+
+		sent += static_cast<std::size_t>(n);
+		n_bytes_sent_ += static_cast<uint_t>(n);
+	}
+}
+
+bool
+HTTPConnection::fill_(){
+
+	char chunk[16384];
+
+	while(true){
+
+		const auto n = ::recv(fd_, chunk, sizeof(chunk), 0);
+
+		if(n > 0){
+			buffer_.append(chunk, static_cast<std::size_t>(n));
+			return true;
+		}
+
+		if(n == 0){
+			return false;
+		}
+
+		if(errno == EINTR){
+			continue;
+		}
+
+		if(errno == ECONNRESET){
+			return false;
+		}
+
+		const auto error = errno;
+		close();
+		throw std::runtime_error("Failed to read from " + endpoint_.authority() + ": " + std::strerror(error));
+	}
+}
+
+std::string
+http_format_request(const HTTPEndpoint& endpoint,
+                    const std::string& method,
+					const std::string& target,
+					const std::string& body,
+					bool keep_alive,
+					const http_header_fields& headers){
+
+	std::string request;
+	request.reserve(256 + body.size());
+
+	request += method + " " + (target.empty() ? std::string("/") : target) + " HTTP/1.1" + CRLF;
+	request += "Host: " + endpoint.host + CRLF;
+	request += std::string("Connection: ") + (keep_alive ? "keep-alive" : "close") + CRLF;
+
+	bool has_content_type = false;
+	for(const auto& [name, value] : headers){
+		request += name + ": " + value + CRLF;
+		has_content_type = has_content_type || to_lower(name) == "content-type";
+	}
+
+	if(!body.empty() && !has_content_type){
+		request += "Content-Type: application/json" + CRLF;
+	}
+
+	request += "Content-Length: " + std::to_string(body.size()) + CRLF;
+	request += CRLF;
+	request += body;
+	return request;
+}
+
+bool
+http_parse_response(const std::string& buffer,
+                    HTTPResponse& response,
+					std::size_t& consumed,
+					bool at_eof){
+
+	const auto header_end = buffer.find(HEADER_END);
+	if(header_end == std::string::npos){
+		return false;
+	}
+
+	response = HTTPResponse();
+
+	auto line_end = buffer.find(CRLF);
+	const auto status_line = buffer.substr(0, line_end);
+
+	// HTTP/1.1 200 OK
+	const auto code_begin = status_line.find(' ');
+	if(code_begin == std::string::npos || status_line.compare(0, 5, "HTTP/") != 0){
+		throw std::runtime_error("Invalid status line: " + status_line);
+	}
+
+	response.status = std::atoi(status_line.c_str() + code_begin + 1);
+
+	auto pos = line_end + 2;
+	while(pos < header_end){
+
+		line_end = buffer.find(CRLF, pos);
+		const auto line = buffer.substr(pos, line_end - pos);
+		pos = line_end + 2;
+
+		const auto separator = line.find(':');
+		if(separator == std::string::npos){
+			continue;
+		}
+
+		response.headers.emplace_back(to_lower(trim(line.substr(0, separator))),
+		                              trim(line.substr(separator + 1)));
+	}
+
+	std::size_t end = header_end + HEADER_END.size();
+
+	const auto transfer_encoding = to_lower(response.header("transfer-encoding"));
+	const auto content_length = response.header("content-length");
+
+	if(transfer_encoding.find("chunked") != std::string::npos){
+
+		while(true){
+
+			const auto size_end = buffer.find(CRLF, end);
+			if(size_end == std::string::npos){
+				return false;
+			}
+
+			const auto chunk_size = std::strtoul(buffer.c_str() + end, nullptr, 16);
+
+			// the last chunk is followed by (ignored) trailers and an empty line
+			if(chunk_size == 0){
+
+				const auto trailers_end = buffer.find(HEADER_END, size_end);
+				if(trailers_end == std::string::npos){
+					return false;
+				}
+
+				end = trailers_end + HEADER_END.size();
+				break;
+			}
+
+			const auto chunk_begin = size_end + 2;
+			if(buffer.size() < chunk_begin + chunk_size + 2){
+				return false;
+			}
+
+			response.body.append(buffer, chunk_begin, chunk_size);
+			end = chunk_begin + chunk_size + 2;
+		}
+	}
+	else if(!content_length.empty()){
+
+		const auto length = static_cast<std::size_t>(std::strtoull(content_length.c_str(), nullptr, 10));
+
+		if(buffer.size() < end + length){
+			return false;
+		}
+
+		response.body = buffer.substr(end, length);
+		end += length;
+	}
+	else if(response.status != 204 && response.status != 304 && response.status >= 200){
+
+		// the body is delimited by the end of the connection
+		if(!at_eof){
+			return false;
+		}
+
+		response.body = buffer.substr(end);
+		end = buffer.size();
+	}
+
+	consumed = end;
+	return true;
+}
+
+void
+HTTPConnection::write_request(const std::string& method,
+                              const std::string& target,
+							  const std::string& body,
+							  bool keep_alive,
+							  const http_header_fields& headers){
+
+	connect();
+	write_all_(http_format_request(endpoint_, method, target, body, keep_alive, headers));
+}
+
+HTTPResponse
+HTTPConnection::read_response(){
+
+	if(!is_open()){
+		throw std::runtime_error("Connection to " + endpoint_.authority() + " is not open");
+	}
+
+	HTTPResponse response;
+	std::size_t consumed = 0;
+	bool at_eof = false;
+
+	try{
+
+		while(!http_parse_response(buffer_, response, consumed, at_eof)){
+
+			if(at_eof){
+
+				const bool partial = !buffer_.empty();
+				close();
+
+				if(partial){
+					throw std::runtime_error("Connection closed by " + endpoint_.authority() + " while reading response");
+				}
+
+				throw HTTPConnectionClosed("Connection closed by " + endpoint_.authority());
+			}
+
+			at_eof = !fill_();
+		}
+	}
+	catch(...){
+		close();
+		throw;
+	}
+
+	buffer_.erase(0, consumed);
+	n_bytes_received_ += consumed;
+
+	if(at_eof || to_lower(response.header("connection")) == "close"){
+		close();
+	}
+
+	n_requests_ += 1;
+	return response;
+}
+
+HTTPResponse
+HTTPConnection::request(const std::string& method,
+                        const std::string& target,
+						const std::string& body,
+						bool keep_alive,
+						const http_header_fields& headers){
+
+	write_request(method, target, body, keep_alive, headers);
+	auto response = read_response();
+
+	if(!keep_alive){
+		close();
+	}
+
+	return response;
+}
+
+HTTPConnectionPool::HTTPConnectionPool(const std::string& url,
+                                       bool keep_alive,
+									   uint_t max_idle_connections)
+:
+url_(url),
+endpoint_(),
+url_error_(),
+keep_alive_(keep_alive),
+max_idle_connections_(max_idle_connections),
+n_opened_(0),
+mutex_(),
+idle_(),
+event_loop_()
+{
+	try{
+		endpoint_ = HTTPEndpoint::parse(url_);
+	}
+	catch(const std::logic_error& e){
+		url_error_ = e.what();
+	}
+}
+
+HTTPConnectionPool::~HTTPConnectionPool()
+{}
+
+std::string
+HTTPConnectionPool::target(const std::string& url)const{
+
+	if(url.compare(0, url_.size(), url_) == 0){
+		return endpoint_.path + url.substr(url_.size());
+	}
+
+	return HTTPEndpoint::parse(url).path;
+}
+
+std::pair<std::unique_ptr<HTTPConnection>, bool>
+HTTPConnectionPool::acquire(){
+
+	if(!url_error_.empty()){
+		throw std::logic_error(url_error_);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		while(keep_alive_ && !idle_.empty()){
+
+			auto connection = std::move(idle_.back());
+			idle_.pop_back();
+
+			if(!connection -> is_stale()){
+				return {std::move(connection), true};
+			}
+		}
+
+		n_opened_ += 1;
+	}
+
+	auto connection = std::make_unique<HTTPConnection>(endpoint_);
+	connection -> connect();
+	return {std::move(connection), false};
+}
+
+HTTPEventLoop&
+HTTPConnectionPool::event_loop(){
+
+	if(!url_error_.empty()){
+		throw std::logic_error(url_error_);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if(!event_loop_){
+		event_loop_ = std::make_unique<HTTPEventLoop>(endpoint_);
+	}
+
+	return *event_loop_;
+}
+
+void
+HTTPConnectionPool::async_request(const std::string& method,
+                                  const std::string& url,
+								  const std::string& body,
+								  const http_header_fields& headers,
+								  http_response_handler handler){
+
+	event_loop().submit(method, target(url), body, headers, std::move(handler));
+}
+
+void
+HTTPConnectionPool::release(std::unique_ptr<HTTPConnection> connection){
+
+	if(!connection || !keep_alive_ || !connection -> is_open()){
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(idle_.size() < max_idle_connections_){
+		idle_.push_back(std::move(connection));
+	}
+}
+
+void
+HTTPConnectionPool::clear(){
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	idle_.clear();
+}
+
+uint_t
+HTTPConnectionPool::n_idle_connections()const{
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return idle_.size();
+}
+
+uint_t
+HTTPConnectionPool::n_opened_connections()const{
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return n_opened_;
+}
+
+HTTPResponse
+HTTPConnectionPool::request(const std::string& method,
+                            const std::string& url,
+							const std::string& body,
+							const http_header_fields& headers,
+							HTTPRequestTiming* timing){
+
+	typedef std::chrono::steady_clock clock_type;
+
+	const auto request_target = target(url);
+
+	// time one attempt of the request on the given connection
+	auto send = [&](HTTPConnection& connection, clock_type::time_point start){
+
+		const auto sent = connection.n_bytes_sent();
+		const auto received = connection.n_bytes_received();
+		const auto connected = clock_type::now();
+
+		try{
+
+			connection.write_request(method, request_target, body, keep_alive_, headers);
+			const auto written = clock_type::now();
+			auto response = connection.read_response();
+
+			if(!keep_alive_){
+				connection.close();
+			}
+
+			if(timing){
+				timing -> connect += connected - start;
+				timing -> send += written - connected;
+				timing -> wait += clock_type::now() - written;
+				timing -> bytes_sent += connection.n_bytes_sent() - sent;
+				timing -> bytes_received += connection.n_bytes_received() - received;
+			}
+
+			return response;
+		}
+		catch(...){
+
+			if(timing){
+				timing -> connect += connected - start;
+				timing -> wait += clock_type::now() - connected;
+				timing -> bytes_sent += connection.n_bytes_sent() - sent;
+			}
+
+			throw;
+		}
+	};
+
+	auto start = clock_type::now();
+	auto [connection, reused] = acquire();
+
+	try{
+		auto response = send(*connection, start);
+		release(std::move(connection));
+		return response;
+	}
+	catch(const HTTPConnectionClosed& e){
+
+		// the server closed a reused connection without answering. It
+		// may have done so after processing the request, so only a
+		// request that can safely run twice is sent again
+		if(!reused || !(http_is_idempotent_method(method) || retry_non_idempotent_)){
+			throw;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		n_opened_ += 1;
+	}
+
+	start = clock_type::now();
+	connection = std::make_unique<HTTPConnection>(endpoint_);
+	connection -> connect();
+
+	auto response = send(*connection, start);
+	release(std::move(connection));
+	return response;
+}
+
+std::vector<HTTPResponse>
+HTTPConnectionPool::request_sequence(const std::string& method,
+                                     const std::string& url,
+									 const std::vector<std::string>& bodies,
+									 const http_header_fields& headers,
+									 uint_t max_in_flight,
+									 std::vector<HTTPRequestTiming>* timings){
+
+	typedef std::chrono::steady_clock clock_type;
+
+	const auto request_target = target(url);
+	const auto window = max_in_flight == 0 ? 1 : max_in_flight;
+
+	std::vector<HTTPResponse> responses;
+	responses.reserve(bodies.size());
+
+	if(timings){
+		timings -> assign(bodies.size(), HTTPRequestTiming());
+	}
+
+	if(bodies.empty()){
+		return responses;
+	}
+
+	// the time a request finished writing and the time spent opening
+	// the connection, which is charged to the next request written
+	std::vector<clock_type::time_point> written_at(timings ? bodies.size() : 0);
+	auto start = clock_type::now();
+	auto [connection, reused] = acquire();
+	auto connect_time = clock_type::now() - start;
+
+	// true once the current connection is known to work. A connection
+	// that fails before that is not retried
+	bool answered = reused;
+
+	// the requests from responses.size() up to n_written
+	// are in flight on the current connection
+	uint_t n_written = 0;
+
+	// requests in flight on a closed connection may have been
+	// processed. Only those that can safely run twice are resent
+	const bool resend = http_is_idempotent_method(method) || retry_non_idempotent_;
+
+	auto reconnect = [&](){
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			n_opened_ += 1;
+		}
+
+		const auto reconnect_start = clock_type::now();
+		connection = std::make_unique<HTTPConnection>(endpoint_);
+		connection -> connect();
+		connect_time += clock_type::now() - reconnect_start;
+		n_written = responses.size();
+		answered = false;
+	};
+
+	auto interrupted = [&](){
+
+		return HTTPSequenceInterrupted("Connection closed by " + endpoint_.authority() +
+		                               " after " + std::to_string(responses.size()) +
+									   " of " + std::to_string(bodies.size()) + " responses",
+									   responses.size());
+	};
+
+	while(responses.size() < bodies.size()){
+
+		// nothing is in flight. Replace a connection
+		// the server closed before writing to it
+		if(n_written == responses.size() && answered && connection -> is_stale()){
+			reconnect();
+		}
+
+		try{
+
+			while(n_written < bodies.size() && n_written - responses.size() < window){
+
+				if(!timings){
+					connection -> write_request(method, request_target, bodies[n_written], true, headers);
+					n_written += 1;
+					continue;
+				}
+
+				auto& timing = (*timings)[n_written];
+				const auto sent = connection -> n_bytes_sent();
+				const auto write_start = clock_type::now();
+
+				timing.connect += std::chrono::duration_cast<std::chrono::nanoseconds>(connect_time);
+				connect_time = clock_type::duration::zero();
+
+				connection -> write_request(method, request_target, bodies[n_written], true, headers);
+
+				written_at[n_written] = clock_type::now();
+				timing.send += written_at[n_written] - write_start;
+				timing.bytes_sent += connection -> n_bytes_sent() - sent;
+				n_written += 1;
+			}
+
+			const auto received = connection -> n_bytes_received();
+			responses.push_back(connection -> read_response());
+			answered = true;
+
+			if(timings){
+
+				const auto idx = responses.size() - 1;
+				(*timings)[idx].wait += clock_type::now() - written_at[idx];
+				(*timings)[idx].bytes_received += connection -> n_bytes_received() - received;
+			}
+		}
+		catch(const HTTPConnectionClosed& e){
+
+			if(!answered){
+				throw;
+			}
+
+			if(n_written > responses.size() && !resend){
+				throw interrupted();
+			}
+
+			reconnect();
+			continue;
+		}
+
+		if(!connection -> is_open() && responses.size() < bodies.size()){
+
+			if(n_written > responses.size() && !resend){
+				throw interrupted();
+			}
+
+			reconnect();
+		}
+	}
+
+	release(std::move(connection));
+	return responses;
+}
+
+}
+}
@@ -0,0 +1,550 @@
+#ifndef HTTP_CONNECTION_H
+#define HTTP_CONNECTION_H
+
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <atomic>
+
+namespace rlenvscpp{
+namespace envs{
+
+struct HTTPResponse;
+class HTTPEventLoop;
+
+///
+/// \brief Callback invoked with the response of an asynchronous request.
+/// If the request failed the response is empty and the exception
+/// pointer is set. The callback runs on the event loop thread and
+/// should not block
+///
+typedef std::function<void(HTTPResponse&&, std::exception_ptr)> http_response_handler;
+
+///
+/// \brief Header fields of an HTTP message. Names of the
+/// fields read from a response are lower case
+///
+typedef std::vector<std::pair<std::string, std::string> > http_header_fields;
+
+///
+/// \brief The parts of a URL that an HTTPConnection needs
+///
+struct HTTPEndpoint
+{
+	///
+	/// \brief The host to connect to
+	///
+	std::string host;
+
+	///
+	/// \brief The port to connect to
+	///
+	std::string port{"80"};
+
+	///
+	/// \brief The path part of the URL. Empty if the
+	/// URL has no path
+	///
+	std::string path;
+
+	///
+	/// \brief The path of the Unix domain socket to connect to.
+	/// Empty for TCP endpoints
+	///
+	std::string socket_path;
+
+	///
+	/// \brief Parse the given URL. The http scheme and the unix
+	/// scheme are supported. A unix URL has the form
+	/// unix:///path/to.sock[:/api/path] and connects to the server
+	/// listening on the given Unix domain socket.
+	/// Throws std::logic_error for any other scheme
+	///
+	static HTTPEndpoint parse(const std::string& url);
+
+	///
+	/// \brief Returns true if the endpoint is a Unix domain socket
+	///
+	bool is_unix()const noexcept{return !socket_path.empty();}
+
+	///
+	/// \brief Returns host:port or unix:socket_path
+	///
+	std::string authority()const{return is_unix() ? "unix:" + socket_path : host + ":" + port;}
+};
+
+///
+/// \brief A parsed HTTP response
+///
+struct HTTPResponse
+{
+	///
+	/// \brief The status code of the response
+	///
+	int status{0};
+
+	///
+	/// \brief The header fields of the response
+	///
+	http_header_fields headers;
+
+	///
+	/// \brief The body of the response
+	///
+	std::string body;
+
+	///
+	/// \brief Returns the value of the header field with the given
+	/// (lower case) name or an empty string
+	///
+	std::string header(const std::string& name)const;
+};
+
+///
+/// \brief Format an HTTP/1.1 request. A JSON content type
+/// is assumed for a non empty body unless headers set one
+///
+std::string http_format_request(const HTTPEndpoint& endpoint,
+                                const std::string& method,
+								const std::string& target,
+								const std::string& body,
+								bool keep_alive=true,
+								const http_header_fields& headers=http_header_fields());
+
+///
+/// \brief Returns true if the method is idempotent, i.e. sending the
+/// request twice has the same effect as sending it once. Only requests
+/// with such a method are resent after the server closed the connection
+///
+bool http_is_idempotent_method(const std::string& method);
+
+///
+/// \brief Returns true if the peer closed the given socket or sent
+/// bytes that no request asked for. Does not block
+///
+bool http_socket_closed(int fd)noexcept;
+
+///
+/// \brief Create a stream socket connected to the Unix domain socket
+/// at socket_path. A non blocking socket may return while the connection
+/// is still in progress. Returns -1 and sets errno on failure
+///
+int http_connect_unix_socket(const std::string& socket_path, bool non_blocking=false);
+
+///
+/// \brief Parse the response at the front of the given buffer. Returns
+/// false if the buffer does not hold a complete response yet. Otherwise
+/// fills in the response and sets consumed to the number of bytes it
+/// occupies. at_eof signals that no more bytes will arrive; it completes
+/// responses whose body is delimited by the end of the connection.
+/// Throws std::runtime_error if the buffer does not hold an HTTP response
+///
+bool http_parse_response(const std::string& buffer,
+                         HTTPResponse& response,
+						 std::size_t& consumed,
+						 bool at_eof=false);
+
+///
+/// \brief The time spent in the phases of an HTTP request
+/// and the number of bytes transferred
+///
+struct HTTPRequestTiming
+{
+	///
+	/// \brief Time to check out or open the connection
+	///
+	std::chrono::nanoseconds connect{0};
+
+	///
+	/// \brief Time to write the request
+	///
+	std::chrono::nanoseconds send{0};
+
+	///
+	/// \brief Time from the end of the request until the
+	/// response has been read
+	///
+	std::chrono::nanoseconds wait{0};
+
+	///
+	/// \brief Bytes written, including the request line and headers
+	///
+	uint_t bytes_sent{0};
+
+	///
+	/// \brief Bytes read, including the status line and headers
+	///
+	uint_t bytes_received{0};
+
+	///
+	/// \brief The total time of the request
+	///
+	std::chrono::nanoseconds total()const noexcept{return connect + send + wait;}
+};
+
+///
+/// \brief Exception thrown when the remote peer closed the connection
+/// before any byte of the response was received. The server may or may
+/// not have processed the request, so only an idempotent request can
+/// safely be resent
+///
+class HTTPConnectionClosed: public std::runtime_error
+{
+public:
+	explicit HTTPConnectionClosed(const std::string& what)
+	:
+	std::runtime_error(what)
+	{}
+};
+
+///
+/// \brief Exception thrown when the connection of a request sequence
+/// is closed while requests are in flight. The first n_confirmed requests
+/// were answered. The others may or may not have been processed
+///
+class HTTPSequenceInterrupted: public HTTPConnectionClosed
+{
+public:
+	HTTPSequenceInterrupted(const std::string& what, uint_t n_confirmed)
+	:
+	HTTPConnectionClosed(what),
+	n_confirmed_(n_confirmed)
+	{}
+
+	///
+	/// \brief The number of requests that received a response
+	///
+	uint_t n_confirmed()const noexcept{return n_confirmed_;}
+
+private:
+
+	uint_t n_confirmed_;
+};
+
+///
+/// \brief A single HTTP/1.1 connection. Unlike http::Request the
+/// socket stays open after a response has been read so that
+/// the same connection can serve any number of requests. Responses
+/// are read strictly by Content-Length or chunked encoding so
+/// bytes belonging to a following response are kept for the next read
+///
+class HTTPConnection
+{
+public:
+
+	///
+	/// \brief Constructor. Does not connect
+	///
+	explicit HTTPConnection(const HTTPEndpoint& endpoint);
+
+	///
+	/// \brief Destructor. Closes the socket
+	///
+	~HTTPConnection();
+
+	HTTPConnection(const HTTPConnection&)=delete;
+	HTTPConnection& operator=(const HTTPConnection&)=delete;
+
+	///
+	/// \brief Open the socket. Throws std::runtime_error
+	/// if the remote server cannot be reached
+	///
+	void connect();
+
+	///
+	/// \brief Close the socket
+	///
+	void close()noexcept;
+
+	///
+	/// \brief Returns true if the socket is open
+	///
+	bool is_open()const noexcept{return fd_ != -1;}
+
+	///
+	/// \brief Returns true if the socket is closed or the server
+	/// closed its side of it. Used to drop idle connections
+	/// before a request is written to them
+	///
+	bool is_stale()const noexcept;
+
+	///
+	/// \brief Write a request to the socket without
+	/// waiting for the response. Connects if needed
+	///
+	void write_request(const std::string& method,
+	                   const std::string& target,
+					   const std::string& body,
+					   bool keep_alive=true,
+					   const http_header_fields& headers=http_header_fields());
+
+	///
+	/// \brief Read exactly one response from the socket
+	///
+	HTTPResponse read_response();
+
+	///
+	/// \brief Send a request and wait for its response
+	///
+	HTTPResponse request(const std::string& method,
+	                     const std::string& target,
+						 const std::string& body,
+						 bool keep_alive=true,
+						 const http_header_fields& headers=http_header_fields());
+
+	///
+	/// \brief The number of requests served by this connection
+	///
+	uint_t n_requests()const noexcept{return n_requests_;}
+
+	///
+	/// \brief The number of bytes written to the socket
+	///
+	uint_t n_bytes_sent()const noexcept{return n_bytes_sent_;}
+
+	///
+	/// \brief The number of bytes of the responses read
+	///
+	uint_t n_bytes_received()const noexcept{return n_bytes_received_;}
+
+private:
+
+	///
+	/// \brief The remote endpoint
+	///
+	const HTTPEndpoint endpoint_;
+
+	///
+	/// \brief The socket descriptor
+	///
+	int fd_{-1};
+
+	///
+	/// \brief The number of responses read
+	///
+	uint_t n_requests_{0};
+
+	///
+	/// \brief Bytes written so far
+	///
+	uint_t n_bytes_sent_{0};
+
+	///
+	/// \brief Bytes of the responses read so far
+	///
+	uint_t n_bytes_received_{0};
+
+	///
+	/// \brief Bytes read from the socket but not consumed yet
+	///
+	std::string buffer_;
+
+	///
+	/// \brief Read more bytes into the buffer. Returns
+	/// false if the peer closed the connection
+	///
+	bool fill_();
+
+	///
+	/// \brief Write all the given bytes
+	///
+	void write_all_(const std::string& data);
+};
+
+///
+/// \brief Thread-safe pool of persistent connections to a single
+/// server. Connections are checked out for the duration of a request and
+/// returned afterwards, so concurrent callers never share a socket.
+/// When keep_alive is false every request uses a fresh connection that is
+/// closed after the response; this is the behaviour of http::Request
+///
+class HTTPConnectionPool
+{
+public:
+
+	///
+	/// \brief Constructor. The url is the root of the server
+	/// e.g. http://0.0.0.0:8001/api. An invalid url is
+	/// reported when the first connection is requested
+	///
+	explicit HTTPConnectionPool(const std::string& url,
+	                            bool keep_alive=true,
+								uint_t max_idle_connections=64);
+
+	///
+	/// \brief Destructor. Stops the event loop if one was started
+	///
+	~HTTPConnectionPool();
+
+	///
+	/// \brief Send the request to the given url and wait for the response.
+	/// The url must be served by the endpoint of the pool. Idle connections
+	/// the server has already closed are dropped before the request is
+	/// written. If a reused connection is closed without a response the
+	/// request is resent once on a new connection, but only for idempotent
+	/// methods or when set_retry_non_idempotent(true) was called. Otherwise
+	/// HTTPConnectionClosed is thrown since the server may have processed
+	/// the request. If timing is given it receives the time spent in each
+	/// phase, summed over both attempts
+	///
+	HTTPResponse request(const std::string& method,
+	                     const std::string& url,
+						 const std::string& body="",
+						 const http_header_fields& headers=http_header_fields(),
+						 HTTPRequestTiming* timing=nullptr);
+
+	///
+	/// \brief Send one request per body to the given url over a single
+	/// keep-alive connection without waiting for the responses in between.
+	/// Up to max_in_flight requests are written ahead of the responses,
+	/// which are returned in the order of the bodies. If the server closes
+	/// the connection while requests are in flight they are resent on a new
+	/// connection only for idempotent methods or when non idempotent retries
+	/// are allowed. Otherwise HTTPSequenceInterrupted is thrown with the
+	/// number of answered requests. If timings is given it receives the
+	/// timing of every request. The wait of a request starts once it is written
+	///
+	std::vector<HTTPResponse> request_sequence(const std::string& method,
+	                                           const std::string& url,
+											   const std::vector<std::string>& bodies,
+											   const http_header_fields& headers=http_header_fields(),
+											   uint_t max_in_flight=32,
+											   std::vector<HTTPRequestTiming>* timings=nullptr);
+
+	///
+	/// \brief Send the request to the given url without blocking. The
+	/// handler is called from the event loop thread with the response.
+	/// Asynchronous requests always use keep-alive connections that
+	/// are separate from the ones used by request()
+	///
+	void async_request(const std::string& method,
+	                   const std::string& url,
+					   const std::string& body,
+					   const http_header_fields& headers,
+					   http_response_handler handler);
+
+	///
+	/// \brief Returns the event loop serving the asynchronous
+	/// requests. The loop is started on first use
+	///
+	HTTPEventLoop& event_loop();
+
+	///
+	/// \brief Check out a connection. The second
+	/// member is true if the connection was reused
+	///
+	std::pair<std::unique_ptr<HTTPConnection>, bool> acquire();
+
+	///
+	/// \brief Return a connection to the pool. Closed connections
+	/// and connections in excess of the idle limit are dropped
+	///
+	void release(std::unique_ptr<HTTPConnection> connection);
+
+	///
+	/// \brief Close all the idle connections
+	///
+	void clear();
+
+	///
+	/// \brief Allow request() to resend a non idempotent request, e.g.
+	/// POST /step, when a reused connection is closed before the response
+	/// arrives. The server may then execute the request twice
+	///
+	void set_retry_non_idempotent(bool flag)noexcept{retry_non_idempotent_ = flag;}
+
+	///
+	/// \brief Returns true if request() resends non idempotent requests
+	///
+	bool retry_non_idempotent()const noexcept{return retry_non_idempotent_;}
+
+	///
+	/// \brief Returns true if connections are kept alive
+	///
+	bool keep_alive()const noexcept{return keep_alive_;}
+
+	///
+	/// \brief The number of idle connections
+	///
+	uint_t n_idle_connections()const;
+
+	///
+	/// \brief The number of connections opened so far
+	///
+	uint_t n_opened_connections()const;
+
+	///
+	/// \brief The endpoint of the pool
+	///
+	const HTTPEndpoint& endpoint()const noexcept{return endpoint_;}
+
+	///
+	/// \brief Returns the request target for the given url
+	///
+	std::string target(const std::string& url)const;
+
+private:
+
+	///
+	/// \brief The url of the server
+	///
+	const std::string url_;
+
+	///
+	/// \brief The endpoint url_ points to
+	///
+	HTTPEndpoint endpoint_;
+
+	///
+	/// \brief The error raised when parsing url_. Empty if url_ is valid
+	///
+	std::string url_error_;
+
+	///
+	/// \brief Flag indicating if connections are reused
+	///
+	const bool keep_alive_;
+
+	///
+	/// \brief Maximum number of idle connections to keep
+	///
+	const uint_t max_idle_connections_;
+
+	///
+	/// \brief Number of connections opened
+	///
+	uint_t n_opened_{0};
+
+	///
+	/// \brief Flag indicating if non idempotent requests are resent
+	///
+	std::atomic<bool> retry_non_idempotent_{false};
+
+	///
+	/// \brief Mutex guarding the idle connections
+	///
+	mutable std::mutex mutex_;
+
+	///
+	/// \brief The idle connections
+	///
+	std::vector<std::unique_ptr<HTTPConnection> > idle_;
+
+	///
+	/// \brief The event loop for asynchronous requests
+	///
+	std::unique_ptr<HTTPEventLoop> event_loop_;
+};
+
+}
+}
+
+#endif // HTTP_CONNECTION_H
@@ -0,0 +1,486 @@
+#include "rlenvs/envs/api_server/http_event_loop.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace rlenvscpp{
+namespace envs{
+
+HTTPEventLoop::HTTPEventLoop(const HTTPEndpoint& endpoint,
+                             uint_t max_connections)
+:
+endpoint_(endpoint),
+max_connections_(max_connections == 0 ? 1 : max_connections)
+{
+	epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+	if(epoll_fd_ == -1){
+		throw std::runtime_error(std::string("Failed to create epoll instance: ") + std::strerror(errno));
+	}
+
+	wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(wake_fd_ == -1){
+		::close(epoll_fd_);
+		throw std::runtime_error(std::string("Failed to create eventfd: ") + std::strerror(errno));
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = wake_fd_;
+	::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+	thread_ = std::thread([this](){run_();});
+}
+
+HTTPEventLoop::~HTTPEventLoop(){
+
+	stop_ = true;
+
+	const std::uint64_t value = 1;
+	[[maybe_unused]] auto n = ::write(wake_fd_, &value, sizeof(value));
+
+	if(thread_.joinable()){
+		thread_.join();
+	}
+
+	::close(wake_fd_);
+	::close(epoll_fd_);
+}
+
+void
+HTTPEventLoop::submit(const std::string& method,
+                      const std::string& target,
+					  const std::string& body,
+					  const http_header_fields& headers,
+					  http_response_handler handler){
+
+	Request request;
+	request.data = http_format_request(endpoint_, method, target, body, true, headers);
+	request.handler = std::move(handler);
+	request.idempotent = http_is_idempotent_method(method);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		submitted_.push_back(std::move(request));
+	}
+
+	n_pending_ += 1;
+
+	const std::uint64_t value = 1;
+	[[maybe_unused]] auto n = ::write(wake_fd_, &value, sizeof(value));
+}
+
+void
+HTTPEventLoop::complete_(Request& request, HTTPResponse&& response, std::exception_ptr error){
+
+	n_pending_ -= 1;
+
+	try{
+		request.handler(std::move(response), error);
+	}
+	catch(...){
+		// handlers should not throw. There
+		// is no one to report the error to
+	}
+}
+
+void
+HTTPEventLoop::watch_(const Connection& connection, bool for_write){
+
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLRDHUP | (for_write ? EPOLLOUT : 0);
+	event.data.fd = connection.fd;
+	::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+HTTPEventLoop::Connection*
+HTTPEventLoop::add_connection_(int fd){
+
+	auto connection = std::make_unique<Connection>();
+	connection -> fd = fd;
+
+	// writable once the connection is established
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+	event.data.fd = fd;
+	::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+
+	n_opened_ += 1;
+	auto ptr = connection.get();
+	connections_[fd] = std::move(connection);
+	return ptr;
+}
+
+HTTPEventLoop::Connection*
+HTTPEventLoop::open_(){
+
+	if(endpoint_.is_unix()){
+
+		const auto fd = http_connect_unix_socket(endpoint_.socket_path, true);
+		return fd == -1 ? nullptr : add_connection_(fd);
+	}
+
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo* info = nullptr;
+	if(::getaddrinfo(endpoint_.host.c_str(), endpoint_.port.c_str(), &hints, &info) != 0){
+		return nullptr;
+	}
+
+	std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> addresses(info, &::freeaddrinfo);
+
+	for(auto address = addresses.get(); address != nullptr; address = address -> ai_next){
+
+		const auto fd = ::socket(address -> ai_family,
+		                         address -> ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+								 address -> ai_protocol);
+
+		if(fd == -1){
+			continue;
+		}
+
+		if(::connect(fd, address -> ai_addr, address -> ai_addrlen) == -1 && errno != EINPROGRESS){
+			::close(fd);
+			continue;
+		}
+
+		int flag = 1;
+		::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+		return add_connection_(fd);
+	}
+
+	return nullptr;
+}
+
+void
+HTTPEventLoop::dispatch_(){
+
+	while(!waiting_.empty()){
+
+		Connection* connection = nullptr;
+
+		if(!idle_.empty()){
+
+			connection = idle_.back();
+			idle_.pop_back();
+
+			// the server closed the connection while it was idle
+			if(http_socket_closed(connection -> fd)){
+				fail_(*connection, "Connection closed by " + endpoint_.authority());
+				continue;
+			}
+		}
+		else if(connections_.size() < max_connections_){
+
+			connection = open_();
+
+			if(connection == nullptr){
+				auto request = std::move(waiting_.front());
+				waiting_.pop_front();
+				complete_(request, HTTPResponse(),
+				          std::make_exception_ptr(std::runtime_error("Failed to connect to " + endpoint_.authority())));
+				continue;
+			}
+		}
+		else{
+			// all connections are busy
+			return;
+		}
+
+		connection -> request = std::move(waiting_.front());
+		waiting_.pop_front();
+		connection -> busy = true;
+		connection -> written = 0;
+
+		if(connection -> connected){
+			write_(*connection);
+		}
+	}
+}
+
+void
+HTTPEventLoop::write_(Connection& connection){
+
+	const auto& data = connection.request.data;
+
+	while(connection.written < data.size()){
+
+		const auto n = ::send(connection.fd, data.data() + connection.written,
+		                      data.size() - connection.written, MSG_NOSIGNAL);
+
+		if(n > 0){
+			connection.written += static_cast<std::size_t>(n);
+			continue;
+		}
+
+		if(n == -1 && errno == EINTR){
+			continue;
+		}
+
+		if(n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+			watch_(connection, true);
+			return;
+		}
+
+		fail_(connection, std::string("Failed to write to " + endpoint_.authority() + ": ") + std::strerror(errno));
+		return;
+	}
+
+	watch_(connection, false);
+}
+
+void
+HTTPEventLoop::read_(Connection& connection){
+
+	char chunk[16384];
+	bool at_eof = false;
+
+	while(true){
+
+		const auto n = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+
+		if(n > 0){
+			connection.input.append(chunk, static_cast<std::size_t>(n));
+			continue;
+		}
+
+		if(n == 0){
+			at_eof = true;
+			break;
+		}
+
+		if(errno == EINTR){
+			continue;
+		}
+
+		if(errno == EAGAIN || errno == EWOULDBLOCK){
+			break;
+		}
+
+		if(errno == ECONNRESET){
+			at_eof = true;
+			break;
+		}
+
+		fail_(connection, std::string("Failed to read from " + endpoint_.authority() + ": ") + std::strerror(errno));
+		return;
+	}
+
+	if(!connection.busy){
+
+		// an idle connection closed by the server
+		if(at_eof){
+			fail_(connection, "Connection closed by " + endpoint_.authority());
+		}
+
+		return;
+	}
+
+	HTTPResponse response;
+	std::size_t consumed = 0;
+	bool complete = false;
+
+	try{
+		complete = http_parse_response(connection.input, response, consumed, at_eof);
+	}
+	catch(const std::exception& e){
+		fail_(connection, e.what());
+		return;
+	}
+
+	if(!complete){
+
+		if(at_eof){
+			fail_(connection, "Connection closed by " + endpoint_.authority());
+		}
+
+		return;
+	}
+
+	connection.input.erase(0, consumed);
+	connection.n_requests += 1;
+	connection.busy = false;
+
+	auto request = std::move(connection.request);
+	connection.request = Request();
+
+	std::string connection_header = response.header("connection");
+	std::transform(connection_header.begin(), connection_header.end(), connection_header.begin(),
+	               [](unsigned char c){return static_cast<char>(std::tolower(c));});
+
+	if(at_eof || connection_header == "close"){
+		fail_(connection, "Connection closed by " + endpoint_.authority());
+	}
+	else{
+		idle_.push_back(&connection);
+	}
+
+	complete_(request, std::move(response), nullptr);
+}
+
+void
+HTTPEventLoop::fail_(Connection& connection, const std::string& reason){
+
+	const auto fd = connection.fd;
+	const bool busy = connection.busy;
+
+	// a reused connection closed by the server before any byte of
+	// the response arrived. The server may still have processed the
+	// request, so only an idempotent request is sent again
+	const bool resend = busy && connection.n_requests > 0 &&
+	                    connection.input.empty() && connection.request.idempotent;
+	auto request = std::move(connection.request);
+
+	::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+	::close(fd);
+
+	idle_.erase(std::remove(idle_.begin(), idle_.end(), &connection), idle_.end());
+	connections_.erase(fd);
+
+	if(!busy){
+		return;
+	}
+
+	if(resend){
+		waiting_.push_front(std::move(request));
+		return;
+	}
+
+	complete_(request, HTTPResponse(), std::make_exception_ptr(std::runtime_error(reason)));
+}
+
+void
+HTTPEventLoop::run_(){
+
+	std::vector<epoll_event> events(64);
+
+	while(!stop_){
+
+		const auto n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+
+		if(n == -1){
+
+			if(errno == EINTR){
+				continue;
+			}
+
+			break;
+		}
+
+		for(int e=0; e<n; ++e){
+
+			const auto fd = events[e].data.fd;
+			const auto flags = events[e].events;
+
+			if(fd == wake_fd_){
+
+				std::uint64_t value = 0;
+				[[maybe_unused]] auto r = ::read(wake_fd_, &value, sizeof(value));
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				for(auto& request : submitted_){
+					waiting_.push_back(std::move(request));
+				}
+
+				submitted_.clear();
+				continue;
+			}
+
+			// the connection may have been closed while
+			// handling an earlier event of this batch
+			auto itr = connections_.find(fd);
+			if(itr == connections_.end()){
+				continue;
+			}
+
+			auto& connection = *itr -> second;
+
+			if(!connection.connected){
+
+				int error = 0;
+				socklen_t length = sizeof(error);
+				::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+
+				if(error != 0 || (flags & (EPOLLERR | EPOLLHUP))){
+					fail_(connection, "Failed to connect to " + endpoint_.authority() + ": " + std::strerror(error));
+					continue;
+				}
+
+				if(!(flags & EPOLLOUT)){
+					continue;
+				}
+
+				connection.connected = true;
+
+				if(connection.busy){
+					write_(connection);
+				}
+				else{
+					watch_(connection, false);
+				}
+
+				continue;
+			}
+
+			if(flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)){
+				read_(connection);
+				continue;
+			}
+
+			if((flags & EPOLLOUT) && connection.busy){
+				write_(connection);
+			}
+		}
+
+		dispatch_();
+	}
+
+	// fail whatever is still pending
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(auto& request : submitted_){
+			waiting_.push_back(std::move(request));
+		}
+
+		submitted_.clear();
+	}
+
+	const auto stopped = std::make_exception_ptr(std::runtime_error("HTTP event loop stopped"));
+
+	for(auto& [fd, connection] : connections_){
+
+		::close(fd);
+
+		if(connection -> busy){
+			complete_(connection -> request, HTTPResponse(), stopped);
+		}
+	}
+
+	connections_.clear();
+	idle_.clear();
+
+	for(auto& request : waiting_){
+		complete_(request, HTTPResponse(), stopped);
+	}
+
+	waiting_.clear();
+}
+
+}
+}
@@ -0,0 +1,214 @@
+#ifndef HTTP_EVENT_LOOP_H
+#define HTTP_EVENT_LOOP_H
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/api_server/http_connection.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief Event loop that drives non-blocking HTTP requests to a single
+/// server, over TCP or a Unix domain socket, from one background thread
+/// using epoll. Requests are submitted from any thread and spread over
+/// up to max_connections keep-alive
+/// connections; requests in excess wait until a connection becomes free.
+/// This allows a single thread to keep hundreds of requests in flight
+///
+class HTTPEventLoop
+{
+public:
+
+	///
+	/// \brief Constructor. Starts the event loop thread
+	///
+	explicit HTTPEventLoop(const HTTPEndpoint& endpoint,
+	                       uint_t max_connections=256);
+
+	///
+	/// \brief Destructor. Stops the event loop thread. Requests
+	/// still pending are failed with std::runtime_error
+	///
+	~HTTPEventLoop();
+
+	HTTPEventLoop(const HTTPEventLoop&)=delete;
+	HTTPEventLoop& operator=(const HTTPEventLoop&)=delete;
+
+	///
+	/// \brief Submit a request. The handler is called exactly
+	/// once when the response has been read or the request failed
+	///
+	void submit(const std::string& method,
+	            const std::string& target,
+				const std::string& body,
+				const http_header_fields& headers,
+				http_response_handler handler);
+
+	///
+	/// \brief The number of requests submitted but not completed
+	///
+	uint_t n_pending()const noexcept{return n_pending_;}
+
+	///
+	/// \brief The number of connections opened so far
+	///
+	uint_t n_opened_connections()const noexcept{return n_opened_;}
+
+	///
+	/// \brief The endpoint of the loop
+	///
+	const HTTPEndpoint& endpoint()const noexcept{return endpoint_;}
+
+private:
+
+	///
+	/// \brief A request waiting for or occupying a connection
+	///
+	struct Request
+	{
+		std::string data;
+		http_response_handler handler;
+		bool idempotent{false};
+	};
+
+	///
+	/// \brief State of a non-blocking connection
+	///
+	struct Connection
+	{
+		int fd{-1};
+		bool connected{false};
+		bool busy{false};
+		uint_t n_requests{0};
+		std::size_t written{0};
+		std::string input;
+		Request request;
+	};
+
+	///
+	/// \brief The remote endpoint
+	///
+	const HTTPEndpoint endpoint_;
+
+	///
+	/// \brief Maximum number of connections
+	///
+	const uint_t max_connections_;
+
+	///
+	/// \brief The epoll instance
+	///
+	int epoll_fd_{-1};
+
+	///
+	/// \brief eventfd used to wake up the loop
+	///
+	int wake_fd_{-1};
+
+	///
+	/// \brief Flag telling the loop to stop
+	///
+	std::atomic<bool> stop_{false};
+
+	///
+	/// \brief Number of pending requests
+	///
+	std::atomic<uint_t> n_pending_{0};
+
+	///
+	/// \brief Number of connections opened
+	///
+	std::atomic<uint_t> n_opened_{0};
+
+	///
+	/// \brief Guards submitted_
+	///
+	std::mutex mutex_;
+
+	///
+	/// \brief Requests submitted since the loop last woke up
+	///
+	std::vector<Request> submitted_;
+
+	///
+	/// \brief Requests waiting for a free connection. Loop thread only
+	///
+	std::deque<Request> waiting_;
+
+	///
+	/// \brief The open connections keyed by descriptor. Loop thread only
+	///
+	std::unordered_map<int, std::unique_ptr<Connection> > connections_;
+
+	///
+	/// \brief Connections without a request. Loop thread only
+	///
+	std::vector<Connection*> idle_;
+
+	///
+	/// \brief The event loop thread
+	///
+	std::thread thread_;
+
+	///
+	/// \brief The event loop
+	///
+	void run_();
+
+	///
+	/// \brief Assign waiting requests to connections
+	///
+	void dispatch_();
+
+	///
+	/// \brief Open a new non-blocking connection
+	///
+	Connection* open_();
+
+	///
+	/// \brief Register the connected or connecting socket fd
+	///
+	Connection* add_connection_(int fd);
+
+	///
+	/// \brief Write the pending request bytes of the connection
+	///
+	void write_(Connection& connection);
+
+	///
+	/// \brief Read from the connection and complete its request
+	/// if the whole response has arrived
+	///
+	void read_(Connection& connection);
+
+	///
+	/// \brief Close the connection and fail or resend its request
+	///
+	void fail_(Connection& connection, const std::string& reason);
+
+	///
+	/// \brief Change the events the connection is registered for
+	///
+	void watch_(const Connection& connection, bool for_write);
+
+	///
+	/// \brief Invoke the handler of a completed request
+	///
+	void complete_(Request& request, HTTPResponse&& response, std::exception_ptr error);
+};
+
+}
+}
+
+#endif // HTTP_EVENT_LOOP_H
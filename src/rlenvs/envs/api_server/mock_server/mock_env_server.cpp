@@ -0,0 +1,670 @@
+#include "rlenvs/envs/api_server/mock_server/mock_env_server.h"
+#include "rlenvs/envs/api_server/wire_format.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+const std::string HEADER_END = "\r\n\r\n";
+
+std::string
+to_lower(std::string str){
+	std::transform(str.begin(), str.end(), str.begin(),
+	               [](unsigned char c){return static_cast<char>(std::tolower(c));});
+	return str;
+}
+
+std::string
+reason_phrase(int status){
+
+	switch(status){
+		case 200: return "OK";
+		case 201: return "Created";
+		case 202: return "Accepted";
+		case 400: return "Bad Request";
+		case 404: return "Not Found";
+		default: return "Internal Server Error";
+	}
+}
+
+// the value of the given parameter in the query string or -1
+long
+query_value(const std::string& query, const std::string& name){
+
+	std::size_t start = 0;
+	while(start < query.size()){
+
+		auto end = query.find('&', start);
+		if(end == std::string::npos){
+			end = query.size();
+		}
+
+		const auto item = query.substr(start, end - start);
+		if(item.compare(0, name.size() + 1, name + "=") == 0){
+			return std::strtol(item.c_str() + name.size() + 1, nullptr, 10);
+		}
+
+		start = end + 1;
+	}
+
+	return -1;
+}
+
+// the observation as doubles. Returns false if it is not numeric
+bool
+observation_values(const nlohmann::json& observation, std::vector<real_t>& values){
+
+	if(observation.is_number()){
+		values.push_back(observation.get<real_t>());
+		return true;
+	}
+
+	if(!observation.is_array()){
+		return false;
+	}
+
+	for(const auto& value : observation){
+
+		if(!value.is_number()){
+			return false;
+		}
+
+		values.push_back(value.get<real_t>());
+	}
+
+	return true;
+}
+
+nlohmann::json
+message(const std::string& text){
+
+	nlohmann::json j;
+	j["message"] = text;
+	return j;
+}
+
+}
+
+nlohmann::json
+MockEnvModel::dynamics(uint_t /*sidx*/, uint_t /*aidx*/)const{
+	throw std::logic_error("The environment does not have dynamics");
+}
+
+bool
+MockEnvModel::is_valid_action(const nlohmann::json& /*action*/)const{
+	return true;
+}
+
+MockTimeStep
+MockCartPole::reset(uint_t seed, const nlohmann::json& /*options*/){
+
+	generator_.seed(seed);
+	std::uniform_real_distribution<real_t> distribution(-0.05, 0.05);
+
+	for(auto& value : state_){
+		value = distribution(generator_);
+	}
+
+	n_steps_ = 0;
+	done_ = false;
+	return MockTimeStep{TimeStepTp::FIRST, 0.0, 1.0, state_};
+}
+
+MockTimeStep
+MockCartPole::step(const nlohmann::json& action){
+
+	if(!is_valid_action(action)){
+		throw std::logic_error("Action " + action.dump() + " not in [0, 1]");
+	}
+
+	native::CartPole::integrate(state_, action.get<uint_t>());
+	n_steps_ += 1;
+
+	const bool terminated = native::CartPole::is_terminal(state_);
+
+	// like Gymnasium a step after termination earns no reward
+	const real_t reward = done_ ? 0.0 : 1.0;
+	done_ = done_ || terminated;
+
+	const auto type = terminated || n_steps_ >= MAX_EPISODE_STEPS ? TimeStepTp::LAST : TimeStepTp::MID;
+	return MockTimeStep{type, reward, 1.0, state_};
+}
+
+bool
+MockCartPole::is_valid_action(const nlohmann::json& action)const{
+	return action.is_number_integer() && (action.get<int>() == 0 || action.get<int>() == 1);
+}
+
+MockCannedEnv::MockCannedEnv(const nlohmann::json& observation,
+                             real_t reward,
+							 uint_t episode_length)
+:
+observation_(observation),
+reward_(reward),
+episode_length_(episode_length),
+n_steps_(0)
+{}
+
+MockTimeStep
+MockCannedEnv::reset(uint_t /*seed*/, const nlohmann::json& /*options*/){
+
+	n_steps_ = 0;
+	return MockTimeStep{TimeStepTp::FIRST, 0.0, 1.0, observation_};
+}
+
+MockTimeStep
+MockCannedEnv::step(const nlohmann::json& /*action*/){
+
+	n_steps_ += 1;
+	const auto type = n_steps_ >= episode_length_ ? TimeStepTp::LAST : TimeStepTp::MID;
+	return MockTimeStep{type, reward_, 1.0, observation_};
+}
+
+nlohmann::json
+MockCannedEnv::dynamics(uint_t sidx, uint_t /*aidx*/)const{
+
+	auto transitions = nlohmann::json::array();
+	transitions.push_back(nlohmann::json::array({1.0, sidx, reward_, false}));
+	return transitions;
+}
+
+MockEnvServer::MockEnvServer(const std::string& socket_path)
+:
+socket_path_(socket_path)
+{
+	if(!socket_path_.empty()){
+
+		sockaddr_un address{};
+		if(socket_path_.size() >= sizeof(address.sun_path)){
+			throw std::logic_error("Unix domain socket path " + socket_path_ + " is too long");
+		}
+
+		::unlink(socket_path_.c_str());
+		listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+		address.sun_family = AF_UNIX;
+		std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+
+		if(listen_fd_ == -1 ||
+		   ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+		   ::listen(listen_fd_, 128) == -1){
+
+			const auto error = errno;
+			if(listen_fd_ != -1){
+				::close(listen_fd_);
+			}
+			throw std::runtime_error("Failed to listen on " + socket_path_ + ": " + std::strerror(error));
+		}
+	}
+	else{
+
+		listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+
+		int flag = 1;
+		::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+
+		socklen_t length = sizeof(address);
+
+		if(listen_fd_ == -1 ||
+		   ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+		   ::listen(listen_fd_, 128) == -1 ||
+		   ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) == -1){
+
+			const auto error = errno;
+			if(listen_fd_ != -1){
+				::close(listen_fd_);
+			}
+			throw std::runtime_error(std::string("Failed to listen on 127.0.0.1: ") + std::strerror(error));
+		}
+
+		port_ = ::ntohs(address.sin_port);
+	}
+
+	add_env("/gymnasium/cart-pole-env", [](){return std::make_unique<MockCartPole>();});
+	add_env("/gymnasium/frozen-lake-env", [](){return std::make_unique<MockCannedEnv>(0, 0.0, 100);});
+	add_env("/gymnasium/taxi-env", [](){return std::make_unique<MockCannedEnv>(0, -1.0, 200);});
+	add_env("/gymnasium/cliff-walking-env", [](){return std::make_unique<MockCannedEnv>(36, -1.0, 100);});
+	add_env("/gymnasium/black-jack-env", [](){return std::make_unique<MockCannedEnv>(nlohmann::json::array({14, 10, 0}), 0.0, 3);});
+	add_env("/gymnasium/mountain-car-env", [](){return std::make_unique<MockCannedEnv>(nlohmann::json::array({-0.5, 0.0}), -1.0, 200);});
+	add_env("/gymnasium/acrobot-env", [](){return std::make_unique<MockCannedEnv>(nlohmann::json::array({1.0, 0.0, 1.0, 0.0, 0.0, 0.0}), -1.0, 500);});
+	add_env("/gymnasium/pendulum-env", [](){return std::make_unique<MockCannedEnv>(nlohmann::json::array({1.0, 0.0, 0.0}), -1.0, 200);});
+	add_env("/gdrl/gym-walk-env", [](){return std::make_unique<MockCannedEnv>(3, 0.0, 100);});
+
+	accept_thread_ = std::thread([this](){accept_();});
+}
+
+MockEnvServer::~MockEnvServer(){
+	stop();
+}
+
+std::string
+MockEnvServer::url()const{
+
+	if(!socket_path_.empty()){
+		return "unix://" + socket_path_ + ":/api";
+	}
+
+	return "http://127.0.0.1:" + std::to_string(port_) + "/api";
+}
+
+void
+MockEnvServer::add_env(const std::string& uri, model_factory_type factory){
+
+	std::lock_guard<std::mutex> lock(envs_mutex_);
+	envs_[uri] = EnvEntry{std::move(factory), {}};
+}
+
+void
+MockEnvServer::stop(){
+
+	if(stop_.exchange(true)){
+		return;
+	}
+
+	::shutdown(listen_fd_, SHUT_RDWR);
+	::close(listen_fd_);
+	accept_thread_.join();
+
+	// wake up the connection threads and wait until they are done
+	std::unique_lock<std::mutex> lock(connections_mutex_);
+	for(auto fd : connection_fds_){
+		::shutdown(fd, SHUT_RDWR);
+	}
+
+	connections_cv_.wait(lock, [this](){return connection_fds_.empty();});
+
+	if(!socket_path_.empty()){
+		::unlink(socket_path_.c_str());
+	}
+}
+
+void
+MockEnvServer::accept_(){
+
+	while(!stop_){
+
+		const auto fd = ::accept(listen_fd_, nullptr, nullptr);
+
+		if(fd == -1){
+
+			if(errno == EINTR || errno == ECONNABORTED){
+				continue;
+			}
+
+			break;
+		}
+
+		if(socket_path_.empty()){
+			int flag = 1;
+			::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+		}
+
+		n_connections_ += 1;
+
+		std::lock_guard<std::mutex> lock(connections_mutex_);
+		connection_fds_.push_back(fd);
+		std::thread([this, fd](){serve_connection_(fd);}).detach();
+	}
+}
+
+void
+MockEnvServer::serve_connection_(int fd){
+
+	std::string buffer;
+	char chunk[8192];
+
+	auto fill = [&](){
+
+		const auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+		if(n <= 0){
+			return false;
+		}
+
+		buffer.append(chunk, n);
+		return true;
+	};
+
+	while(!stop_){
+
+		const auto header_end = buffer.find(HEADER_END);
+		if(header_end == std::string::npos){
+
+			if(!fill()){
+				break;
+			}
+
+			continue;
+		}
+
+		// request line and header fields
+		const auto line_end = buffer.find("\r\n");
+		const auto request_line = buffer.substr(0, line_end);
+		const auto method_end = request_line.find(' ');
+		const auto target_end = request_line.find(' ', method_end + 1);
+
+		if(method_end == std::string::npos || target_end == std::string::npos){
+			break;
+		}
+
+		const auto method = request_line.substr(0, method_end);
+		const auto target = request_line.substr(method_end + 1, target_end - method_end - 1);
+
+		std::size_t content_length = 0;
+		std::string accept;
+		bool close_connection = false;
+
+		std::size_t start = line_end + 2;
+		while(start < header_end){
+
+			auto end = buffer.find("\r\n", start);
+			const auto field = buffer.substr(start, end - start);
+			start = end + 2;
+
+			const auto colon = field.find(':');
+			if(colon == std::string::npos){
+				continue;
+			}
+
+			const auto name = to_lower(field.substr(0, colon));
+			auto value = field.substr(colon + 1);
+			value.erase(0, value.find_first_not_of(" \t"));
+
+			if(name == "content-length"){
+				content_length = std::strtoul(value.c_str(), nullptr, 10);
+			}
+			else if(name == "accept"){
+				accept = value;
+			}
+			else if(name == "connection"){
+				close_connection = to_lower(value) == "close";
+			}
+		}
+
+		const auto request_size = header_end + HEADER_END.size() + content_length;
+		bool complete = true;
+
+		while(buffer.size() < request_size){
+			if(!fill()){
+				complete = false;
+				break;
+			}
+		}
+
+		if(!complete){
+			break;
+		}
+
+		const auto body = buffer.substr(header_end + HEADER_END.size(), content_length);
+		buffer.erase(0, request_size);
+
+		const auto reply = handle_(method, target, accept, body);
+		n_requests_ += 1;
+
+		std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " " + reason_phrase(reply.status) + "\r\n";
+		response += "Content-Type: " + reply.content_type + "\r\n";
+		response += "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+
+		if(close_connection){
+			response += "Connection: close\r\n";
+		}
+
+		response += "\r\n";
+		response += reply.body;
+
+		std::size_t sent = 0;
+		while(sent < response.size()){
+
+			const auto n = ::send(fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+			if(n <= 0){
+				break;
+			}
+
+			sent += static_cast<std::size_t>(n);
+		}
+
+		if(close_connection || sent < response.size()){
+			break;
+		}
+	}
+
+	// the last access to this server
+	std::lock_guard<std::mutex> lock(connections_mutex_);
+	connection_fds_.erase(std::find(connection_fds_.begin(), connection_fds_.end(), fd));
+	::close(fd);
+	connections_cv_.notify_all();
+}
+
+MockEnvServer::Reply
+MockEnvServer::time_step_reply_(const MockTimeStep& time_step, bool binary){
+
+	Reply reply;
+	reply.status = 202;
+
+	std::vector<real_t> values;
+	if(binary && observation_values(time_step.observation, values)){
+
+		reply.content_type = BINARY_TIME_STEP_MEDIA_TYPE;
+		reply.body = wire_format::encode_time_step(time_step.type, time_step.reward, time_step.discount,
+		                                           values.data(), values.size());
+		return reply;
+	}
+
+	nlohmann::json j;
+	j["time_step"]["step_type"] = static_cast<uint_t>(time_step.type);
+	j["time_step"]["reward"] = time_step.reward;
+	j["time_step"]["discount"] = time_step.discount;
+	j["time_step"]["observation"] = time_step.observation;
+	j["time_step"]["info"] = nlohmann::json::object();
+	reply.body = j.dump();
+	return reply;
+}
+
+MockEnvServer::Reply
+MockEnvServer::handle_(const std::string& method,
+                       const std::string& target,
+					   const std::string& accept,
+					   const std::string& body){
+
+	auto error = [](int status, const std::string& text){
+		return Reply{status, "application/json", message(text).dump()};
+	};
+
+	const auto query_start = target.find('?');
+	auto path = target.substr(0, query_start);
+	const auto query = query_start == std::string::npos ? std::string() : target.substr(query_start + 1);
+
+	const std::string prefix = "/api";
+	if(path.compare(0, prefix.size(), prefix) != 0){
+		return error(404, "Not Found");
+	}
+
+	path.erase(0, prefix.size());
+
+	std::lock_guard<std::mutex> lock(envs_mutex_);
+
+	// the environment with the longest uri that prefixes the path
+	auto env = envs_.end();
+	for(auto itr = envs_.begin(); itr != envs_.end(); ++itr){
+		if(path.compare(0, itr -> first.size(), itr -> first) == 0 &&
+		   (env == envs_.end() || itr -> first.size() > env -> first.size())){
+			env = itr;
+		}
+	}
+
+	if(env == envs_.end()){
+		return error(404, "Not Found");
+	}
+
+	const auto endpoint = path.substr(env -> first.size());
+	auto& copies = env -> second.copies;
+	const bool binary = accept.find(BINARY_TIME_STEP_MEDIA_TYPE) != std::string::npos;
+
+	auto find_copy = [&copies](long cidx)->MockEnvModel*{
+
+		if(cidx < 0){
+			return nullptr;
+		}
+
+		auto itr = copies.find(static_cast<uint_t>(cidx));
+		return itr == copies.end() ? nullptr : itr -> second.get();
+	};
+
+	try{
+
+		nlohmann::json request;
+		if(!body.empty()){
+			request = nlohmann::json::parse(body);
+		}
+
+		if(endpoint == "/is-alive" && method == "GET"){
+
+			const auto cidx = query_value(query, "cidx");
+			if(cidx < 0 || copies.find(static_cast<uint_t>(cidx)) == copies.end()){
+				return error(400, "Environment has not been created");
+			}
+
+			nlohmann::json j;
+			j["result"] = find_copy(cidx) != nullptr;
+			return Reply{200, "application/json", j.dump()};
+		}
+
+		if(endpoint == "/close" && method == "POST"){
+
+			const auto cidx = query_value(query, "cidx");
+			if(find_copy(cidx) == nullptr){
+				return error(400, "Environment has not been created");
+			}
+
+			copies[static_cast<uint_t>(cidx)].reset();
+			return Reply{202, "application/json", message("Environment is closed").dump()};
+		}
+
+		if(endpoint == "/make" && method == "POST"){
+
+			const auto cidx = request.at("cidx").get<uint_t>();
+			copies[cidx] = env -> second.factory();
+
+			nlohmann::json j;
+			j["result"] = true;
+			return Reply{201, "application/json", j.dump()};
+		}
+
+		if(endpoint == "/reset" && method == "POST"){
+
+			auto model = find_copy(request.at("cidx").get<long>());
+			if(model == nullptr){
+				return error(400, "Environment is not initialized. Have you called make()?");
+			}
+
+			const auto seed = request.value("seed", uint_t(42));
+			const auto options = request.value("options", nlohmann::json::object());
+			return time_step_reply_(model -> reset(seed, options), binary);
+		}
+
+		if(endpoint == "/step" && method == "POST"){
+
+			auto model = find_copy(request.at("cidx").get<long>());
+			if(model == nullptr){
+				return error(400, "Environment is not initialized. Have you called make()?");
+			}
+
+			return time_step_reply_(model -> step(request.at("action")), binary);
+		}
+
+		if(endpoint == "/step-batch" && method == "POST"){
+
+			const auto& actions = request.at("actions");
+
+			// validate the whole batch before any copy is stepped
+			// so that an invalid entry does not leave it half executed
+			std::vector<MockEnvModel*> models;
+			models.reserve(actions.size());
+
+			for(const auto& entry : actions){
+
+				auto model = find_copy(entry.at("cidx").get<long>());
+				if(model == nullptr){
+					return error(400, "Environment is not initialized. Have you called make()?");
+				}
+
+				if(!model -> is_valid_action(entry.at("action"))){
+					return error(400, "Action " + entry.at("action").dump() + " is not valid");
+				}
+
+				models.push_back(model);
+			}
+
+			auto time_steps = nlohmann::json::array();
+			for(uint_t i=0; i<actions.size(); ++i){
+
+				const auto& entry = actions[i];
+				auto model = models[i];
+				auto step = nlohmann::json::parse(time_step_reply_(model -> step(entry.at("action")), false).body);
+
+				nlohmann::json item;
+				item["cidx"] = entry.at("cidx");
+				item["time_step"] = step["time_step"];
+				time_steps.push_back(item);
+			}
+
+			nlohmann::json j;
+			j["time_steps"] = time_steps;
+			return Reply{202, "application/json", j.dump()};
+		}
+
+		if(endpoint == "/dynamics" && method == "GET"){
+
+			auto model = find_copy(query_value(query, "cidx"));
+			if(model == nullptr){
+				return error(400, "Environment is not initialized. Have you called make()?");
+			}
+
+			const auto sidx = query_value(query, "stateId");
+			const auto aidx = query_value(query, "actionId");
+
+			nlohmann::json j;
+			try{
+				j["dynamics"] = model -> dynamics(sidx < 0 ? 0 : sidx, aidx < 0 ? 0 : aidx);
+			}
+			catch(const std::logic_error& e){
+				return error(404, e.what());
+			}
+
+			return Reply{200, "application/json", j.dump()};
+		}
+
+		if(endpoint == "/sync" && method == "POST"){
+			return Reply{202, "application/json", message("OK").dump()};
+		}
+	}
+	catch(const std::exception& e){
+		return error(400, e.what());
+	}
+
+	return error(404, "Not Found");
+}
+
+}
+}
@@ -0,0 +1,259 @@
+#ifndef MOCK_ENV_SERVER_H
+#define MOCK_ENV_SERVER_H
+
+/**
+ * In-process stand-in for the Python environment server. It speaks
+ * the same HTTP/JSON contract as the FastAPI application for the
+ * endpoints /make, /reset, /step, /step-batch, /dynamics, /is-alive
+ * and /close, and answers with the binary time step encoding when the
+ * client asks for it. The environments are served by MockEnvModel
+ * instances: CartPole is simulated natively and every other environment
+ * known to RESTApiServerWrapper gets a canned model. This allows testing
+ * and benchmarking the client side without Python or network access.
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/extern/nlohmann/json/json.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+#include <functional>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief The time step a MockEnvModel returns. The observation
+/// is sent to the client as is
+///
+struct MockTimeStep
+{
+	TimeStepTp type{TimeStepTp::FIRST};
+	real_t reward{0.0};
+	real_t discount{1.0};
+	nlohmann::json observation;
+};
+
+///
+/// \brief The dynamics of one copy of an environment served by MockEnvServer
+///
+class MockEnvModel
+{
+public:
+
+	virtual ~MockEnvModel()=default;
+
+	///
+	/// \brief Reset the environment
+	///
+	virtual MockTimeStep reset(uint_t seed, const nlohmann::json& options)=0;
+
+	///
+	/// \brief Execute the action. Throws std::logic_error
+	/// if the action is not valid
+	///
+	virtual MockTimeStep step(const nlohmann::json& action)=0;
+
+	///
+	/// \brief Returns true if step accepts the action.
+	/// By default every action is accepted
+	///
+	virtual bool is_valid_action(const nlohmann::json& action)const;
+
+	///
+	/// \brief The transitions for the given state and action in
+	/// the form [[probability, next state, reward, done], ...].
+	/// Throws std::logic_error if the environment has no dynamics
+	///
+	virtual nlohmann::json dynamics(uint_t sidx, uint_t aidx)const;
+};
+
+///
+/// \brief Natively simulated CartPole-v1. Uses the dynamics
+/// of native::CartPole
+///
+class MockCartPole: public MockEnvModel
+{
+public:
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	static constexpr uint_t MAX_EPISODE_STEPS = 500;
+
+	virtual MockTimeStep reset(uint_t seed, const nlohmann::json& options)override;
+	virtual MockTimeStep step(const nlohmann::json& action)override;
+	virtual bool is_valid_action(const nlohmann::json& action)const override;
+
+private:
+
+	std::mt19937 generator_;
+	native::CartPole::raw_state_type state_{0.0, 0.0, 0.0, 0.0};
+	uint_t n_steps_{0};
+	bool done_{false};
+};
+
+///
+/// \brief Environment with fixed answers. Every step returns the same
+/// observation and reward and the episode ends after episode_length steps.
+/// The dynamics of any state and action are a certain transition
+/// to the same state
+///
+class MockCannedEnv: public MockEnvModel
+{
+public:
+
+	///
+	/// \brief Constructor
+	///
+	MockCannedEnv(const nlohmann::json& observation,
+	              real_t reward=1.0,
+				  uint_t episode_length=100);
+
+	virtual MockTimeStep reset(uint_t seed, const nlohmann::json& options)override;
+	virtual MockTimeStep step(const nlohmann::json& action)override;
+	virtual nlohmann::json dynamics(uint_t sidx, uint_t aidx)const override;
+
+private:
+
+	nlohmann::json observation_;
+	real_t reward_;
+	uint_t episode_length_;
+	uint_t n_steps_{0};
+};
+
+///
+/// \brief Multi-threaded HTTP/1.1 server on the loopback interface
+/// or on a Unix domain socket that serves MockEnvModel environments.
+/// Connections are kept alive unless the client asks otherwise. All
+/// requests are served under a single lock, like the Python server
+///
+class MockEnvServer
+{
+public:
+
+	///
+	/// \brief Creates the model of a new environment copy
+	///
+	typedef std::function<std::unique_ptr<MockEnvModel>()> model_factory_type;
+
+	///
+	/// \brief Constructor. Starts listening on an ephemeral port of
+	/// 127.0.0.1 or, if socket_path is not empty, on the Unix domain
+	/// socket at socket_path. Throws std::runtime_error on failure
+	///
+	explicit MockEnvServer(const std::string& socket_path="");
+
+	///
+	/// \brief Destructor. Stops the server
+	///
+	~MockEnvServer();
+
+	MockEnvServer(const MockEnvServer&)=delete;
+	MockEnvServer& operator=(const MockEnvServer&)=delete;
+
+	///
+	/// \brief The url to pass to RESTApiServerWrapper
+	///
+	std::string url()const;
+
+	///
+	/// \brief The TCP port. Zero for a Unix domain socket
+	///
+	uint_t port()const noexcept{return port_;}
+
+	///
+	/// \brief Serve the environment at uri, e.g. /gymnasium/cart-pole-env,
+	/// with models created by the given factory. Replaces any environment
+	/// with the same uri
+	///
+	void add_env(const std::string& uri, model_factory_type factory);
+
+	///
+	/// \brief Stop accepting connections and close the open ones
+	///
+	void stop();
+
+	///
+	/// \brief The number of requests served
+	///
+	uint_t n_requests()const noexcept{return n_requests_;}
+
+	///
+	/// \brief The number of connections accepted
+	///
+	uint_t n_connections()const noexcept{return n_connections_;}
+
+private:
+
+	///
+	/// \brief The environments served under one uri
+	///
+	struct EnvEntry
+	{
+		model_factory_type factory;
+		std::map<uint_t, std::unique_ptr<MockEnvModel> > copies;
+	};
+
+	///
+	/// \brief A response to send
+	///
+	struct Reply
+	{
+		int status{200};
+		std::string content_type{"application/json"};
+		std::string body;
+	};
+
+	std::string socket_path_;
+	uint_t port_{0};
+	int listen_fd_{-1};
+	std::atomic<bool> stop_{false};
+	std::atomic<uint_t> n_requests_{0};
+	std::atomic<uint_t> n_connections_{0};
+
+	///
+	/// \brief Guards the environments
+	///
+	std::mutex envs_mutex_;
+	std::map<std::string, EnvEntry> envs_;
+
+	///
+	/// \brief Guards the open connections. Every connection
+	/// is served by a detached thread that removes it when done
+	///
+	std::mutex connections_mutex_;
+	std::condition_variable connections_cv_;
+	std::vector<int> connection_fds_;
+	std::thread accept_thread_;
+
+	void accept_();
+	void serve_connection_(int fd);
+
+	///
+	/// \brief Handle one request
+	///
+	Reply handle_(const std::string& method,
+	              const std::string& target,
+				  const std::string& accept,
+				  const std::string& body);
+
+	///
+	/// \brief Encode the time step as JSON or binary
+	///
+	static Reply time_step_reply_(const MockTimeStep& time_step, bool binary);
+};
+
+}
+}
+
+#endif // MOCK_ENV_SERVER_H
@@ -0,0 +1,140 @@
+#include "rlenvs/envs/api_server/shard_router.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+// FNV-1a followed by the splitmix64 finalizer so that
+// similar keys land far apart on the ring
+std::uint64_t
+hash_key(const std::string& key){
+
+	std::uint64_t hash = 0xcbf29ce484222325ULL;
+	for(const unsigned char c : key){
+		hash ^= c;
+		hash *= 0x100000001b3ULL;
+	}
+
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebULL;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+}
+
+ShardRouter::ShardRouter(const std::vector<std::string>& urls,
+                         ShardPolicy policy)
+:
+urls_(urls),
+policy_(policy),
+ring_(),
+mutex_(),
+assignments_(),
+loads_(urls.size(), 0)
+{
+	if(urls_.empty()){
+		throw std::logic_error("At least one server url is needed");
+	}
+
+	ring_.reserve(urls_.size() * N_VIRTUAL_NODES);
+
+	for(uint_t s=0; s<urls_.size(); ++s){
+		for(uint_t v=0; v<N_VIRTUAL_NODES; ++v){
+			ring_.emplace_back(hash_key(urls_[s] + "#" + std::to_string(v)), s);
+		}
+	}
+
+	std::sort(ring_.begin(), ring_.end());
+}
+
+uint_t
+ShardRouter::hash_shard(const std::string& env_name, uint_t cidx)const noexcept{
+
+	if(urls_.size() == 1){
+		return 0;
+	}
+
+	const auto hash = hash_key(env_name + ":" + std::to_string(cidx));
+	auto itr = std::lower_bound(ring_.begin(), ring_.end(),
+	                            std::make_pair(hash, uint_t(0)));
+
+	// wrap around the ring
+	if(itr == ring_.end()){
+		itr = ring_.begin();
+	}
+
+	return itr -> second;
+}
+
+uint_t
+ShardRouter::shard(const std::string& env_name, uint_t cidx)const{
+
+	if(urls_.size() == 1){
+		return 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto itr = assignments_.find({env_name, cidx});
+
+		if(itr != assignments_.end()){
+			return itr -> second;
+		}
+	}
+
+	return hash_shard(env_name, cidx);
+}
+
+uint_t
+ShardRouter::assign(const std::string& env_name, uint_t cidx){
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto itr = assignments_.find({env_name, cidx});
+	if(itr != assignments_.end()){
+		return itr -> second;
+	}
+
+	uint_t shard = 0;
+	if(policy_ == ShardPolicy::LEAST_LOADED){
+		shard = std::min_element(loads_.begin(), loads_.end()) - loads_.begin();
+	}
+	else{
+		shard = hash_shard(env_name, cidx);
+	}
+
+	assignments_[{env_name, cidx}] = shard;
+	loads_[shard] += 1;
+	return shard;
+}
+
+void
+ShardRouter::release(const std::string& env_name, uint_t cidx){
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto itr = assignments_.find({env_name, cidx});
+	if(itr == assignments_.end()){
+		return;
+	}
+
+	loads_[itr -> second] -= 1;
+	assignments_.erase(itr);
+}
+
+uint_t
+ShardRouter::load(uint_t shard)const{
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return loads_.at(shard);
+}
+
+}
+}
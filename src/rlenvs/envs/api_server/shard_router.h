@@ -0,0 +1,128 @@
+#ifndef SHARD_ROUTER_H
+#define SHARD_ROUTER_H
+
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <mutex>
+#include <cstdint>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief How the copies of an environment are spread over the servers
+///
+enum class ShardPolicy: int {CONSISTENT_HASH=0, LEAST_LOADED=1};
+
+///
+/// \brief Maps every environment copy, identified by the environment
+/// name and its copy index, to one of several servers. With
+/// CONSISTENT_HASH the server follows from the key alone, so independent
+/// clients agree on it and adding a server moves only a fraction of the
+/// copies. With LEAST_LOADED a copy is placed on the server that holds
+/// the fewest copies when it is made. Thread-safe
+///
+class ShardRouter
+{
+public:
+
+	///
+	/// \brief The number of points every server has on the hash ring
+	///
+	static constexpr uint_t N_VIRTUAL_NODES = 64;
+
+	///
+	/// \brief Constructor. Throws std::logic_error if urls is empty
+	///
+	explicit ShardRouter(const std::vector<std::string>& urls,
+	                     ShardPolicy policy=ShardPolicy::CONSISTENT_HASH);
+
+	///
+	/// \brief The routing policy
+	///
+	ShardPolicy policy()const noexcept{return policy_;}
+
+	///
+	/// \brief The number of servers
+	///
+	uint_t n_shards()const noexcept{return urls_.size();}
+
+	///
+	/// \brief The url of the given server
+	///
+	const std::string& url(uint_t shard)const{return urls_.at(shard);}
+
+	///
+	/// \brief The urls of the servers
+	///
+	const std::vector<std::string>& urls()const noexcept{return urls_;}
+
+	///
+	/// \brief Returns the server that owns the given copy. A copy that
+	/// has not been assigned is routed by its hash
+	///
+	uint_t shard(const std::string& env_name, uint_t cidx)const;
+
+	///
+	/// \brief Place the given copy on a server according to the
+	/// policy and return it. A copy that is already assigned stays
+	/// on its server
+	///
+	uint_t assign(const std::string& env_name, uint_t cidx);
+
+	///
+	/// \brief Forget the server of the given copy
+	///
+	void release(const std::string& env_name, uint_t cidx);
+
+	///
+	/// \brief The number of copies assigned to the given server
+	///
+	uint_t load(uint_t shard)const;
+
+	///
+	/// \brief The server the hash ring maps the copy to
+	///
+	uint_t hash_shard(const std::string& env_name, uint_t cidx)const noexcept;
+
+private:
+
+	///
+	/// \brief The server urls
+	///
+	const std::vector<std::string> urls_;
+
+	///
+	/// \brief The routing policy
+	///
+	const ShardPolicy policy_;
+
+	///
+	/// \brief The points on the hash ring and their server, sorted
+	///
+	std::vector<std::pair<std::uint64_t, uint_t> > ring_;
+
+	///
+	/// \brief Mutex guarding the assignments
+	///
+	mutable std::mutex mutex_;
+
+	///
+	/// \brief The server of every assigned copy
+	///
+	std::map<std::pair<std::string, uint_t>, uint_t> assignments_;
+
+	///
+	/// \brief The number of copies assigned to every server
+	///
+	std::vector<uint_t> loads_;
+};
+
+}
+}
+
+#endif // SHARD_ROUTER_H
@@ -0,0 +1,235 @@
+#include "rlenvs/envs/api_server/shm_channel.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+// offsets of the header fields
+const uint_t MAGIC_OFFSET = 0;
+const uint_t VERSION_OFFSET = 4;
+const uint_t N_ENVS_OFFSET = 8;
+const uint_t OBS_SIZE_OFFSET = 12;
+const uint_t N_SLOTS_OFFSET = 16;
+const uint_t SLOT_SIZE_OFFSET = 20;
+const uint_t LAST_SEQ_OFFSET = 24;
+
+std::uint32_t
+read_u32(const void* data, uint_t offset){
+	std::uint32_t value = 0;
+	std::memcpy(&value, static_cast<const unsigned char*>(data) + offset, sizeof(value));
+	return value;
+}
+
+void
+write_u32(void* data, uint_t offset, std::uint32_t value){
+	std::memcpy(static_cast<unsigned char*>(data) + offset, &value, sizeof(value));
+}
+
+uint_t
+pad8(uint_t size){
+	return (size + 7) / 8 * 8;
+}
+
+}
+
+uint_t
+SharedMemoryChannel::slot_size(uint_t n_envs, uint_t obs_size)noexcept{
+	return sizeof(std::uint64_t) + pad8(n_envs) + (2 * n_envs + n_envs * obs_size) * sizeof(real_t);
+}
+
+std::shared_ptr<SharedMemoryChannel>
+SharedMemoryChannel::open(const std::string& name){
+
+	const auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+
+	if(fd == -1){
+		throw std::runtime_error("Failed to open shared memory " + name + ": " + std::strerror(errno));
+	}
+
+	std::shared_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel());
+	channel -> name_ = name;
+
+	try{
+		channel -> map_(fd, false);
+	}
+	catch(...){
+		::close(fd);
+		throw;
+	}
+
+	::close(fd);
+	return channel;
+}
+
+std::shared_ptr<SharedMemoryChannel>
+SharedMemoryChannel::create(const std::string& name,
+                            uint_t n_envs,
+							uint_t obs_size,
+							uint_t n_slots){
+
+	if(n_envs == 0 || n_slots == 0){
+		throw std::logic_error("A shared memory channel needs at least one environment and one slot");
+	}
+
+	const auto fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if(fd == -1){
+		throw std::runtime_error("Failed to create shared memory " + name + ": " + std::strerror(errno));
+	}
+
+	std::shared_ptr<SharedMemoryChannel> channel(new SharedMemoryChannel());
+	channel -> name_ = name;
+	channel -> owner_ = true;
+	channel -> n_envs_ = n_envs;
+	channel -> obs_size_ = obs_size;
+	channel -> n_slots_ = n_slots;
+	channel -> slot_size_ = slot_size(n_envs, obs_size);
+
+	const auto size = HEADER_SIZE + n_slots * channel -> slot_size_;
+
+	try{
+
+		if(::ftruncate(fd, static_cast<off_t>(size)) == -1){
+			throw std::runtime_error("Failed to size shared memory " + name + ": " + std::strerror(errno));
+		}
+
+		channel -> map_(fd, true);
+	}
+	catch(...){
+		::close(fd);
+		::shm_unlink(name.c_str());
+		throw;
+	}
+
+	::close(fd);
+	return channel;
+}
+
+SharedMemoryChannel::~SharedMemoryChannel(){
+
+	if(data_ != nullptr){
+		::munmap(data_, size_);
+	}
+
+	if(owner_){
+		::shm_unlink(name_.c_str());
+	}
+}
+
+void
+SharedMemoryChannel::map_(int fd, bool writable){
+
+	struct stat info;
+	if(::fstat(fd, &info) == -1){
+		throw std::runtime_error("Failed to stat shared memory " + name_ + ": " + std::strerror(errno));
+	}
+
+	size_ = static_cast<uint_t>(info.st_size);
+
+	if(size_ < HEADER_SIZE){
+		throw std::runtime_error("Shared memory " + name_ + " is too small");
+	}
+
+	const auto protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+	auto data = ::mmap(nullptr, size_, protection, MAP_SHARED, fd, 0);
+
+	if(data == MAP_FAILED){
+		throw std::runtime_error("Failed to map shared memory " + name_ + ": " + std::strerror(errno));
+	}
+
+	data_ = data;
+
+	if(writable){
+		write_u32(data_, MAGIC_OFFSET, MAGIC);
+		write_u32(data_, VERSION_OFFSET, VERSION);
+		write_u32(data_, N_ENVS_OFFSET, static_cast<std::uint32_t>(n_envs_));
+		write_u32(data_, OBS_SIZE_OFFSET, static_cast<std::uint32_t>(obs_size_));
+		write_u32(data_, N_SLOTS_OFFSET, static_cast<std::uint32_t>(n_slots_));
+		write_u32(data_, SLOT_SIZE_OFFSET, static_cast<std::uint32_t>(slot_size_));
+		return;
+	}
+
+	if(read_u32(data_, MAGIC_OFFSET) != MAGIC || read_u32(data_, VERSION_OFFSET) != VERSION){
+		throw std::runtime_error("Shared memory " + name_ + " is not a time step channel");
+	}
+
+	n_envs_ = read_u32(data_, N_ENVS_OFFSET);
+	obs_size_ = read_u32(data_, OBS_SIZE_OFFSET);
+	n_slots_ = read_u32(data_, N_SLOTS_OFFSET);
+	slot_size_ = read_u32(data_, SLOT_SIZE_OFFSET);
+
+	if(n_slots_ == 0 || slot_size_ != slot_size(n_envs_, obs_size_) ||
+	   size_ < HEADER_SIZE + n_slots_ * slot_size_){
+		throw std::runtime_error("Shared memory " + name_ + " has an invalid layout");
+	}
+}
+
+unsigned char*
+SharedMemoryChannel::slot_(std::uint64_t seq)const noexcept{
+	return static_cast<unsigned char*>(data_) + HEADER_SIZE + (seq % n_slots_) * slot_size_;
+}
+
+uint_t
+SharedMemoryChannel::rewards_offset_()const noexcept{
+	return sizeof(std::uint64_t) + pad8(n_envs_);
+}
+
+std::uint64_t
+SharedMemoryChannel::last_seq()const noexcept{
+
+	const auto ptr = reinterpret_cast<std::uint64_t*>(static_cast<unsigned char*>(data_) + LAST_SEQ_OFFSET);
+	return std::atomic_ref<std::uint64_t>(*ptr).load(std::memory_order_acquire);
+}
+
+std::uint64_t
+SharedMemoryChannel::write(const std::vector<TimeStepTp>& types,
+                           const std::vector<real_t>& rewards,
+						   const std::vector<real_t>& discounts,
+						   std::span<const real_t> observations){
+
+	if(!owner_){
+		throw std::logic_error("Only the creator of the shared memory " + name_ + " can write to it");
+	}
+
+	if(types.size() != n_envs_ || rewards.size() != n_envs_ ||
+	   discounts.size() != n_envs_ || observations.size() != n_envs_ * obs_size_){
+		throw std::logic_error("The time step does not match the shared memory layout");
+	}
+
+	const auto seq = last_seq() + 1;
+	auto slot = slot_(seq);
+
+	// invalidate the slot before it is overwritten so that
+	// readers of the previous time step notice the change
+	std::atomic_ref<std::uint64_t>(*reinterpret_cast<std::uint64_t*>(slot)).store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for(uint_t i=0; i<n_envs_; ++i){
+		slot[sizeof(std::uint64_t) + i] = static_cast<unsigned char>(types[i]);
+	}
+
+	auto values = slot + rewards_offset_();
+	std::memcpy(values, rewards.data(), n_envs_ * sizeof(real_t));
+	std::memcpy(values + n_envs_ * sizeof(real_t), discounts.data(), n_envs_ * sizeof(real_t));
+	std::memcpy(values + 2 * n_envs_ * sizeof(real_t), observations.data(), observations.size() * sizeof(real_t));
+
+	// publish the slot and then the sequence number
+	std::atomic_ref<std::uint64_t>(*reinterpret_cast<std::uint64_t*>(slot)).store(seq, std::memory_order_release);
+
+	const auto last = reinterpret_cast<std::uint64_t*>(static_cast<unsigned char*>(data_) + LAST_SEQ_OFFSET);
+	std::atomic_ref<std::uint64_t>(*last).store(seq, std::memory_order_release);
+	return seq;
+}
+
+}
+}
@@ -0,0 +1,222 @@
+#ifndef SHM_CHANNEL_H
+#define SHM_CHANNEL_H
+
+/**
+ * Shared memory data plane between a local environment server
+ * and the client. The server creates a POSIX shared memory object
+ * that holds a ring of fixed size slots and writes every time step
+ * of a vector environment into the next slot. The HTTP response only
+ * carries the sequence number of the slot. All values are little endian.
+ *
+ * Header (HEADER_SIZE bytes):
+ *    u32  magic
+ *    u32  version
+ *    u32  number of environments n
+ *    u32  observation size d
+ *    u32  number of slots
+ *    u32  slot size in bytes
+ *    u64  sequence number of the last written slot
+ *
+ * Slot:
+ *    u64    sequence number
+ *    u8[n]  step types, padded to a multiple of 8 bytes
+ *    f64[n] rewards
+ *    f64[n] discounts
+ *    f64[n * d] observations, row major
+ *
+ * The sequence number s is written in slot s % n_slots. A slot
+ * remains valid until n_slots further time steps have been written.
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/vector_time_step.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief The media type of a response whose time step
+/// was written into the shared memory channel
+///
+inline const std::string SHM_SLOT_MEDIA_TYPE = "application/x-rlenvs-shm-slot";
+
+///
+/// \brief A mapped POSIX shared memory ring of vector time steps
+///
+class SharedMemoryChannel
+{
+public:
+
+	///
+	/// \brief Identifies a channel segment
+	///
+	static constexpr std::uint32_t MAGIC = 0x48534C52;
+
+	///
+	/// \brief The layout version
+	///
+	static constexpr std::uint32_t VERSION = 1;
+
+	///
+	/// \brief The size of the header in bytes
+	///
+	static constexpr uint_t HEADER_SIZE = 64;
+
+	///
+	/// \brief The size in bytes of a slot
+	///
+	static uint_t slot_size(uint_t n_envs, uint_t obs_size)noexcept;
+
+	///
+	/// \brief Map the existing shared memory object with the given
+	/// name read only. Throws std::runtime_error if it cannot be mapped
+	/// or is not a channel
+	///
+	static std::shared_ptr<SharedMemoryChannel> open(const std::string& name);
+
+	///
+	/// \brief Create and map a new shared memory object. The object is
+	/// removed when the returned channel is destroyed
+	///
+	static std::shared_ptr<SharedMemoryChannel> create(const std::string& name,
+	                                                   uint_t n_envs,
+													   uint_t obs_size,
+													   uint_t n_slots);
+
+	///
+	/// \brief Destructor. Unmaps the memory
+	///
+	~SharedMemoryChannel();
+
+	SharedMemoryChannel(const SharedMemoryChannel&)=delete;
+	SharedMemoryChannel& operator=(const SharedMemoryChannel&)=delete;
+
+	///
+	/// \brief The name of the shared memory object
+	///
+	const std::string& name()const noexcept{return name_;}
+
+	///
+	/// \brief The number of environments per time step
+	///
+	uint_t n_envs()const noexcept{return n_envs_;}
+
+	///
+	/// \brief The size of every observation
+	///
+	uint_t obs_size()const noexcept{return obs_size_;}
+
+	///
+	/// \brief The number of slots in the ring
+	///
+	uint_t n_slots()const noexcept{return n_slots_;}
+
+	///
+	/// \brief The sequence number of the last written slot
+	///
+	std::uint64_t last_seq()const noexcept;
+
+	///
+	/// \brief Write a time step into the next slot and return its
+	/// sequence number. Only channels that were created can be written
+	///
+	std::uint64_t write(const std::vector<TimeStepTp>& types,
+	                    const std::vector<real_t>& rewards,
+						const std::vector<real_t>& discounts,
+						std::span<const real_t> observations);
+
+	///
+	/// \brief Returns the time step in the slot with the given sequence
+	/// number. The observations are copied out of the slot, so the time
+	/// step stays valid when the server reuses it. Throws std::runtime_error
+	/// if the slot was overwritten before or while it was read
+	///
+	template<typename StateType>
+	VectorTimeStep<StateType> read(std::uint64_t seq)const;
+
+private:
+
+	SharedMemoryChannel()=default;
+
+	std::string name_;
+	bool owner_{false};
+	void* data_{nullptr};
+	uint_t size_{0};
+	uint_t n_envs_{0};
+	uint_t obs_size_{0};
+	uint_t n_slots_{0};
+	uint_t slot_size_{0};
+
+	///
+	/// \brief Map the object behind fd and read or write the header
+	///
+	void map_(int fd, bool writable);
+
+	///
+	/// \brief Start of the slot for the given sequence number
+	///
+	unsigned char* slot_(std::uint64_t seq)const noexcept;
+
+	///
+	/// \brief Offset of the rewards in a slot
+	///
+	uint_t rewards_offset_()const noexcept;
+};
+
+template<typename StateType>
+VectorTimeStep<StateType>
+SharedMemoryChannel::read(std::uint64_t seq)const{
+
+	static_assert(std::is_same_v<StateType, std::vector<real_t> >,
+	              "The shared memory channel holds std::vector<real_t> observations");
+
+	const auto slot = slot_(seq);
+	std::atomic_ref<std::uint64_t> slot_seq(*reinterpret_cast<std::uint64_t*>(slot));
+
+	if(slot_seq.load(std::memory_order_acquire) != seq){
+		throw std::runtime_error("Shared memory slot " + std::to_string(seq) + " is not available");
+	}
+
+	std::vector<TimeStepTp> types(n_envs_);
+	for(uint_t i=0; i<n_envs_; ++i){
+		types[i] = TimeStepEnumUtils::time_step_type_from_int(static_cast<uint_t>(slot[sizeof(std::uint64_t) + i]));
+	}
+
+	const auto rewards = reinterpret_cast<const real_t*>(slot + rewards_offset_());
+	const auto discounts = rewards + n_envs_;
+	const auto observations = discounts + n_envs_;
+
+	std::vector<real_t> step_rewards(rewards, rewards + n_envs_);
+	std::vector<real_t> step_discounts(discounts, discounts + n_envs_);
+	auto buffer = std::make_shared<std::vector<real_t> >(observations, observations + n_envs_ * obs_size_);
+
+	// the server may have started to overwrite the slot while it was copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if(slot_seq.load(std::memory_order_relaxed) != seq){
+		throw std::runtime_error("Shared memory slot " + std::to_string(seq) + " was overwritten while it was read");
+	}
+
+	const std::span<const real_t> view(buffer -> data(), buffer -> size());
+	return VectorTimeStep<StateType>(types,
+	                                 step_rewards,
+									 step_discounts,
+									 view,
+									 obs_size_,
+									 std::move(buffer));
+}
+
+}
+}
+
+#endif // SHM_CHANNEL_H
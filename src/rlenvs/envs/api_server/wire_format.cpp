@@ -0,0 +1,90 @@
+#include "rlenvs/envs/api_server/wire_format.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace rlenvscpp{
+namespace envs{
+namespace wire_format{
+
+namespace{
+
+template<typename T>
+void
+append_value(std::string& out, const T value){
+	out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}
+
+http_header_fields
+accept_headers(WireFormat format){
+
+	if(format == WireFormat::BINARY){
+		return {{"Accept", BINARY_TIME_STEP_MEDIA_TYPE + ", application/json;q=0.5"}};
+	}
+
+	return http_header_fields();
+}
+
+bool
+has_media_type(const HTTPResponse& response, const std::string& media_type){
+
+	auto content_type = response.header("content-type");
+	std::transform(content_type.begin(), content_type.end(), content_type.begin(),
+	               [](unsigned char c){return static_cast<char>(std::tolower(c));});
+
+	return content_type.compare(0, media_type.size(), media_type) == 0;
+}
+
+bool
+is_binary(const HTTPResponse& response){
+	return has_media_type(response, BINARY_TIME_STEP_MEDIA_TYPE);
+}
+
+std::string
+encode_time_step(TimeStepTp type, real_t reward, real_t discount,
+                 const real_t* observation, uint_t size){
+
+	std::string out;
+	out.reserve(TIME_STEP_HEADER_SIZE + size * sizeof(double));
+
+	append_value(out, static_cast<std::uint8_t>(type));
+	append_value(out, static_cast<double>(reward));
+	append_value(out, static_cast<double>(discount));
+	out.append(reinterpret_cast<const char*>(observation), size * sizeof(double));
+	return out;
+}
+
+std::string
+encode_vector_time_step(const std::vector<TimeStepTp>& types,
+                        const std::vector<real_t>& rewards,
+						const std::vector<real_t>& discounts,
+						const real_t* observations,
+						uint_t obs_size){
+
+	const auto n_envs = types.size();
+
+	if(rewards.size() != n_envs || discounts.size() != n_envs){
+		throw std::logic_error("The number of rewards and discounts should match the number of environments");
+	}
+
+	std::string out;
+	out.reserve(VECTOR_TIME_STEP_HEADER_SIZE + n_envs + (2 * n_envs + n_envs * obs_size) * sizeof(double));
+
+	append_value(out, static_cast<std::uint32_t>(n_envs));
+	append_value(out, static_cast<std::uint32_t>(obs_size));
+
+	for(auto type : types){
+		append_value(out, static_cast<std::uint8_t>(type));
+	}
+
+	out.append(reinterpret_cast<const char*>(rewards.data()), n_envs * sizeof(double));
+	out.append(reinterpret_cast<const char*>(discounts.data()), n_envs * sizeof(double));
+	out.append(reinterpret_cast<const char*>(observations), n_envs * obs_size * sizeof(double));
+	return out;
+}
+
+}
+}
+}
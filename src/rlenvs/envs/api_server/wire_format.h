@@ -0,0 +1,237 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+/**
+ * Compact binary encoding of the time steps returned by the
+ * environment server. The client asks for it with the header
+ * Accept: application/x-rlenvs-time-step and the server answers
+ * with the same Content-Type if it supports it; any other response
+ * is JSON. All values are little endian.
+ *
+ * TimeStep:
+ *    u8    step type
+ *    f64   reward
+ *    f64   discount
+ *    f64[] observation (the length follows from the body size)
+ *
+ * VectorTimeStep:
+ *    u32   number of environments n
+ *    u32   observation size d
+ *    u8[n] step types
+ *    f64[n] rewards
+ *    f64[n] discounts
+ *    f64[n * d] observations, row major
+ *
+ * The info dictionary is not transferred.
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/vector_time_step.h"
+#include "rlenvs/envs/api_server/http_connection.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <bit>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief The encoding of the time steps exchanged with the server
+///
+enum class WireFormat: int {JSON=0, BINARY=1};
+
+///
+/// \brief The media type of the binary time step encoding
+///
+inline const std::string BINARY_TIME_STEP_MEDIA_TYPE = "application/x-rlenvs-time-step";
+
+namespace wire_format{
+
+static_assert(std::endian::native == std::endian::little,
+              "The binary wire format assumes a little endian host");
+
+///
+/// \brief Size of the fixed part of an encoded TimeStep
+///
+inline constexpr uint_t TIME_STEP_HEADER_SIZE = sizeof(std::uint8_t) + 2 * sizeof(double);
+
+///
+/// \brief Size of the fixed part of an encoded VectorTimeStep
+///
+inline constexpr uint_t VECTOR_TIME_STEP_HEADER_SIZE = 2 * sizeof(std::uint32_t);
+
+///
+/// \brief Returns the header fields that request the given format
+///
+http_header_fields accept_headers(WireFormat format);
+
+///
+/// \brief Returns true if the Content-Type of the
+/// response is the given media type
+///
+bool has_media_type(const HTTPResponse& response, const std::string& media_type);
+
+///
+/// \brief Returns true if the response body is binary encoded
+///
+bool is_binary(const HTTPResponse& response);
+
+///
+/// \brief Encode a time step with the given observation values
+///
+std::string encode_time_step(TimeStepTp type, real_t reward, real_t discount,
+                             const real_t* observation, uint_t size);
+
+///
+/// \brief Encode a vector time step. observations holds
+/// n_envs * obs_size values in row major order
+///
+std::string encode_vector_time_step(const std::vector<TimeStepTp>& types,
+                                    const std::vector<real_t>& rewards,
+									const std::vector<real_t>& discounts,
+									const real_t* observations,
+									uint_t obs_size);
+
+template<typename T> struct is_vector_time_step: std::false_type{};
+template<typename T, typename I> struct is_vector_time_step<VectorTimeStep<T, I> >: std::true_type{};
+
+template<typename T> struct is_std_vector: std::false_type{};
+template<typename T> struct is_std_vector<std::vector<T> >: std::true_type{};
+
+///
+/// \brief Copy size doubles starting at offset of data into out
+/// converting them to T
+///
+template<typename T>
+void
+read_values(const std::string& data, uint_t offset, uint_t size, T* out){
+
+	if constexpr(std::is_same_v<T, double>){
+		std::memcpy(out, data.data() + offset, size * sizeof(double));
+	}
+	else{
+		for(uint_t i=0; i<size; ++i){
+			double value;
+			std::memcpy(&value, data.data() + offset + i * sizeof(double), sizeof(double));
+			out[i] = static_cast<T>(value);
+		}
+	}
+}
+
+///
+/// \brief Decode a binary encoded body into the given time step
+/// type. TimeStep and VectorTimeStep with arithmetic or std::vector
+/// states are supported. Throws std::logic_error for any other state
+/// type and std::runtime_error if the body is malformed
+///
+template<typename TimeStepType>
+TimeStepType
+decode_time_step(const std::string& body){
+
+	typedef typename TimeStepType::state_type state_type;
+
+	if constexpr(is_vector_time_step<TimeStepType>::value){
+
+		if(body.size() < VECTOR_TIME_STEP_HEADER_SIZE){
+			throw std::runtime_error("Binary vector time step is too short");
+		}
+
+		std::uint32_t n_envs = 0;
+		std::uint32_t obs_size = 0;
+		std::memcpy(&n_envs, body.data(), sizeof(std::uint32_t));
+		std::memcpy(&obs_size, body.data() + sizeof(std::uint32_t), sizeof(std::uint32_t));
+
+		const uint_t expected = VECTOR_TIME_STEP_HEADER_SIZE + n_envs * sizeof(std::uint8_t) +
+		                        (2 * n_envs + n_envs * obs_size) * sizeof(double);
+
+		if(body.size() != expected){
+			throw std::runtime_error("Binary vector time step has invalid size");
+		}
+
+		uint_t offset = VECTOR_TIME_STEP_HEADER_SIZE;
+
+		std::vector<TimeStepTp> types(n_envs);
+		for(uint_t i=0; i<n_envs; ++i){
+			types[i] = TimeStepEnumUtils::time_step_type_from_int(
+			                      static_cast<uint_t>(static_cast<std::uint8_t>(body[offset + i])));
+		}
+
+		offset += n_envs;
+
+		std::vector<real_t> rewards(n_envs);
+		read_values(body, offset, n_envs, rewards.data());
+		offset += n_envs * sizeof(double);
+
+		std::vector<real_t> discounts(n_envs);
+		read_values(body, offset, n_envs, discounts.data());
+		offset += n_envs * sizeof(double);
+
+		std::vector<state_type> observations(n_envs);
+		for(uint_t i=0; i<n_envs; ++i){
+
+			if constexpr(is_std_vector<state_type>::value){
+				observations[i].resize(obs_size);
+				read_values(body, offset, obs_size, observations[i].data());
+			}
+			else if constexpr(std::is_arithmetic_v<state_type>){
+				read_values(body, offset, 1, &observations[i]);
+			}
+			else{
+				throw std::logic_error("The binary wire format does not support this state type");
+			}
+
+			offset += obs_size * sizeof(double);
+		}
+
+		return TimeStepType(types, rewards, observations, discounts);
+	}
+	else{
+
+		if(body.size() < TIME_STEP_HEADER_SIZE || (body.size() - TIME_STEP_HEADER_SIZE) % sizeof(double) != 0){
+			throw std::runtime_error("Binary time step has invalid size");
+		}
+
+		const auto type = TimeStepEnumUtils::time_step_type_from_int(
+		                            static_cast<uint_t>(static_cast<std::uint8_t>(body[0])));
+
+		real_t reward = 0.0;
+		real_t discount = 0.0;
+		read_values(body, 1, 1, &reward);
+		read_values(body, 1 + sizeof(double), 1, &discount);
+
+		const uint_t obs_size = (body.size() - TIME_STEP_HEADER_SIZE) / sizeof(double);
+
+		state_type observation;
+		if constexpr(is_std_vector<state_type>::value){
+			observation.resize(obs_size);
+			read_values(body, TIME_STEP_HEADER_SIZE, obs_size, observation.data());
+		}
+		else if constexpr(std::is_arithmetic_v<state_type>){
+
+			if(obs_size != 1){
+				throw std::runtime_error("Binary time step has invalid observation size");
+			}
+
+			read_values(body, TIME_STEP_HEADER_SIZE, 1, &observation);
+		}
+		else{
+			throw std::logic_error("The binary wire format does not support this state type");
+		}
+
+		return TimeStepType(type, reward, observation, discount);
+	}
+}
+
+}
+
+}
+}
+
+#endif // WIRE_FORMAT_H
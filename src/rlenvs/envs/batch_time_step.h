@@ -0,0 +1,173 @@
+#ifndef BATCH_TIME_STEP_H
+#define BATCH_TIME_STEP_H
+
+/**
+ * Structure-of-arrays time step of a batch of environments. The
+ * observations of all the environments live in one row major
+ * [n_envs x obs_size] buffer and the types, rewards and discounts in
+ * flat arrays. The vector environments fill a BatchTimeStep in place
+ * with step_into(), so the same object can be reused across steps
+ * without allocating and its observations can be handed to a network
+ * as a matrix without repacking:
+ *
+ *     BatchTimeStep<real_t> batch;
+ *     env.reset_into(42, batch);
+ *     env.step_into(actions, batch);
+ *     auto x = batch.observations_matrix(); // n_envs x obs_size
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/time_step_info.h"
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <numeric>
+
+namespace rlenvscpp{
+
+///
+/// \brief class BatchTimeStep. The time step of a batch of environments
+/// in structure-of-arrays layout
+///
+template<typename T=real_t, typename InfoType=NoInfo>
+class BatchTimeStep
+{
+public:
+
+	///
+	/// \brief The type of the observation values
+	///
+	typedef T value_type;
+
+	///
+	/// \brief The type of the typed info of an environment
+	///
+	typedef InfoType info_type;
+
+	///
+	/// \brief The observations viewed as an n_envs x obs_size matrix
+	///
+	typedef Eigen::Map<const RowMajorDynMat<T> > const_matrix_map_type;
+
+	///
+	/// \brief The observations viewed as an obs_size x n_envs matrix,
+	/// one column per environment
+	///
+	typedef Eigen::Map<const DynMat<T> > const_column_map_type;
+
+	///
+	/// \brief Default constructor
+	///
+	BatchTimeStep()=default;
+
+	///
+	/// \brief Constructor. Allocates the buffers for the given sizes
+	///
+	BatchTimeStep(uint_t n_envs, uint_t obs_size);
+
+	///
+	/// \brief Set the sizes of the batch. Does not allocate if the
+	/// buffers are already large enough
+	///
+	void resize(uint_t n_envs, uint_t obs_size);
+
+	///
+	/// \brief The number of environments
+	///
+	uint_t n_envs()const noexcept{return types_.size();}
+
+	///
+	/// \brief The size of the observation of every environment
+	///
+	uint_t obs_size()const noexcept{return obs_size_;}
+
+	///
+	/// \brief The step types
+	///
+	std::span<const TimeStepTp> types()const noexcept{return types_;}
+	std::span<TimeStepTp> types()noexcept{return types_;}
+
+	///
+	/// \brief The rewards
+	///
+	std::span<const real_t> rewards()const noexcept{return rewards_;}
+	std::span<real_t> rewards()noexcept{return rewards_;}
+
+	///
+	/// \brief The discounts
+	///
+	std::span<const real_t> discounts()const noexcept{return discounts_;}
+	std::span<real_t> discounts()noexcept{return discounts_;}
+
+	///
+	/// \brief The row major observation buffer
+	///
+	std::span<const T> observations()const noexcept{return obs_;}
+	std::span<T> observations()noexcept{return obs_;}
+
+	///
+	/// \brief The observation of the i-th environment
+	///
+	std::span<const T> observation(uint_t i)const noexcept{return std::span<const T>(obs_).subspan(i * obs_size_, obs_size_);}
+	std::span<T> observation(uint_t i)noexcept{return std::span<T>(obs_).subspan(i * obs_size_, obs_size_);}
+
+	///
+	/// \brief The observations as an n_envs x obs_size matrix. No copy is made
+	///
+	const_matrix_map_type observations_matrix()const noexcept{return const_matrix_map_type(obs_.data(), n_envs(), obs_size_);}
+
+	///
+	/// \brief The observations as an obs_size x n_envs column major
+	/// matrix, the layout Eigen networks take their inputs in. No copy is made
+	///
+	const_column_map_type observations_columns()const noexcept{return const_column_map_type(obs_.data(), obs_size_, n_envs());}
+
+	///
+	/// \brief The typed info of every environment. Empty if
+	/// the environments report none
+	///
+	const std::vector<info_type>& typed_infos()const noexcept{return infos_;}
+	std::vector<info_type>& typed_infos()noexcept{return infos_;}
+
+	///
+	/// \brief Returns the sum of the rewards
+	///
+	real_t reward()const noexcept{return std::accumulate(rewards_.begin(), rewards_.end(), 0.0);}
+
+	///
+	/// \brief Returns true if any time step is LAST
+	///
+	bool done()const noexcept{return std::find(types_.begin(), types_.end(), TimeStepTp::LAST) != types_.end();}
+
+private:
+
+	uint_t obs_size_{0};
+	std::vector<TimeStepTp> types_;
+	std::vector<real_t> rewards_;
+	std::vector<real_t> discounts_;
+	std::vector<T> obs_;
+	std::vector<info_type> infos_;
+};
+
+template<typename T, typename InfoType>
+BatchTimeStep<T, InfoType>::BatchTimeStep(uint_t n_envs, uint_t obs_size)
+{
+	resize(n_envs, obs_size);
+}
+
+template<typename T, typename InfoType>
+void
+BatchTimeStep<T, InfoType>::resize(uint_t n_envs, uint_t obs_size){
+
+	obs_size_ = obs_size;
+	types_.resize(n_envs, TimeStepTp::INVALID_TYPE);
+	rewards_.resize(n_envs, 0.0);
+	discounts_.resize(n_envs, 1.0);
+	obs_.resize(n_envs * obs_size);
+}
+
+}
+
+#endif // BATCH_TIME_STEP_H
@@ -17,7 +17,7 @@ const std::string Connect2::name = "Connect2";
 
 Connect2::Connect2()
 :
-EnvBase<TimeStep<std::vector<uint_t>>,
+EnvBase<TimeStep<std::vector<uint_t>, ActionMaskInfo<4> >,
 		DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > >(0, "Connect2"),
 discount_(1.0),
 board_()
@@ -25,7 +25,7 @@ board_()
 
 Connect2::Connect2(uint_t cidx)
 :
-EnvBase<TimeStep<std::vector<uint_t>>,
+EnvBase<TimeStep<std::vector<uint_t>, ActionMaskInfo<4> >,
 		DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > >(cidx, "Connect2"),
 discount_(1.0),
 board_()
@@ -33,7 +33,7 @@ board_()
 
 Connect2::Connect2(const Connect2& other)
 :
-EnvBase<TimeStep<std::vector<uint_t>>,
+EnvBase<TimeStep<std::vector<uint_t>, ActionMaskInfo<4> >,
 		DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > >(other),
 discount_(1.0),
 board_(other.board_),
@@ -56,12 +56,36 @@ Connect2::step(const action_type& action){
 	
 }
 
+void
+Connect2::step_into(const action_type& action, time_step_type& time_step){
+
+	validate_move_(player_id_1_, action);
+
+	if(is_finished_){
+		board_.assign(4, 0);
+		is_finished_ = false;
+		time_step.update(TimeStepTp::FIRST, 0.0, discount_);
+	}
+	else{
+		const auto [step_type, reward] = apply_move_(player_id_1_, action);
+		time_step.update(step_type, reward, discount_);
+	}
+
+	time_step.mutable_observation().assign(board_.begin(), board_.end());
+	time_step.typed_info().action_mask = action_mask();
+
+	// an info map the time step carries does
+	// not describe the board after this move
+	time_step.clear_info();
+}
+
 Connect2::time_step_type 
 Connect2::reset(uint_t /*seed*/,
 				const std::unordered_map<std::string, std::any>& /*options*/){
-	board_ = std::vector<uint_t>(4, 0);
+	board_.assign(4, 0);
 	is_finished_ = false;
-	this -> get_current_time_step_() = Connect2::time_step_type(TimeStepTp::FIRST, 0.0, board_, discount_);
+	this -> get_current_time_step_() = Connect2::time_step_type(TimeStepTp::FIRST, 0.0, board_, discount_,
+	                                                            time_step_type::info_type{action_mask()});
 	return 	this -> get_current_time_step_();			
 }
 
@@ -95,6 +119,17 @@ Connect2::get_valid_moves()const{
 	return val_moves_;
 }
 
+std::bitset<4>
+Connect2::action_mask()const noexcept{
+
+	std::bitset<4> mask;
+	for(uint_t i=0; i<board_.size(); ++i){
+		mask[i] = board_[i] == 0;
+	}
+
+	return mask;
+}
+
 bool 
 Connect2::has_legal_moves()const noexcept{
 	
@@ -111,6 +146,22 @@ Connect2::has_legal_moves()const noexcept{
 Connect2::time_step_type 
 Connect2::move(const uint_t pid, const action_type& action){
 	
+	validate_move_(pid, action);
+	
+	if(is_finished_){
+		return reset();
+	}
+	
+	const auto [step_type, reward] = apply_move_(pid, action);
+	
+	// the valid moves are only reported in the action mask, so
+	// the time step does not allocate an info map on every move
+	return Connect2::time_step_type(step_type, reward, board_, discount_,
+	                                time_step_type::info_type{action_mask()});
+}
+
+void
+Connect2::validate_move_(const uint_t pid, const action_type& action)const{
 	
 	if(pid != 1 && pid != 2){
 		throw std::logic_error("Invalid player id: " + std::to_string(pid));
@@ -119,59 +170,51 @@ Connect2::move(const uint_t pid, const action_type& action){
 	if(action >= board_.size()){
 		throw std::logic_error("Invalid action id: " + std::to_string(action));
 	}
+}
+
+std::pair<TimeStepTp, real_t>
+Connect2::apply_move_(const uint_t pid, const action_type& action){
 	
-	if(is_finished_){
-		return reset();
-	}
-	
-	auto valid_move = true;
 	if(board_[action] != 0){
-		valid_move = false;
+		throw std::logic_error("Move: " + std::to_string(action) + " is invalid");
 	}
 	
-	if(valid_move){
-		// this position on the board
-		// is occupied by the given player
-		board_[action] = pid;
-		
-		bool won = is_win(pid);
-		bool has_moves = has_legal_moves();
-		
-		// there may be more moves to make in the game
-		// but the player may have won. That's why we look
-		// at the won variable first
-		auto step_type  = TimeStepTp::INVALID_TYPE;
-		auto reward = 0.0;
-		if(won){
-			step_type  = TimeStepTp::LAST;
-			is_finished_ = true;
-			reward = 1.0;
-		}
-		else if(has_moves){
-			// the player has not won the game
-			// and there may be more moves
-			step_type = TimeStepTp::MID;
-			reward = 0.0;
-			
-		}
-		else{
-			// the player lost the game
-			step_type  = TimeStepTp::LAST;
-			is_finished_ = true;
-			reward = -1.0;
-		}
-		
-		auto val_moves = get_valid_moves();
-		
-		std::unordered_map<std::string, std::any> extra;
-		extra["valid_moves"] = std::any(val_moves);
-		return Connect2::time_step_type(step_type, reward, 
-		                                board_, discount_,
-										std::move(extra));
+	// this position on the board
+	// is occupied by the given player
+	board_[action] = pid;
+	
+	// there may be more moves to make in the game
+	// but the player may have won. That's why we look
+	// at the won variable first
+	if(is_win(pid)){
+		is_finished_ = true;
+		return {TimeStepTp::LAST, 1.0};
 	}
 	
-	throw std::logic_error("Move: " + std::to_string(action) + " is invalid");
+	if(has_legal_moves()){
+		// the player has not won the game
+		// and there may be more moves
+		return {TimeStepTp::MID, 0.0};
+	}
 	
+	// the player lost the game
+	is_finished_ = true;
+	return {TimeStepTp::LAST, -1.0};
+}
+
+Connect2::snapshot_type
+Connect2::snapshot()const{
+
+	snapshot_type snapshot{{0, 0, 0, 0}, is_finished_};
+	std::copy(board_.begin(), board_.end(), snapshot.board.begin());
+	return snapshot;
+}
+
+void
+Connect2::restore(const snapshot_type& snapshot){
+
+	board_.assign(snapshot.board.begin(), snapshot.board.end());
+	is_finished_ = snapshot.is_finished;
 }
 
 Connect2 
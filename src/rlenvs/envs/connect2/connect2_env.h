@@ -12,26 +12,41 @@
 #include "rlenvs/rlenvscpp_config.h"
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_info.h"
 #include "rlenvs/envs/env_types.h"
 #include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
 
 #include <boost/noncopyable.hpp>
+#include <array>
+#include <bitset>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <utility>
 
 namespace rlenvscpp{
 namespace envs{
 namespace connect2{
 
+///
+/// \brief Snapshot of the Connect2 environment
+///
+struct Connect2Snapshot
+{
+	std::array<uint_t, 4> board;
+	bool is_finished;
+};
+
 ///
 /// \brief Implementation of Connect2 environment from https://github.com/JoshVarty/AlphaZeroSimple
 /// Initially the environment has all its positions set to zero. When a player makes
 /// a move then the position corresponding to this move 
 ///	
-class Connect2 final: public EnvBase<TimeStep<std::vector<uint_t>>,
-									 DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > >
+class Connect2 final: public EnvBase<TimeStep<std::vector<uint_t>, ActionMaskInfo<4> >,
+									 DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > >,
+                      public with_snapshot_mixin<Connect2Snapshot>
 {
 	
 public:
@@ -44,7 +59,7 @@ public:
 	///
 	/// \brief The base type
 	///
-	typedef EnvBase<TimeStep<std::vector<uint_t> >,
+	typedef EnvBase<TimeStep<std::vector<uint_t>, ActionMaskInfo<4> >,
 							 DiscreteVectorStateDiscreteActionEnv<53, 0, 4, uint_t > > base_type;
 							 
 	
@@ -77,6 +92,11 @@ public:
 	/// \brief Expose the various reset methods we use from base class
 	///
 	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef Connect2Snapshot snapshot_type;
 	
 	///
     /// \brief Constructor
@@ -107,6 +127,15 @@ public:
     /// \return
     ///
     virtual time_step_type step(const action_type& action)override final;
+
+	///
+	/// \brief Move player_1 and write the result into the given time step.
+	/// The observation is refilled in place and the valid moves are
+	/// reported in the action mask of the typed info. An info map the
+	/// time step carries is cleared. Reusing the time step across steps
+	/// does not allocate
+	///
+	virtual void step_into(const action_type& action, time_step_type& time_step)override final;
 	
 	///
     /// \brief close
@@ -136,7 +165,8 @@ public:
     uint_t n_actions()const noexcept{return action_space_type::size;}
 	
 	///
-	/// \brief Make a move for the player with the given id
+	/// \brief Make a move for the player with the given id. The valid
+	/// moves are reported in the action mask of the typed info
 	///
 	time_step_type move(const uint_t pid, const action_type& action);
 
@@ -155,6 +185,21 @@ public:
 	///
 	std::vector<uint_t> get_valid_moves()const;
 
+	///
+	/// \brief The valid moves as a mask. Bit i is set if position i is free
+	///
+	std::bitset<4> action_mask()const noexcept;
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
 private:
 	
 	
@@ -188,6 +233,18 @@ private:
 	/// \brief Flag indicating if the game is finished
 	///
 	bool is_finished_{false};
+
+	///
+	/// \brief Throws std::logic_error if the player or the action is not valid
+	///
+	void validate_move_(const uint_t pid, const action_type& action)const;
+
+	///
+	/// \brief Place the piece of the player and return the type
+	/// of the step and the reward. Throws std::logic_error if the
+	/// position is occupied
+	///
+	std::pair<TimeStepTp, real_t> apply_move_(const uint_t pid, const action_type& action);
 	
 };
 
@@ -86,6 +86,15 @@ public:
     /// \param action The action to execute in the environment 
 	/// \return The time step 
     virtual time_step_type step(const action_type& action)=0;
+
+	///
+	/// \brief step in the environment and write the time step into the given one.
+	/// Environments that can refill the observation in place override this, so that
+	/// a loop that reuses one time step does not allocate. By default the result
+	/// of step() is moved into time_step
+	///
+    virtual void step_into(const action_type& action, time_step_type& time_step){
+        time_step = step(action);}
 	
 	///
 	/// \brief Reset the environment always using the same seed
@@ -0,0 +1,196 @@
+#include "rlenvs/envs/env_factory.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/gymnasium/classic_control/pendulum_env.h"
+#include "rlenvs/envs/gymnasium/classic_control/mountain_car_env.h"
+#include "rlenvs/envs/gymnasium/classic_control/acrobot_env.h"
+#include "rlenvs/envs/gymnasium/toy_text/frozen_lake_env.h"
+#include "rlenvs/envs/gymnasium/toy_text/taxi_env.h"
+#include "rlenvs/envs/gymnasium/toy_text/cliff_world_env.h"
+#include "rlenvs/envs/gymnasium/toy_text/black_jack_env.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/native/pendulum_env.h"
+#include "rlenvs/envs/native/mountain_car_env.h"
+#include "rlenvs/envs/native/acrobot_env.h"
+#include "rlenvs/envs/native/frozen_lake_env.h"
+#include "rlenvs/envs/native/taxi_env.h"
+#include "rlenvs/envs/native/cliff_world_env.h"
+#include "rlenvs/envs/native/black_jack_env.h"
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <memory>
+#include <type_traits>
+
+namespace rlenvscpp{
+namespace envs{
+
+namespace{
+
+// one wrapper per url so that the environments created
+// by the factory share its connection pool
+RESTApiServerWrapper
+api_server_for(const std::string& url){
+
+	static std::mutex mutex;
+	static std::map<std::string, RESTApiServerWrapper> servers;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto itr = servers.find(url);
+	if(itr == servers.end()){
+		itr = servers.emplace(url, RESTApiServerWrapper(url)).first;
+	}
+
+	return itr -> second;
+}
+
+template<typename RestEnvType>
+std::unique_ptr<RestEnvType>
+new_rest_env(const RESTApiServerWrapper& api_server, uint_t cidx){
+
+	if constexpr(std::is_constructible_v<RestEnvType, const RESTApiServerWrapper&, uint_t>){
+		return std::make_unique<RestEnvType>(api_server, cidx);
+	}
+	else{
+		// FrozenLake also takes the slippery flag, make reads it from the options
+		return std::make_unique<RestEnvType>(api_server, cidx, true);
+	}
+}
+
+template<typename RestEnvType>
+void
+add_rest_env(const std::string& name){
+
+	typedef env_interface_t<RestEnvType> interface_type;
+	auto& registry = EnvRegistry<interface_type>::instance();
+
+	registry.add(name, EnvBackend::REST,
+	             [](uint_t cidx, const EnvFactoryConfig& config){
+		             return std::unique_ptr<interface_type>(new_rest_env<RestEnvType>(api_server_for(config.rest_url), cidx));
+	             });
+
+	registry.add(name, EnvBackend::MOCK,
+	             [](uint_t cidx, const EnvFactoryConfig& config){
+
+		             if(config.mock_url.empty()){
+			             throw std::logic_error("The mock_url of the environment factory is not set");
+		             }
+
+		             return std::unique_ptr<interface_type>(new_rest_env<RestEnvType>(api_server_for(config.mock_url), cidx));
+	             });
+}
+
+template<typename NativeEnvType>
+void
+add_native_env(const std::string& name){
+
+	typedef env_interface_t<NativeEnvType> interface_type;
+
+	EnvRegistry<interface_type>::instance().add(name, EnvBackend::NATIVE,
+	             [](uint_t cidx, const EnvFactoryConfig& /*config*/){
+		             return std::unique_ptr<interface_type>(std::make_unique<NativeEnvType>(cidx));
+	             });
+}
+
+}
+
+EnvBackend
+env_backend_from_string(const std::string& backend){
+
+	if(backend == "rest"){
+		return EnvBackend::REST;
+	}
+
+	if(backend == "native"){
+		return EnvBackend::NATIVE;
+	}
+
+	if(backend == "mock"){
+		return EnvBackend::MOCK;
+	}
+
+	throw std::logic_error("Environment backend " + backend + " is not known. Use rest, native or mock");
+}
+
+std::string
+to_string(EnvBackend backend){
+
+	switch(backend){
+		case EnvBackend::REST:
+			return "rest";
+		case EnvBackend::NATIVE:
+			return "native";
+		case EnvBackend::MOCK:
+			return "mock";
+	}
+
+	return "unknown";
+}
+
+EnvBackend
+EnvFactoryConfig::backend(const std::string& env_name)const{
+
+	auto itr = backends.find(env_name);
+	return itr != backends.end() ? itr -> second : default_backend;
+}
+
+EnvFactoryConfig
+EnvFactoryConfig::from_json(const nlohmann::json& config){
+
+	EnvFactoryConfig result;
+
+	if(config.contains("rest_url")){
+		result.rest_url = config["rest_url"].get<std::string>();
+	}
+
+	if(config.contains("mock_url")){
+		result.mock_url = config["mock_url"].get<std::string>();
+	}
+
+	if(config.contains("backend")){
+		result.default_backend = env_backend_from_string(config["backend"].get<std::string>());
+	}
+
+	if(config.contains("envs")){
+		for(const auto& [name, backend] : config["envs"].items()){
+			result.backends[name] = env_backend_from_string(backend.get<std::string>());
+		}
+	}
+
+	return result;
+}
+
+void
+register_builtin_envs(){
+
+	static std::once_flag registered;
+
+	std::call_once(registered, [](){
+
+		add_rest_env<gymnasium::CartPole>(gymnasium::CartPole::name);
+		add_rest_env<gymnasium::Pendulum>(gymnasium::Pendulum::name);
+		add_rest_env<gymnasium::MountainCar>(gymnasium::MountainCar::name);
+		add_rest_env<gymnasium::Acrobot>(gymnasium::Acrobot::name);
+		add_rest_env<gymnasium::FrozenLake<4> >(gymnasium::FrozenLake<4>::name);
+		add_rest_env<gymnasium::FrozenLake<8> >(gymnasium::FrozenLake<8>::name);
+		add_rest_env<gymnasium::Taxi>(gymnasium::Taxi::name);
+		add_rest_env<gymnasium::CliffWorld>(gymnasium::CliffWorld::name);
+		add_rest_env<gymnasium::BlackJack>(gymnasium::BlackJack::name);
+
+		add_native_env<native::CartPole>(native::CartPole::name);
+		add_native_env<native::Pendulum>(native::Pendulum::name);
+		add_native_env<native::MountainCar>(native::MountainCar::name);
+		add_native_env<native::Acrobot>(native::Acrobot::name);
+		add_native_env<native::FrozenLake<4> >(native::FrozenLake<4>::name);
+		add_native_env<native::FrozenLake<8> >(native::FrozenLake<8>::name);
+		add_native_env<native::Taxi>(native::Taxi::name);
+		add_native_env<native::CliffWorld>(native::CliffWorld::name);
+		add_native_env<native::BlackJack>(native::BlackJack::name);
+	});
+}
+
+}
+}
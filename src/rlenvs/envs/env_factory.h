@@ -0,0 +1,305 @@
+#ifndef ENV_FACTORY_H
+#define ENV_FACTORY_H
+
+/**
+ * Creates environments by name and selects at runtime the implementation
+ * that serves them. Every environment interface, an EnvBase instantiation,
+ * has its own EnvRegistry that maps an environment name and a backend to
+ * a function that creates the environment. The backends are
+ *
+ * - REST: the environment is served by the Python server at rest_url
+ * - NATIVE: the environment runs in-process, see rlenvs/envs/native
+ * - MOCK: the REST client talks to a MockEnvServer at mock_url
+ *
+ * The REST and the native implementations of CartPole, Pendulum, Taxi and
+ * FrozenLake share the same interface and can be swapped from the
+ * configuration without changing the code:
+ *
+ *     auto env = make_env<CartPoleInterface>("CartPole", "v1", config);
+ *
+ * env_interface_t gives the interface of any environment class, e.g.
+ * env_interface_t<native::MountainCar>.
+ *
+ * The native MountainCar, Acrobot, CliffWalking and BlackJack use state
+ * or action spaces that differ from those of their REST counterparts, so
+ * each is registered under its own interface only.
+ */
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/extern/nlohmann/json/json.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <any>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief The implementations an environment can be served by
+///
+enum class EnvBackend: int {REST=0, NATIVE=1, MOCK=2};
+
+///
+/// \brief Returns the backend with the given name, one of rest,
+/// native or mock. Throws std::logic_error for any other name
+///
+EnvBackend env_backend_from_string(const std::string& backend);
+
+///
+/// \brief Returns the name of the backend
+///
+std::string to_string(EnvBackend backend);
+
+///
+/// \brief The configuration of the environment factory
+///
+struct EnvFactoryConfig
+{
+	///
+	/// \brief The url of the REST server
+	///
+	std::string rest_url{"http://0.0.0.0:8001/api"};
+
+	///
+	/// \brief The url of the MockEnvServer used by the MOCK backend
+	///
+	std::string mock_url;
+
+	///
+	/// \brief The backend of the environments not listed in backends
+	///
+	EnvBackend default_backend{EnvBackend::REST};
+
+	///
+	/// \brief The backend of individual environments
+	///
+	std::unordered_map<std::string, EnvBackend> backends;
+
+	///
+	/// \brief Returns the backend that serves the given environment
+	///
+	EnvBackend backend(const std::string& env_name)const;
+
+	///
+	/// \brief Read the configuration from JSON of the form
+	/// {"rest_url": ..., "mock_url": ..., "backend": "native",
+	/// "envs": {"CartPole": "rest"}}. Every key is optional.
+	/// Throws std::logic_error if a backend is not known
+	///
+	static EnvFactoryConfig from_json(const nlohmann::json& config);
+};
+
+///
+/// \brief Registers the environments that ship with the library.
+/// Called by EnvRegistry before the first lookup
+///
+void register_builtin_envs();
+
+///
+/// \brief Maps an environment name and a backend to a function that
+/// creates an environment with the interface EnvType. Thread-safe
+///
+template<typename EnvType>
+class EnvRegistry
+{
+public:
+
+	///
+	/// \brief The interface of the environments
+	///
+	typedef EnvType env_type;
+
+	///
+	/// \brief Creates an environment with the given copy index
+	///
+	typedef std::function<std::unique_ptr<EnvType>(uint_t cidx, const EnvFactoryConfig& config)> creator_type;
+
+	///
+	/// \brief The registry of the EnvType environments
+	///
+	static EnvRegistry& instance();
+
+	EnvRegistry(const EnvRegistry&)=delete;
+	EnvRegistry& operator=(const EnvRegistry&)=delete;
+
+	///
+	/// \brief Register the creator of the given environment and backend.
+	/// Replaces any creator registered for them
+	///
+	void add(const std::string& name, EnvBackend backend, creator_type creator);
+
+	///
+	/// \brief Returns true if the environment can be created with the backend
+	///
+	bool contains(const std::string& name, EnvBackend backend)const;
+
+	///
+	/// \brief The backends the given environment can be created with
+	///
+	std::vector<EnvBackend> backends(const std::string& name)const;
+
+	///
+	/// \brief Create the environment with the given backend and call
+	/// make with the version and the options. Throws std::logic_error if
+	/// the environment is not registered for the backend
+	///
+	std::unique_ptr<EnvType> create(const std::string& name,
+	                                const std::string& version,
+	                                EnvBackend backend,
+	                                const std::unordered_map<std::string, std::any>& options,
+	                                const EnvFactoryConfig& config,
+	                                uint_t cidx=0)const;
+
+private:
+
+	EnvRegistry()=default;
+
+	mutable std::mutex mutex_;
+	std::map<std::pair<std::string, EnvBackend>, creator_type> creators_;
+};
+
+template<typename EnvType>
+EnvRegistry<EnvType>&
+EnvRegistry<EnvType>::instance(){
+
+	static EnvRegistry<EnvType> registry;
+	return registry;
+}
+
+template<typename EnvType>
+void
+EnvRegistry<EnvType>::add(const std::string& name, EnvBackend backend, creator_type creator){
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	creators_[{name, backend}] = std::move(creator);
+}
+
+template<typename EnvType>
+bool
+EnvRegistry<EnvType>::contains(const std::string& name, EnvBackend backend)const{
+
+	register_builtin_envs();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	return creators_.contains({name, backend});
+}
+
+template<typename EnvType>
+std::vector<EnvBackend>
+EnvRegistry<EnvType>::backends(const std::string& name)const{
+
+	register_builtin_envs();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<EnvBackend> result;
+	for(const auto& [key, creator] : creators_){
+		if(key.first == name){
+			result.push_back(key.second);
+		}
+	}
+
+	return result;
+}
+
+template<typename EnvType>
+std::unique_ptr<EnvType>
+EnvRegistry<EnvType>::create(const std::string& name,
+                             const std::string& version,
+                             EnvBackend backend,
+                             const std::unordered_map<std::string, std::any>& options,
+                             const EnvFactoryConfig& config,
+                             uint_t cidx)const{
+
+	register_builtin_envs();
+
+	creator_type creator;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto itr = creators_.find({name, backend});
+
+		if(itr == creators_.end()){
+			throw std::logic_error("Environment " + name + " has no " + to_string(backend) +
+			                       " implementation with the requested interface");
+		}
+
+		creator = itr -> second;
+	}
+
+	auto env = creator(cidx, config);
+	env -> make(version, options);
+	return env;
+}
+
+///
+/// \brief Create and make the environment with the given backend
+///
+template<typename EnvType>
+std::unique_ptr<EnvType>
+make_env(const std::string& name,
+         const std::string& version,
+         EnvBackend backend,
+         const std::unordered_map<std::string, std::any>& options=std::unordered_map<std::string, std::any>(),
+         const EnvFactoryConfig& config=EnvFactoryConfig(),
+         uint_t cidx=0){
+
+	return EnvRegistry<EnvType>::instance().create(name, version, backend, options, config, cidx);
+}
+
+///
+/// \brief Create and make the environment with the backend the
+/// configuration selects for it
+///
+template<typename EnvType>
+std::unique_ptr<EnvType>
+make_env(const std::string& name,
+         const std::string& version,
+         const EnvFactoryConfig& config,
+         const std::unordered_map<std::string, std::any>& options=std::unordered_map<std::string, std::any>(),
+         uint_t cidx=0){
+
+	return EnvRegistry<EnvType>::instance().create(name, version, config.backend(name), options, config, cidx);
+}
+
+namespace detail_{
+
+	template<typename TimeStepType, typename SpaceType>
+	EnvBase<TimeStepType, SpaceType>* env_interface(EnvBase<TimeStepType, SpaceType>*);
+}
+
+///
+/// \brief The EnvBase interface the environment EnvType implements
+///
+template<typename EnvType>
+using env_interface_t = std::remove_pointer_t<decltype(detail_::env_interface(std::declval<EnvType*>()))>;
+
+///
+/// \brief The interfaces shared by the REST and the native implementations
+///
+typedef EnvBase<TimeStep<std::vector<real_t> >,
+                ContinuousVectorStateDiscreteActionEnv<4, 2, 0, real_t> > CartPoleInterface;
+
+typedef EnvBase<TimeStep<std::vector<real_t> >,
+                ContinuousVectorStateContinuousScalarBoundedActionEnv<3, 1, RealRange<-2.0, 2.0>, 0, real_t> > PendulumInterface;
+
+typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<16, 4, 0, 0> > FrozenLake4x4Interface;
+typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<64, 4, 0, 0> > FrozenLake8x8Interface;
+typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<500, 6, 0, 0> > TaxiInterface;
+
+}
+}
+
+#endif // ENV_FACTORY_H
@@ -1,5 +1,12 @@
+#ifndef ENV_TYPES_H
+#define ENV_TYPES_H
+
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/space_type.h"
+#include "rlenvs/utils/sampling_engine.h"
+
+#include <vector>
+#include <span>
 
 namespace rlenvscpp{
 namespace envs{
@@ -42,30 +49,47 @@ struct ScalarDiscreteEnv{
 	
 	
 	///
-    /// \brief sample
+    /// \brief sample an action in [action_start, action_end)
     /// \return
     ///
-    static action_type sample_action(){return action_space::sample(true);}
+    static action_type sample_action(){return action_space::sample(false);}
 
     ///
     /// \brief sample
     /// \param seed
     /// \return
     ///
-    static action_type sample_action(uint_t seed){return action_space::sample(seed, true);}
+    static action_type sample_action(uint_t seed){return action_space::sample(seed, false);}
 	
 	
-	static std::vector<action_type> sample_action(uint_t seed, uint_t size){return action_space::sample(seed, size, true);}
+	static std::vector<action_type> sample_action(uint_t seed, uint_t size){return action_space::sample(seed, size, false);}
+
+	///
+    /// \brief Sample an action with the given engine
+    ///
+    static action_type sample_action(utils::sampling_engine_type& engine){return action_space::sample(engine, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the engine of the calling thread
+    ///
+    static void sample_actions(std::span<action_type> actions){action_space::sample_n(actions, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the given engine
+    ///
+    static void sample_actions(utils::sampling_engine_type& engine, std::span<action_type> actions){
+		action_space::sample_n(engine, actions, false);}
 };
 
 template<uint_t StateSpaceSize, 
 		 uint_t action_end, 
 		 uint_t action_start=0,
-		 typename StateSpaceItemType = real_t>
+		 typename StateSpaceItemType = real_t,
+		 typename StateType = std::vector<StateSpaceItemType> >
 struct ContinuousVectorStateDiscreteActionEnv
 {
 	
-	typedef ContinuousVectorSpace<StateSpaceSize, StateSpaceItemType> state_space;
+	typedef ContinuousVectorSpace<StateSpaceSize, StateSpaceItemType, StateType> state_space;
 	
 	///
 	/// \brief the State type
@@ -98,7 +122,28 @@ struct ContinuousVectorStateDiscreteActionEnv
     /// \brief sample
     /// \return
     ///
-    static action_type sample_action(){return action_space::sample();}
+    static action_type sample_action(){return action_space::sample(false);}
+
+	///
+    /// \brief Sample an action with a new engine seeded with seed
+    ///
+    static action_type sample_action(uint_t seed){return action_space::sample(seed, false);}
+
+	///
+    /// \brief Sample an action with the given engine
+    ///
+    static action_type sample_action(utils::sampling_engine_type& engine){return action_space::sample(engine, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the engine of the calling thread
+    ///
+    static void sample_actions(std::span<action_type> actions){action_space::sample_n(actions, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the given engine
+    ///
+    static void sample_actions(utils::sampling_engine_type& engine, std::span<action_type> actions){
+		action_space::sample_n(engine, actions, false);}
 };
 
 
@@ -106,13 +151,14 @@ template<uint_t StateSpaceSize,
 		 uint_t action_end, 
 		 typename real_range,
 		 uint_t action_start = 0,
-		 typename StateSpaceItemType = real_t>
+		 typename StateSpaceItemType = real_t,
+		 typename StateType = std::vector<StateSpaceItemType> >
 struct ContinuousVectorStateContinuousScalarBoundedActionEnv
 {
 	///
 	/// \brief The type of the state space
 	///
-	typedef ContinuousVectorSpace<StateSpaceSize, StateSpaceItemType> state_space;
+	typedef ContinuousVectorSpace<StateSpaceSize, StateSpaceItemType, StateType> state_space;
 	
 	///
 	/// \brief the State type
@@ -144,6 +190,37 @@ struct ContinuousVectorStateContinuousScalarBoundedActionEnv
     /// \brief action space size
     ///
     static constexpr uint_t ACTION_SPACE_SIZE = action_space::size;
+
+	///
+	/// \brief The space the actions are sampled from
+	///
+	typedef BoundedContinuousScalarSpace<real_range::S, real_range::E> action_sample_space;
+
+	///
+    /// \brief Sample an action uniformly in the action limits
+    ///
+    static action_type sample_action(){return action_sample_space::sample();}
+
+	///
+    /// \brief Sample an action with a new engine seeded with seed
+    ///
+    static action_type sample_action(uint_t seed){return action_sample_space::sample(seed);}
+
+	///
+    /// \brief Sample an action with the given engine
+    ///
+    static action_type sample_action(utils::sampling_engine_type& engine){return action_sample_space::sample(engine);}
+
+	///
+    /// \brief Fill actions with samples drawn with the engine of the calling thread
+    ///
+    static void sample_actions(std::span<action_type> actions){action_sample_space::sample_n(actions);}
+
+	///
+    /// \brief Fill actions with samples drawn with the given engine
+    ///
+    static void sample_actions(utils::sampling_engine_type& engine, std::span<action_type> actions){
+		action_sample_space::sample_n(engine, actions);}
 	
 };
 
@@ -312,7 +389,35 @@ struct DiscreteVectorStateDiscreteActionEnv
     /// \brief state space size
     ///
     static constexpr uint_t ACTION_SPACE_SIZE = action_space::size;
+
+	///
+    /// \brief Sample an action with the engine of the calling thread
+    ///
+    static action_type sample_action(){return action_space::sample(false);}
+
+	///
+    /// \brief Sample an action with a new engine seeded with seed
+    ///
+    static action_type sample_action(uint_t seed){return action_space::sample(seed, false);}
+
+	///
+    /// \brief Sample an action with the given engine
+    ///
+    static action_type sample_action(utils::sampling_engine_type& engine){return action_space::sample(engine, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the engine of the calling thread
+    ///
+    static void sample_actions(std::span<action_type> actions){action_space::sample_n(actions, false);}
+
+	///
+    /// \brief Fill actions with samples drawn with the given engine
+    ///
+    static void sample_actions(utils::sampling_engine_type& engine, std::span<action_type> actions){
+		action_space::sample_n(engine, actions, false);}
 };
 
 }
-}
\ No newline at end of file
+}
+
+#endif // ENV_TYPES_H
@@ -8,6 +8,7 @@
 #include "rlenvs/rlenvscpp_config.h"
 
 #include <vector>
+#include <algorithm>
 
 #ifdef RLENVSCPP_DEBUG
 #include <cassert>
@@ -67,6 +68,30 @@ create_trajectory(EnvType& env, ActionSelector& action_selector, uint_t max_step
 
 }
 
+///
+/// \brief Reset the environment and apply the given open-loop action
+/// sequence. The steps are sent with EnvType::step_sequence, i.e.
+/// pipelined, so this is much faster than create_trajectory with a
+/// scripted selector for remote environments. The returned trajectory
+/// ends at the first time step that is done
+///
+template<typename EnvType>
+std::vector<typename EnvType::time_step_type>
+create_open_loop_trajectory(EnvType& env, const std::vector<typename EnvType::action_type>& actions){
+
+    env.reset();
+    auto trajectory = env.step_sequence(actions);
+
+    auto done = std::find_if(trajectory.begin(), trajectory.end(),
+                             [](const auto& time_step){return time_step.done();});
+
+    if(done != trajectory.end()){
+        trajectory.erase(done + 1, trajectory.end());
+    }
+
+    return trajectory;
+}
+
 } // envs
 }// rlenvs_cpp
 
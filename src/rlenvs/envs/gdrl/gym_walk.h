@@ -1,10 +1,22 @@
 /*
  * GymWalk environment from
- * <a href="https://github.com/mimoralea/gym-walk2">gym_walk</a>
- * 
- * 
- * 
- */ 
+ * <a href="https://github.com/mimoralea/gym-walk">gym_walk</a>
+ *
+ * A chain of state_size states. The two end states are terminal and
+ * the agent starts in the middle, at state_size / 2. Action 0 moves to
+ * the left and action 1 to the right. The move is made with probability
+ * 1 - p_stay - p_backward, the agent stays where it is with probability
+ * p_stay and moves the opposite way with probability p_backward.
+ * Entering the right end state gives a reward of +1, every other
+ * transition gives 0.
+ *
+ * The environment runs in-process. The transitions of all the states
+ * and actions are computed when make() is called and p() returns a view
+ * into them, in the same order as the Python implementation:
+ * forward, stay, backward. The time step observation is the state index.
+ *
+ * The state_size of gym_walk's WalkFive, 5 non-terminal states, is 7.
+ */
 
 #ifndef GYM_WALK_H
 #define GYM_WALK_H
@@ -12,17 +24,20 @@
 #include "rlenvs/rlenvscpp_config.h"
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_info.h"
+#include "rlenvs/envs/time_step_type.h"
 #include "rlenvs/envs/env_types.h"
 #include "rlenvs/envs/env_base.h"
-#include "rlenvs/extern/nlohmann/json/json.hpp"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+#include "rlenvs/utils/xoshiro256.h"
 
-#include <boost/noncopyable.hpp>
 #include <vector>
 #include <tuple>
+#include <span>
 #include <string>
 #include <any>
 #include <unordered_map>
-#include <memory>
+#include <stdexcept>
 
 #ifdef RLENVSCPP_DEBUG
 #include <cassert>
@@ -34,40 +49,49 @@ namespace gdrl{
 
 
 ///
-/// \brief class GymWalk. Interface for the GymWalk environment
+/// \brief class GymWalk. In-process implementation of the GymWalk environment
 ///
 template<uint_t state_size>
-class GymWalk final: public EnvBase<TimeStep<uint_t>, 
+class GymWalk final: public EnvBase<TimeStep<uint_t, TruncationInfo>,
                                     ScalarDiscreteEnv<state_size, 2, 0, 0>
-									>
+									>,
+                   public with_snapshot_mixin<DiscreteStateSnapshot>
 {
 public:
-	
+
+	static_assert(state_size >= 3, "GymWalk needs at least one non-terminal state");
+
 	///
     /// \brief name
     ///
     static  const std::string name;
-	
+
 	///
-	/// \brief The URI for accessing the environment
+	/// \brief The state the episodes start from
+	///
+	static constexpr uint_t START_STATE = state_size / 2;
+
 	///
-	static const std::string URI;
-	
-	typedef EnvBase<TimeStep<uint_t>, 
+	/// \brief The actions
+	///
+	static constexpr uint_t LEFT = 0;
+	static constexpr uint_t RIGHT = 1;
+
+	typedef EnvBase<TimeStep<uint_t, TruncationInfo>,
                                     ScalarDiscreteEnv<state_size, 2, 0, 0>
 									> base_type;
-									
-	   ///
+
+	///
 	/// \brief The time step type we return every time a step in the
 	/// environment is performed
 	///
     typedef typename base_type::time_step_type time_step_type;
-	
+
 	///
 	/// \brief The type describing the state space for the environment
 	///
 	typedef typename base_type::state_space_type state_space_type;
-	
+
 	///
 	/// \brief The type of the action space for the environment
 	///
@@ -77,71 +101,87 @@ public:
 	/// \brief The type of the action to be undertaken in the environment
 	///
     typedef typename base_type::action_type action_type;
-	
+
 	///
 	/// \brief The type of the state
 	///
-	typedef typename base_type::state_type state_type; 
-									
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief A transition in the form (probability, next state, reward, done)
+	///
+	typedef std::tuple<real_t, uint_t, real_t, bool> transition_type;
+
 	///
-    /// \brief dynamics_t
+    /// \brief The transitions for a state and action. This is a view
+	/// into the transition model of the environment
     ///
-    typedef std::vector<std::tuple<real_t, uint_t, real_t, bool>> dynamics_t;								
-									
+    typedef std::span<const transition_type> dynamics_t;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef DiscreteStateSnapshot snapshot_type;
+
     ///
 	/// \brief Constructor
 	///
-    GymWalk(const RESTApiServerWrapper& api_server);
-	
+    GymWalk();
+
 	///
 	/// \brief Constructor
 	///
-	GymWalk(const RESTApiServerWrapper& api_server, 
-			const uint_t cidx);
-			
+	explicit GymWalk(uint_t cidx);
+
 	///
 	/// \brief copy ctor
 	///
-	GymWalk(const GymWalk& other);
+	GymWalk(const GymWalk& other)=default;
 
     ///
-    /// \brief make. Builds the environment. Optionally we can choose if the
-    /// environment will be slippery
+    /// \brief make. Builds the environment and its transition model.
+	/// The options may contain "p_stay" and "p_backward", both 0 by
+	/// default, and "max_episode_steps" to truncate the episodes.
+	/// Throws std::logic_error if the version is not v0 or the
+	/// probabilities are not valid
     ///
     virtual void make(const std::string& version,
                       const std::unordered_map<std::string, std::any>& options) override final;
-					  
-					  
-	///
-	/// \brief
-	///
-	virtual bool is_alive()const override final;
-	
+
 	///
     /// \brief close the environment
     ///
     virtual void close() override final;
-	
+
 	///
-    /// \brief step
-    /// \param action
-    /// \return
+    /// \brief step. A step after the end of an episode resets the environment.
+	/// The typed info tells if a LAST step is due to max_episode_steps
     ///
     virtual time_step_type step(const action_type& action) override final;
-	
-	/// 
-	/// \brief Reset the environment
+
+	///
+	/// \brief Reset the environment. The agent is placed at START_STATE
+	/// and the seed initializes the generator of the slips
 	///
     virtual time_step_type reset(uint_t seed,
                                  const std::unordered_map<std::string, std::any>& options)override final;
-								 
-								 
+
 	///
 	/// \brief Create a new copy of the environment with the given
 	/// copy index
 	///
-	virtual std::unique_ptr<base_type> make_copy(uint_t cidx)const override final;
+	GymWalk make_copy(uint_t cidx)const;
 
+	///
+    /// \brief The transitions for the given state and action. The
+	/// view stays valid until the environment is closed
+    ///
+    dynamics_t p(uint_t sidx, uint_t aidx)const;
 
     ///
     /// \brief n_states. Returns the number of states
@@ -153,171 +193,256 @@ public:
     ///
     uint_t n_actions()const noexcept{return action_space_type::size;}
 
+	///
+	/// \brief The probability of staying in the same state
+	///
+	real_t p_stay()const noexcept{return p_stay_;}
+
+	///
+	/// \brief The probability of moving opposite to the action
+	///
+	real_t p_backward()const noexcept{return p_backward_;}
+
+	///
+	/// \brief The current state
+	///
+	uint_t state()const noexcept{return state_;}
+
+	///
+	/// \brief Returns true if the given state is one of the two end states
+	///
+	static constexpr bool is_terminal(uint_t sidx)noexcept{return sidx == 0 || sidx == state_size - 1;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
 
 private:
-	
-    ///
-    /// \brief build the dynamics from response
-    ///
-    dynamics_t build_dynamics_from_response_(const nlohmann::json& response)const;
 
-    ///
-    /// \brief Handle the reset response from the environment server
-    ///
-    time_step_type create_time_step_from_response_(const nlohmann::json& response) const;
-	
-	
-	RESTApiServerWrapper api_server_;
-};
+	real_t p_stay_{0.0};
+	real_t p_backward_{0.0};
 
-template<uint_t state_size>
-const std::string GymWalk<state_size>::name = "GymWalk";
-const std::string GymWalk<state_size>::URI =  "/gdrl/gym-walk-env";
+	///
+	/// \brief The time limit. Zero means no limit
+	///
+	uint_t max_episode_steps_{0};
+	uint_t n_steps_{0};
+	bool is_finished_{true};
+	uint_t state_{START_STATE};
 
+	///
+	/// \brief The generator of the slips
+	///
+	utils::Xoshiro256 generator_;
+
+	///
+	/// \brief The transitions of state s and action a start at transitions_[(s * 2 + a) * 3]
+	///
+	std::vector<transition_type> transitions_;
+
+	///
+	/// \brief Build the transition model
+	///
+	void build_transitions_();
+};
 
 template<uint_t state_size>
-GymWalk<state_size>::GymWalk(const RESTApiServerWrapper& api_server)
-:
-EnvBase<TimeStep<uint_t>, 
-		ScalarDiscreteEnv<state_size, 2, 0, 0>
-	   >(0, GymWalk<state_size>::name),
-api_server_(api_server_)
-{
-	api_server_.register_if_not(GymWalk<state_size>::name, GymWalk<state_size>::URI);
-}
+const std::string GymWalk<state_size>::name = "GymWalk";
 
 template<uint_t state_size>
-GymWalk<state_size>::GymWalk(const RESTApiServerWrapper& api_server, 
-			                 const uint_t cidx)
+GymWalk<state_size>::GymWalk()
 :
-EnvBase<TimeStep<uint_t>, 
-		ScalarDiscreteEnv<state_size, 2, 0, 0>
-	   >(cidx, "GymWalk"),
-api_server_(api_server)
-{
-	api_server_.register_if_not(GymWalk<state_size>::name, GymWalk<state_size>::URI);
-}
-
+base_type(0, GymWalk<state_size>::name)
+{}
 
 template<uint_t state_size>
-GymWalk<state_size>::GymWalk(const GymWalk<state_size>& other)
+GymWalk<state_size>::GymWalk(uint_t cidx)
 :
-EnvBase<TimeStep<uint_t>, 
-		ScalarDiscreteEnv<state_size, 2, 0, 0>
-	   >(other),
-api_server_(other.api_server_)
+base_type(cidx, GymWalk<state_size>::name)
 {}
 
 template<uint_t state_size>
-typename GymWalk<state_size>::dynamics_t
-GymWalk<state_size>::build_dynamics_from_response_(const nlohmann::json& response)const{
-    auto dynamics = response["dynamics"];
-    return dynamics;
+void
+GymWalk<state_size>::make(const std::string& version,
+                          const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+        return;
+    }
+
+	if(version != "v0"){
+		throw std::logic_error("GymWalk version " + version + " is not supported");
+	}
+
+	auto stay_itr = options.find("p_stay");
+	if(stay_itr != options.end()){
+		p_stay_ = std::any_cast<real_t>(stay_itr -> second);
+	}
+
+	auto backward_itr = options.find("p_backward");
+	if(backward_itr != options.end()){
+		p_backward_ = std::any_cast<real_t>(backward_itr -> second);
+	}
+
+	if(p_stay_ < 0.0 || p_backward_ < 0.0 || p_stay_ + p_backward_ > 1.0){
+		throw std::logic_error("GymWalk p_stay and p_backward must be non-negative and sum to at most 1");
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	build_transitions_();
+
+	this -> set_version_(version);
+    this -> make_created_();
 }
 
 template<uint_t state_size>
 typename GymWalk<state_size>::time_step_type
-GymWalk<state_size>::create_time_step_from_response_(const nlohmann::json& response)const{
-
-    auto step_type   = response["time_step"]["step_type"];
-    auto reward      = response["time_step"]["reward"];
-    auto discount    = response["time_step"]["discount"];
-    auto observation = response["time_step"]["observation"];
-    auto info        = response["time_step"]["info"];
-    return GymWalk::time_step_type(time_step_type_from_int(step_type),
-                                                 reward, observation, discount,
-                                                 std::unordered_map<std::string, std::any>());
-}
+GymWalk<state_size>::reset(uint_t seed,
+						   const std::unordered_map<std::string, std::any>& /*options*/){
 
-template<uint_t state_size>
-void
-GymWalk<state_size>::make(const std::string& version,
-           const std::unordered_map<std::string, std::any>& options){
-			   
-	if(this->is_created()){
-        return;
-    }
-	
-	auto response = api_server_.make(this->env_name(),
-	                                              this->cidx(),
-												  version,
-												  ops);
-
-	this->set_version_(version);
-    this->make_created_();
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	state_ = START_STATE;
+	n_steps_ = 0;
+	is_finished_ = false;
+	this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+	return this -> get_current_time_step_();
 }
 
 template<uint_t state_size>
 typename GymWalk<state_size>::time_step_type
-GymWalk<state_size>::step(const action_type&  action){
+GymWalk<state_size>::step(const action_type& action){
 
 #ifdef RLENVSCPP_DEBUG
-     assert(this->is_created() && "Environment has not been created");
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
 #endif
 
-	if(this->get_current_time_step_().last()){
-         return this->reset(42, std::unordered_map<std::string, std::any>());
-     }
+	if(is_finished_){
+		state_ = START_STATE;
+		n_steps_ = 0;
+		is_finished_ = false;
+		this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+		return this -> get_current_time_step_();
+	}
 
-    const auto response  = api_server_.step(this -> env_name(),
-											this -> cidx(),
-											action);
+	const auto transitions = p(state_, action);
 
-    this->get_current_time_step_() = this->create_time_step_from_response_(response);
-    return this->get_current_time_step_();
-}
+	// pick forward, stay or backward
+	const auto u = generator_.uniform();
+	const auto p_forward = std::get<0>(transitions[0]);
+	const auto& [probability, next_state, reward, done] = transitions[u < p_forward ? 0 : (u < p_forward + p_stay_ ? 1 : 2)];
 
-template<uint_t state_size>
-bool
-GymWalk<state_size>::is_alive()const{
-	auto response = this -> api_server_.is_alive(this->env_name(), this -> cidx());
-	return response["result"];
+	state_ = next_state;
+	n_steps_ += 1;
+
+	const bool truncated = !done && max_episode_steps_ != 0 && n_steps_ >= max_episode_steps_;
+	is_finished_ = done || truncated;
 
+	this -> get_current_time_step_() = time_step_type(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                                                  reward, state_, 1.0, TruncationInfo{truncated});
+	return this -> get_current_time_step_();
 }
 
 template<uint_t state_size>
-bool
+void
 GymWalk<state_size>::close(){
 
-	if(!this->is_created()){
-        return;
-    }
+	transitions_.clear();
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<uint_t state_size>
+typename GymWalk<state_size>::snapshot_type
+GymWalk<state_size>::snapshot()const{
 
-	auto response = this -> api_server_.close(this->env_name(), this -> cidx());
-    this -> invalidate_is_created_flag_();
+	return {state_, n_steps_, is_finished_};
 }
 
 template<uint_t state_size>
-typename GymWalk<state_size>::time_step_type
-GymWalk<state_size>::reset(uint_t seed,
-						   const std::unordered_map<std::string, std::any>& /*options*/){
+void
+GymWalk<state_size>::restore(const snapshot_type& snapshot){
 
-    if(!this->is_created()){
 #ifdef RLENVSCPP_DEBUG
-     assert(this->is_created() && "Environment has not been created");
+	assert(this -> is_created() && "Environment has not been created");
 #endif
-     return time_step_type();
-    }
-	
-	auto response = this -> api_server_.reset(this->env_name(), 
-	                                         this -> cidx(), seed,
-											  nlohmann::json());
 
-    this->create_time_step_from_response_(response);
-    return this -> get_current_time_step_();
+	state_ = snapshot.state;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
 }
 
 template<uint_t state_size>
 GymWalk<state_size>
 GymWalk<state_size>::make_copy(uint_t cidx)const{
-	
-	GymWalk<state_size> copy(api_server_ ,cidx);
-	std::unordered_map<std::string, std::any> ops;
-	auto version = this -> version();
-	copy.make(version, ops);
+
+	GymWalk<state_size> copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["p_stay"] = p_stay_;
+	options["p_backward"] = p_backward_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
 	return copy;
 }
 
+template<uint_t state_size>
+typename GymWalk<state_size>::dynamics_t
+GymWalk<state_size>::p(uint_t sidx, uint_t aidx)const{
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(sidx < state_space_type::size && aidx < action_space_type::size && "Invalid state or action");
+#endif
+
+	return dynamics_t(transitions_.data() + (sidx * action_space_type::size + aidx) * 3, 3);
+}
+
+template<uint_t state_size>
+void
+GymWalk<state_size>::build_transitions_(){
+
+	constexpr uint_t last = state_size - 1;
+	const auto p_forward = 1.0 - p_stay_ - p_backward_;
+
+	transitions_.clear();
+	transitions_.reserve(state_size * action_space_type::size * 3);
+
+	for(uint_t s=0; s<state_size; ++s){
+		for(uint_t a=0; a<action_space_type::size; ++a){
+
+			// the end states are absorbing
+			const auto s_forward = is_terminal(s) ? s : (a == LEFT ? s - 1 : s + 1);
+			const auto s_backward = is_terminal(s) ? s : (a == LEFT ? s + 1 : s - 1);
+
+			const auto r_forward = s == last - 1 && s_forward == last ? 1.0 : 0.0;
+			const auto r_backward = s == last - 1 && s_backward == last ? 1.0 : 0.0;
+
+			const bool d_forward = (s >= last - 1 && s_forward == last) || (s <= 1 && s_forward == 0);
+			const bool d_backward = (s >= last - 1 && s_backward == last) || (s <= 1 && s_backward == 0);
+
+			transitions_.emplace_back(p_forward, s_forward, r_forward, d_forward);
+			transitions_.emplace_back(p_stay_, s, 0.0, is_terminal(s));
+			transitions_.emplace_back(p_backward_, s_backward, r_backward, d_backward);
+		}
+	}
+}
+
 }
 }
 }
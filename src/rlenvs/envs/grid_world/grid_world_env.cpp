@@ -348,7 +348,7 @@ board::validate_move(board_component_type piece, board_position pos)const{
         // #if outside bounds of board
          outcome = board_move_type::INVALID;
     }
-    else if( min(new_pos) < 0){
+    else if( new_pos.first < 0 || new_pos.second < 0){
         // #if outside bounds
          outcome = board_move_type::INVALID;
     }
@@ -14,11 +14,14 @@
 #include "rlenvs/envs/time_step.h"
 #include "rlenvs/envs/env_base.h"
 #include "rlenvs/envs/space_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
 
 #ifdef RLENVSCPP_DEBUG
 #include <cassert>
 #endif
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <utility>
@@ -262,8 +265,154 @@ namespace detail{
 		///
 		static constexpr uint_t ACTION_SPACE_SIZE = action_space::size;
 	};
+
+	///
+	/// \brief Compact representation of the board used when stepping.
+	/// Every component is stored as one byte, the index row * side_size + col
+	/// of the cell it occupies. The cell the player lands on for every cell
+	/// and action is computed when the board is packed, so a step is a
+	/// table lookup followed by two comparisons
+	///
+	template<uint_t side_size>
+	struct packed_board
+	{
+		static_assert(side_size <= 16, "The packed board supports boards up to 16x16");
+
+		///
+		/// \brief The number of cells
+		///
+		static constexpr uint_t n_cells = side_size * side_size;
+
+		///
+		/// \brief The cells of the components indexed by board_component_type
+		///
+		std::array<std::uint8_t, 4> cells{};
+
+		///
+		/// \brief moves[cell * 4 + action] is the cell the player lands on
+		/// when executing the action from cell. Moves into the WALL or out of
+		/// the board leave the player where it is
+		///
+		std::array<std::uint8_t, n_cells * 4> moves{};
+
+		///
+		/// \brief Pack the given board
+		///
+		void pack(const board& b);
+
+		///
+		/// \brief Compute the move table. Called when the WALL moves
+		///
+		void build_moves()noexcept;
+
+		///
+		/// \brief Execute the action and return the reward
+		///
+		real_t step(GridWorldActionType action)noexcept{
+			cells[PLAYER] = moves[cells[PLAYER] * 4 + static_cast<uint_t>(action)];
+			return get_reward();
+		}
+
+		///
+		/// \brief The reward for the current position of the player. -10 at
+		/// the PIT, 10 at the GOAL and -1 everywhere else
+		///
+		real_t get_reward()const noexcept{
+			return cells[PLAYER] == cells[PIT] ? -10.0 : (cells[PLAYER] == cells[GOAL] ? 10.0 : -1.0);
+		}
+
+		///
+		/// \brief The position of the given component
+		///
+		board_position position(board_component_type component)const noexcept{
+			return {static_cast<int>(cells[component] / side_size), static_cast<int>(cells[component] % side_size)};
+		}
+
+		///
+		/// \brief Place the component at the given position
+		///
+		void set_position(board_component_type component, board_position pos)noexcept;
+
+		///
+		/// \brief Returns the state of the board. Layer i of the
+		/// state is the mask of component i, as in board::get_state
+		///
+		board_state_type get_state()const;
+	};
+
+	template<uint_t side_size>
+	void
+	packed_board<side_size>::pack(const board& b){
+
+#ifdef RLENVSCPP_DEBUG
+		assert(b.board_size == side_size && "Invalid board size");
+#endif
+
+		for(const auto& [component, piece] : b.components){
+			cells[component] = static_cast<std::uint8_t>(piece.pos.first * side_size + piece.pos.second);
+		}
+
+		build_moves();
+	}
+
+	template<uint_t side_size>
+	void
+	packed_board<side_size>::set_position(board_component_type component, board_position pos)noexcept{
+
+		cells[component] = static_cast<std::uint8_t>(pos.first * side_size + pos.second);
+
+		if(component == WALL){
+			build_moves();
+		}
+	}
+
+	template<uint_t side_size>
+	void
+	packed_board<side_size>::build_moves()noexcept{
+
+		// the row and column offsets of UP, DOWN, LEFT and RIGHT
+		constexpr int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+		constexpr int size = static_cast<int>(side_size);
+
+		for(uint_t cell=0; cell<n_cells; ++cell){
+
+			const auto row = static_cast<int>(cell / side_size);
+			const auto col = static_cast<int>(cell % side_size);
+
+			for(uint_t a=0; a<4; ++a){
+
+				const auto next_row = row + offsets[a][0];
+				const auto next_col = col + offsets[a][1];
+				const auto in_board = next_row >= 0 && next_row < size && next_col >= 0 && next_col < size;
+				const auto next_cell = in_board ? static_cast<std::uint8_t>(next_row * size + next_col) : static_cast<std::uint8_t>(cell);
+
+				moves[cell * 4 + a] = next_cell == cells[WALL] ? static_cast<std::uint8_t>(cell) : next_cell;
+			}
+		}
+	}
+
+	template<uint_t side_size>
+	board_state_type
+	packed_board<side_size>::get_state()const{
+
+		board_state_type state(4, std::vector<std::vector<real_t> >(side_size, std::vector<real_t>(side_size, 0.0)));
+
+		for(uint_t layer=0; layer<4; ++layer){
+			state[layer][cells[layer] / side_size][cells[layer] % side_size] = 1.0;
+		}
+
+		return state;
+	}
 }
 
+///
+/// \brief Snapshot of the Gridworld environment. The positions
+/// of the board components indexed by detail::board_component_type
+///
+struct GridworldSnapshot
+{
+	std::array<std::array<int, 2>, 4> positions;
+};
 
 ///
 /// The Gridworld class models a square board. There are three ways to initialize the board.
@@ -277,7 +426,8 @@ namespace detail{
 ///
 template<uint_t side_size_>
 class Gridworld final: public EnvBase<TimeStep<detail::board_state_type>,
-                                      detail::GridWorldEnv<side_size_>> 
+                                      detail::GridWorldEnv<side_size_>>,
+                       public with_snapshot_mixin<GridworldSnapshot>
 {
 public:
 
@@ -336,6 +486,11 @@ public:
 	///
 	using base_type::reset;
 
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef GridworldSnapshot snapshot_type;
+
     ///
     /// \brief Constructor
     ///
@@ -423,7 +578,32 @@ public:
     /// \return
     ///
     GridWorldInitType init_type()const noexcept{return init_mode_;}
-	
+
+	///
+	/// \brief Execute the action without building the observation and
+	/// return the reward. The episode is over when the reward is not -1.0.
+	/// Agents that encode the observation themselves can read the board
+	/// from packed_board()
+	///
+	real_t step_packed(const action_type& action)noexcept{
+		return packed_board_.step(static_cast<GridWorldActionType>(action));
+	}
+
+	///
+	/// \brief The board the steps are executed on
+	///
+	const detail::packed_board<side_size_>& packed_board()const noexcept{return packed_board_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
 private:
 
     ///
@@ -447,9 +627,14 @@ private:
     real_t noise_factor_;
 
     ///
-    /// \brief board_
+    /// \brief The board the episodes are initialized from
     ///
     detail::board board_;
+
+    ///
+    /// \brief The board the steps are executed on
+    ///
+    detail::packed_board<side_size_> packed_board_;
 };
 
 template<uint_t side_size>
@@ -493,7 +678,8 @@ init_mode_(other.init_mode_),
 randomize_state_(other.randomize_state_),
 seed_(other.seed_),
 noise_factor_(other.noise_factor_),
-board_(other.board_)
+board_(other.board_),
+packed_board_(other.packed_board_)
 {}
 
 
@@ -533,6 +719,7 @@ Gridworld<side_size_>::make(const std::string& version,
 
     // initialize the board
     board_.init_board(side_size_, init_mode_);
+    packed_board_.pack(board_);
 
     // set the version and set the board
     // to created
@@ -554,12 +741,35 @@ Gridworld<side_size_>::make_copy(uint_t cidx)const{
 	return copy;
 }
 
+template<uint_t side_size_>
+typename Gridworld<side_size_>::snapshot_type
+Gridworld<side_size_>::snapshot()const{
+
+	snapshot_type snapshot{};
+	for(uint_t component=0; component<n_components; ++component){
+		const auto pos = packed_board_.position(static_cast<detail::board_component_type>(component));
+		snapshot.positions[component] = {pos.first, pos.second};
+	}
+
+	return snapshot;
+}
+
+template<uint_t side_size_>
+void
+Gridworld<side_size_>::restore(const snapshot_type& snapshot){
+
+	for(uint_t component=0; component<n_components; ++component){
+		packed_board_.set_position(static_cast<detail::board_component_type>(component),
+		                           {snapshot.positions[component][0], snapshot.positions[component][1]});
+	}
+}
+
 template<uint_t side_size_>
 typename Gridworld<side_size_>::time_step_type
 Gridworld<side_size_>::step(const action_type& action){
 	
-	auto obs = board_.step(static_cast<GridWorldActionType>(action));
-    auto reward = board_.get_reward();
+    auto reward = packed_board_.step(static_cast<GridWorldActionType>(action));
+    auto obs = packed_board_.get_state();
 
 	// if the reward is not -1.0 then either
 	// we reached the goal or we hit the PIT
@@ -578,7 +788,8 @@ Gridworld<side_size_>::reset(uint_t /*seed*/,
 
     // reinitialize the board
     auto obs = board_.init_board(side_size_, init_mode_);
-    auto reward = board_.get_reward();
+    packed_board_.pack(board_);
+    auto reward = packed_board_.get_reward();
     this->get_current_time_step_() = time_step_type(TimeStepTp::FIRST, reward, obs);
     return this->get_current_time_step_();
 }
@@ -587,14 +798,8 @@ template<uint_t side_size_>
 bool
 Gridworld<side_size_>::is_game_lost()const{
 
-    auto player = board_.components.find(detail::board_component_type::PLAYER)->second.pos;
-    auto pit_pos = board_.components.find(detail::board_component_type::PIT)->second.pos;
-
-     if (player == pit_pos){
-        return true;
-    }
-
-    return false;
+    return packed_board_.cells[detail::board_component_type::PLAYER] ==
+           packed_board_.cells[detail::board_component_type::PIT];
 }
 
 template<uint_t side_size_>
@@ -84,12 +84,7 @@ Acrobot::step(const action_type& action){
          return this->reset(42, std::unordered_map<std::string, std::any>());
      }
 	 
-	 const auto response  = this -> get_api_server().step(this -> env_name(),
-	                                                 this -> cidx(),
-													 action);
-
-    this->get_current_time_step_() = this->create_time_step_from_response_(response);
-    return this->get_current_time_step_();
+	return this -> step_remote_(action);
 }
 
 Acrobot 
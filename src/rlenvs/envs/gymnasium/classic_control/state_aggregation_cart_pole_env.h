@@ -49,7 +49,7 @@
 namespace rlenvscpp{
 
 /// Forward declaration
-template<typename StateTp> class TimeStep;
+template<typename StateTp, typename InfoTp> class TimeStep;
 
 
 namespace envs{
@@ -26,7 +26,7 @@
 namespace rlenvscpp{
 
 /// Forward declaration
-template<typename StateTp> class VectorTimeStep;
+template<typename StateTp, typename InfoTp> class VectorTimeStep;
 
 namespace envs{
 namespace gymnasium{
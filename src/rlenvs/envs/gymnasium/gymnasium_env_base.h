@@ -7,6 +7,7 @@
 #include "rlenvs/extern/nlohmann/json/json.hpp"
 #include "rlenvs/envs/env_base.h"
 #include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/api_server/wire_format.h"
 
 
 #include <boost/noncopyable.hpp>
@@ -16,6 +17,11 @@
 #include <tuple>
 #include <unordered_map>
 #include <any>
+#include <typeinfo>
+#include <future>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
 
 
 #ifdef RLENVSCPP_DEBUG
@@ -97,6 +103,54 @@ public:
 	/// \brief Returns the full path on the server for this environment
 	///
 	std::string get_url()const;
+	
+	///
+	/// \brief Set the encoding requested for the time steps returned by
+	/// step and reset. Servers that do not support the binary format
+	/// answer with JSON, which is then used. The binary format does not
+	/// carry the info of the time step
+	///
+	void set_wire_format(WireFormat format)noexcept{wire_format_ = format;}
+	
+	///
+	/// \brief Returns the encoding requested for the time steps
+	///
+	WireFormat wire_format()const noexcept{return wire_format_;}
+	
+	///
+	/// \brief Execute the actions one after the other with the requests
+	/// pipelined over one connection. See RESTApiServerWrapper::step_sequence.
+	/// The environment is not reset in between; the caller should stop at
+	/// the first LAST time step. The last time step becomes the current one
+	///
+	std::vector<time_step_type> step_sequence(const std::vector<action_type>& actions,
+	                                          uint_t max_in_flight=32);
+	
+	///
+	/// \brief Asynchronous version of step. Returns immediately with a future
+	/// that holds the time step once the server has responded. The response
+	/// is decoded in the wire format of the environment when get() is called
+	/// and the time step then becomes the current one. Call get() on the
+	/// calling thread before the environment is used again, moved or destroyed
+	///
+	std::future<time_step_type> async_step(const action_type& action);
+	
+	///
+	/// \brief Asynchronous version of reset. See async_step
+	///
+	std::future<time_step_type> async_reset(uint_t seed,
+	                                        const std::unordered_map<std::string, std::any>& options);
+	
+	///
+	/// \brief Step in all the given copies of an environment with a
+	/// single request to the server. actions[i] is executed on envs[i].
+	/// Copies whose current time step is the last one are reset
+	/// instead, as step() does. All the copies should be served by
+	/// the same server
+	///
+	template<typename EnvType>
+	static std::vector<time_step_type> step_batch(std::vector<EnvType>& envs,
+	                                              const std::vector<action_type>& actions);
 
 
 protected:
@@ -119,16 +173,65 @@ protected:
 	///
 	RESTApiServerWrapper api_server_;
 	
+	///
+	/// \brief The encoding requested for the time steps
+	///
+	WireFormat wire_format_{WireFormat::JSON};
+	
 	
 	///
 	/// \brief read reference to the api server instance
 	///
 	RESTApiServerWrapper& get_api_server(){return api_server_;}
+	
+	///
+	/// \brief Convert the reset options to the JSON sent to the server.
+	/// Options whose type has no JSON form are not sent
+	///
+	static nlohmann::json reset_options_to_json_(const std::unordered_map<std::string, std::any>& options);
+	
+	///
+	/// \brief Returns true if a step should reset the environment
+	/// instead. By default this happens when the current time step
+	/// is the last one
+	///
+	virtual bool reset_on_step_()const{return this -> get_current_time_step_().last();}
 					 
 	///
     /// \brief build the time step from the server response
     ///
     virtual time_step_type create_time_step_from_response_(const nlohmann::json& response)const=0;
+	
+	///
+    /// \brief build the time step from a binary encoded server response
+    ///
+	virtual time_step_type create_time_step_from_binary_(const std::string& body)const{
+		return wire_format::decode_time_step<time_step_type>(body);
+	}
+	
+	///
+	/// \brief build the time step from the server response in
+	/// whatever encoding the server used
+	///
+	virtual time_step_type create_time_step_from_http_response_(const HTTPResponse& response)const;
+	
+	///
+	/// \brief As create_time_step_from_http_response_ but records the
+	/// time it takes under the given endpoint in the server statistics
+	///
+	time_step_type decode_http_response_(const std::string& endpoint, const HTTPResponse& response)const;
+	
+	///
+	/// \brief The header fields sent with step and reset to
+	/// negotiate the encoding of the time step
+	///
+	virtual http_header_fields accept_headers_()const{return wire_format::accept_headers(wire_format_);}
+	
+	///
+	/// \brief Execute the action on the remote environment and
+	/// make the resulting time step the current one
+	///
+	time_step_type step_remote_(const action_type& action);
 
 };
 
@@ -139,7 +242,8 @@ GymnasiumEnvBase<TimeStepType,
 				                              const std::string& name)
 :
 EnvBase<TimeStepType, SpaceType>(cidx, name),
-api_server_(api_server)
+api_server_(api_server),
+wire_format_(WireFormat::JSON)
 {}
 
 template<typename TimeStepType, typename SpaceType>
@@ -147,7 +251,8 @@ GymnasiumEnvBase<TimeStepType,
                  SpaceType>::GymnasiumEnvBase(const GymnasiumEnvBase<TimeStepType, SpaceType>& other)
 				 :
 EnvBase<TimeStepType, SpaceType>(other),
-api_server_(other.api_server_)
+api_server_(other.api_server_),
+wire_format_(other.wire_format_)
 {}
 			 
 
@@ -185,7 +290,7 @@ GymnasiumEnvBase<TimeStepType, SpaceType>::close(){
 template<typename TimeStepType, typename SpaceType>
 typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type
 GymnasiumEnvBase<TimeStepType, SpaceType>::reset(uint_t seed,
-                                      const std::unordered_map<std::string, std::any>& /*options*/){
+                                      const std::unordered_map<std::string, std::any>& options){
 
     if(!this->is_created()){
 #ifdef RLENVSCPP_DEBUG
@@ -194,14 +299,118 @@ GymnasiumEnvBase<TimeStepType, SpaceType>::reset(uint_t seed,
      return time_step_type();
     }
 	
-	auto response = this -> api_server_.reset(this->env_name(), 
-	                                         this -> cidx(), seed,
-											  nlohmann::json());
+	auto response = this -> api_server_.reset_raw(this->env_name(), 
+	                                              this -> cidx(), seed,
+											      reset_options_to_json_(options),
+												  this -> accept_headers_());
+											  
+	this -> get_current_time_step_() = this -> decode_http_response_("/reset", response);
+    return this -> get_current_time_step_();
+}
+
+template<typename TimeStepType, typename SpaceType>
+typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type
+GymnasiumEnvBase<TimeStepType, SpaceType>::step_remote_(const action_type& action){
+	
+	auto response = this -> api_server_.step_raw(this->env_name(), 
+	                                             this -> cidx(),
+												 action,
+												 this -> accept_headers_());
 											  
-	this -> get_current_time_step_() = this->create_time_step_from_response_(response);
+	this -> get_current_time_step_() = this -> decode_http_response_("/step", response);
     return this -> get_current_time_step_();
 }
 
+template<typename TimeStepType, typename SpaceType>
+std::vector<typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type>
+GymnasiumEnvBase<TimeStepType, SpaceType>::step_sequence(const std::vector<action_type>& actions,
+                                                         uint_t max_in_flight){
+	
+	const auto responses = this -> api_server_.step_sequence_raw(this->env_name(), 
+	                                                             this -> cidx(),
+												                 actions,
+												                 this -> accept_headers_(),
+																 max_in_flight);
+	
+	std::vector<time_step_type> time_steps;
+	time_steps.reserve(responses.size());
+	
+	for(const auto& response : responses){
+		time_steps.push_back(this -> decode_http_response_("/step", response));
+	}
+	
+	if(!time_steps.empty()){
+		this -> get_current_time_step_() = time_steps.back();
+	}
+	
+	return time_steps;
+}
+
+template<typename TimeStepType, typename SpaceType>
+typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type
+GymnasiumEnvBase<TimeStepType, SpaceType>::create_time_step_from_http_response_(const HTTPResponse& response)const{
+	
+	if(wire_format::is_binary(response)){
+		return this -> create_time_step_from_binary_(response.body);
+	}
+	
+	return this -> create_time_step_from_response_(nlohmann::json::parse(response.body));
+}
+
+template<typename TimeStepType, typename SpaceType>
+typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type
+GymnasiumEnvBase<TimeStepType, SpaceType>::decode_http_response_(const std::string& endpoint,
+                                                                 const HTTPResponse& response)const{
+	
+	StopWatch watch;
+	auto time_step = this -> create_time_step_from_http_response_(response);
+	this -> api_server_.stats_collector().record_parse(this -> env_name(), endpoint, watch.elapsed());
+	return time_step;
+}
+
+
+template<typename TimeStepType, typename SpaceType>
+nlohmann::json
+GymnasiumEnvBase<TimeStepType, SpaceType>::reset_options_to_json_(const std::unordered_map<std::string, std::any>& options){
+	
+	if(options.empty()){
+		return nlohmann::json();
+	}
+	
+	nlohmann::json json = nlohmann::json::object();
+	for(const auto& [name, value] : options){
+		
+		if(value.type() == typeid(bool)){
+			json[name] = std::any_cast<bool>(value);
+		}
+		else if(value.type() == typeid(int)){
+			json[name] = std::any_cast<int>(value);
+		}
+		else if(value.type() == typeid(uint_t)){
+			json[name] = std::any_cast<uint_t>(value);
+		}
+		else if(value.type() == typeid(real_t)){
+			json[name] = std::any_cast<real_t>(value);
+		}
+		else if(value.type() == typeid(float)){
+			json[name] = std::any_cast<float>(value);
+		}
+		else if(value.type() == typeid(std::string)){
+			json[name] = std::any_cast<std::string>(value);
+		}
+		else if(value.type() == typeid(const char*)){
+			json[name] = std::any_cast<const char*>(value);
+		}
+		else if(value.type() == typeid(nlohmann::json)){
+			json[name] = std::any_cast<nlohmann::json>(value);
+		}
+		
+		// any other option stays on the client as
+		// it did before the options were sent
+	}
+	
+	return json.empty() ? nlohmann::json() : json;
+}
 
 template<typename TimeStepType, typename SpaceType>
 std::string 
@@ -210,6 +419,118 @@ GymnasiumEnvBase<TimeStepType, SpaceType>::get_url()const{
 }
 
 
+template<typename TimeStepType, typename SpaceType>
+std::future<typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type>
+GymnasiumEnvBase<TimeStepType, SpaceType>::async_step(const action_type& action){
+	
+	if(!this->is_created()){
+#ifdef RLENVSCPP_DEBUG
+		assert(this->is_created() && "Environment has not been created");
+#endif
+		std::promise<time_step_type> promise;
+		promise.set_value(time_step_type());
+		return promise.get_future();
+	}
+	
+	if(this -> reset_on_step_()){
+		return async_reset(42, std::unordered_map<std::string, std::any>());
+	}
+	
+	// the event loop thread only delivers the response. It is decoded
+	// and stored as the current time step on the thread calling get()
+	auto response = this -> api_server_.async_step_raw(this -> env_name(), this -> cidx(), action,
+	                                                   this -> accept_headers_());
+	
+	return std::async(std::launch::deferred, [this, response=std::move(response)]() mutable{
+		this -> get_current_time_step_() = this -> decode_http_response_("/step", response.get());
+		return this -> get_current_time_step_();
+	});
+}
+
+template<typename TimeStepType, typename SpaceType>
+std::future<typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type>
+GymnasiumEnvBase<TimeStepType, SpaceType>::async_reset(uint_t seed,
+                                                       const std::unordered_map<std::string, std::any>& options){
+	
+	if(!this->is_created()){
+#ifdef RLENVSCPP_DEBUG
+		assert(this->is_created() && "Environment has not been created");
+#endif
+		std::promise<time_step_type> promise;
+		promise.set_value(time_step_type());
+		return promise.get_future();
+	}
+	
+	auto response = this -> api_server_.async_reset_raw(this -> env_name(), this -> cidx(), seed,
+	                                                    reset_options_to_json_(options),
+	                                                    this -> accept_headers_());
+	
+	return std::async(std::launch::deferred, [this, response=std::move(response)]() mutable{
+		this -> get_current_time_step_() = this -> decode_http_response_("/reset", response.get());
+		return this -> get_current_time_step_();
+	});
+}
+
+template<typename TimeStepType, typename SpaceType>
+template<typename EnvType>
+std::vector<typename GymnasiumEnvBase<TimeStepType, SpaceType>::time_step_type>
+GymnasiumEnvBase<TimeStepType, SpaceType>::step_batch(std::vector<EnvType>& envs,
+                                                      const std::vector<action_type>& actions){
+	
+	static_assert(std::is_base_of_v<GymnasiumEnvBase<TimeStepType, SpaceType>, EnvType>,
+	              "EnvType should derive from GymnasiumEnvBase");
+	
+	if(envs.size() != actions.size()){
+		throw std::logic_error("The number of actions does not match the number of environments");
+	}
+	
+	std::vector<time_step_type> time_steps(envs.size());
+	
+	if(envs.empty()){
+		return time_steps;
+	}
+	
+	// the indices in envs of the copies that are stepped
+	std::vector<uint_t> stepped;
+	stepped.reserve(envs.size());
+	
+	std::vector<std::pair<uint_t, action_type> > batch;
+	batch.reserve(envs.size());
+	
+	for(uint_t i=0; i<envs.size(); ++i){
+		
+		GymnasiumEnvBase<TimeStepType, SpaceType>& env = envs[i];
+		
+#ifdef RLENVSCPP_DEBUG
+		assert(env.is_created() && "Environment has not been created");
+#endif
+		
+		if(env.reset_on_step_()){
+			time_steps[i] = env.reset(42, std::unordered_map<std::string, std::any>());
+			continue;
+		}
+		
+		stepped.push_back(i);
+		batch.push_back({env.cidx(), actions[i]});
+	}
+	
+	if(batch.empty()){
+		return time_steps;
+	}
+	
+	GymnasiumEnvBase<TimeStepType, SpaceType>& first = envs[stepped[0]];
+	auto response = first.api_server_.step_batch(first.env_name(), batch);
+	
+	for(uint_t i=0; i<stepped.size(); ++i){
+		
+		GymnasiumEnvBase<TimeStepType, SpaceType>& env = envs[stepped[i]];
+		env.get_current_time_step_() = env.create_time_step_from_response_(response[i]);
+		time_steps[stepped[i]] = env.get_current_time_step_();
+	}
+	
+	return time_steps;
+}
+
 
 } // gymnasium
 } // envs
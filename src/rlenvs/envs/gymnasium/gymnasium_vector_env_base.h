@@ -14,6 +14,8 @@
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/env_types.h"
 #include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/api_server/shm_channel.h"
+#include "rlenvs/envs/api_server/wire_format.h"
 #include "rlenvs/extern/nlohmann/json/json.hpp"
 
 #ifdef RLENVSCPP_DEBUG
@@ -21,6 +23,8 @@
 #endif
 
 #include <stdexcept>
+#include <memory>
+#include <type_traits>
 	
 
 namespace rlenvscpp{
@@ -84,6 +88,26 @@ public:
 	///
 	bool get_reset_if_any_done()const noexcept{return reset_if_any_done_;}
 	
+	///
+	/// \brief Ask the server to write the time steps of this environment
+	/// into a shared memory ring with n_slots slots and map it. The HTTP
+	/// requests are then only used for control and every time step is
+	/// copied out of the ring when its response arrives. Only servers
+	/// on the same host support this
+	///
+	void attach_shared_memory(uint_t n_slots=8);
+	
+	///
+	/// \brief Go back to receiving the time steps over HTTP
+	///
+	void detach_shared_memory();
+	
+	///
+	/// \brief Returns true if the time steps are received
+	/// over shared memory
+	///
+	bool is_shared_memory_attached()const noexcept{return shm_channel_ != nullptr;}
+	
 protected:
 	
 	///
@@ -94,6 +118,26 @@ protected:
 	                    const std::string& name);
 						
 	GymnasiumVecEnvBase(const GymnasiumVecEnvBase& other);
+	
+	///
+	/// \brief The vector environment is reset on step
+	/// only if reset_if_any_done is set
+	///
+	virtual bool reset_on_step_()const override{
+		return reset_if_any_done_ && this -> get_current_time_step_().last();
+	}
+	
+	///
+	/// \brief Read the time step from the shared memory ring if the
+	/// server wrote it there
+	///
+	virtual time_step_type create_time_step_from_http_response_(const HTTPResponse& response)const override;
+	
+	///
+	/// \brief Also ask for the time step to be written into
+	/// shared memory if attached
+	///
+	virtual http_header_fields accept_headers_()const override;
 					  
 private:
 	
@@ -106,6 +150,11 @@ private:
 	///
 	bool reset_if_any_done_{false};
 	
+	///
+	/// \brief The shared memory ring the server writes the time steps to
+	///
+	std::shared_ptr<SharedMemoryChannel> shm_channel_;
+	
 };
 
 
@@ -123,9 +172,69 @@ GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::GymnasiumVecEnvBase(const Gy
 :
 GymnasiumEnvBase<VectorTimeStepType, SpaceType>(other),
 n_envs_(other.n_envs_),
-reset_if_any_done_(other.reset_if_any_done_)
+reset_if_any_done_(other.reset_if_any_done_),
+shm_channel_(other.shm_channel_)
 {}
 
+template<typename VectorTimeStepType, typename SpaceType>
+void 
+GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::attach_shared_memory(uint_t n_slots){
+	
+	auto response = this -> get_api_server().attach_shm(this -> env_name(), this -> cidx(), n_slots);
+	shm_channel_ = SharedMemoryChannel::open(response["name"].template get<std::string>());
+}
+
+template<typename VectorTimeStepType, typename SpaceType>
+void 
+GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::detach_shared_memory(){
+	
+	if(shm_channel_ == nullptr){
+		return;
+	}
+	
+	this -> get_api_server().detach_shm(this -> env_name(), this -> cidx());
+	shm_channel_.reset();
+}
+
+template<typename VectorTimeStepType, typename SpaceType>
+http_header_fields 
+GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::accept_headers_()const{
+	
+	auto headers = GymnasiumEnvBase<VectorTimeStepType, SpaceType>::accept_headers_();
+	
+	if(shm_channel_ == nullptr){
+		return headers;
+	}
+	
+	// the shared memory slot is preferred over any other encoding
+	for(auto& [name, value] : headers){
+		if(name == "Accept"){
+			value = SHM_SLOT_MEDIA_TYPE + ", " + value;
+			return headers;
+		}
+	}
+	
+	headers.push_back({"Accept", SHM_SLOT_MEDIA_TYPE});
+	
+	return headers;
+}
+
+template<typename VectorTimeStepType, typename SpaceType>
+typename GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::time_step_type 
+GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::create_time_step_from_http_response_(const HTTPResponse& response)const{
+	
+	if constexpr(std::is_same_v<state_type, std::vector<real_t> >){
+		
+		if(shm_channel_ != nullptr && wire_format::has_media_type(response, SHM_SLOT_MEDIA_TYPE)){
+			
+			auto j = nlohmann::json::parse(response.body);
+			return shm_channel_ -> template read<state_type>(j["seq"].template get<std::uint64_t>());
+		}
+	}
+	
+	return GymnasiumEnvBase<VectorTimeStepType, SpaceType>::create_time_step_from_http_response_(response);
+}
+
 template<typename VectorTimeStepType, typename SpaceType>
 void 
 GymnasiumVecEnvBase<VectorTimeStepType, SpaceType>::make(const std::string& version,
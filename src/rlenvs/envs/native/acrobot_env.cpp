@@ -0,0 +1,193 @@
+#include "rlenvs/envs/native/acrobot_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+template<typename StateType>
+const std::string BasicAcrobot<StateType>::name = "Acrobot";
+
+template<typename StateType>
+BasicAcrobot<StateType>::BasicAcrobot()
+:
+base_type(0, name)
+{}
+
+template<typename StateType>
+BasicAcrobot<StateType>::BasicAcrobot(uint_t cidx)
+:
+base_type(cidx, name)
+{}
+
+template<typename StateType>
+void
+BasicAcrobot<StateType>::make(const std::string& version,
+                              const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("Acrobot version " + version + " is not supported");
+	}
+
+	auto dynamics_itr = options.find("book_or_nips");
+	if(dynamics_itr != options.end()){
+
+		const auto dynamics = std::any_cast<std::string>(dynamics_itr -> second);
+
+		if(dynamics == "book"){
+			dynamics_ = AcrobotDynamics::BOOK;
+		}
+		else if(dynamics == "nips"){
+			dynamics_ = AcrobotDynamics::NIPS;
+		}
+		else{
+			throw std::logic_error("Acrobot dynamics " + dynamics + " are not known. Use book or nips");
+		}
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+template<typename StateType>
+typename BasicAcrobot<StateType>::time_step_type
+BasicAcrobot<StateType>::reset(uint_t seed,
+                               const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	reset_state_();
+	return store_time_step_(TimeStepTp::FIRST, 0.0);
+}
+
+template<typename StateType>
+typename BasicAcrobot<StateType>::time_step_type
+BasicAcrobot<StateType>::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		reset_state_();
+		return store_time_step_(TimeStepTp::FIRST, 0.0);
+	}
+
+	state_ = integrate(state_, action, dynamics_);
+	n_steps_ += 1;
+
+	const bool terminated = is_terminal(state_[0], state_[1]);
+	is_finished_ = terminated || n_steps_ >= max_episode_steps_;
+
+	return store_time_step_(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                        terminated ? 0.0 : -1.0);
+}
+
+template<typename StateType>
+void
+BasicAcrobot<StateType>::close(){
+
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<typename StateType>
+typename BasicAcrobot<StateType>::snapshot_type
+BasicAcrobot<StateType>::snapshot()const{
+
+	return {{state_[0], state_[1], state_[2], state_[3]}, n_steps_, is_finished_};
+}
+
+template<typename StateType>
+void
+BasicAcrobot<StateType>::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = raw_state_type(snapshot.state[0], snapshot.state[1], snapshot.state[2], snapshot.state[3]);
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+template<typename StateType>
+BasicAcrobot<StateType>
+BasicAcrobot<StateType>::make_copy(uint_t cidx)const{
+
+	BasicAcrobot copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["book_or_nips"] = std::string(dynamics_ == AcrobotDynamics::BOOK ? "book" : "nips");
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+template<typename StateType>
+typename BasicAcrobot<StateType>::state_type
+BasicAcrobot<StateType>::observation(const raw_state_type& state){
+
+	return make_space_item<state_type>(observation_values_(state));
+}
+
+template<typename StateType>
+std::array<real_t, 6>
+BasicAcrobot<StateType>::observation_values_(const raw_state_type& state){
+
+	return std::array<real_t, 6>{std::cos(state[0]), std::sin(state[0]),
+	                             std::cos(state[1]), std::sin(state[1]),
+	                             state[2], state[3]};
+}
+
+template<typename StateType>
+const typename BasicAcrobot<StateType>::time_step_type&
+BasicAcrobot<StateType>::store_time_step_(TimeStepTp type, real_t reward){
+
+	auto& time_step = this -> get_current_time_step_();
+	assign_space_item(time_step.mutable_observation(), observation_values_(state_));
+	time_step.update(type, reward, 1.0);
+	return time_step;
+}
+
+template<typename StateType>
+void
+BasicAcrobot<StateType>::reset_state_(){
+
+	for(uint_t i=0; i<4; ++i){
+		state_[i] = -0.1 + 0.2 * generator_.uniform();
+	}
+
+	n_steps_ = 0;
+	is_finished_ = false;
+}
+
+template class BasicAcrobot<std::vector<real_t> >;
+template class BasicAcrobot<std::array<real_t, 6> >;
+template class BasicAcrobot<Eigen::Matrix<real_t, 6, 1> >;
+
+}
+}
+}
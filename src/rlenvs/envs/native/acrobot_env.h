@@ -0,0 +1,385 @@
+/**
+ * Native C++ implementation of the Acrobot environment. It follows
+ * the equations of the Gymnasium Acrobot-v1 environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/classic_control/acrobot.py
+ * but runs in-process so that no request is sent to the REST API server.
+ * The equations of motion are integrated with one step of the classical
+ * fourth order Runge-Kutta method per time step, like the Python code.
+ *
+ * Observation: [cos(theta1), sin(theta1), cos(theta2), sin(theta2),
+ * angular velocity 1, angular velocity 2]
+ * Actions: 0 apply -1 torque, 1 apply no torque, 2 apply +1 torque
+ * Reward: -1 for every step that does not reach the goal, 0 otherwise
+ * Episode termination: -cos(theta1) - cos(theta1 + theta2) > 1
+ * Episode truncation: 500 steps
+ *
+ * The dynamics follow Sutton and Barto's book by default. The "book_or_nips"
+ * option selects those of the NIPS paper instead, see AcrobotDynamics.
+ *
+ * FixedAcrobot and EigenAcrobot return the six observation values in a
+ * std::array or an Eigen vector, so building a time step does not allocate.
+ *
+ * See AcrobotV for stepping many instances at once.
+ */
+
+#ifndef NATIVE_ACROBOT_ENV_H
+#define NATIVE_ACROBOT_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+#include "rlenvs/utils/xoshiro256.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+#include <algorithm>
+#include <cmath>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief The equations of motion of the Acrobot. BOOK are those
+/// of Sutton and Barto's book and NIPS those of the NIPS paper that
+/// omit the term -m2 * l1 * lc2 * dtheta1^2 * sin(theta2)
+///
+enum class AcrobotDynamics: int {BOOK=0, NIPS=1};
+
+///
+/// \brief Snapshot of the Acrobot environment
+///
+struct AcrobotSnapshot
+{
+	std::array<real_t, 4> state;
+	uint_t n_steps;
+	bool is_finished;
+};
+
+///
+/// \brief In-process Acrobot environment. StateType is the type of
+/// the observation
+///
+template<typename StateType>
+class BasicAcrobot final: public EnvBase<TimeStep<StateType>,
+                                         ContinuousVectorStateDiscreteActionEnv<6, 3, 0, real_t, StateType> >,
+                          public with_snapshot_mixin<AcrobotSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The constants of the Gymnasium implementation
+	///
+	static constexpr real_t DT = 0.2;
+	static constexpr real_t LINK_LENGTH_1 = 1.0;
+	static constexpr real_t LINK_MASS_1 = 1.0;
+	static constexpr real_t LINK_MASS_2 = 1.0;
+	static constexpr real_t LINK_COM_POS_1 = 0.5;
+	static constexpr real_t LINK_COM_POS_2 = 0.5;
+	static constexpr real_t LINK_MOI = 1.0;
+	static constexpr real_t GRAVITY = 9.8;
+	static constexpr real_t PI = 3.14159265358979323846;
+	static constexpr real_t MAX_VEL_1 = 4.0 * PI;
+	static constexpr real_t MAX_VEL_2 = 9.0 * PI;
+
+	///
+	/// \brief The internal state [theta1, theta2, dtheta1, dtheta2]
+	///
+	typedef RealColVec4d raw_state_type;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<StateType>,
+	                ContinuousVectorStateDiscreteActionEnv<6, 3, 0, real_t, StateType> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef AcrobotSnapshot snapshot_type;
+
+	///
+	/// \brief The time derivative of the state under the given torque
+	///
+	static raw_state_type dsdt(const raw_state_type& state, real_t torque,
+	                           AcrobotDynamics dynamics)noexcept;
+
+	///
+	/// \brief Advance the state by one time step. The angles are
+	/// wrapped to [-pi, pi) and the angular velocities are clipped
+	///
+	static raw_state_type integrate(const raw_state_type& state, uint_t action,
+	                                AcrobotDynamics dynamics)noexcept;
+
+	///
+	/// \brief Advance n acrobots stored as separate arrays of the
+	/// angles and the angular velocities by one time step
+	///
+	static void integrate(real_t* theta1s, real_t* theta2s,
+	                      real_t* dtheta1s, real_t* dtheta2s,
+	                      const uint_t* actions, uint_t n,
+	                      AcrobotDynamics dynamics)noexcept;
+
+	///
+	/// \brief Returns true if the free end is above the target height
+	///
+	static bool is_terminal(real_t theta1, real_t theta2)noexcept{
+		return -std::cos(theta1) - std::cos(theta2 + theta1) > 1.0;
+	}
+
+	///
+	/// \brief Constructor
+	///
+	BasicAcrobot();
+
+	///
+	/// \brief Constructor
+	///
+	explicit BasicAcrobot(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	BasicAcrobot(const BasicAcrobot& other)=default;
+
+	///
+	/// \brief make. Build the environment. The options may contain
+	/// "book_or_nips", either "book" or "nips", and "max_episode_steps".
+	/// Throws std::logic_error if the version is not v1 or the dynamics
+	/// are not known
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The angles and the angular
+	/// velocities are drawn uniformly from [-0.1, 0.1]
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief step. Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	BasicAcrobot make_copy(uint_t cidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief The internal state
+	///
+	const raw_state_type& state()const noexcept{return state_;}
+
+	///
+	/// \brief The equations of motion
+	///
+	AcrobotDynamics dynamics()const noexcept{return dynamics_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief The observation of the given internal state
+	///
+	static state_type observation(const raw_state_type& state);
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	AcrobotDynamics dynamics_{AcrobotDynamics::BOOK};
+	uint_t max_episode_steps_{500};
+	uint_t n_steps_{0};
+	bool is_finished_{true};
+	raw_state_type state_{raw_state_type::Zero()};
+
+	///
+	/// \brief The generator of the initial states
+	///
+	utils::Xoshiro256 generator_;
+
+	///
+	/// \brief Draw a new initial state
+	///
+	void reset_state_();
+
+	///
+	/// \brief The values of the observation of the given internal state
+	///
+	static std::array<real_t, 6> observation_values_(const raw_state_type& state);
+
+	///
+	/// \brief Refill the current time step in place with the current
+	/// state and return it. The observation keeps its capacity
+	///
+	const time_step_type& store_time_step_(TimeStepTp type, real_t reward);
+};
+
+template<typename StateType>
+inline
+typename BasicAcrobot<StateType>::raw_state_type
+BasicAcrobot<StateType>::dsdt(const raw_state_type& state, real_t torque,
+                              AcrobotDynamics dynamics)noexcept{
+
+	constexpr real_t m1 = LINK_MASS_1;
+	constexpr real_t m2 = LINK_MASS_2;
+	constexpr real_t l1 = LINK_LENGTH_1;
+	constexpr real_t lc1 = LINK_COM_POS_1;
+	constexpr real_t lc2 = LINK_COM_POS_2;
+	constexpr real_t I1 = LINK_MOI;
+	constexpr real_t I2 = LINK_MOI;
+	constexpr real_t g = GRAVITY;
+
+	const auto theta1 = state[0];
+	const auto theta2 = state[1];
+	const auto dtheta1 = state[2];
+	const auto dtheta2 = state[3];
+
+	const auto cos_theta2 = std::cos(theta2);
+	const auto sin_theta2 = std::sin(theta2);
+
+	const auto d1 = m1 * lc1 * lc1 + m2 * (l1 * l1 + lc2 * lc2 + 2.0 * l1 * lc2 * cos_theta2) + I1 + I2;
+	const auto d2 = m2 * (lc2 * lc2 + l1 * lc2 * cos_theta2) + I2;
+	const auto phi2 = m2 * lc2 * g * std::cos(theta1 + theta2 - PI / 2.0);
+	const auto phi1 = -m2 * l1 * lc2 * dtheta2 * dtheta2 * sin_theta2
+	                  - 2.0 * m2 * l1 * lc2 * dtheta2 * dtheta1 * sin_theta2
+	                  + (m1 * lc1 + m2 * l1) * g * std::cos(theta1 - PI / 2.0) + phi2;
+
+	// the book adds the centrifugal term of the first link
+	const auto centrifugal = dynamics == AcrobotDynamics::BOOK ? m2 * l1 * lc2 * dtheta1 * dtheta1 * sin_theta2 : 0.0;
+	const auto ddtheta2 = (torque + d2 / d1 * phi1 - centrifugal - phi2) / (m2 * lc2 * lc2 + I2 - d2 * d2 / d1);
+	const auto ddtheta1 = -(d2 * ddtheta2 + phi1) / d1;
+
+	return raw_state_type(dtheta1, dtheta2, ddtheta1, ddtheta2);
+}
+
+template<typename StateType>
+inline
+typename BasicAcrobot<StateType>::raw_state_type
+BasicAcrobot<StateType>::integrate(const raw_state_type& state, uint_t action,
+                                   AcrobotDynamics dynamics)noexcept{
+
+	const auto torque = static_cast<real_t>(action) - 1.0;
+
+	const raw_state_type k1 = dsdt(state, torque, dynamics);
+	const raw_state_type k2 = dsdt(state + 0.5 * DT * k1, torque, dynamics);
+	const raw_state_type k3 = dsdt(state + 0.5 * DT * k2, torque, dynamics);
+	const raw_state_type k4 = dsdt(state + DT * k3, torque, dynamics);
+
+	raw_state_type next = state + DT / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+
+	// wrap the angles to [-pi, pi)
+	next[0] -= 2.0 * PI * std::floor((next[0] + PI) / (2.0 * PI));
+	next[1] -= 2.0 * PI * std::floor((next[1] + PI) / (2.0 * PI));
+	next[2] = std::clamp(next[2], -MAX_VEL_1, MAX_VEL_1);
+	next[3] = std::clamp(next[3], -MAX_VEL_2, MAX_VEL_2);
+	return next;
+}
+
+template<typename StateType>
+inline
+void
+BasicAcrobot<StateType>::integrate(real_t* theta1s, real_t* theta2s,
+                                   real_t* dtheta1s, real_t* dtheta2s,
+                                   const uint_t* actions, uint_t n,
+                                   AcrobotDynamics dynamics)noexcept{
+
+	for(uint_t i=0; i<n; ++i){
+
+		const auto next = integrate(raw_state_type(theta1s[i], theta2s[i], dtheta1s[i], dtheta2s[i]),
+		                            actions[i], dynamics);
+		theta1s[i] = next[0];
+		theta2s[i] = next[1];
+		dtheta1s[i] = next[2];
+		dtheta2s[i] = next[3];
+	}
+}
+
+///
+/// \brief Acrobot with std::vector observations
+///
+typedef BasicAcrobot<std::vector<real_t> > Acrobot;
+
+///
+/// \brief Acrobot with std::array observations held inline
+///
+typedef BasicAcrobot<std::array<real_t, 6> > FixedAcrobot;
+
+///
+/// \brief Acrobot with Eigen observations held inline
+///
+typedef BasicAcrobot<Eigen::Matrix<real_t, 6, 1> > EigenAcrobot;
+
+}
+}
+}
+
+#endif // NATIVE_ACROBOT_ENV_H
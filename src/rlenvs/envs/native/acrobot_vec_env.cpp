@@ -0,0 +1,247 @@
+#include "rlenvs/envs/native/acrobot_vec_env.h"
+#include "rlenvs/envs/vector_time_step.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+const std::string AcrobotV::name = "AcrobotV";
+
+AcrobotV::AcrobotV()
+:
+base_type(0, AcrobotV::name)
+{}
+
+AcrobotV::AcrobotV(uint_t cidx)
+:
+base_type(cidx, AcrobotV::name)
+{}
+
+void
+AcrobotV::make(const std::string& version,
+                   const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("Acrobot version " + version + " is not supported");
+	}
+
+	auto n_envs_itr = options.find("num_envs");
+	if(n_envs_itr == options.end()){
+		throw std::logic_error("num_envs variable is not provided");
+	}
+
+	n_envs_ = std::any_cast<uint_t>(n_envs_itr -> second);
+
+	auto dynamics_itr = options.find("book_or_nips");
+	if(dynamics_itr != options.end()){
+
+		const auto dynamics = std::any_cast<std::string>(dynamics_itr -> second);
+
+		if(dynamics == "book"){
+			dynamics_ = AcrobotDynamics::BOOK;
+		}
+		else if(dynamics == "nips"){
+			dynamics_ = AcrobotDynamics::NIPS;
+		}
+		else{
+			throw std::logic_error("Acrobot dynamics " + dynamics + " are not known. Use book or nips");
+		}
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	theta1s_.assign(n_envs_, 0.0);
+	theta2s_.assign(n_envs_, 0.0);
+	dtheta1s_.assign(n_envs_, 0.0);
+	dtheta2s_.assign(n_envs_, 0.0);
+	rewards_.assign(n_envs_, 0.0);
+	n_steps_.assign(n_envs_, 0);
+	types_.assign(n_envs_, TimeStepTp::LAST);
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+AcrobotV::time_step_type
+AcrobotV::reset(uint_t seed,
+                    const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	return time_step_();
+}
+
+void
+AcrobotV::reset_into(uint_t seed, batch_time_step_type& batch){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	write_batch_(batch);
+}
+
+AcrobotV::time_step_type
+AcrobotV::step(const action_type& actions){
+
+	step_state(actions);
+	return time_step_();
+}
+
+void
+AcrobotV::step_into(std::span<const uint_t> actions, batch_time_step_type& batch){
+
+	step_state(actions);
+	write_batch_(batch);
+}
+
+void
+AcrobotV::step_state(std::span<const uint_t> actions){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	if(actions.size() != n_envs_){
+		throw std::logic_error("The number of actions does not match the number of environments");
+	}
+
+	// the finished instances are reset instead of stepped. The runs
+	// of live instances in between are integrated in one call each
+	uint_t begin = 0;
+	for(uint_t i=0; i<=n_envs_; ++i){
+
+		if(i < n_envs_ && types_[i] != TimeStepTp::LAST){
+			continue;
+		}
+
+		Acrobot::integrate(theta1s_.data() + begin, theta2s_.data() + begin,
+		                   dtheta1s_.data() + begin, dtheta2s_.data() + begin,
+		                   actions.data() + begin, i - begin, dynamics_);
+
+		for(uint_t j=begin; j<i; ++j){
+
+			n_steps_[j] += 1;
+
+			const bool terminated = Acrobot::is_terminal(theta1s_[j], theta2s_[j]);
+			rewards_[j] = terminated ? 0.0 : -1.0;
+			types_[j] = terminated || n_steps_[j] >= max_episode_steps_ ? TimeStepTp::LAST : TimeStepTp::MID;
+		}
+
+		if(i < n_envs_){
+			reset_instance_(i);
+		}
+
+		begin = i + 1;
+	}
+}
+
+void
+AcrobotV::close(){
+
+	theta1s_.clear();
+	theta2s_.clear();
+	dtheta1s_.clear();
+	dtheta2s_.clear();
+	rewards_.clear();
+	n_steps_.clear();
+	types_.clear();
+	this -> invalidate_is_created_flag_();
+}
+
+AcrobotV
+AcrobotV::make_copy(uint_t cidx)const{
+
+	AcrobotV copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs_;
+	options["book_or_nips"] = std::string(dynamics_ == AcrobotDynamics::BOOK ? "book" : "nips");
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+void
+AcrobotV::reset_instance_(uint_t i)noexcept{
+
+	theta1s_[i] = -0.1 + 0.2 * generator_.uniform();
+	theta2s_[i] = -0.1 + 0.2 * generator_.uniform();
+	dtheta1s_[i] = -0.1 + 0.2 * generator_.uniform();
+	dtheta2s_[i] = -0.1 + 0.2 * generator_.uniform();
+	rewards_[i] = 0.0;
+	n_steps_[i] = 0;
+	types_[i] = TimeStepTp::FIRST;
+}
+
+void
+AcrobotV::reset_instances_(uint_t seed)noexcept{
+
+	generator_.seed(seed);
+	for(uint_t i=0; i<n_envs_; ++i){
+		reset_instance_(i);
+	}
+}
+
+void
+AcrobotV::write_observations_(std::span<real_t> obs)const noexcept{
+
+	// the observations are interleaved in row major order
+	for(uint_t i=0; i<n_envs_; ++i){
+		obs[6 * i] = std::cos(theta1s_[i]);
+		obs[6 * i + 1] = std::sin(theta1s_[i]);
+		obs[6 * i + 2] = std::cos(theta2s_[i]);
+		obs[6 * i + 3] = std::sin(theta2s_[i]);
+		obs[6 * i + 4] = dtheta1s_[i];
+		obs[6 * i + 5] = dtheta2s_[i];
+	}
+}
+
+void
+AcrobotV::write_batch_(batch_time_step_type& batch)const{
+
+	batch.resize(n_envs_, 6);
+	std::copy(types_.begin(), types_.end(), batch.types().begin());
+	std::copy(rewards_.begin(), rewards_.end(), batch.rewards().begin());
+	std::fill(batch.discounts().begin(), batch.discounts().end(), 1.0);
+	write_observations_(batch.observations());
+}
+
+AcrobotV::time_step_type
+AcrobotV::time_step_(){
+
+	auto buffer = obs_buffers_.acquire(6 * n_envs_);
+	write_observations_(*buffer);
+
+	time_step_type time_step(types_, rewards_, std::vector<real_t>(n_envs_, 1.0),
+	                         std::span<const real_t>(*buffer), 6, buffer);
+
+	// the copy assignment reuses the capacity of the stored time step
+	this -> get_current_time_step_() = time_step;
+	return time_step;
+}
+
+}
+}
+}
@@ -0,0 +1,285 @@
+/**
+ * Batch of native Acrobot environments. The state of the batch is
+ * kept in structure-of-arrays layout, one array for each angle and
+ * angular velocity, and all the instances are advanced by the same
+ * Runge-Kutta kernel. Every instance that reaches the end of its episode is
+ * reset on the following step, like the single environment does.
+ */
+
+#ifndef NATIVE_ACROBOT_VEC_ENV_H
+#define NATIVE_ACROBOT_VEC_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/space_type.h"
+#include "rlenvs/envs/vector_time_step.h"
+#include "rlenvs/envs/batch_time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/native/acrobot_env.h"
+#include "rlenvs/utils/xoshiro256.h"
+
+#include <string>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <any>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+namespace detail_{
+
+	struct AcrobotVEnv{
+
+		typedef ContinuousVectorSpace<6, real_t> state_space;
+
+		typedef state_space::space_item_type state_type;
+
+		///
+		/// \brief state space size
+		///
+		static constexpr uint_t STATE_SPACE_SIZE = state_space::size;
+
+		typedef ScalarDiscreteSpace<0, 3> action_space;
+
+		///
+		/// \brief the Action type, one action per instance
+		///
+		typedef std::vector<typename action_space::space_item_type> action_type;
+
+		///
+		/// \brief action space size
+		///
+		static constexpr uint_t ACTION_SPACE_SIZE = action_space::size;
+	};
+}
+
+///
+/// \brief Batch of in-process Acrobot environments
+///
+class AcrobotV final: public EnvBase<VectorTimeStep<detail_::AcrobotVEnv::state_type>,
+                                         detail_::AcrobotVEnv>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<VectorTimeStep<detail_::AcrobotVEnv::state_type>,
+	                detail_::AcrobotVEnv> base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief The structure-of-arrays time step filled by step_into
+	///
+	typedef BatchTimeStep<real_t> batch_time_step_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief Expose the step_into of the base class
+	///
+	using base_type::step_into;
+
+	///
+	/// \brief Constructor
+	///
+	AcrobotV();
+
+	///
+	/// \brief Constructor
+	///
+	explicit AcrobotV(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	AcrobotV(const AcrobotV& other)=default;
+
+	///
+	/// \brief make. Build the environment. The options must contain
+	/// "num_envs" and may contain "book_or_nips" and "max_episode_steps".
+	/// Throws std::logic_error if num_envs is missing, the version is not
+	/// v1 or the dynamics are not known
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset all the instances
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Step every instance with its action
+	///
+	virtual time_step_type step(const action_type& actions) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Step every instance with its action without building a
+	/// time step. Read the results with theta1s(), theta2s(), dtheta1s(),
+	/// dtheta2s(), rewards() and step_types()
+	///
+	void step_state(std::span<const uint_t> actions);
+
+	///
+	/// \brief Reset all the instances and write the time step into
+	/// the given batch. The batch is resized only if its sizes differ
+	///
+	void reset_into(uint_t seed, batch_time_step_type& batch);
+
+	///
+	/// \brief Step every instance with its action and write the time
+	/// step into the given batch. Reusing the same batch across steps
+	/// does not allocate
+	///
+	void step_into(std::span<const uint_t> actions, batch_time_step_type& batch);
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	AcrobotV make_copy(uint_t cidx)const;
+
+	///
+	/// \brief Returns the number of environments
+	///
+	uint_t get_n_envs()const noexcept{return n_envs_;}
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief The equations of motion
+	///
+	AcrobotDynamics dynamics()const noexcept{return dynamics_;}
+
+	///
+	/// \brief The angles of the first link
+	///
+	std::span<const real_t> theta1s()const noexcept{return theta1s_;}
+
+	///
+	/// \brief The angles of the second link relative to the first
+	///
+	std::span<const real_t> theta2s()const noexcept{return theta2s_;}
+
+	///
+	/// \brief The angular velocities of the first link
+	///
+	std::span<const real_t> dtheta1s()const noexcept{return dtheta1s_;}
+
+	///
+	/// \brief The angular velocities of the second link
+	///
+	std::span<const real_t> dtheta2s()const noexcept{return dtheta2s_;}
+
+	///
+	/// \brief The rewards of the last step
+	///
+	std::span<const real_t> rewards()const noexcept{return rewards_;}
+
+	///
+	/// \brief The types of the last step
+	///
+	std::span<const TimeStepTp> step_types()const noexcept{return types_;}
+
+private:
+
+	uint_t n_envs_{0};
+	AcrobotDynamics dynamics_{AcrobotDynamics::BOOK};
+	uint_t max_episode_steps_{500};
+
+	std::vector<real_t> theta1s_;
+	std::vector<real_t> theta2s_;
+	std::vector<real_t> dtheta1s_;
+	std::vector<real_t> dtheta2s_;
+	std::vector<real_t> rewards_;
+	std::vector<uint_t> n_steps_;
+	std::vector<TimeStepTp> types_;
+
+	///
+	/// \brief The generator of the initial states
+	///
+	utils::Xoshiro256 generator_;
+
+	///
+	/// \brief Reset the i-th instance
+	///
+	void reset_instance_(uint_t i)noexcept;
+
+	///
+	/// \brief Reset every instance with the given seed
+	///
+	void reset_instances_(uint_t seed)noexcept;
+
+	///
+	/// \brief Write the observations in row major order
+	///
+	void write_observations_(std::span<real_t> obs)const noexcept;
+
+	///
+	/// \brief Write the last step into the batch
+	///
+	void write_batch_(batch_time_step_type& batch)const;
+
+	///
+	/// \brief The observation buffers of the returned time steps
+	///
+	mutable ObservationBufferPool obs_buffers_;
+
+	///
+	/// \brief Build the time step of the last step and keep
+	/// a copy of it as the current time step
+	///
+	time_step_type time_step_();
+};
+
+}
+}
+}
+
+#endif // NATIVE_ACROBOT_VEC_ENV_H
@@ -0,0 +1,181 @@
+#include "rlenvs/envs/native/black_jack_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+const std::string BlackJack::name = "BlackJack";
+
+BlackJack::BlackJack()
+:
+base_type(0, BlackJack::name)
+{}
+
+BlackJack::BlackJack(uint_t cidx)
+:
+base_type(cidx, BlackJack::name)
+{}
+
+void
+BlackJack::make(const std::string& version,
+                const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("BlackJack version " + version + " is not supported");
+	}
+
+	auto natural_itr = options.find("natural");
+	if(natural_itr != options.end()){
+		is_natural_ = std::any_cast<bool>(natural_itr -> second);
+	}
+
+	auto sab_itr = options.find("sab");
+	if(sab_itr != options.end()){
+		is_sab_ = std::any_cast<bool>(sab_itr -> second);
+	}
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+BlackJack::time_step_type
+BlackJack::reset(uint_t seed,
+                 const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	deal_();
+	this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state(), 1.0);
+	return this -> get_current_time_step_();
+}
+
+BlackJack::time_step_type
+BlackJack::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		deal_();
+		this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state(), 1.0);
+		return this -> get_current_time_step_();
+	}
+
+	real_t reward = 0.0;
+
+	// hit
+	if(action == 1){
+
+		player_.add(draw_card_());
+
+		if(player_.is_bust()){
+			is_finished_ = true;
+			reward = -1.0;
+		}
+	}
+	else{
+
+		is_finished_ = true;
+		while(dealer_.sum_hand() < 17){
+			dealer_.add(draw_card_());
+		}
+
+		const auto player_score = player_.score();
+		const auto dealer_score = dealer_.score();
+		reward = player_score > dealer_score ? 1.0 : (player_score < dealer_score ? -1.0 : 0.0);
+
+		if(is_sab_ && player_.is_natural() && !dealer_.is_natural()){
+			reward = 1.0;
+		}
+		else if(!is_sab_ && is_natural_ && player_.is_natural() && reward == 1.0){
+			reward = 1.5;
+		}
+	}
+
+	this -> get_current_time_step_() = time_step_type(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                                                  reward, state(), 1.0);
+	return this -> get_current_time_step_();
+}
+
+void
+BlackJack::close(){
+
+	is_finished_ = true;
+	this -> invalidate_is_created_flag_();
+}
+
+BlackJack::snapshot_type
+BlackJack::snapshot()const{
+
+	return {{player_.sum, player_.n_cards, player_.first_card, player_.has_ace},
+	        {dealer_.sum, dealer_.n_cards, dealer_.first_card, dealer_.has_ace},
+	        is_finished_};
+}
+
+void
+BlackJack::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	player_.sum = snapshot.player.sum;
+	player_.n_cards = snapshot.player.n_cards;
+	player_.first_card = snapshot.player.first_card;
+	player_.has_ace = snapshot.player.has_ace;
+
+	dealer_.sum = snapshot.dealer.sum;
+	dealer_.n_cards = snapshot.dealer.n_cards;
+	dealer_.first_card = snapshot.dealer.first_card;
+	dealer_.has_ace = snapshot.dealer.has_ace;
+
+	is_finished_ = snapshot.is_finished;
+}
+
+BlackJack
+BlackJack::make_copy(uint_t cidx)const{
+
+	BlackJack copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["natural"] = is_natural_;
+	options["sab"] = is_sab_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+void
+BlackJack::deal_(){
+
+	player_ = Hand();
+	dealer_ = Hand();
+
+	dealer_.add(draw_card_());
+	dealer_.add(draw_card_());
+	player_.add(draw_card_());
+	player_.add(draw_card_());
+
+	is_finished_ = false;
+}
+
+}
+}
+}
@@ -0,0 +1,317 @@
+/**
+ * Native C++ implementation of the Blackjack environment. It follows
+ * the rules of the Gymnasium Blackjack-v1 environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/toy_text/blackjack.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * Cards are drawn with replacement from an infinite deck using the
+ * xoshiro256++ generator.
+ *
+ * Actions: 0 stick, 1 hit
+ * Observation: (player_sum * 11 + dealer_card) * 2 + usable_ace,
+ * see BlackJack::encode() and BlackJack::decode()
+ * Reward: +1 win, 0 draw, -1 loss. With the natural option a winning
+ * natural blackjack earns +1.5. With the sab option, which follows
+ * Sutton and Barto and ignores natural, a natural blackjack wins unless
+ * the dealer also has one
+ * Episode termination: the player sticks or goes bust
+ */
+
+#ifndef NATIVE_BLACK_JACK_ENV_H
+#define NATIVE_BLACK_JACK_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+#include "rlenvs/utils/xoshiro256.h"
+
+#include <string>
+#include <unordered_map>
+#include <any>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief The decoded Blackjack observation
+///
+struct BlackJackState
+{
+	uint_t player_sum;
+	uint_t dealer_card;
+	bool usable_ace;
+};
+
+///
+/// \brief Snapshot of the Blackjack environment
+///
+struct BlackJackSnapshot
+{
+	///
+	/// \brief The cards of a hand
+	///
+	struct Hand
+	{
+		uint_t sum;
+		uint_t n_cards;
+		uint_t first_card;
+		bool has_ace;
+	};
+
+	Hand player;
+	Hand dealer;
+	bool is_finished;
+};
+
+///
+/// \brief In-process Blackjack environment
+///
+class BlackJack final: public EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<704, 2, 0, 0> >,
+                       public with_snapshot_mixin<BlackJackSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<704, 2, 0, 0> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef BlackJackSnapshot snapshot_type;
+
+	///
+	/// \brief Pack the given observation into a state index. The player
+	/// sum is at most 31 and the dealer card is in [1, 10]
+	///
+	static constexpr uint_t encode(uint_t player_sum, uint_t dealer_card, bool usable_ace)noexcept{
+		return (player_sum * 11 + dealer_card) * 2 + (usable_ace ? 1 : 0);
+	}
+
+	///
+	/// \brief Unpack the given state index
+	///
+	static constexpr BlackJackState decode(uint_t sidx)noexcept{
+		return BlackJackState{sidx / 22, (sidx / 2) % 11, sidx % 2 == 1};
+	}
+
+	///
+	/// \brief Constructor
+	///
+	BlackJack();
+
+	///
+	/// \brief Constructor
+	///
+	explicit BlackJack(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	BlackJack(const BlackJack& other)=default;
+
+	///
+	/// \brief make. Builds the environment. The options may contain
+	/// "natural" and "sab", both false by default. Throws
+	/// std::logic_error if the version is not v1
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. Deals two cards to the
+	/// player and two to the dealer
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	BlackJack make_copy(uint_t cidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief Number of states
+	///
+	uint_t n_states()const noexcept{return state_space_type::size;}
+
+	///
+	/// \brief is_natural
+	///
+	bool is_natural()const noexcept{return is_natural_;}
+
+	///
+	/// \brief is_sab
+	///
+	bool is_sab()const noexcept{return is_sab_;}
+
+	///
+	/// \brief The current observation
+	///
+	uint_t state()const noexcept;
+
+	///
+	/// \brief The sum of the dealer hand
+	///
+	uint_t dealer_sum()const noexcept{return dealer_.sum_hand();}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	///
+	/// \brief A hand. Only the quantities the rules
+	/// need are kept rather than the cards
+	///
+	struct Hand
+	{
+		uint_t sum{0};
+		uint_t n_cards{0};
+		uint_t first_card{0};
+		bool has_ace{false};
+
+		void add(uint_t card)noexcept;
+		bool usable_ace()const noexcept{return has_ace && sum + 10 <= 21;}
+		uint_t sum_hand()const noexcept{return usable_ace() ? sum + 10 : sum;}
+		bool is_bust()const noexcept{return sum_hand() > 21;}
+		uint_t score()const noexcept{return is_bust() ? 0 : sum_hand();}
+		bool is_natural()const noexcept{return n_cards == 2 && has_ace && sum == 11;}
+	};
+
+	///
+	/// \brief Flag indicating if a natural blackjack pays 1.5
+	///
+	bool is_natural_{false};
+
+	///
+	/// \brief Flag indicating if the Sutton and Barto rules are used
+	///
+	bool is_sab_{false};
+
+	///
+	/// \brief Flag indicating that the episode has ended
+	///
+	bool is_finished_{true};
+
+	///
+	/// \brief The hands
+	///
+	Hand player_;
+	Hand dealer_;
+
+	///
+	/// \brief The card generator
+	///
+	utils::Xoshiro256 generator_;
+
+	///
+	/// \brief Draw a card from the infinite deck
+	///
+	uint_t draw_card_()noexcept;
+
+	///
+	/// \brief Deal new hands
+	///
+	void deal_();
+};
+
+inline
+void
+BlackJack::Hand::add(uint_t card)noexcept{
+
+	if(n_cards == 0){
+		first_card = card;
+	}
+
+	sum += card;
+	n_cards += 1;
+	has_ace = has_ace || card == 1;
+}
+
+inline
+uint_t
+BlackJack::draw_card_()noexcept{
+
+	// 1-9, 10 and the three face cards
+	const auto card = generator_.bounded(13) + 1;
+	return card > 10 ? 10 : card;
+}
+
+inline
+uint_t
+BlackJack::state()const noexcept{
+	return encode(player_.sum_hand(), dealer_.first_card, player_.usable_ace());
+}
+
+}
+}
+}
+
+#endif // NATIVE_BLACK_JACK_ENV_H
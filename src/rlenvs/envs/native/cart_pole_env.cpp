@@ -0,0 +1,181 @@
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+template<typename StateType>
+const std::string BasicCartPole<StateType>::name = "CartPole";
+
+template<typename StateType>
+BasicCartPole<StateType>::BasicCartPole()
+:
+base_type(0, name)
+{}
+
+template<typename StateType>
+BasicCartPole<StateType>::BasicCartPole(uint_t cidx)
+:
+base_type(cidx, name)
+{}
+
+template<typename StateType>
+BasicCartPole<StateType>::BasicCartPole(const BasicCartPole& other)
+:
+base_type(other),
+integrator_(other.integrator_),
+max_episode_steps_(other.max_episode_steps_),
+n_steps_(other.n_steps_),
+is_finished_(other.is_finished_),
+state_(other.state_),
+generator_(other.generator_)
+{}
+
+template<typename StateType>
+void
+BasicCartPole<StateType>::make(const std::string& version,
+                               const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version == "v1"){
+		max_episode_steps_ = 500;
+	}
+	else if(version == "v0"){
+		max_episode_steps_ = 200;
+	}
+	else{
+		throw std::logic_error("CartPole version " + version + " is not supported");
+	}
+
+	auto integrator_itr = options.find("kinematics_integrator");
+	if(integrator_itr != options.end()){
+
+		const auto integrator = std::any_cast<std::string>(integrator_itr -> second);
+		if(integrator == "euler"){
+			integrator_ = KinematicsIntegrator::EULER;
+		}
+		else if(integrator == "semi-implicit euler"){
+			integrator_ = KinematicsIntegrator::SEMI_IMPLICIT_EULER;
+		}
+		else{
+			throw std::logic_error("Kinematics integrator " + integrator + " is not supported");
+		}
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+template<typename StateType>
+typename BasicCartPole<StateType>::time_step_type
+BasicCartPole<StateType>::reset(uint_t seed,
+                                const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	reset_state_();
+
+	// refill the current time step in place so that its
+	// observation keeps its capacity
+	auto& time_step = this -> get_current_time_step_();
+	assign_space_item(time_step.mutable_observation(), state_);
+	time_step.update(TimeStepTp::FIRST, 0.0, 1.0);
+	return time_step;
+}
+
+template<typename StateType>
+typename BasicCartPole<StateType>::time_step_type
+BasicCartPole<StateType>::step(const action_type& action){
+
+	step_into(action, this -> get_current_time_step_());
+	return this -> get_current_time_step_();
+}
+
+template<typename StateType>
+void
+BasicCartPole<StateType>::step_into(const action_type& action, time_step_type& time_step){
+
+	const auto type = step_state(action);
+	assign_space_item(time_step.mutable_observation(), state_);
+	time_step.update(type, type == TimeStepTp::FIRST ? 0.0 : 1.0, 1.0);
+}
+
+template<typename StateType>
+void
+BasicCartPole<StateType>::close(){
+
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<typename StateType>
+typename BasicCartPole<StateType>::snapshot_type
+BasicCartPole<StateType>::snapshot()const{
+
+	return {state_, n_steps_, is_finished_};
+}
+
+template<typename StateType>
+void
+BasicCartPole<StateType>::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = snapshot.state;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+template<typename StateType>
+BasicCartPole<StateType>
+BasicCartPole<StateType>::make_copy(uint_t cidx)const{
+
+	BasicCartPole copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["kinematics_integrator"] = std::string(integrator_ == KinematicsIntegrator::EULER ? "euler" : "semi-implicit euler");
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+template<typename StateType>
+void
+BasicCartPole<StateType>::reset_state_(){
+
+	std::uniform_real_distribution<real_t> distribution(-0.05, 0.05);
+
+	for(auto& value : state_){
+		value = distribution(generator_);
+	}
+
+	n_steps_ = 0;
+	is_finished_ = false;
+}
+
+template class BasicCartPole<std::vector<real_t> >;
+template class BasicCartPole<std::array<real_t, 4> >;
+template class BasicCartPole<Eigen::Matrix<real_t, 4, 1> >;
+
+}
+}
+}
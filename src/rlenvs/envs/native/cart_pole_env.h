@@ -0,0 +1,383 @@
+/**
+ * Native C++ implementation of the CartPole environment. It follows
+ * the equations, thresholds and time limit of the Gymnasium CartPole-v1
+ * environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/classic_control/cartpole.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * The state and action spaces and the time step type are the same
+ * as those of rlenvscpp::envs::gymnasium::CartPole so that the two
+ * can be used interchangeably.
+ *
+ * The environment is templated on the observation type. CartPole
+ * returns std::vector observations like the REST environment does.
+ * FixedCartPole and EigenCartPole return std::array and
+ * Eigen::Matrix<real_t, 4, 1> observations that are held inline in
+ * the TimeStep, so no step allocates.
+ *
+ * Observation: [cart position, cart velocity, pole angle, pole angular velocity]
+ * Actions: 0 push the cart to the left, 1 push the cart to the right
+ * Reward: 1 for every step taken, including the termination step
+ * Episode termination: the pole angle exceeds 12 degrees or the cart
+ * position exceeds 2.4 in absolute value
+ * Episode truncation: 500 steps for v1, 200 steps for v0
+ */
+
+#ifndef NATIVE_CART_POLE_ENV_H
+#define NATIVE_CART_POLE_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+#include <random>
+#include <cmath>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief The integrator used to advance the CartPole state
+///
+enum class KinematicsIntegrator: int {EULER=0, SEMI_IMPLICIT_EULER=1};
+
+///
+/// \brief Snapshot of the CartPole environment
+///
+struct CartPoleSnapshot
+{
+	std::array<real_t, 4> state;
+	uint_t n_steps;
+	bool is_finished;
+};
+
+///
+/// \brief In-process CartPole environment. StateType is the type of
+/// the observation, see CartPole, FixedCartPole and EigenCartPole
+///
+template<typename StateType>
+class BasicCartPole final: public EnvBase<TimeStep<StateType>,
+                                          ContinuousVectorStateDiscreteActionEnv<4, 2, 0, real_t, StateType> >,
+                           public with_snapshot_mixin<CartPoleSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The physical constants of the Gymnasium implementation
+	///
+	static constexpr real_t GRAVITY = 9.8;
+	static constexpr real_t MASS_CART = 1.0;
+	static constexpr real_t MASS_POLE = 0.1;
+	static constexpr real_t TOTAL_MASS = MASS_CART + MASS_POLE;
+	static constexpr real_t LENGTH = 0.5;
+	static constexpr real_t POLE_MASS_LENGTH = MASS_POLE * LENGTH;
+	static constexpr real_t FORCE_MAG = 10.0;
+	static constexpr real_t TAU = 0.02;
+
+	///
+	/// \brief The pole angle at which the episode terminates
+	///
+	static constexpr real_t THETA_THRESHOLD_RADIANS = 12.0 * 2.0 * 3.14159265358979323846 / 360.0;
+
+	///
+	/// \brief The cart position at which the episode terminates
+	///
+	static constexpr real_t X_THRESHOLD = 2.4;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<StateType>,
+	                ContinuousVectorStateDiscreteActionEnv<4, 2, 0, real_t, StateType> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief The fixed size representation of the state
+	///
+	typedef std::array<real_t, 4> raw_state_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef CartPoleSnapshot snapshot_type;
+
+	///
+	/// \brief Advance the given state by one time step under the given action
+	///
+	static void integrate(raw_state_type& state, action_type action,
+	                      KinematicsIntegrator integrator=KinematicsIntegrator::EULER)noexcept;
+
+	///
+	/// \brief Returns true if the given state is outside the thresholds
+	///
+	static bool is_terminal(const raw_state_type& state)noexcept;
+
+	///
+	/// \brief Constructor
+	///
+	BasicCartPole();
+
+	///
+	/// \brief Constructor
+	///
+	explicit BasicCartPole(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	BasicCartPole(const BasicCartPole& other);
+
+	///
+	/// \brief make. Build the environment. The version sets the time limit,
+	/// v1 or v0. The options may contain "kinematics_integrator", either
+	/// "euler" or "semi-implicit euler", and "max_episode_steps" to
+	/// override the time limit. Throws std::logic_error for an unknown
+	/// version or integrator
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The state is drawn uniformly
+	/// from [-0.05, 0.05]
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief step. Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief Execute the action and write the time step into the given
+	/// one. The observation is refilled in place
+	///
+	virtual void step_into(const action_type& action, time_step_type& time_step) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Step in the environment without building a time step.
+	/// Returns the type of the step. The reward is 1 for MID and LAST
+	/// steps and 0 for the FIRST step. Use state() to read the observation
+	///
+	TimeStepTp step_state(const action_type& action);
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	BasicCartPole make_copy(uint_t cidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief The current state
+	///
+	const raw_state_type& state()const noexcept{return state_;}
+
+	///
+	/// \brief The number of steps in the current episode
+	///
+	uint_t n_steps()const noexcept{return n_steps_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief The integrator in use
+	///
+	KinematicsIntegrator kinematics_integrator()const noexcept{return integrator_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	///
+	/// \brief The integrator in use
+	///
+	KinematicsIntegrator integrator_{KinematicsIntegrator::EULER};
+
+	///
+	/// \brief The time limit
+	///
+	uint_t max_episode_steps_{500};
+
+	///
+	/// \brief The number of steps in the current episode
+	///
+	uint_t n_steps_{0};
+
+	///
+	/// \brief Flag indicating that the episode has ended
+	///
+	bool is_finished_{true};
+
+	///
+	/// \brief The current state
+	///
+	raw_state_type state_{0.0, 0.0, 0.0, 0.0};
+
+	///
+	/// \brief The generator of the initial states
+	///
+	std::mt19937 generator_;
+
+	///
+	/// \brief Draw a new initial state
+	///
+	void reset_state_();
+};
+
+template<typename StateType>
+inline
+void
+BasicCartPole<StateType>::integrate(raw_state_type& state, action_type action,
+                                    KinematicsIntegrator integrator)noexcept{
+
+	auto& x = state[0];
+	auto& x_dot = state[1];
+	auto& theta = state[2];
+	auto& theta_dot = state[3];
+
+	const auto force = action == 1 ? FORCE_MAG : -FORCE_MAG;
+	const auto cos_theta = std::cos(theta);
+	const auto sin_theta = std::sin(theta);
+
+	const auto temp = (force + POLE_MASS_LENGTH * theta_dot * theta_dot * sin_theta) / TOTAL_MASS;
+	const auto theta_acc = (GRAVITY * sin_theta - cos_theta * temp) /
+	                       (LENGTH * (4.0 / 3.0 - MASS_POLE * cos_theta * cos_theta / TOTAL_MASS));
+	const auto x_acc = temp - POLE_MASS_LENGTH * theta_acc * cos_theta / TOTAL_MASS;
+
+	if(integrator == KinematicsIntegrator::EULER){
+		x += TAU * x_dot;
+		x_dot += TAU * x_acc;
+		theta += TAU * theta_dot;
+		theta_dot += TAU * theta_acc;
+	}
+	else{
+		x_dot += TAU * x_acc;
+		x += TAU * x_dot;
+		theta_dot += TAU * theta_acc;
+		theta += TAU * theta_dot;
+	}
+}
+
+template<typename StateType>
+inline
+bool
+BasicCartPole<StateType>::is_terminal(const raw_state_type& state)noexcept{
+
+	return state[0] < -X_THRESHOLD || state[0] > X_THRESHOLD ||
+	       state[2] < -THETA_THRESHOLD_RADIANS || state[2] > THETA_THRESHOLD_RADIANS;
+}
+
+template<typename StateType>
+inline
+TimeStepTp
+BasicCartPole<StateType>::step_state(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		reset_state_();
+		return TimeStepTp::FIRST;
+	}
+
+	integrate(state_, action, integrator_);
+	n_steps_ += 1;
+
+	is_finished_ = is_terminal(state_) || n_steps_ >= max_episode_steps_;
+	return is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID;
+}
+
+///
+/// \brief CartPole with std::vector observations
+///
+typedef BasicCartPole<std::vector<real_t> > CartPole;
+
+///
+/// \brief CartPole with std::array observations held inline
+///
+typedef BasicCartPole<std::array<real_t, 4> > FixedCartPole;
+
+///
+/// \brief CartPole with Eigen observations held inline
+///
+typedef BasicCartPole<Eigen::Matrix<real_t, 4, 1> > EigenCartPole;
+
+}
+}
+}
+
+#endif // NATIVE_CART_POLE_ENV_H
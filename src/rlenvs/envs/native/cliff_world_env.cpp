@@ -0,0 +1,195 @@
+#include "rlenvs/envs/native/cliff_world_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+const std::string CliffWorld::name = "CliffWalking";
+
+CliffWorld::CliffWorld()
+:
+base_type(0, CliffWorld::name)
+{}
+
+CliffWorld::CliffWorld(uint_t cidx)
+:
+base_type(cidx, CliffWorld::name)
+{}
+
+CliffWorld::CliffWorld(const CliffWorld& other)
+:
+base_type(other),
+max_episode_steps_(other.max_episode_steps_),
+n_steps_(other.n_steps_),
+is_finished_(other.is_finished_),
+state_(other.state_),
+transitions_(other.transitions_)
+{}
+
+void
+CliffWorld::make(const std::string& version,
+                 const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v0" && version != "v1"){
+		throw std::logic_error("CliffWalking version " + version + " is not supported");
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	build_transitions_();
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+CliffWorld::time_step_type
+CliffWorld::reset(uint_t /*seed*/,
+                  const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = START_STATE;
+	n_steps_ = 0;
+	is_finished_ = false;
+	this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+CliffWorld::time_step_type
+CliffWorld::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		this -> get_current_time_step_() = reset();
+		return this -> get_current_time_step_();
+	}
+
+	const auto& [probability, next_state, reward, done] = transitions_[state_ * action_space_type::size + action];
+
+	state_ = next_state;
+	n_steps_ += 1;
+	is_finished_ = done || (max_episode_steps_ != 0 && n_steps_ >= max_episode_steps_);
+
+	this -> get_current_time_step_() = time_step_type(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                                                  reward, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+void
+CliffWorld::close(){
+
+	transitions_.clear();
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+CliffWorld::snapshot_type
+CliffWorld::snapshot()const{
+
+	return {state_, n_steps_, is_finished_};
+}
+
+void
+CliffWorld::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = snapshot.state;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+CliffWorld
+CliffWorld::make_copy(uint_t cidx)const{
+
+	CliffWorld copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+CliffWorld::dynamics_t
+CliffWorld::p(uint_t sidx, uint_t aidx)const{
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(sidx < state_space_type::size && aidx < action_space_type::size && "Invalid state or action");
+#endif
+
+	return dynamics_t(transitions_.data() + sidx * action_space_type::size + aidx, 1);
+}
+
+void
+CliffWorld::build_transitions_(){
+
+	transitions_.clear();
+	transitions_.reserve(state_space_type::size * action_space_type::size);
+
+	for(uint_t s=0; s<state_space_type::size; ++s){
+
+		const auto row = s / N_COLS;
+		const auto col = s % N_COLS;
+
+		for(uint_t a=0; a<action_space_type::size; ++a){
+
+			auto new_row = row;
+			auto new_col = col;
+
+			switch(a){
+				case 0:
+					new_row = row > 0 ? row - 1 : 0;
+					break;
+				case 1:
+					new_col = std::min(col + 1, N_COLS - 1);
+					break;
+				case 2:
+					new_row = std::min(row + 1, N_ROWS - 1);
+					break;
+				case 3:
+					new_col = col > 0 ? col - 1 : 0;
+					break;
+			}
+
+			const auto next_state = new_row * N_COLS + new_col;
+
+			if(is_cliff(next_state)){
+				transitions_.emplace_back(1.0, START_STATE, -100.0, false);
+			}
+			else{
+				transitions_.emplace_back(1.0, next_state, -1.0, next_state == GOAL_STATE);
+			}
+		}
+	}
+}
+
+}
+}
+}
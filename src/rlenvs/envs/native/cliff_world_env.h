@@ -0,0 +1,238 @@
+/**
+ * Native C++ implementation of the CliffWalking environment. It follows
+ * the grid and rewards of the Gymnasium CliffWalking environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/toy_text/cliff_walking.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * The board is a 4x12 grid with the start at [3, 0], the goal at [3, 11]
+ * and the cliff at [3, 1..10]. Stepping into the cliff costs -100 and
+ * returns the agent to the start. Every other step costs -1.
+ *
+ * Actions: 0 up, 1 right, 2 down, 3 left
+ * Observation: row * 12 + col
+ * Episode termination: the agent reaches the goal
+ *
+ * The moves are deterministic and the transitions of all the states
+ * and actions are computed once when make() is called.
+ */
+
+#ifndef NATIVE_CLIFF_WORLD_ENV_H
+#define NATIVE_CLIFF_WORLD_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <span>
+#include <unordered_map>
+#include <any>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief In-process CliffWalking environment
+///
+class CliffWorld final: public EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<48, 4, 0, 0> >,
+                        public with_snapshot_mixin<DiscreteStateSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The number of rows and columns of the grid
+	///
+	static constexpr uint_t N_ROWS = 4;
+	static constexpr uint_t N_COLS = 12;
+
+	///
+	/// \brief The start and the goal states
+	///
+	static constexpr uint_t START_STATE = 36;
+	static constexpr uint_t GOAL_STATE = 47;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<48, 4, 0, 0> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief A transition in the form (probability, next state, reward, done)
+	///
+	typedef std::tuple<real_t, uint_t, real_t, bool> transition_type;
+
+	///
+	/// \brief The transitions for a state and action. This is a view
+	/// into the transition model of the environment
+	///
+	typedef std::span<const transition_type> dynamics_t;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef DiscreteStateSnapshot snapshot_type;
+
+	///
+	/// \brief Constructor
+	///
+	CliffWorld();
+
+	///
+	/// \brief Constructor
+	///
+	explicit CliffWorld(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	CliffWorld(const CliffWorld& other);
+
+	///
+	/// \brief make. Builds the environment and its transition model.
+	/// The options may contain "max_episode_steps" to truncate the
+	/// episodes, by default they are not truncated. Throws
+	/// std::logic_error if the version is not v0 or v1
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The agent is placed at the start
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	CliffWorld make_copy(uint_t cidx)const;
+
+	///
+	/// \brief The transitions for the given state and action. The
+	/// view stays valid until the environment is closed
+	///
+	dynamics_t p(uint_t sidx, uint_t aidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief Number of states
+	///
+	uint_t n_states()const noexcept{return state_space_type::size;}
+
+	///
+	/// \brief Returns true if the given state is on the cliff
+	///
+	static constexpr bool is_cliff(uint_t sidx)noexcept{return sidx > START_STATE && sidx < GOAL_STATE;}
+
+	///
+	/// \brief The current state
+	///
+	uint_t state()const noexcept{return state_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	///
+	/// \brief The time limit. Zero means no limit
+	///
+	uint_t max_episode_steps_{0};
+
+	///
+	/// \brief The number of steps in the current episode
+	///
+	uint_t n_steps_{0};
+
+	///
+	/// \brief Flag indicating that the episode has ended
+	///
+	bool is_finished_{true};
+
+	///
+	/// \brief The current state
+	///
+	uint_t state_{START_STATE};
+
+	///
+	/// \brief The transition of state s and action a is transitions_[s * 4 + a]
+	///
+	std::vector<transition_type> transitions_;
+
+	///
+	/// \brief Build the transition model
+	///
+	void build_transitions_();
+};
+
+}
+}
+}
+
+#endif // NATIVE_CLIFF_WORLD_ENV_H
@@ -0,0 +1,308 @@
+#include "rlenvs/envs/native/frozen_lake_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+namespace{
+
+const std::array<std::string, 4> MAP_4x4 = {"SFFF",
+                                            "FHFH",
+                                            "FFFH",
+                                            "HFFG"};
+
+const std::array<std::string, 8> MAP_8x8 = {"SFFFFFFF",
+                                            "FFFFFFFF",
+                                            "FFFHFFFF",
+                                            "FFFFFHFF",
+                                            "FFFHFFFF",
+                                            "FHHFFFHF",
+                                            "FHFFHFHF",
+                                            "FFFHFFFG"};
+
+template<uint_t side_size>
+char
+map_tile(uint_t row, uint_t col){
+
+	if constexpr (side_size == 4){
+		return MAP_4x4[row][col];
+	}
+	else{
+		return MAP_8x8[row][col];
+	}
+}
+
+}
+
+template<uint_t side_size>
+const std::string FrozenLake<side_size>::name = "FrozenLake";
+
+template<uint_t side_size>
+FrozenLake<side_size>::FrozenLake()
+:
+base_type(0, FrozenLake<side_size>::name)
+{}
+
+template<uint_t side_size>
+FrozenLake<side_size>::FrozenLake(uint_t cidx)
+:
+base_type(cidx, FrozenLake<side_size>::name)
+{}
+
+template<uint_t side_size>
+FrozenLake<side_size>::FrozenLake(const FrozenLake<side_size>& other)
+:
+base_type(other),
+is_slippery_(other.is_slippery_),
+max_episode_steps_(other.max_episode_steps_),
+n_steps_(other.n_steps_),
+is_finished_(other.is_finished_),
+state_(other.state_),
+transitions_(other.transitions_),
+offsets_(other.offsets_),
+generator_(other.generator_)
+{}
+
+template<uint_t side_size>
+void
+FrozenLake<side_size>::make(const std::string& version,
+                            const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("FrozenLake version " + version + " is not supported");
+	}
+
+	is_slippery_ = true;
+	auto slip_itr = options.find("is_slippery");
+	if(slip_itr != options.end()){
+		is_slippery_ = std::any_cast<bool>(slip_itr -> second);
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	build_transitions_();
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+template<uint_t side_size>
+typename FrozenLake<side_size>::time_step_type
+FrozenLake<side_size>::reset(uint_t seed,
+                             const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	state_ = 0;
+	n_steps_ = 0;
+	is_finished_ = false;
+	this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+template<uint_t side_size>
+typename FrozenLake<side_size>::time_step_type
+FrozenLake<side_size>::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		state_ = 0;
+		n_steps_ = 0;
+		is_finished_ = false;
+		this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+		return this -> get_current_time_step_();
+	}
+
+	auto transitions = p(state_, action);
+
+	// sample the transition, every slippery move has probability 1/3
+	auto selected = transitions.begin();
+	if(transitions.size() > 1){
+		std::uniform_real_distribution<real_t> distribution(0.0, 1.0);
+		auto u = distribution(generator_);
+
+		for(; selected != transitions.end() - 1; ++selected){
+			u -= std::get<0>(*selected);
+			if(u < 0.0){
+				break;
+			}
+		}
+	}
+
+	const auto& [probability, next_state, reward, done] = *selected;
+
+	state_ = next_state;
+	n_steps_ += 1;
+	is_finished_ = done || n_steps_ >= max_episode_steps_;
+
+	this -> get_current_time_step_() = time_step_type(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                                                  reward, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+template<uint_t side_size>
+void
+FrozenLake<side_size>::close(){
+
+	transitions_.clear();
+	offsets_.clear();
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<uint_t side_size>
+typename FrozenLake<side_size>::snapshot_type
+FrozenLake<side_size>::snapshot()const{
+
+	return {state_, n_steps_, is_finished_};
+}
+
+template<uint_t side_size>
+void
+FrozenLake<side_size>::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = snapshot.state;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+template<uint_t side_size>
+FrozenLake<side_size>
+FrozenLake<side_size>::make_copy(uint_t cidx)const{
+
+	FrozenLake<side_size> copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["is_slippery"] = is_slippery_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+template<uint_t side_size>
+typename FrozenLake<side_size>::dynamics_t
+FrozenLake<side_size>::p(uint_t sidx, uint_t aidx)const{
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(sidx < state_space_type::size && aidx < action_space_type::size && "Invalid state or action");
+#endif
+
+	const auto idx = sidx * action_space_type::size + aidx;
+	return dynamics_t(transitions_.data() + offsets_[idx],
+	                  offsets_[idx + 1] - offsets_[idx]);
+}
+
+template<uint_t side_size>
+char
+FrozenLake<side_size>::tile(uint_t sidx)const{
+
+	if(sidx >= state_space_type::size){
+		throw std::logic_error("State " + std::to_string(sidx) + " is not valid");
+	}
+
+	return map_tile<side_size>(sidx / side_size, sidx % side_size);
+}
+
+template<uint_t side_size>
+void
+FrozenLake<side_size>::build_transitions_(){
+
+	const uint_t n_actions = action_space_type::size;
+
+	transitions_.clear();
+	transitions_.reserve(state_space_type::size * n_actions * 3);
+
+	offsets_.clear();
+	offsets_.reserve(state_space_type::size * n_actions + 1);
+	offsets_.push_back(0);
+
+	// the cell reached when moving in the given direction
+	auto move = [](uint_t row, uint_t col, uint_t action){
+
+		switch(action){
+			case 0:
+				col = col > 0 ? col - 1 : 0;
+				break;
+			case 1:
+				row = std::min(row + 1, side_size - 1);
+				break;
+			case 2:
+				col = std::min(col + 1, side_size - 1);
+				break;
+			case 3:
+				row = row > 0 ? row - 1 : 0;
+				break;
+		}
+
+		return row * side_size + col;
+	};
+
+	for(uint_t s=0; s<state_space_type::size; ++s){
+
+		const auto row = s / side_size;
+		const auto col = s % side_size;
+		const auto letter = map_tile<side_size>(row, col);
+
+		for(uint_t a=0; a<n_actions; ++a){
+
+			if(letter == 'G' || letter == 'H'){
+				transitions_.emplace_back(1.0, s, 0.0, true);
+			}
+			else if(is_slippery_){
+
+				for(auto b : {(a + n_actions - 1) % n_actions, a, (a + 1) % n_actions}){
+					const auto next = move(row, col, b);
+					const auto next_letter = map_tile<side_size>(next / side_size, next % side_size);
+					transitions_.emplace_back(1.0 / 3.0, next, next_letter == 'G' ? 1.0 : 0.0,
+					                          next_letter == 'G' || next_letter == 'H');
+				}
+			}
+			else{
+				const auto next = move(row, col, a);
+				const auto next_letter = map_tile<side_size>(next / side_size, next % side_size);
+				transitions_.emplace_back(1.0, next, next_letter == 'G' ? 1.0 : 0.0,
+				                          next_letter == 'G' || next_letter == 'H');
+			}
+
+			offsets_.push_back(transitions_.size());
+		}
+	}
+}
+
+template class FrozenLake<4>;
+template class FrozenLake<8>;
+
+}
+}
+}
@@ -0,0 +1,266 @@
+/**
+ * Native C++ implementation of the FrozenLake environment. It follows
+ * the maps and the transition model of the Gymnasium FrozenLake-v1
+ * environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/toy_text/frozen_lake.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * The full transition model P[s][a] is built once when make() is called
+ * and is stored in a single contiguous array. p() returns a view into it.
+ *
+ * Actions: 0 LEFT, 1 DOWN, 2 RIGHT, 3 UP
+ * Observation: current_row * side_size + current_col
+ * Reward: 1 for reaching the goal, 0 otherwise
+ * Episode termination: the agent reaches the goal or falls into a hole
+ * Episode truncation: 100 steps for the 4x4 map, 200 steps for the 8x8 map
+ * Slippery: the agent moves in the intended direction with probability 1/3
+ * and in each perpendicular direction with probability 1/3
+ */
+
+#ifndef NATIVE_FROZEN_LAKE_ENV_H
+#define NATIVE_FROZEN_LAKE_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <span>
+#include <unordered_map>
+#include <any>
+#include <random>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief In-process FrozenLake environment on the 4x4 or the 8x8 map
+///
+template<uint_t side_size>
+class FrozenLake final: public EnvBase<TimeStep<uint_t>,
+                                       ScalarDiscreteEnv<side_size * side_size, 4, 0, 0> >,
+                        public with_snapshot_mixin<DiscreteStateSnapshot>
+{
+public:
+
+	static_assert(side_size == 4 || side_size == 8, "FrozenLake supports the 4x4 and 8x8 maps");
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<uint_t>,
+	                ScalarDiscreteEnv<side_size * side_size, 4, 0, 0> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief A transition in the form (probability, next state, reward, done)
+	///
+	typedef std::tuple<real_t, uint_t, real_t, bool> transition_type;
+
+	///
+	/// \brief The transitions for a state and action. This is a view
+	/// into the transition model of the environment
+	///
+	typedef std::span<const transition_type> dynamics_t;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef DiscreteStateSnapshot snapshot_type;
+
+	///
+	/// \brief Constructor
+	///
+	FrozenLake();
+
+	///
+	/// \brief Constructor
+	///
+	explicit FrozenLake(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	FrozenLake(const FrozenLake& other);
+
+	///
+	/// \brief make. Builds the environment and its transition model.
+	/// The options may contain "is_slippery", true by default, and
+	/// "max_episode_steps" to override the time limit. Throws
+	/// std::logic_error if the version is not v1
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The agent is placed at the start
+	/// and the seed initialises the generator used by slippery moves
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	FrozenLake make_copy(uint_t cidx)const;
+
+	///
+	/// \brief The transitions for the given state and action. The
+	/// view stays valid until the environment is closed
+	///
+	dynamics_t p(uint_t sidx, uint_t aidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief Number of states
+	///
+	uint_t n_states()const noexcept{return state_space_type::size;}
+
+	///
+	/// \brief map_type
+	///
+	std::string map_type()const noexcept{return side_size == 4 ? "4x4" : "8x8";}
+
+	///
+	/// \brief is_slippery
+	///
+	bool is_slippery()const noexcept{return is_slippery_;}
+
+	///
+	/// \brief The tile of the given state, one of S, F, H or G
+	///
+	char tile(uint_t sidx)const;
+
+	///
+	/// \brief The current state
+	///
+	uint_t state()const noexcept{return state_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	///
+	/// \brief is_slippery_
+	///
+	bool is_slippery_{true};
+
+	///
+	/// \brief The time limit
+	///
+	uint_t max_episode_steps_{side_size == 4 ? 100 : 200};
+
+	///
+	/// \brief The number of steps in the current episode
+	///
+	uint_t n_steps_{0};
+
+	///
+	/// \brief Flag indicating that the episode has ended
+	///
+	bool is_finished_{true};
+
+	///
+	/// \brief The current state
+	///
+	uint_t state_{0};
+
+	///
+	/// \brief The transitions of all the states and actions
+	/// one after the other
+	///
+	std::vector<transition_type> transitions_;
+
+	///
+	/// \brief The transitions of state s and action a are
+	/// transitions_[offsets_[s * 4 + a], offsets_[s * 4 + a + 1])
+	///
+	std::vector<uint_t> offsets_;
+
+	///
+	/// \brief The generator used by slippery moves
+	///
+	std::mt19937 generator_;
+
+	///
+	/// \brief Build the transition model
+	///
+	void build_transitions_();
+};
+
+}
+}
+}
+
+#endif // NATIVE_FROZEN_LAKE_ENV_H
@@ -0,0 +1,165 @@
+#include "rlenvs/envs/native/mountain_car_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+template<typename StateType>
+const std::string BasicMountainCar<StateType>::name = "MountainCar";
+
+template<typename StateType>
+BasicMountainCar<StateType>::BasicMountainCar()
+:
+base_type(0, name)
+{}
+
+template<typename StateType>
+BasicMountainCar<StateType>::BasicMountainCar(uint_t cidx)
+:
+base_type(cidx, name)
+{}
+
+template<typename StateType>
+void
+BasicMountainCar<StateType>::make(const std::string& version,
+                                  const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v0"){
+		throw std::logic_error("MountainCar version " + version + " is not supported");
+	}
+
+	auto goal_itr = options.find("goal_velocity");
+	if(goal_itr != options.end()){
+		goal_velocity_ = std::any_cast<real_t>(goal_itr -> second);
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+template<typename StateType>
+typename BasicMountainCar<StateType>::time_step_type
+BasicMountainCar<StateType>::reset(uint_t seed,
+                                   const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	reset_state_();
+	return store_time_step_(TimeStepTp::FIRST, 0.0);
+}
+
+template<typename StateType>
+typename BasicMountainCar<StateType>::time_step_type
+BasicMountainCar<StateType>::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		reset_state_();
+		return store_time_step_(TimeStepTp::FIRST, 0.0);
+	}
+
+	integrate(&position_, &velocity_, &action, 1);
+	n_steps_ += 1;
+
+	const bool terminated = position_ >= GOAL_POSITION && velocity_ >= goal_velocity_;
+	is_finished_ = terminated || n_steps_ >= max_episode_steps_;
+
+	return store_time_step_(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID, -1.0);
+}
+
+template<typename StateType>
+const typename BasicMountainCar<StateType>::time_step_type&
+BasicMountainCar<StateType>::store_time_step_(TimeStepTp type, real_t reward){
+
+	auto& time_step = this -> get_current_time_step_();
+	assign_space_item(time_step.mutable_observation(), std::array<real_t, 2>{position_, velocity_});
+	time_step.update(type, reward, 1.0);
+	return time_step;
+}
+
+template<typename StateType>
+void
+BasicMountainCar<StateType>::close(){
+
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<typename StateType>
+typename BasicMountainCar<StateType>::snapshot_type
+BasicMountainCar<StateType>::snapshot()const{
+
+	return {position_, velocity_, n_steps_, is_finished_};
+}
+
+template<typename StateType>
+void
+BasicMountainCar<StateType>::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	position_ = snapshot.position;
+	velocity_ = snapshot.velocity;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+template<typename StateType>
+BasicMountainCar<StateType>
+BasicMountainCar<StateType>::make_copy(uint_t cidx)const{
+
+	BasicMountainCar copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["goal_velocity"] = goal_velocity_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+template<typename StateType>
+void
+BasicMountainCar<StateType>::reset_state_(){
+
+	std::uniform_real_distribution<real_t> distribution(-0.6, -0.4);
+	position_ = distribution(generator_);
+	velocity_ = 0.0;
+	n_steps_ = 0;
+	is_finished_ = false;
+}
+
+template class BasicMountainCar<std::vector<real_t> >;
+template class BasicMountainCar<std::array<real_t, 2> >;
+template class BasicMountainCar<Eigen::Matrix<real_t, 2, 1> >;
+
+}
+}
+}
@@ -0,0 +1,272 @@
+/**
+ * Native C++ implementation of the MountainCar environment. It follows
+ * the equations of the Gymnasium MountainCar-v0 environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/classic_control/mountain_car.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * Observation: [position, velocity]
+ * Actions: 0 accelerate to the left, 1 do not accelerate, 2 accelerate to the right
+ * Reward: -1 for every step
+ * Episode termination: the position is at least 0.5 and the velocity
+ * at least goal_velocity
+ * Episode truncation: 200 steps
+ *
+ * FixedMountainCar and EigenMountainCar hold the two observation values
+ * inline, in a std::array and an Eigen vector, instead of a std::vector.
+ *
+ * See MountainCarV for stepping many instances at once.
+ */
+
+#ifndef NATIVE_MOUNTAIN_CAR_ENV_H
+#define NATIVE_MOUNTAIN_CAR_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief Snapshot of the MountainCar environment
+///
+struct MountainCarSnapshot
+{
+	real_t position;
+	real_t velocity;
+	uint_t n_steps;
+	bool is_finished;
+};
+
+///
+/// \brief In-process MountainCar environment. StateType is the type of
+/// the observation
+///
+template<typename StateType>
+class BasicMountainCar final: public EnvBase<TimeStep<StateType>,
+                                             ContinuousVectorStateDiscreteActionEnv<2, 3, 0, real_t, StateType> >,
+                              public with_snapshot_mixin<MountainCarSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The constants of the Gymnasium implementation
+	///
+	static constexpr real_t MIN_POSITION = -1.2;
+	static constexpr real_t MAX_POSITION = 0.6;
+	static constexpr real_t MAX_SPEED = 0.07;
+	static constexpr real_t GOAL_POSITION = 0.5;
+	static constexpr real_t FORCE = 0.001;
+	static constexpr real_t GRAVITY = 0.0025;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<StateType>,
+	                ContinuousVectorStateDiscreteActionEnv<2, 3, 0, real_t, StateType> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef MountainCarSnapshot snapshot_type;
+
+	///
+	/// \brief Advance n cars stored as separate position and velocity
+	/// arrays by one time step. The loop has no branches so that the
+	/// compiler can vectorize it
+	///
+	static void integrate(real_t* positions, real_t* velocities,
+	                      const uint_t* actions, uint_t n)noexcept;
+
+	///
+	/// \brief Constructor
+	///
+	BasicMountainCar();
+
+	///
+	/// \brief Constructor
+	///
+	explicit BasicMountainCar(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	BasicMountainCar(const BasicMountainCar& other)=default;
+
+	///
+	/// \brief make. Build the environment. The options may contain
+	/// "goal_velocity", 0 by default, and "max_episode_steps".
+	/// Throws std::logic_error if the version is not v0
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The position is drawn uniformly
+	/// from [-0.6, -0.4] and the velocity is zero
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief step. Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	BasicMountainCar make_copy(uint_t cidx)const;
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief The current position and velocity
+	///
+	std::array<real_t, 2> state()const noexcept{return {position_, velocity_};}
+
+	///
+	/// \brief The velocity needed at the goal position
+	///
+	real_t goal_velocity()const noexcept{return goal_velocity_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	real_t goal_velocity_{0.0};
+	uint_t max_episode_steps_{200};
+	uint_t n_steps_{0};
+	bool is_finished_{true};
+	real_t position_{0.0};
+	real_t velocity_{0.0};
+
+	///
+	/// \brief The generator of the initial states
+	///
+	std::mt19937 generator_;
+
+	///
+	/// \brief Draw a new initial state
+	///
+	void reset_state_();
+
+	///
+	/// \brief Refill the current time step in place with the current
+	/// state and return it. The observation keeps its capacity
+	///
+	const time_step_type& store_time_step_(TimeStepTp type, real_t reward);
+};
+
+template<typename StateType>
+inline
+void
+BasicMountainCar<StateType>::integrate(real_t* positions, real_t* velocities,
+                                       const uint_t* actions, uint_t n)noexcept{
+
+	for(uint_t i=0; i<n; ++i){
+
+		auto velocity = velocities[i] + (static_cast<real_t>(actions[i]) - 1.0) * FORCE - std::cos(3.0 * positions[i]) * GRAVITY;
+		velocity = std::clamp(velocity, -MAX_SPEED, MAX_SPEED);
+
+		const auto position = std::clamp(positions[i] + velocity, MIN_POSITION, MAX_POSITION);
+
+		// the car stops at the left wall
+		velocities[i] = position == MIN_POSITION && velocity < 0.0 ? 0.0 : velocity;
+		positions[i] = position;
+	}
+}
+
+///
+/// \brief MountainCar with std::vector observations
+///
+typedef BasicMountainCar<std::vector<real_t> > MountainCar;
+
+///
+/// \brief MountainCar with std::array observations held inline
+///
+typedef BasicMountainCar<std::array<real_t, 2> > FixedMountainCar;
+
+///
+/// \brief MountainCar with Eigen observations held inline
+///
+typedef BasicMountainCar<Eigen::Matrix<real_t, 2, 1> > EigenMountainCar;
+
+}
+}
+}
+
+#endif // NATIVE_MOUNTAIN_CAR_ENV_H
@@ -0,0 +1,225 @@
+#include "rlenvs/envs/native/mountain_car_vec_env.h"
+#include "rlenvs/envs/native/mountain_car_env.h"
+#include "rlenvs/envs/vector_time_step.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+const std::string MountainCarV::name = "MountainCarV";
+
+MountainCarV::MountainCarV()
+:
+base_type(0, MountainCarV::name)
+{}
+
+MountainCarV::MountainCarV(uint_t cidx)
+:
+base_type(cidx, MountainCarV::name)
+{}
+
+void
+MountainCarV::make(const std::string& version,
+                   const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v0"){
+		throw std::logic_error("MountainCar version " + version + " is not supported");
+	}
+
+	auto n_envs_itr = options.find("num_envs");
+	if(n_envs_itr == options.end()){
+		throw std::logic_error("num_envs variable is not provided");
+	}
+
+	n_envs_ = std::any_cast<uint_t>(n_envs_itr -> second);
+
+	auto goal_itr = options.find("goal_velocity");
+	if(goal_itr != options.end()){
+		goal_velocity_ = std::any_cast<real_t>(goal_itr -> second);
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	positions_.assign(n_envs_, 0.0);
+	velocities_.assign(n_envs_, 0.0);
+	rewards_.assign(n_envs_, 0.0);
+	n_steps_.assign(n_envs_, 0);
+	types_.assign(n_envs_, TimeStepTp::LAST);
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+MountainCarV::time_step_type
+MountainCarV::reset(uint_t seed,
+                    const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	return time_step_();
+}
+
+void
+MountainCarV::reset_into(uint_t seed, batch_time_step_type& batch){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	write_batch_(batch);
+}
+
+MountainCarV::time_step_type
+MountainCarV::step(const action_type& actions){
+
+	step_state(actions);
+	return time_step_();
+}
+
+void
+MountainCarV::step_into(std::span<const uint_t> actions, batch_time_step_type& batch){
+
+	step_state(actions);
+	write_batch_(batch);
+}
+
+void
+MountainCarV::step_state(std::span<const uint_t> actions){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	if(actions.size() != n_envs_){
+		throw std::logic_error("The number of actions does not match the number of environments");
+	}
+
+	// the finished instances are reset instead of stepped. The runs
+	// of live instances in between are integrated in one call each
+	uint_t begin = 0;
+	for(uint_t i=0; i<=n_envs_; ++i){
+
+		if(i < n_envs_ && types_[i] != TimeStepTp::LAST){
+			continue;
+		}
+
+		MountainCar::integrate(positions_.data() + begin, velocities_.data() + begin,
+		                       actions.data() + begin, i - begin);
+
+		for(uint_t j=begin; j<i; ++j){
+
+			n_steps_[j] += 1;
+			rewards_[j] = -1.0;
+
+			const bool terminated = positions_[j] >= MountainCar::GOAL_POSITION && velocities_[j] >= goal_velocity_;
+			types_[j] = terminated || n_steps_[j] >= max_episode_steps_ ? TimeStepTp::LAST : TimeStepTp::MID;
+		}
+
+		if(i < n_envs_){
+			reset_instance_(i);
+		}
+
+		begin = i + 1;
+	}
+}
+
+void
+MountainCarV::close(){
+
+	positions_.clear();
+	velocities_.clear();
+	rewards_.clear();
+	n_steps_.clear();
+	types_.clear();
+	this -> invalidate_is_created_flag_();
+}
+
+MountainCarV
+MountainCarV::make_copy(uint_t cidx)const{
+
+	MountainCarV copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs_;
+	options["goal_velocity"] = goal_velocity_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+void
+MountainCarV::reset_instance_(uint_t i)noexcept{
+
+	positions_[i] = -0.6 + 0.2 * generator_.uniform();
+	velocities_[i] = 0.0;
+	rewards_[i] = 0.0;
+	n_steps_[i] = 0;
+	types_[i] = TimeStepTp::FIRST;
+}
+
+void
+MountainCarV::reset_instances_(uint_t seed)noexcept{
+
+	generator_.seed(seed);
+	for(uint_t i=0; i<n_envs_; ++i){
+		reset_instance_(i);
+	}
+}
+
+void
+MountainCarV::write_observations_(std::span<real_t> obs)const noexcept{
+
+	// the observations are interleaved in row major order
+	for(uint_t i=0; i<n_envs_; ++i){
+		obs[2 * i] = positions_[i];
+		obs[2 * i + 1] = velocities_[i];
+	}
+}
+
+void
+MountainCarV::write_batch_(batch_time_step_type& batch)const{
+
+	batch.resize(n_envs_, 2);
+	std::copy(types_.begin(), types_.end(), batch.types().begin());
+	std::copy(rewards_.begin(), rewards_.end(), batch.rewards().begin());
+	std::fill(batch.discounts().begin(), batch.discounts().end(), 1.0);
+	write_observations_(batch.observations());
+}
+
+MountainCarV::time_step_type
+MountainCarV::time_step_(){
+
+	auto buffer = obs_buffers_.acquire(2 * n_envs_);
+	write_observations_(*buffer);
+
+	time_step_type time_step(types_, rewards_, std::vector<real_t>(n_envs_, 1.0),
+	                         std::span<const real_t>(*buffer), 2, buffer);
+
+	// the copy assignment reuses the capacity of the stored time step
+	this -> get_current_time_step_() = time_step;
+	return time_step;
+}
+
+}
+}
+}
@@ -0,0 +1,168 @@
+#include "rlenvs/envs/native/pendulum_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+template<typename StateType>
+const std::string BasicPendulum<StateType>::name = "Pendulum";
+
+template<typename StateType>
+BasicPendulum<StateType>::BasicPendulum()
+:
+base_type(0, name)
+{}
+
+template<typename StateType>
+BasicPendulum<StateType>::BasicPendulum(uint_t cidx)
+:
+base_type(cidx, name)
+{}
+
+template<typename StateType>
+void
+BasicPendulum<StateType>::make(const std::string& version,
+                               const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("Pendulum version " + version + " is not supported");
+	}
+
+	auto g_itr = options.find("g");
+	if(g_itr != options.end()){
+		g_ = std::any_cast<real_t>(g_itr -> second);
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+template<typename StateType>
+typename BasicPendulum<StateType>::time_step_type
+BasicPendulum<StateType>::reset(uint_t seed,
+                                const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	reset_state_();
+	return store_time_step_(TimeStepTp::FIRST, 0.0);
+}
+
+template<typename StateType>
+typename BasicPendulum<StateType>::time_step_type
+BasicPendulum<StateType>::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	if(is_finished_){
+		reset_state_();
+		return store_time_step_(TimeStepTp::FIRST, 0.0);
+	}
+
+	real_t reward = 0.0;
+	integrate(&theta_, &theta_dot_, &action, &reward, 1, g_);
+	n_steps_ += 1;
+
+	is_finished_ = n_steps_ >= max_episode_steps_;
+
+	return store_time_step_(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID, reward);
+}
+
+template<typename StateType>
+const typename BasicPendulum<StateType>::time_step_type&
+BasicPendulum<StateType>::store_time_step_(TimeStepTp type, real_t reward){
+
+	auto& time_step = this -> get_current_time_step_();
+	assign_space_item(time_step.mutable_observation(), std::array<real_t, 3>{std::cos(theta_), std::sin(theta_), theta_dot_});
+	time_step.update(type, reward, 1.0);
+	return time_step;
+}
+
+template<typename StateType>
+void
+BasicPendulum<StateType>::close(){
+
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+template<typename StateType>
+typename BasicPendulum<StateType>::snapshot_type
+BasicPendulum<StateType>::snapshot()const{
+
+	return {theta_, theta_dot_, n_steps_, is_finished_};
+}
+
+template<typename StateType>
+void
+BasicPendulum<StateType>::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	theta_ = snapshot.theta;
+	theta_dot_ = snapshot.theta_dot;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+template<typename StateType>
+BasicPendulum<StateType>
+BasicPendulum<StateType>::make_copy(uint_t cidx)const{
+
+	BasicPendulum copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["g"] = g_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+template<typename StateType>
+void
+BasicPendulum<StateType>::reset_state_(){
+
+	constexpr real_t PI = 3.14159265358979323846;
+
+	std::uniform_real_distribution<real_t> theta_distribution(-PI, PI);
+	std::uniform_real_distribution<real_t> theta_dot_distribution(-1.0, 1.0);
+
+	theta_ = theta_distribution(generator_);
+	theta_dot_ = theta_dot_distribution(generator_);
+	n_steps_ = 0;
+	is_finished_ = false;
+}
+
+template class BasicPendulum<std::vector<real_t> >;
+template class BasicPendulum<std::array<real_t, 3> >;
+template class BasicPendulum<Eigen::Matrix<real_t, 3, 1> >;
+
+}
+}
+}
@@ -0,0 +1,279 @@
+/**
+ * Native C++ implementation of the Pendulum environment. It follows
+ * the equations of the Gymnasium Pendulum-v1 environment described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/classic_control/pendulum.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ * The state and action spaces and the time step type are the same
+ * as those of rlenvscpp::envs::gymnasium::Pendulum so that the two
+ * can be used interchangeably.
+ *
+ * Observation: [cos(theta), sin(theta), angular velocity]
+ * Action: the torque in [-2, 2]. Larger torques are clipped
+ * Reward: -(theta^2 + 0.1 * theta_dot^2 + 0.001 * torque^2) with
+ * theta normalized to [-pi, pi]
+ * Episode truncation: 200 steps. The episode never terminates
+ *
+ * Pendulum keeps the std::vector observation of the REST environment.
+ * FixedPendulum and EigenPendulum hold it inline instead.
+ *
+ * See PendulumV for stepping many instances at once.
+ */
+
+#ifndef NATIVE_PENDULUM_ENV_H
+#define NATIVE_PENDULUM_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief Snapshot of the Pendulum environment
+///
+struct PendulumSnapshot
+{
+	real_t theta;
+	real_t theta_dot;
+	uint_t n_steps;
+	bool is_finished;
+};
+
+///
+/// \brief In-process Pendulum environment. StateType is the type of
+/// the observation
+///
+template<typename StateType>
+class BasicPendulum final: public EnvBase<TimeStep<StateType>,
+                                          ContinuousVectorStateContinuousScalarBoundedActionEnv<3, 1, RealRange<-2.0, 2.0>, 0, real_t, StateType> >,
+                           public with_snapshot_mixin<PendulumSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The constants of the Gymnasium implementation
+	///
+	static constexpr real_t MAX_SPEED = 8.0;
+	static constexpr real_t MAX_TORQUE = 2.0;
+	static constexpr real_t DT = 0.05;
+	static constexpr real_t MASS = 1.0;
+	static constexpr real_t LENGTH = 1.0;
+	static constexpr real_t DEFAULT_GRAVITY = 10.0;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<StateType>,
+	                ContinuousVectorStateContinuousScalarBoundedActionEnv<3, 1, RealRange<-2.0, 2.0>, 0, real_t, StateType> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef PendulumSnapshot snapshot_type;
+
+	///
+	/// \brief Advance n pendulums stored as separate angle and angular
+	/// velocity arrays by one time step and write the rewards. The
+	/// loop has no branches so that the compiler can vectorize it
+	///
+	static void integrate(real_t* thetas, real_t* theta_dots,
+	                      const real_t* torques, real_t* rewards,
+	                      uint_t n, real_t g=DEFAULT_GRAVITY)noexcept;
+
+	///
+	/// \brief Constructor
+	///
+	BasicPendulum();
+
+	///
+	/// \brief Constructor
+	///
+	explicit BasicPendulum(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	BasicPendulum(const BasicPendulum& other)=default;
+
+	///
+	/// \brief make. Build the environment. The options may contain
+	/// "g", the acceleration of gravity, and "max_episode_steps".
+	/// Throws std::logic_error if the version is not v1
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The angle is drawn uniformly from
+	/// [-pi, pi] and the angular velocity from [-1, 1]
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief step. Apply the given torque. A step after the end of
+	/// an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	BasicPendulum make_copy(uint_t cidx)const;
+
+	///
+	/// \brief The current angle and angular velocity
+	///
+	std::array<real_t, 2> state()const noexcept{return {theta_, theta_dot_};}
+
+	///
+	/// \brief The acceleration of gravity
+	///
+	real_t gravity()const noexcept{return g_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	real_t g_{DEFAULT_GRAVITY};
+	uint_t max_episode_steps_{200};
+	uint_t n_steps_{0};
+	bool is_finished_{true};
+	real_t theta_{0.0};
+	real_t theta_dot_{0.0};
+
+	///
+	/// \brief The generator of the initial states
+	///
+	std::mt19937 generator_;
+
+	///
+	/// \brief Draw a new initial state
+	///
+	void reset_state_();
+
+	///
+	/// \brief Refill the current time step in place with the current
+	/// state and return it. The observation keeps its capacity
+	///
+	const time_step_type& store_time_step_(TimeStepTp type, real_t reward);
+};
+
+template<typename StateType>
+inline
+void
+BasicPendulum<StateType>::integrate(real_t* thetas, real_t* theta_dots,
+                                    const real_t* torques, real_t* rewards,
+                                    uint_t n, real_t g)noexcept{
+
+	constexpr real_t PI = 3.14159265358979323846;
+
+	for(uint_t i=0; i<n; ++i){
+
+		const auto u = std::clamp(torques[i], -MAX_TORQUE, MAX_TORQUE);
+		const auto theta = thetas[i];
+		const auto theta_dot = theta_dots[i];
+
+		// normalize the angle to [-pi, pi)
+		const auto normalized = theta - 2.0 * PI * std::floor((theta + PI) / (2.0 * PI));
+		rewards[i] = -(normalized * normalized + 0.1 * theta_dot * theta_dot + 0.001 * u * u);
+
+		auto new_theta_dot = theta_dot + (3.0 * g / (2.0 * LENGTH) * std::sin(theta) + 3.0 / (MASS * LENGTH * LENGTH) * u) * DT;
+		new_theta_dot = std::clamp(new_theta_dot, -MAX_SPEED, MAX_SPEED);
+
+		thetas[i] = theta + new_theta_dot * DT;
+		theta_dots[i] = new_theta_dot;
+	}
+}
+
+///
+/// \brief Pendulum with std::vector observations
+///
+typedef BasicPendulum<std::vector<real_t> > Pendulum;
+
+///
+/// \brief Pendulum with std::array observations held inline
+///
+typedef BasicPendulum<std::array<real_t, 3> > FixedPendulum;
+
+///
+/// \brief Pendulum with Eigen observations held inline
+///
+typedef BasicPendulum<Eigen::Matrix<real_t, 3, 1> > EigenPendulum;
+
+}
+}
+}
+
+#endif // NATIVE_PENDULUM_ENV_H
@@ -0,0 +1,225 @@
+#include "rlenvs/envs/native/pendulum_vec_env.h"
+#include "rlenvs/envs/native/pendulum_env.h"
+#include "rlenvs/envs/vector_time_step.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+const std::string PendulumV::name = "PendulumV";
+
+PendulumV::PendulumV()
+:
+base_type(0, PendulumV::name)
+{}
+
+PendulumV::PendulumV(uint_t cidx)
+:
+base_type(cidx, PendulumV::name)
+{}
+
+void
+PendulumV::make(const std::string& version,
+                const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v1"){
+		throw std::logic_error("Pendulum version " + version + " is not supported");
+	}
+
+	auto n_envs_itr = options.find("num_envs");
+	if(n_envs_itr == options.end()){
+		throw std::logic_error("num_envs variable is not provided");
+	}
+
+	n_envs_ = std::any_cast<uint_t>(n_envs_itr -> second);
+
+	auto g_itr = options.find("g");
+	if(g_itr != options.end()){
+		g_ = std::any_cast<real_t>(g_itr -> second);
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	thetas_.assign(n_envs_, 0.0);
+	theta_dots_.assign(n_envs_, 0.0);
+	rewards_.assign(n_envs_, 0.0);
+	n_steps_.assign(n_envs_, 0);
+	types_.assign(n_envs_, TimeStepTp::LAST);
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+PendulumV::time_step_type
+PendulumV::reset(uint_t seed,
+                 const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	return time_step_();
+}
+
+void
+PendulumV::reset_into(uint_t seed, batch_time_step_type& batch){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	reset_instances_(seed);
+	write_batch_(batch);
+}
+
+PendulumV::time_step_type
+PendulumV::step(const action_type& actions){
+
+	step_state(actions);
+	return time_step_();
+}
+
+void
+PendulumV::step_into(std::span<const real_t> actions, batch_time_step_type& batch){
+
+	step_state(actions);
+	write_batch_(batch);
+}
+
+void
+PendulumV::step_state(std::span<const real_t> actions){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	if(actions.size() != n_envs_){
+		throw std::logic_error("The number of actions does not match the number of environments");
+	}
+
+	// the finished instances are reset instead of stepped. The runs
+	// of live instances in between are integrated in one call each
+	uint_t begin = 0;
+	for(uint_t i=0; i<=n_envs_; ++i){
+
+		if(i < n_envs_ && types_[i] != TimeStepTp::LAST){
+			continue;
+		}
+
+		Pendulum::integrate(thetas_.data() + begin, theta_dots_.data() + begin, actions.data() + begin,
+		                    rewards_.data() + begin, i - begin, g_);
+
+		for(uint_t j=begin; j<i; ++j){
+			n_steps_[j] += 1;
+			types_[j] = n_steps_[j] >= max_episode_steps_ ? TimeStepTp::LAST : TimeStepTp::MID;
+		}
+
+		if(i < n_envs_){
+			reset_instance_(i);
+		}
+
+		begin = i + 1;
+	}
+}
+
+void
+PendulumV::close(){
+
+	thetas_.clear();
+	theta_dots_.clear();
+	rewards_.clear();
+	n_steps_.clear();
+	types_.clear();
+	this -> invalidate_is_created_flag_();
+}
+
+PendulumV
+PendulumV::make_copy(uint_t cidx)const{
+
+	PendulumV copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs_;
+	options["g"] = g_;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+void
+PendulumV::reset_instance_(uint_t i)noexcept{
+
+	constexpr real_t PI = 3.14159265358979323846;
+
+	thetas_[i] = -PI + 2.0 * PI * generator_.uniform();
+	theta_dots_[i] = -1.0 + 2.0 * generator_.uniform();
+	rewards_[i] = 0.0;
+	n_steps_[i] = 0;
+	types_[i] = TimeStepTp::FIRST;
+}
+
+void
+PendulumV::reset_instances_(uint_t seed)noexcept{
+
+	generator_.seed(seed);
+	for(uint_t i=0; i<n_envs_; ++i){
+		reset_instance_(i);
+	}
+}
+
+void
+PendulumV::write_observations_(std::span<real_t> obs)const noexcept{
+
+	// the observations are interleaved in row major order
+	for(uint_t i=0; i<n_envs_; ++i){
+		obs[3 * i] = std::cos(thetas_[i]);
+		obs[3 * i + 1] = std::sin(thetas_[i]);
+		obs[3 * i + 2] = theta_dots_[i];
+	}
+}
+
+void
+PendulumV::write_batch_(batch_time_step_type& batch)const{
+
+	batch.resize(n_envs_, 3);
+	std::copy(types_.begin(), types_.end(), batch.types().begin());
+	std::copy(rewards_.begin(), rewards_.end(), batch.rewards().begin());
+	std::fill(batch.discounts().begin(), batch.discounts().end(), 1.0);
+	write_observations_(batch.observations());
+}
+
+PendulumV::time_step_type
+PendulumV::time_step_(){
+
+	auto buffer = obs_buffers_.acquire(3 * n_envs_);
+	write_observations_(*buffer);
+
+	time_step_type time_step(types_, rewards_, std::vector<real_t>(n_envs_, 1.0),
+	                         std::span<const real_t>(*buffer), 3, buffer);
+
+	// the copy assignment reuses the capacity of the stored time step
+	this -> get_current_time_step_() = time_step;
+	return time_step;
+}
+
+}
+}
+}
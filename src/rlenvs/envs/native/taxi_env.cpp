@@ -0,0 +1,297 @@
+#include "rlenvs/envs/native/taxi_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifdef RLENVSCPP_DEBUG
+#include <cassert>
+#endif
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+namespace{
+
+const std::array<std::string, 7> MAP = {"+---------+",
+                                        "|R: | : :G|",
+                                        "| : | : : |",
+                                        "| : : : : |",
+                                        "| | : | : |",
+                                        "|Y| : |B: |",
+                                        "+---------+"};
+
+// the row and column of R, G, Y and B
+const std::array<std::pair<uint_t, uint_t>, 4> LOCATIONS = {std::make_pair(0, 0),
+                                                            std::make_pair(0, 4),
+                                                            std::make_pair(4, 0),
+                                                            std::make_pair(4, 3)};
+
+bool
+can_move_east(uint_t row, uint_t col){
+	return MAP[row + 1][2 * col + 2] == ':';
+}
+
+bool
+can_move_west(uint_t row, uint_t col){
+	return MAP[row + 1][2 * col] == ':';
+}
+
+// the index of the location at the given cell or 4
+uint_t
+location_index(uint_t row, uint_t col){
+
+	for(uint_t l=0; l<LOCATIONS.size(); ++l){
+		if(LOCATIONS[l].first == row && LOCATIONS[l].second == col){
+			return l;
+		}
+	}
+
+	return Taxi::IN_TAXI;
+}
+
+}
+
+const std::string Taxi::name = "Taxi";
+
+Taxi::Taxi()
+:
+base_type(0, Taxi::name)
+{}
+
+Taxi::Taxi(uint_t cidx)
+:
+base_type(cidx, Taxi::name)
+{}
+
+Taxi::Taxi(const Taxi& other)
+:
+base_type(other),
+max_episode_steps_(other.max_episode_steps_),
+n_steps_(other.n_steps_),
+is_finished_(other.is_finished_),
+state_(other.state_),
+transitions_(other.transitions_),
+action_masks_(other.action_masks_),
+initial_states_(other.initial_states_),
+generator_(other.generator_)
+{}
+
+void
+Taxi::make(const std::string& version,
+           const std::unordered_map<std::string, std::any>& options){
+
+	if(this -> is_created()){
+		return;
+	}
+
+	if(version != "v3"){
+		throw std::logic_error("Taxi version " + version + " is not supported");
+	}
+
+	auto steps_itr = options.find("max_episode_steps");
+	if(steps_itr != options.end()){
+		max_episode_steps_ = std::any_cast<uint_t>(steps_itr -> second);
+	}
+
+	build_transitions_();
+
+	this -> set_version_(version);
+	this -> make_created_();
+}
+
+Taxi::time_step_type
+Taxi::reset(uint_t seed,
+            const std::unordered_map<std::string, std::any>& /*options*/){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	generator_.seed(seed);
+	reset_state_();
+	this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+Taxi::time_step_type
+Taxi::step(const action_type& action){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(action < action_space_type::size && "Invalid action");
+#endif
+
+	if(is_finished_){
+		reset_state_();
+		this -> get_current_time_step_() = time_step_type(TimeStepTp::FIRST, 0.0, state_, 1.0);
+		return this -> get_current_time_step_();
+	}
+
+	const auto& [probability, next_state, reward, done] = transitions_[state_ * action_space_type::size + action];
+
+	state_ = next_state;
+	n_steps_ += 1;
+	is_finished_ = done || n_steps_ >= max_episode_steps_;
+
+	this -> get_current_time_step_() = time_step_type(is_finished_ ? TimeStepTp::LAST : TimeStepTp::MID,
+	                                                  reward, state_, 1.0);
+	return this -> get_current_time_step_();
+}
+
+void
+Taxi::close(){
+
+	transitions_.clear();
+	action_masks_.clear();
+	initial_states_.clear();
+	is_finished_ = true;
+	n_steps_ = 0;
+	this -> invalidate_is_created_flag_();
+}
+
+Taxi::snapshot_type
+Taxi::snapshot()const{
+
+	return {state_, n_steps_, is_finished_};
+}
+
+void
+Taxi::restore(const snapshot_type& snapshot){
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+#endif
+
+	state_ = snapshot.state;
+	n_steps_ = snapshot.n_steps;
+	is_finished_ = snapshot.is_finished;
+}
+
+Taxi
+Taxi::make_copy(uint_t cidx)const{
+
+	Taxi copy(cidx);
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = max_episode_steps_;
+	copy.make(this -> version(), options);
+	return copy;
+}
+
+Taxi::dynamics_t
+Taxi::p(uint_t sidx, uint_t aidx)const{
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(sidx < state_space_type::size && aidx < action_space_type::size && "Invalid state or action");
+#endif
+
+	return dynamics_t(transitions_.data() + sidx * action_space_type::size + aidx, 1);
+}
+
+const Taxi::action_mask_type&
+Taxi::action_mask(uint_t sidx)const{
+
+#ifdef RLENVSCPP_DEBUG
+	assert(this -> is_created() && "Environment has not been created");
+	assert(sidx < state_space_type::size && "Invalid state");
+#endif
+
+	return action_masks_[sidx];
+}
+
+void
+Taxi::build_transitions_(){
+
+	transitions_.clear();
+	transitions_.reserve(state_space_type::size * action_space_type::size);
+
+	action_masks_.assign(state_space_type::size, action_mask_type{});
+	initial_states_.clear();
+
+	for(uint_t s=0; s<state_space_type::size; ++s){
+
+		const auto [row, col, passenger, destination] = decode(s);
+		const auto taxi_location = location_index(row, col);
+
+		if(passenger < IN_TAXI && passenger != destination){
+			initial_states_.push_back(s);
+		}
+
+		for(uint_t a=0; a<action_space_type::size; ++a){
+
+			auto new_row = row;
+			auto new_col = col;
+			auto new_passenger = passenger;
+			real_t reward = -1.0;
+			bool done = false;
+
+			switch(a){
+				case 0:
+					new_row = std::min(row + 1, N_ROWS - 1);
+					break;
+				case 1:
+					new_row = row > 0 ? row - 1 : 0;
+					break;
+				case 2:
+					if(can_move_east(row, col)){
+						new_col = std::min(col + 1, N_COLS - 1);
+					}
+					break;
+				case 3:
+					if(can_move_west(row, col)){
+						new_col = col > 0 ? col - 1 : 0;
+					}
+					break;
+				case 4:
+					if(passenger < IN_TAXI && taxi_location == passenger){
+						new_passenger = IN_TAXI;
+					}
+					else{
+						reward = -10.0;
+					}
+					break;
+				case 5:
+					if(passenger == IN_TAXI && taxi_location == destination){
+						new_passenger = destination;
+						done = true;
+						reward = 20.0;
+					}
+					else if(passenger == IN_TAXI && taxi_location < IN_TAXI){
+						new_passenger = taxi_location;
+					}
+					else{
+						reward = -10.0;
+					}
+					break;
+			}
+
+			transitions_.emplace_back(1.0, encode(new_row, new_col, new_passenger, destination), reward, done);
+		}
+
+		auto& mask = action_masks_[s];
+		mask[0] = row < N_ROWS - 1;
+		mask[1] = row > 0;
+		mask[2] = col < N_COLS - 1 && can_move_east(row, col);
+		mask[3] = col > 0 && can_move_west(row, col);
+		mask[4] = passenger < IN_TAXI && taxi_location == passenger;
+		mask[5] = passenger == IN_TAXI && taxi_location < IN_TAXI;
+	}
+}
+
+void
+Taxi::reset_state_(){
+
+	std::uniform_int_distribution<uint_t> distribution(0, initial_states_.size() - 1);
+	state_ = initial_states_[distribution(generator_)];
+	n_steps_ = 0;
+	is_finished_ = false;
+}
+
+}
+}
+}
@@ -0,0 +1,310 @@
+/**
+ * Native C++ implementation of the Taxi environment. It follows the map,
+ * the state encoding and the rewards of the Gymnasium Taxi-v3 environment
+ * described here:
+ * https://github.com/Farama-Foundation/Gymnasium/blob/main/gymnasium/envs/toy_text/taxi.py
+ * but runs in-process so that no request is sent to the REST API server.
+ *
+ *     +---------+
+ *     |R: | : :G|
+ *     | : | : : |
+ *     | : : : : |
+ *     | | : | : |
+ *     |Y| : |B: |
+ *     +---------+
+ *
+ * Actions: 0 south, 1 north, 2 east, 3 west, 4 pickup, 5 drop off
+ * Observation: ((taxi_row * 5 + taxi_col) * 5 + passenger_location) * 4 + destination
+ * where the passenger location is 0-3 for R, G, Y, B and 4 in the taxi
+ * Reward: -1 per step, +20 for delivering the passenger, -10 for an
+ * illegal pickup or drop off
+ * Episode termination: the passenger is dropped off at the destination
+ * Episode truncation: 200 steps
+ *
+ * The transitions and rewards of all the states and actions as well as
+ * the action masks are computed once when make() is called.
+ */
+
+#ifndef NATIVE_TAXI_ENV_H
+#define NATIVE_TAXI_ENV_H
+
+#include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/envs/env_base.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/with_snapshot_mixin.h"
+
+#include <array>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <span>
+#include <unordered_map>
+#include <any>
+#include <random>
+
+namespace rlenvscpp{
+namespace envs{
+namespace native{
+
+///
+/// \brief The decoded Taxi state
+///
+struct TaxiState
+{
+	uint_t taxi_row;
+	uint_t taxi_col;
+	uint_t passenger_location;
+	uint_t destination;
+};
+
+///
+/// \brief In-process Taxi environment
+///
+class Taxi final: public EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<500, 6, 0, 0> >,
+                  public with_snapshot_mixin<DiscreteStateSnapshot>
+{
+public:
+
+	///
+	/// \brief name
+	///
+	static const std::string name;
+
+	///
+	/// \brief The number of rows and columns of the grid
+	///
+	static constexpr uint_t N_ROWS = 5;
+	static constexpr uint_t N_COLS = 5;
+
+	///
+	/// \brief The passenger location when in the taxi
+	///
+	static constexpr uint_t IN_TAXI = 4;
+
+	///
+	/// \brief The base type
+	///
+	typedef EnvBase<TimeStep<uint_t>, ScalarDiscreteEnv<500, 6, 0, 0> > base_type;
+
+	///
+	/// \brief The time step type we return every time a step in the
+	/// environment is performed
+	///
+	typedef typename base_type::time_step_type time_step_type;
+
+	///
+	/// \brief The type describing the state space for the environment
+	///
+	typedef typename base_type::state_space_type state_space_type;
+
+	///
+	/// \brief The type of the action space for the environment
+	///
+	typedef typename base_type::action_space_type action_space_type;
+
+	///
+	/// \brief The type of the action to be undertaken in the environment
+	///
+	typedef typename base_type::action_type action_type;
+
+	///
+	/// \brief The type of the state
+	///
+	typedef typename base_type::state_type state_type;
+
+	///
+	/// \brief A transition in the form (probability, next state, reward, done)
+	///
+	typedef std::tuple<real_t, uint_t, real_t, bool> transition_type;
+
+	///
+	/// \brief The transitions for a state and action. This is a view
+	/// into the transition model of the environment
+	///
+	typedef std::span<const transition_type> dynamics_t;
+
+	///
+	/// \brief Entry a is true if action a changes the state
+	///
+	typedef std::array<bool, 6> action_mask_type;
+
+	///
+	/// \brief Expose the various reset methods we use from base class
+	///
+	using base_type::reset;
+
+	///
+	/// \brief The snapshot of the environment state
+	///
+	typedef DiscreteStateSnapshot snapshot_type;
+
+	///
+	/// \brief Pack the given components into a state index
+	///
+	static constexpr uint_t encode(uint_t taxi_row, uint_t taxi_col,
+	                               uint_t passenger_location, uint_t destination)noexcept{
+		return ((taxi_row * N_COLS + taxi_col) * 5 + passenger_location) * 4 + destination;
+	}
+
+	///
+	/// \brief Unpack the given state index
+	///
+	static constexpr TaxiState decode(uint_t sidx)noexcept{
+		return TaxiState{sidx / 100, (sidx / 20) % 5, (sidx / 4) % 5, sidx % 4};
+	}
+
+	///
+	/// \brief Constructor
+	///
+	Taxi();
+
+	///
+	/// \brief Constructor
+	///
+	explicit Taxi(uint_t cidx);
+
+	///
+	/// \brief Copy constructor
+	///
+	Taxi(const Taxi& other);
+
+	///
+	/// \brief make. Builds the environment and its transition model.
+	/// The options may contain "max_episode_steps" to override the
+	/// time limit. Throws std::logic_error if the version is not v3
+	///
+	virtual void make(const std::string& version,
+	                  const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Reset the environment. The taxi position, the passenger
+	/// location and the destination are drawn uniformly with the passenger
+	/// waiting away from the destination
+	///
+	virtual time_step_type reset(uint_t seed,
+	                             const std::unordered_map<std::string, std::any>& options) override final;
+
+	///
+	/// \brief Step in the environment following the given action.
+	/// A step after the end of an episode resets the environment
+	///
+	virtual time_step_type step(const action_type& action) override final;
+
+	///
+	/// \brief close the environment
+	///
+	virtual void close() override final;
+
+	///
+	/// \brief Create a new copy of the environment with the given
+	/// copy index
+	///
+	Taxi make_copy(uint_t cidx)const;
+
+	///
+	/// \brief The transitions for the given state and action. The
+	/// view stays valid until the environment is closed
+	///
+	dynamics_t p(uint_t sidx, uint_t aidx)const;
+
+	///
+	/// \brief The actions that change the given state
+	///
+	const action_mask_type& action_mask(uint_t sidx)const;
+
+	///
+	/// \brief The actions that change the current state
+	///
+	const action_mask_type& action_mask()const{return action_mask(state_);}
+
+	///
+	/// \brief n_actions. Returns the number of actions
+	///
+	uint_t n_actions()const noexcept{return action_space_type::size;}
+
+	///
+	/// \brief Number of states
+	///
+	uint_t n_states()const noexcept{return state_space_type::size;}
+
+	///
+	/// \brief The current state
+	///
+	uint_t state()const noexcept{return state_;}
+
+	///
+	/// \brief The number of steps after which an episode is truncated
+	///
+	uint_t max_episode_steps()const noexcept{return max_episode_steps_;}
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const override final;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot) override final;
+
+private:
+
+	///
+	/// \brief The time limit
+	///
+	uint_t max_episode_steps_{200};
+
+	///
+	/// \brief The number of steps in the current episode
+	///
+	uint_t n_steps_{0};
+
+	///
+	/// \brief Flag indicating that the episode has ended
+	///
+	bool is_finished_{true};
+
+	///
+	/// \brief The current state
+	///
+	uint_t state_{0};
+
+	///
+	/// \brief The transition of state s and action a is transitions_[s * 6 + a]
+	///
+	std::vector<transition_type> transitions_;
+
+	///
+	/// \brief The action mask of every state
+	///
+	std::vector<action_mask_type> action_masks_;
+
+	///
+	/// \brief The states an episode may start from
+	///
+	std::vector<uint_t> initial_states_;
+
+	///
+	/// \brief The generator of the initial states
+	///
+	std::mt19937 generator_;
+
+	///
+	/// \brief Build the transition model and the action masks
+	///
+	void build_transitions_();
+
+	///
+	/// \brief Draw a new initial state
+	///
+	void reset_state_();
+};
+
+}
+}
+}
+
+#endif // NATIVE_TAXI_ENV_H
@@ -2,8 +2,12 @@
 #define SPACE_TYPE_H
 
 #include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/utils/sampling_engine.h"
 #include <random>
 #include <vector>
+#include <span>
+#include <array>
+#include <algorithm>
 #include <type_traits>
 
 namespace rlenvscpp {
@@ -35,80 +39,89 @@ struct ScalarDiscreteSpace{
     static constexpr uint_t size = IntegralRange<s, e>::size;
 	
 	///
-    /// \brief sample
-    /// \return
+    /// \brief Sample a value with the engine of the calling thread.
+    /// The end of the range is included if use_end is true
     ///
     static space_item_type sample(bool use_end);
 
     ///
-    /// \brief sample
-    /// \param seed
-    /// \return
+    /// \brief Sample a value with a new engine seeded with seed
     ///
     static space_item_type sample(uint_t seed, bool use_end);
 	
 	///
-    /// \brief sample
-    /// \param seed
-    /// \return
+    /// \brief Sample size values with a new engine seeded with seed
     ///
     static std::vector<space_item_type> sample(uint_t seed, uint_t size, bool use_end);
+
+	///
+    /// \brief Sample a value with the given engine
+    ///
+    static space_item_type sample(utils::sampling_engine_type& engine, bool use_end)noexcept;
+
+	///
+    /// \brief Fill out with values sampled with the engine of the
+	/// calling thread
+    ///
+    static void sample_n(std::span<space_item_type> out, bool use_end);
+
+	///
+    /// \brief Fill out with values sampled with the given engine
+    ///
+    static void sample_n(utils::sampling_engine_type& engine,
+	                     std::span<space_item_type> out, bool use_end)noexcept;
 	
 };
 
 template<uint_t s, uint_t e>
 typename ScalarDiscreteSpace<s, e>::space_item_type
 ScalarDiscreteSpace<s, e>::sample(bool use_end){
-
-	auto E = IntegralRange<s, e>::E;
-	
-	if(!use_end){
-		E -= 1;
-	}
-	
-    std::uniform_int_distribution<> dist(IntegralRange<s, e>::S, E);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    return dist(gen);
+	return sample(utils::thread_sampling_engine(), use_end);
 }
 
 template<uint_t s, uint_t e>
 typename ScalarDiscreteSpace<s, e>::space_item_type
 ScalarDiscreteSpace<s, e>::sample(uint_t seed, bool use_end){
 	
-	auto E = IntegralRange<s, e>::E;
-	
-	if(!use_end){
-		E -= 1;
-	}
-
-    std::uniform_int_distribution<> dist(IntegralRange<s, e>::S, E);
-    std::mt19937 gen(seed);
-    return dist(gen);
+	utils::sampling_engine_type engine(seed);
+	return sample(engine, use_end);
 }
 
 template<uint_t s, uint_t e>
 std::vector<typename ScalarDiscreteSpace<s, e>::space_item_type>
 ScalarDiscreteSpace<s, e>::sample(uint_t seed, uint_t size, bool use_end){
-	
-	auto E = IntegralRange<s, e>::E;
-	
-	if(!use_end){
-		E -= 1;
-	}
 
-	std::vector<typename ScalarDiscreteSpace<s, e>::space_item_type> vals_;
-	vals_.reserve(size);
-	
-	std::uniform_int_distribution<> dist(IntegralRange<s, e>::S, E);
-    std::mt19937 gen(seed);
-	for(uint_t i=0; i<size; ++i){
-		vals_.push_back(dist(gen));
-	}
-	
+	std::vector<space_item_type> vals_(size);
+	utils::sampling_engine_type engine(seed);
+	sample_n(engine, vals_, use_end);
     return vals_;
 }
 
+template<uint_t s, uint_t e>
+typename ScalarDiscreteSpace<s, e>::space_item_type
+ScalarDiscreteSpace<s, e>::sample(utils::sampling_engine_type& engine, bool use_end)noexcept{
+
+	const auto n_values = IntegralRange<s, e>::size + (use_end ? 1 : 0);
+	return IntegralRange<s, e>::S + engine.bounded(n_values);
+}
+
+template<uint_t s, uint_t e>
+void
+ScalarDiscreteSpace<s, e>::sample_n(std::span<space_item_type> out, bool use_end){
+	sample_n(utils::thread_sampling_engine(), out, use_end);
+}
+
+template<uint_t s, uint_t e>
+void
+ScalarDiscreteSpace<s, e>::sample_n(utils::sampling_engine_type& engine,
+                                    std::span<space_item_type> out, bool use_end)noexcept{
+
+	const auto n_values = IntegralRange<s, e>::size + (use_end ? 1 : 0);
+	for(auto& value : out){
+		value = IntegralRange<s, e>::S + engine.bounded(n_values);
+	}
+}
+
 
 
 template<uint_t Size>
@@ -124,6 +137,31 @@ struct ContinuousScalareSpace
 	/// how many elements can potentially the space have
     ///
     static constexpr uint_t size = Size;
+
+	///
+    /// \brief Sample a value with the given engine. The space is
+	/// unbounded so, like Gymnasium, the value is standard normal
+    ///
+    static space_item_type sample(utils::sampling_engine_type& engine){
+		return std::normal_distribution<real_t>()(engine);}
+
+	///
+    /// \brief Sample a value with the engine of the calling thread
+    ///
+    static space_item_type sample(){return sample(utils::thread_sampling_engine());}
+
+	///
+    /// \brief Fill out with values sampled with the given engine
+    ///
+    static void sample_n(utils::sampling_engine_type& engine, std::span<space_item_type> out){
+		std::normal_distribution<real_t> dist;
+		std::generate(out.begin(), out.end(), [&](){return dist(engine);});
+	}
+
+	///
+    /// \brief Fill out with values sampled with the engine of the calling thread
+    ///
+    static void sample_n(std::span<space_item_type> out){sample_n(utils::thread_sampling_engine(), out);}
 };
 
 ///
@@ -147,13 +185,69 @@ struct BoundedContinuousScalarSpace
 	/// \brief The boundaries the scalar value can assume
 	///
 	static constexpr RealRange<S, E> limits = RealRange<S, E>();
+
+	///
+    /// \brief Sample a value uniformly in [S, E) with the given engine
+    ///
+    static space_item_type sample(utils::sampling_engine_type& engine)noexcept{
+		return S + (E - S) * engine.uniform();}
+
+	///
+    /// \brief Sample a value with the engine of the calling thread
+    ///
+    static space_item_type sample(){return sample(utils::thread_sampling_engine());}
+
+	///
+    /// \brief Sample a value with a new engine seeded with seed
+    ///
+    static space_item_type sample(uint_t seed){
+		utils::sampling_engine_type engine(seed);
+		return sample(engine);
+	}
+
+	///
+    /// \brief Fill out with values sampled with the given engine
+    ///
+    static void sample_n(utils::sampling_engine_type& engine, std::span<space_item_type> out)noexcept{
+		for(auto& value : out){
+			value = sample(engine);
+		}
+	}
+
+	///
+    /// \brief Fill out with values sampled with the engine of the calling thread
+    ///
+    static void sample_n(std::span<space_item_type> out){sample_n(utils::thread_sampling_engine(), out);}
 };
 
 
-template<uint_t Size, typename T=real_t>
+///
+/// \brief Tests if ItemType can hold an item of a vector space
+/// of Size values of type T. The item is either a std::vector<T>,
+/// a std::array<T, Size> or a fixed size Eigen column vector
+///
+template<typename ItemType, uint_t Size, typename T>
+struct is_vector_space_item: std::false_type{};
+
+template<uint_t Size, typename T>
+struct is_vector_space_item<std::vector<T>, Size, T>: std::true_type{};
+
+template<uint_t Size, typename T>
+struct is_vector_space_item<std::array<T, Size>, Size, T>: std::true_type{};
+
+template<uint_t Size, typename T>
+struct is_vector_space_item<Eigen::Matrix<T, static_cast<int>(Size), 1>, Size, T>: std::true_type{};
+
+///
+/// \brief A space of Size real values. The item type is a std::vector
+/// by default. Use FixedContinuousVectorSpace or EigenContinuousVectorSpace
+/// to hold the values inline
+///
+template<uint_t Size, typename T=real_t, typename ItemType=std::vector<T> >
 struct ContinuousVectorSpace
 {
 	static_assert(std::is_floating_point_v<T> == true && "Floating point type is expected");
+	static_assert(is_vector_space_item<ItemType, Size, T>::value && "Unsupported item type");
 	
 	///
     /// \brief The overall size of the space meaning
@@ -164,9 +258,101 @@ struct ContinuousVectorSpace
 	///
     /// \brief item_t
     ///
-    typedef std::vector<T> space_item_type;
+    typedef ItemType space_item_type;
+
+	///
+    /// \brief Sample an item with the given engine. The space is
+	/// unbounded so, like Gymnasium, the values are standard normal
+    ///
+    static space_item_type sample(utils::sampling_engine_type& engine);
+
+	///
+    /// \brief Sample an item with the engine of the calling thread
+    ///
+    static space_item_type sample(){return sample(utils::thread_sampling_engine());}
+
+	///
+    /// \brief Fill out with items sampled with the given engine
+    ///
+    static void sample_n(utils::sampling_engine_type& engine, std::span<space_item_type> out);
+
+	///
+    /// \brief Fill out with items sampled with the engine of the calling thread
+    ///
+    static void sample_n(std::span<space_item_type> out){sample_n(utils::thread_sampling_engine(), out);}
 };
 
+template<uint_t Size, typename T, typename ItemType>
+typename ContinuousVectorSpace<Size, T, ItemType>::space_item_type
+ContinuousVectorSpace<Size, T, ItemType>::sample(utils::sampling_engine_type& engine){
+
+	space_item_type item;
+	if constexpr(std::is_same_v<ItemType, std::vector<T> >){
+		item.resize(Size);
+	}
+
+	std::normal_distribution<T> dist;
+	std::generate(item.data(), item.data() + Size, [&](){return dist(engine);});
+	return item;
+}
+
+template<uint_t Size, typename T, typename ItemType>
+void
+ContinuousVectorSpace<Size, T, ItemType>::sample_n(utils::sampling_engine_type& engine,
+                                                   std::span<space_item_type> out){
+
+	std::normal_distribution<T> dist;
+	for(auto& item : out){
+
+		if constexpr(std::is_same_v<ItemType, std::vector<T> >){
+			item.resize(Size);
+		}
+
+		std::generate(item.data(), item.data() + Size, [&](){return dist(engine);});
+	}
+}
+
+///
+/// \brief A ContinuousVectorSpace whose items are std::array<T, Size>
+///
+template<uint_t Size, typename T=real_t>
+using FixedContinuousVectorSpace = ContinuousVectorSpace<Size, T, std::array<T, Size> >;
+
+///
+/// \brief A ContinuousVectorSpace whose items are Eigen::Matrix<T, Size, 1>
+///
+template<uint_t Size, typename T=real_t>
+using EigenContinuousVectorSpace = ContinuousVectorSpace<Size, T, Eigen::Matrix<T, static_cast<int>(Size), 1> >;
+
+///
+/// \brief Copy the given values into a vector space item. A std::vector
+/// item is resized in place and reuses its capacity
+///
+template<typename ItemType, typename T, std::size_t N>
+void
+assign_space_item(ItemType& item, const std::array<T, N>& values){
+
+	if constexpr(std::is_same_v<ItemType, std::vector<typename ItemType::value_type> >){
+		item.assign(values.begin(), values.end());
+	}
+	else{
+		static_assert(is_vector_space_item<ItemType, N, typename ItemType::value_type>::value && "Size mismatch");
+		std::copy(values.begin(), values.end(), item.data());
+	}
+}
+
+///
+/// \brief Build a vector space item from the given values
+///
+template<typename ItemType, typename T, std::size_t N>
+ItemType
+make_space_item(const std::array<T, N>& values){
+
+	ItemType item;
+	assign_space_item(item, values);
+	return item;
+}
+
 
 
 
@@ -3,6 +3,7 @@
 
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/rlenvscpp_config.h"
+#include "rlenvs/envs/time_step.h"
 
 #ifdef GYMFCPP_DEBUG
 #include <cassert>
@@ -14,9 +15,6 @@
 namespace rlenvscpp
 {
 
-/// Forward declaration
-template<typename StateTp> class TimeStep;
-
 namespace envs{
 
 ///
@@ -3,6 +3,7 @@
 
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/time_step_info.h"
 #include "rlenvs/utils/io/io_utils.h"
 
 #include <string>
@@ -10,15 +11,25 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <vector>
+#include <array>
 #include <ostream>
+#include <memory>
+#include <utility>
 
 namespace rlenvscpp {
 
 
 ///
-/// \brief The TimeStep class
+/// \brief The TimeStep class. Moving a TimeStep moves its observation
+/// and info and leaves the moved-from object cleared. The info map is
+/// only allocated when it is first written, so a TimeStep without
+/// extra information holds no map at all. InfoTp is the typed info
+/// the environment reports with every step, see time_step_info.h.
+/// The observation is held by value, so a fixed size StateTp such as
+/// std::array or a fixed size Eigen vector lives inline in the
+/// TimeStep and building one does not allocate
 ///
-template<typename StateTp>
+template<typename StateTp, typename InfoTp=NoInfo>
 class TimeStep
 {
 public:
@@ -28,6 +39,11 @@ public:
     ///
     typedef StateTp state_type;
 
+    ///
+    /// \brief The type of the typed info
+    ///
+    typedef InfoTp info_type;
+
 
     ///
     /// \brief TimeStep
@@ -37,19 +53,25 @@ public:
     ///
     /// \brief TimeStep. Constructor
     ///
-    TimeStep(TimeStepTp type, real_t reward, const state_type&  obs);
+    TimeStep(TimeStepTp type, real_t reward, state_type obs);
 
     ///
     /// \brief TimeStep. Constructor
     ///
-    TimeStep(TimeStepTp type, real_t reward, const state_type&  obs, real_t discount_factor);
+    TimeStep(TimeStepTp type, real_t reward, state_type obs, real_t discount_factor);
 
     ///
     /// \brief TimeStep. Constructor
     ///
-    TimeStep(TimeStepTp type, real_t reward, const state_type& obs,
+    TimeStep(TimeStepTp type, real_t reward, state_type obs,
              real_t discount_factor, std::unordered_map<std::string, std::any>&& extra);
 
+    ///
+    /// \brief TimeStep. Constructor
+    ///
+    TimeStep(TimeStepTp type, real_t reward, state_type obs,
+             real_t discount_factor, const info_type& typed_info);
+
     ///
     /// \brief TimeStep
     /// \param other
@@ -102,7 +124,28 @@ public:
     /// \brief observation
     /// \return
     ///
-    state_type observation()const{return obs_;}
+    const state_type& observation()const& noexcept{return obs_;}
+
+    ///
+    /// \brief observation. Moves the observation out of a temporary
+    ///
+    state_type observation()&&{return std::move(obs_);}
+
+    ///
+    /// \brief The observation, to be refilled in place by environments
+    /// that reuse the TimeStep. See EnvBase::step_into
+    ///
+    state_type& mutable_observation()noexcept{return obs_;}
+
+    ///
+    /// \brief Set the type, the reward and the discount. The
+    /// observation and the info are kept
+    ///
+    void update(TimeStepTp type, real_t reward, real_t discount)noexcept{
+        type_ = type;
+        reward_ = reward;
+        discount_ = discount;
+    }
 
     ///
     /// \brief reward
@@ -136,13 +179,28 @@ public:
     /// \brief info
     /// \return
     ///
-    const std::unordered_map<std::string, std::any>& info()const noexcept{return extra_;}
+    const std::unordered_map<std::string, std::any>& info()const noexcept{return extra_ ? *extra_ : empty_info_();}
 
     ///
-    /// \brief info
+    /// \brief info. Allocates the map if the time step has none
     /// \return
     ///
-    std::unordered_map<std::string, std::any>& info()noexcept{return extra_;}
+    std::unordered_map<std::string, std::any>& info();
+
+    ///
+    /// \brief Remove all the entries of the info map. Does not allocate
+    ///
+    void clear_info()noexcept{extra_.reset();}
+
+    ///
+    /// \brief The typed info
+    ///
+    const info_type& typed_info()const noexcept{return typed_info_;}
+
+    ///
+    /// \brief The typed info
+    ///
+    info_type& typed_info()noexcept{return typed_info_;}
 
 private:
 
@@ -167,115 +225,183 @@ private:
     real_t discount_;
 
     ///
-    /// \brief extra_
+    /// \brief extra_. Null until info is written
     ///
-    std::unordered_map<std::string, std::any> extra_;
+    std::unique_ptr<std::unordered_map<std::string, std::any> > extra_;
+
+    ///
+    /// \brief The info of the time steps that have none
+    ///
+    static const std::unordered_map<std::string, std::any>& empty_info_()noexcept;
+
+    ///
+    /// \brief typed_info_
+    ///
+    [[no_unique_address]] info_type typed_info_;
 
 };
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep()
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep()
     :
       type_(TimeStepTp::INVALID_TYPE),
       reward_(0.0),
       obs_(),
       discount_(1.0),
-      extra_()
+      extra_(nullptr),
+      typed_info_()
 {}
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep(TimeStepTp type, real_t reward, const state_type& obs, real_t discount_factor)
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(TimeStepTp type, real_t reward, state_type obs, real_t discount_factor)
     :
       type_(type),
       reward_(reward),
-      obs_(obs),
+      obs_(std::move(obs)),
       discount_(discount_factor),
-      extra_()
+      extra_(nullptr),
+      typed_info_()
 {}
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep(TimeStepTp type, real_t reward, const state_type& obs)
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(TimeStepTp type, real_t reward, state_type obs)
     :
-    TimeStep<StateTp>(type, reward, obs, 1.0)
+    TimeStep<StateTp, InfoTp>(type, reward, std::move(obs), 1.0)
 {}
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep(TimeStepTp type, real_t reward, const state_type& obs, real_t discount_factor,
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(TimeStepTp type, real_t reward, state_type obs, real_t discount_factor,
                             std::unordered_map<std::string, std::any>&& extra)
     :
     type_(type),
     reward_(reward),
-    obs_(obs),
+    obs_(std::move(obs)),
+    discount_(discount_factor),
+    extra_(extra.empty() ? nullptr : std::make_unique<std::unordered_map<std::string, std::any> >(std::move(extra))),
+    typed_info_()
+{}
+
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(TimeStepTp type, real_t reward, state_type obs, real_t discount_factor,
+                                    const info_type& typed_info)
+    :
+    type_(type),
+    reward_(reward),
+    obs_(std::move(obs)),
     discount_(discount_factor),
-    extra_(extra)
+    extra_(nullptr),
+    typed_info_(typed_info)
 {}
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep(const TimeStep& other)
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(const TimeStep& other)
     :
       type_(other.type_),
       reward_(other.reward_),
       obs_(other.obs_),
       discount_(other.discount_),
-      extra_(other.extra_)
+      extra_(other.extra_ ? std::make_unique<std::unordered_map<std::string, std::any> >(*other.extra_) : nullptr),
+      typed_info_(other.typed_info_)
 {}
 
-template<typename StateTp>
-TimeStep<StateTp>&
-TimeStep<StateTp>::operator=(const TimeStep<StateTp>& other){
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>&
+TimeStep<StateTp, InfoTp>::operator=(const TimeStep<StateTp, InfoTp>& other){
+
+    if(this == &other){
+        return *this;
+    }
 
     type_ = other.type_;
     reward_ = other.reward_;
     obs_ = other.obs_;
     discount_ = other.discount_;
-    extra_ = other.extra_;
+    typed_info_ = other.typed_info_;
+
+    if(!other.extra_){
+        extra_.reset();
+    }
+    else if(extra_){
+        *extra_ = *other.extra_;
+    }
+    else{
+        extra_ = std::make_unique<std::unordered_map<std::string, std::any> >(*other.extra_);
+    }
+
     return *this;
 }
 
-template<typename StateTp>
-TimeStep<StateTp>::TimeStep(TimeStep&& other)noexcept
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>::TimeStep(TimeStep&& other)noexcept
     :
       type_(other.type_),
       reward_(other.reward_),
-      obs_(other.obs_),
+      obs_(std::move(other.obs_)),
       discount_(other.discount_),
-      extra_(other.extra_)
+      extra_(std::move(other.extra_)),
+      typed_info_(other.typed_info_)
 {
     other.clear();
 }
 
-template<typename StateTp>
-TimeStep<StateTp>&
-TimeStep<StateTp>::operator=(TimeStep&& other)noexcept{
+template<typename StateTp, typename InfoTp>
+TimeStep<StateTp, InfoTp>&
+TimeStep<StateTp, InfoTp>::operator=(TimeStep&& other)noexcept{
+
+    if(this == &other){
+        return *this;
+    }
 
     type_ = other.type_;
     reward_ = other.reward_;
-    obs_ = other.obs_;
+    obs_ = std::move(other.obs_);
     discount_ = other.discount_;
-    extra_ = other.extra_;
+    extra_ = std::move(other.extra_);
+    typed_info_ = other.typed_info_;
     other.clear();
     return *this;
 }
 
-template<typename StateTp>
+template<typename StateTp, typename InfoTp>
 void
-TimeStep<StateTp>::clear()noexcept{
+TimeStep<StateTp, InfoTp>::clear()noexcept{
 
     type_ = TimeStepTp::INVALID_TYPE;
     reward_ = 0.0;
     obs_ = state_type();
     discount_ = 1.0;
-    extra_.clear();
+    extra_.reset();
+    typed_info_ = info_type();
+}
+
+template<typename StateTp, typename InfoTp>
+std::unordered_map<std::string, std::any>&
+TimeStep<StateTp, InfoTp>::info(){
+
+    if(!extra_){
+        extra_ = std::make_unique<std::unordered_map<std::string, std::any> >();
+    }
+
+    return *extra_;
 }
 
-template<typename StateTp>
+template<typename StateTp, typename InfoTp>
+const std::unordered_map<std::string, std::any>&
+TimeStep<StateTp, InfoTp>::empty_info_()noexcept{
+
+    static const std::unordered_map<std::string, std::any> empty;
+    return empty;
+}
+
+template<typename StateTp, typename InfoTp>
 template<typename T>
 const T&
-TimeStep<StateTp>::get_extra(std::string name)const{
+TimeStep<StateTp, InfoTp>::get_extra(std::string name)const{
 
-    auto itr = extra_.find(name);
+    const auto& extra = info();
+    auto itr = extra.find(name);
 
-    if(itr == extra_.end()){
+    if(itr == extra.end()){
         throw std::logic_error("Property " + name + " does not exist");
     }
 
@@ -283,9 +409,9 @@ TimeStep<StateTp>::get_extra(std::string name)const{
 }
 
 
-template<typename StateTp>
+template<typename StateTp, typename InfoTp>
 inline
-std::ostream& operator<<(std::ostream& out, const TimeStep<StateTp>& step){
+std::ostream& operator<<(std::ostream& out, const TimeStep<StateTp, InfoTp>& step){
 
     out<<"Step type....."<<TimeStepEnumUtils::to_string(step.type())<<std::endl;
     out<<"Reward........"<<step.reward()<<std::endl;
@@ -295,22 +421,35 @@ std::ostream& operator<<(std::ostream& out, const TimeStep<StateTp>& step){
 }
 
 
-template<typename T>
+template<typename T, typename InfoTp>
 std::ostream& operator<<(std::ostream& out,
-                         const TimeStep<std::vector<T>>& step){
+                         const TimeStep<std::vector<T>, InfoTp>& step){
 
     out<<"Step type....."<<TimeStepEnumUtils::to_string(step.type())<<std::endl;
     out<<"Reward........"<<step.reward()<<std::endl;
 
-    auto obs = step.observation();
-
 	out<<"Observation...";
-	rlenvscpp::utils::io::print_vector(out, obs);
+	rlenvscpp::utils::io::print_vector(out, step.observation());
 	
     out<<"Discount..... "<<step.discount()<<std::endl;
     return out;
 }
 
+
+template<typename T, std::size_t N, typename InfoTp>
+std::ostream& operator<<(std::ostream& out,
+                         const TimeStep<std::array<T, N>, InfoTp>& step){
+
+    out<<"Step type....."<<TimeStepEnumUtils::to_string(step.type())<<std::endl;
+    out<<"Reward........"<<step.reward()<<std::endl;
+
+	out<<"Observation...";
+	rlenvscpp::utils::io::print_vector(out, step.observation());
+
+    out<<"Discount..... "<<step.discount()<<std::endl;
+    return out;
+}
+
 }
 
 #endif // TIME_STEP_H
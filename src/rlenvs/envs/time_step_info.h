@@ -0,0 +1,45 @@
+#ifndef TIME_STEP_INFO_H
+#define TIME_STEP_INFO_H
+
+/**
+ * Typed info payloads for TimeStep and VectorTimeStep. An environment
+ * that reports extra information per step picks one of these, or its
+ * own small struct, as the InfoTp template parameter of its time step.
+ * The fields are then read directly, without the string lookup and the
+ * any_cast of the info() map.
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <bitset>
+
+namespace rlenvscpp{
+
+///
+/// \brief The info of the time steps that carry none. It takes
+/// no space in a TimeStep
+///
+struct NoInfo
+{};
+
+///
+/// \brief Tells apart a LAST time step that ends the episode because of
+/// the time limit from one that reaches a terminal state
+///
+struct TruncationInfo
+{
+	bool truncated{false};
+};
+
+///
+/// \brief The actions that are valid after the time step
+///
+template<uint_t n_actions>
+struct ActionMaskInfo
+{
+	std::bitset<n_actions> action_mask;
+};
+
+}
+
+#endif // TIME_STEP_INFO_H
@@ -4,6 +4,7 @@
 
 #include "rlenvs/rlenvs_types_v2.h"
 #include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/time_step_info.h"
 #include "rlenvs/extern/nlohmann/json/json.hpp"
 
 #include <vector>
@@ -11,14 +12,22 @@
 #include <any>
 #include <unordered_map>
 #include <ostream>
+#include <numeric>
+#include <span>
+#include <memory>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace rlenvscpp{
 
 
 ///
-/// \brief VectorTimeSetp class
+/// \brief VectorTimeSetp class. InfoType is the typed info of every
+/// environment, see time_step_info.h
 ///
-template<typename StateType>
+template<typename StateType, typename InfoType=NoInfo>
 class VectorTimeStep
 {
 
@@ -29,6 +38,11 @@ public:
     ///
     typedef StateType state_type;
 
+	///
+	/// \brief The type of the typed info of an environment
+	///
+	typedef InfoType info_type;
+
 	///
 	/// \brief Default construcotr
 	///
@@ -58,6 +72,17 @@ public:
 				   const std::vector<real_t>& discount_factors,
 				   std::unordered_map<std::string, std::any>&& extra);
 				   
+	///
+	/// \brief Constructor. The observations are not copied. They are
+	/// a view onto obs_buffer that holds types.size() * obs_size values
+	/// in row major order. owner keeps the memory behind the buffer alive
+	///
+	VectorTimeStep(const std::vector<TimeStepTp>& types, 
+	               const std::vector<real_t>& rewards, 
+				   const std::vector<real_t>& discount_factors,
+				   std::span<const real_t> obs_buffer,
+				   uint_t obs_size,
+				   std::shared_ptr<const void> owner);
 				   
 	///
     /// \brief TimeStep
@@ -90,10 +115,28 @@ public:
     const std::vector<TimeStepTp>& types()const noexcept{return types_;}
 
     ///
-    /// \brief observation
-    /// \return
+    /// \brief observation. If the time step is a view the
+	/// observations are copied out of the buffer on the first call
     ///
-    const std::vector<state_type>& observations()const{return obs_;}
+    const std::vector<state_type>& observations()const;
+	
+	///
+	/// \brief Returns true if the observations are a view onto a
+	/// buffer owned by someone else
+	///
+	bool is_view()const noexcept{return obs_owner_ != nullptr;}
+	
+	///
+	/// \brief Returns the observation of the i-th environment without
+	/// copying. Available when the state type is std::vector<real_t>
+	///
+	std::span<const real_t> observation_view(uint_t i)const;
+	
+	///
+	/// \brief Returns the row major buffer the observations are viewed
+	/// from. Empty if the time step is not a view
+	///
+	std::span<const real_t> observations_buffer()const noexcept{return obs_buffer_;}
 
     ///
     /// \brief reward
@@ -122,6 +165,17 @@ public:
     ///
     bool last()const noexcept;
 
+	///
+	/// \brief The typed info of every environment. Empty if
+	/// the environments report none
+	///
+	const std::vector<info_type>& typed_infos()const noexcept{return infos_;}
+
+	///
+	/// \brief The typed info of every environment
+	///
+	std::vector<info_type>& typed_infos()noexcept{return infos_;}
+
 private:
 
 	///
@@ -135,25 +189,96 @@ private:
 	std::vector<real_t> rewards_;
 	
 	///
-	/// \brief Observations
+	/// \brief Observations. Filled lazily for views
 	///
-	std::vector<state_type>  obs_;
+	mutable std::vector<state_type>  obs_;
 	
 	///
 	/// \brief The discount factors for every environment
 	///
 	std::vector<real_t> discounts_;
 	
+	///
+	/// \brief The buffer the observations are viewed from
+	///
+	std::span<const real_t> obs_buffer_;
+	
+	///
+	/// \brief The size of every observation in obs_buffer_
+	///
+	uint_t obs_size_{0};
+	
+	///
+	/// \brief Keeps the memory of obs_buffer_ alive
+	///
+	std::shared_ptr<const void> obs_owner_;
+	
 	
 	///
     /// \brief extra_
     ///
     std::unordered_map<std::string, std::any> extra_;
 
+	///
+	/// \brief The typed info of every environment
+	///
+	std::vector<info_type> infos_;
+
 };
 
-template<typename StateType>
-VectorTimeStep<StateType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
+///
+/// \brief Observation buffers that back VectorTimeStep views. A buffer is
+/// handed out again once no time step refers to it any more, so an
+/// environment that returns a new time step on every step and whose
+/// caller keeps only the latest one does not allocate in the steady state
+///
+class ObservationBufferPool
+{
+public:
+
+	ObservationBufferPool()=default;
+
+	///
+	/// \brief A copy starts empty. Sharing the buffers would keep
+	/// them referred to and stop both pools from reusing them
+	///
+	ObservationBufferPool(const ObservationBufferPool&){}
+	ObservationBufferPool& operator=(const ObservationBufferPool&){return *this;}
+
+	///
+	/// \brief Returns a buffer of the given size that no time
+	/// step refers to. Allocates only if no such buffer exists
+	///
+	std::shared_ptr<std::vector<real_t> > acquire(uint_t size){
+
+		for(auto& buffer : buffers_){
+
+			if(!buffer){
+				buffer = std::make_shared<std::vector<real_t> >(size);
+				return buffer;
+			}
+
+			if(buffer.use_count() == 1){
+				buffer -> resize(size);
+				return buffer;
+			}
+		}
+
+		// every buffer is still referred to
+		return std::make_shared<std::vector<real_t> >(size);
+	}
+
+private:
+
+	///
+	/// \brief Two buffers suffice when the previous time step is
+	/// released after the next one has been built
+	///
+	std::array<std::shared_ptr<std::vector<real_t> >, 2> buffers_;
+};
+
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
 	               const std::vector<real_t>& rewards, 
 				   const std::vector<state_type>&  obs, 
 				   const std::vector<real_t>& discount_factors,
@@ -166,8 +291,8 @@ VectorTimeStep<StateType>::VectorTimeStep(const std::vector<TimeStepTp>& types,
 		extra_(extra)
 		{}
 
-template<typename StateType>
-VectorTimeStep<StateType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
 	                                      const std::vector<real_t>& rewards, 
 				                          const std::vector<state_type>&  obs, 
 				                          const std::vector<real_t>& discount_factors)
@@ -178,76 +303,158 @@ VectorTimeStep<StateType>::VectorTimeStep(const std::vector<TimeStepTp>& types,
 		discounts_(discount_factors)
 		{}
 
-template<typename StateType>
-VectorTimeStep<StateType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
 	                                      const std::vector<real_t>& rewards, 
 				                          const std::vector<state_type>&  obs)
 		:
-		VectorTimeStep<StateType>(types, rewards, 
+		VectorTimeStep<StateType, InfoType>(types, rewards, 
 								  obs, std::vector<real_t>())
 {}
 
 
 
-template<typename StateType>
-VectorTimeStep<StateType>::VectorTimeStep(const VectorTimeStep<StateType>& other)
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(const std::vector<TimeStepTp>& types, 
+	                                      const std::vector<real_t>& rewards, 
+				                          const std::vector<real_t>& discount_factors,
+										  std::span<const real_t> obs_buffer,
+										  uint_t obs_size,
+										  std::shared_ptr<const void> owner)
+		:
+		types_(types),
+		rewards_(rewards),
+		obs_(),
+		discounts_(discount_factors),
+		obs_buffer_(obs_buffer),
+		obs_size_(obs_size),
+		obs_owner_(owner)
+{
+	if(obs_buffer_.size() != types_.size() * obs_size_){
+		throw std::logic_error("The observation buffer size does not match the number of environments");
+	}
+}
+
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(const VectorTimeStep<StateType, InfoType>& other)
     :
       types_(other.types_),
       rewards_(other.rewards_),
       obs_(other.obs_),
       discounts_(other.discounts_),
-      extra_(other.extra_)
+	  obs_buffer_(other.obs_buffer_),
+	  obs_size_(other.obs_size_),
+	  obs_owner_(other.obs_owner_),
+      extra_(other.extra_),
+	  infos_(other.infos_)
 {}
 
-template<typename StateType>
-VectorTimeStep<StateType>&
-VectorTimeStep<StateType>::operator=(const VectorTimeStep<StateType>& other){
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>&
+VectorTimeStep<StateType, InfoType>::operator=(const VectorTimeStep<StateType, InfoType>& other){
 
     types_ = other.types_;
     rewards_ = other.rewards_;
     obs_ = other.obs_;
     discounts_ = other.discounts_;
+	obs_buffer_ = other.obs_buffer_;
+	obs_size_ = other.obs_size_;
+	obs_owner_ = other.obs_owner_;
     extra_ = other.extra_;
+	infos_ = other.infos_;
     return *this;
 }
 
-template<typename StateType>
-VectorTimeStep<StateType>::VectorTimeStep(VectorTimeStep<StateType>&& other)noexcept
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>::VectorTimeStep(VectorTimeStep<StateType, InfoType>&& other)noexcept
     :
-      types_(other.types_),
-      rewards_(other.rewards_),
-      obs_(other.obs_),
-      discounts_(other.discounts_),
-      extra_(other.extra_)
+      types_(std::move(other.types_)),
+      rewards_(std::move(other.rewards_)),
+      obs_(std::move(other.obs_)),
+      discounts_(std::move(other.discounts_)),
+	  obs_buffer_(other.obs_buffer_),
+	  obs_size_(other.obs_size_),
+	  obs_owner_(std::move(other.obs_owner_)),
+      extra_(std::move(other.extra_)),
+	  infos_(std::move(other.infos_))
 {
-    //other.clear();
+	other.obs_buffer_ = std::span<const real_t>();
+	other.obs_size_ = 0;
 }
 
-template<typename StateType>
-VectorTimeStep<StateType>&
-VectorTimeStep<StateType>::operator=(VectorTimeStep<StateType>&& other)noexcept{
-
-    types_ = other.types_;
-    rewards_ = other.rewards_;
-    obs_ = other.obs_;
-    discounts_ = other.discounts_;
-    extra_ = other.extra_;
-    //other.clear();
+template<typename StateType, typename InfoType>
+VectorTimeStep<StateType, InfoType>&
+VectorTimeStep<StateType, InfoType>::operator=(VectorTimeStep<StateType, InfoType>&& other)noexcept{
+
+    if(this == &other){
+        return *this;
+    }
+
+    types_ = std::move(other.types_);
+    rewards_ = std::move(other.rewards_);
+    obs_ = std::move(other.obs_);
+    discounts_ = std::move(other.discounts_);
+	obs_buffer_ = other.obs_buffer_;
+	obs_size_ = other.obs_size_;
+	obs_owner_ = std::move(other.obs_owner_);
+    extra_ = std::move(other.extra_);
+	infos_ = std::move(other.infos_);
+
+	other.obs_buffer_ = std::span<const real_t>();
+	other.obs_size_ = 0;
     return *this;
 }
 
-template<typename StateType>
+template<typename StateType, typename InfoType>
+const std::vector<typename VectorTimeStep<StateType, InfoType>::state_type>& 
+VectorTimeStep<StateType, InfoType>::observations()const{
+	
+	if(is_view() && obs_.size() != types_.size()){
+		
+		if constexpr(std::is_same_v<state_type, std::vector<real_t> >){
+			
+			obs_.resize(types_.size());
+			for(uint_t i=0; i<types_.size(); ++i){
+				auto row = obs_buffer_.subspan(i * obs_size_, obs_size_);
+				obs_[i].assign(row.begin(), row.end());
+			}
+		}
+		else{
+			throw std::logic_error("Observation views are only supported for std::vector<real_t> states");
+		}
+	}
+	
+	return obs_;
+}
+
+template<typename StateType, typename InfoType>
+std::span<const real_t> 
+VectorTimeStep<StateType, InfoType>::observation_view(uint_t i)const{
+	
+	if(is_view()){
+		return obs_buffer_.subspan(i * obs_size_, obs_size_);
+	}
+	
+	if constexpr(std::is_same_v<state_type, std::vector<real_t> >){
+		return std::span<const real_t>(obs_[i].data(), obs_[i].size());
+	}
+	else{
+		throw std::logic_error("Observation views are only supported for std::vector<real_t> states");
+	}
+}
+
+template<typename StateType, typename InfoType>
 real_t 
-VectorTimeStep<StateType>::reward()const noexcept{
+VectorTimeStep<StateType, InfoType>::reward()const noexcept{
 	
 	auto sum_ = 0.0;
 	sum_ = std::accumulate(rewards_.begin(), rewards_.end(), sum_);
 	return sum_;
 }
 
-template<typename StateType>
+template<typename StateType, typename InfoType>
 bool 
-VectorTimeStep<StateType>::done()const noexcept{
+VectorTimeStep<StateType, InfoType>::done()const noexcept{
 	auto done_ = false;
 	
 	for(auto step_type: types_){
@@ -261,16 +468,16 @@ VectorTimeStep<StateType>::done()const noexcept{
 }
 
 
-template<typename StateType>
+template<typename StateType, typename InfoType>
 bool 
-VectorTimeStep<StateType>::last()const noexcept{
+VectorTimeStep<StateType, InfoType>::last()const noexcept{
 	return done();
 }
 
 
-template<typename StateTp>
+template<typename StateTp, typename InfoTp>
 inline
-std::ostream& operator<<(std::ostream& out, const VectorTimeStep<StateTp>& step){
+std::ostream& operator<<(std::ostream& out, const VectorTimeStep<StateTp, InfoTp>& step){
 
 	using json = nlohmann::json;
 	json j;
@@ -0,0 +1,69 @@
+#ifndef WITH_SNAPSHOT_MIXIN_H
+#define WITH_SNAPSHOT_MIXIN_H
+
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <type_traits>
+
+namespace rlenvscpp{
+namespace envs{
+
+///
+/// \brief class with_snapshot_mixin. Implemented by the in-process
+/// environments whose state can be saved and restored, so that search
+/// methods can branch from a state without creating new environments.
+/// A snapshot is a small trivially copyable value: it can be copied
+/// with memcpy and kept in pools. It holds the state of the episode
+/// but not the random generators or the options of the environment,
+/// so it should be restored to an environment made with the same options
+///
+template<typename SnapshotType>
+class with_snapshot_mixin
+{
+public:
+
+	static_assert(std::is_trivially_copyable_v<SnapshotType>, "The snapshot type should be trivially copyable");
+
+	///
+	/// \brief The type of the snapshot
+	///
+	typedef SnapshotType snapshot_type;
+
+	///
+	/// \brief Destructor
+	///
+	virtual ~with_snapshot_mixin()=default;
+
+	///
+	/// \brief Returns the current state of the environment
+	///
+	virtual snapshot_type snapshot()const=0;
+
+	///
+	/// \brief Put the environment in the state of the given snapshot
+	///
+	virtual void restore(const snapshot_type& snapshot)=0;
+};
+
+///
+/// \brief Snapshot of the environments whose state is an index
+///
+struct DiscreteStateSnapshot
+{
+	uint_t state;
+	uint_t n_steps;
+	bool is_finished;
+};
+
+///
+/// \brief Returns true if the environment EnvType supports snapshots
+///
+template<typename EnvType>
+inline constexpr bool has_snapshot_v = requires(EnvType& env){
+	env.restore(env.snapshot());
+};
+
+}
+}
+
+#endif // WITH_SNAPSHOT_MIXIN_H
@@ -40,6 +40,12 @@ typedef std::size_t uint_t;
 template<typename T>
 using DynMat = Eigen::MatrixX<T>;
 
+///
+/// \brief Dynamic matrix with row major storage
+///
+template<typename T>
+using RowMajorDynMat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
 ///
 /// \brief Dynamic×3 matrix of type double. 
 /// 
@@ -87,6 +93,9 @@ using FoatColVec = ColVec<float_t>;
 using RealColVec3d = Eigen::Vector3d;
 using FloatColVec3d = Eigen::Vector3f;
 
+using RealColVec4d = Eigen::Vector4d;
+using FloatColVec4d = Eigen::Vector4f;
+
 
 ///
 /// \brief A range of double precision floating point values
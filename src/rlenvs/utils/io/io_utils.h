@@ -3,6 +3,7 @@
 
 #include <ostream>
 #include <vector>
+#include <array>
 
 namespace rlenvscpp{
 namespace utils{
@@ -28,6 +29,12 @@ std::ostream& print_vector(std::ostream& out,
 							 
 }
 			
+template<typename T, std::size_t N>
+std::ostream& print_vector(std::ostream& out,
+                         const std::array<T, N>& obs){
+    return print_vector(out, std::vector<T>(obs.begin(), obs.end()));
+}
+			
 template<typename T>
 std::ostream& operator<<(std::ostream& out,
                          const std::vector<T>& obs){
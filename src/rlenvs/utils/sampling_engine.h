@@ -0,0 +1,52 @@
+#ifndef SAMPLING_ENGINE_H
+#define SAMPLING_ENGINE_H
+
+/**
+ * The engine the spaces in rlenvs/envs/space_type.h sample with. Every
+ * thread owns one Xoshiro256 that is seeded from std::random_device
+ * the first time the thread samples. Later samples make no system
+ * call and take no lock. For reproducible samples, seed the thread
+ * engine with seed_thread_sampling_engine(), or keep one engine per
+ * environment and pass it to the sample overloads that take an engine.
+ */
+
+#include "rlenvs/utils/xoshiro256.h"
+
+#include <random>
+
+namespace rlenvscpp{
+namespace utils{
+
+///
+/// \brief The type of the engine the spaces sample with
+///
+typedef Xoshiro256 sampling_engine_type;
+
+///
+/// \brief The sampling engine of the calling thread
+///
+inline
+sampling_engine_type&
+thread_sampling_engine(){
+
+	thread_local sampling_engine_type engine([](){
+		std::random_device rd;
+		return (static_cast<sampling_engine_type::result_type>(rd()) << 32) ^ rd();
+	}());
+
+	return engine;
+}
+
+///
+/// \brief Seed the sampling engine of the calling thread
+///
+inline
+void
+seed_thread_sampling_engine(sampling_engine_type::result_type seed)noexcept{
+	thread_sampling_engine().seed(seed);
+}
+
+}
+}
+
+#endif // SAMPLING_ENGINE_H
@@ -0,0 +1,110 @@
+#ifndef XOSHIRO256_H
+#define XOSHIRO256_H
+
+/**
+ * The xoshiro256++ pseudo-random number generator of
+ * David Blackman and Sebastiano Vigna, see https://prng.di.unimi.it/.
+ * It is considerably faster than std::mt19937_64 and has a state of
+ * only 32 bytes. It satisfies the UniformRandomBitGenerator
+ * requirements so it can drive the standard distributions.
+ */
+
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace rlenvscpp{
+namespace utils{
+
+///
+/// \brief The xoshiro256++ generator
+///
+class Xoshiro256
+{
+public:
+
+	///
+	/// \brief The type of the generated values
+	///
+	typedef std::uint64_t result_type;
+
+	///
+	/// \brief Constructor
+	///
+	explicit Xoshiro256(result_type seed=42)noexcept{this -> seed(seed);}
+
+	///
+	/// \brief Reset the state from the given seed. The state is filled
+	/// with the splitmix64 sequence started at seed, as recommended
+	///
+	void seed(result_type seed)noexcept;
+
+	///
+	/// \brief The next value
+	///
+	result_type operator()()noexcept;
+
+	///
+	/// \brief A value uniformly distributed in [0, n). Uses the
+	/// multiply and shift reduction of Lemire. The bias is at most
+	/// n / 2^64, negligible for small n
+	///
+	result_type bounded(result_type n)noexcept;
+
+	///
+	/// \brief A value uniformly distributed in [0, 1)
+	///
+	real_t uniform()noexcept{return static_cast<real_t>((*this)() >> 11) * 0x1.0p-53;}
+
+	static constexpr result_type min()noexcept{return std::numeric_limits<result_type>::min();}
+	static constexpr result_type max()noexcept{return std::numeric_limits<result_type>::max();}
+
+private:
+
+	std::array<result_type, 4> state_;
+
+	static constexpr result_type rotl_(result_type x, int k)noexcept{return (x << k) | (x >> (64 - k));}
+};
+
+inline
+void
+Xoshiro256::seed(result_type seed)noexcept{
+
+	for(auto& s : state_){
+		seed += 0x9e3779b97f4a7c15ULL;
+		auto z = seed;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		s = z ^ (z >> 31);
+	}
+}
+
+inline
+Xoshiro256::result_type
+Xoshiro256::operator()()noexcept{
+
+	const auto result = rotl_(state_[0] + state_[3], 23) + state_[0];
+	const auto t = state_[1] << 17;
+
+	state_[2] ^= state_[0];
+	state_[3] ^= state_[1];
+	state_[1] ^= state_[2];
+	state_[0] ^= state_[3];
+	state_[2] ^= t;
+	state_[3] = rotl_(state_[3], 45);
+
+	return result;
+}
+
+inline
+Xoshiro256::result_type
+Xoshiro256::bounded(result_type n)noexcept{
+	return static_cast<result_type>((static_cast<unsigned __int128>((*this)()) * n) >> 64);
+}
+
+}
+}
+
+#endif // XOSHIRO256_H
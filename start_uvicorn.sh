@@ -1,2 +1,2 @@
 cd rest_api
-bash start_uvicorn.sh
+bash start_uvicorn.sh "$@"
@@ -0,0 +1,160 @@
+#include "rlenvs/envs/api_server/apiserver_stats.h"
+#include "rlenvs/envs/api_server/http_connection.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdio>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::LatencyHistogram;
+using rlenvscpp::envs::APIServerStats;
+using rlenvscpp::envs::HTTPRequestTiming;
+
+std::vector<std::string>
+read_lines(const std::string& filename){
+
+	std::ifstream in(filename);
+	std::vector<std::string> lines;
+	std::string line;
+
+	while(std::getline(in, line)){
+		lines.push_back(line);
+	}
+
+	return lines;
+}
+
+}
+
+TEST(TestLatencyHistogram, SmallValuesAreExact) {
+
+	LatencyHistogram histogram;
+
+	for(std::uint64_t v=1; v<=100; ++v){
+		histogram.record(v);
+	}
+
+	ASSERT_EQ(histogram.count(), 100);
+	ASSERT_EQ(histogram.min(), 1);
+	ASSERT_EQ(histogram.max(), 100);
+	ASSERT_DOUBLE_EQ(histogram.mean(), 50.5);
+	ASSERT_EQ(histogram.value_at_quantile(0.5), 50);
+	ASSERT_EQ(histogram.value_at_quantile(0.99), 99);
+	ASSERT_EQ(histogram.value_at_quantile(1.0), 100);
+}
+
+TEST(TestLatencyHistogram, RelativeError) {
+
+	LatencyHistogram histogram;
+
+	// 1us up to 1s
+	for(std::uint64_t v=1000; v<=1000000000; v = v * 11 / 10){
+
+		histogram.clear();
+		histogram.record(v);
+
+		const auto q = histogram.value_at_quantile(0.5);
+		ASSERT_GE(q, v);
+		ASSERT_LE(static_cast<real_t>(q - v) / v, 1.0 / 64.0);
+	}
+}
+
+TEST(TestLatencyHistogram, Quantiles) {
+
+	LatencyHistogram histogram;
+
+	// 990 fast requests and 10 slow ones
+	for(uint_t i=0; i<990; ++i){
+		histogram.record(std::chrono::microseconds(100));
+	}
+
+	for(uint_t i=0; i<10; ++i){
+		histogram.record(std::chrono::milliseconds(10));
+	}
+
+	ASSERT_NEAR(histogram.value_at_quantile(0.5), 100000, 100000 / 64);
+	ASSERT_NEAR(histogram.value_at_quantile(0.99), 100000, 100000 / 64);
+	ASSERT_NEAR(histogram.value_at_quantile(0.999), 10000000, 10000000 / 64);
+	ASSERT_EQ(histogram.max(), 10000000);
+
+	LatencyHistogram other;
+	other.record(std::chrono::seconds(1));
+	histogram.merge(other);
+
+	ASSERT_EQ(histogram.count(), 1001);
+	ASSERT_EQ(histogram.max(), 1000000000);
+	ASSERT_EQ(histogram.value_at_quantile(1.0), 1000000000);
+}
+
+TEST(TestAPIServerStats, Record) {
+
+	APIServerStats stats;
+
+	HTTPRequestTiming timing;
+	timing.connect = std::chrono::microseconds(10);
+	timing.send = std::chrono::microseconds(5);
+	timing.wait = std::chrono::microseconds(100);
+	timing.bytes_sent = 120;
+	timing.bytes_received = 300;
+
+	stats.record("CartPole", "/step", timing);
+	stats.record("CartPole", "/step", timing, true);
+	stats.record("CartPole", "/reset", timing);
+	stats.record_parse("CartPole", "/step", std::chrono::microseconds(3));
+
+	auto snapshot = stats.snapshot();
+	ASSERT_EQ(snapshot.size(), 2);
+
+	const auto& step = snapshot[{"CartPole", "/step"}];
+	ASSERT_EQ(step.n_requests, 2);
+	ASSERT_EQ(step.n_errors, 1);
+	ASSERT_EQ(step.bytes_sent, 240);
+	ASSERT_EQ(step.bytes_received, 600);
+	ASSERT_EQ(step.latency.max(), 115000);
+	ASSERT_EQ(step.wait.count(), 2);
+	ASSERT_EQ(step.parse.count(), 1);
+
+	stats.enable(false);
+	stats.record("CartPole", "/step", timing);
+
+	const APIServerStats::key_type key("CartPole", "/step");
+	ASSERT_EQ(stats.snapshot()[key].n_requests, 2);
+
+	stats.clear();
+	ASSERT_TRUE(stats.snapshot().empty());
+}
+
+TEST(TestAPIServerStats, PeriodicCSVDump) {
+
+	const auto filename = "/tmp/rlenvs_test_stats_" + std::to_string(::getpid()) + ".csv";
+
+	APIServerStats stats;
+
+	HTTPRequestTiming timing;
+	timing.wait = std::chrono::microseconds(50);
+	stats.record("MountainCar", "/step", timing);
+	stats.record("MountainCar", "/make", timing);
+
+	stats.start_csv_dump(filename, std::chrono::milliseconds(10));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	stats.stop_csv_dump();
+
+	const auto lines = read_lines(filename);
+	std::remove(filename.c_str());
+
+	// the file header, the column names and at least two snapshots
+	ASSERT_GE(lines.size(), 2 + 2 * 2);
+	ASSERT_EQ(lines[1].rfind("#time,env,endpoint,", 0), 0);
+	ASSERT_NE(lines.back().find("MountainCar,/step,1,0,"), std::string::npos);
+}
@@ -0,0 +1,189 @@
+#include "rlenvs/envs/batch_time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/native/acrobot_vec_env.h"
+#include "rlenvs/envs/native/mountain_car_vec_env.h"
+#include "rlenvs/envs/native/pendulum_vec_env.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::BatchTimeStep;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::native::AcrobotV;
+using rlenvscpp::envs::native::MountainCarV;
+using rlenvscpp::envs::native::PendulumV;
+
+template<typename EnvType, typename ActionType>
+void assert_batch_matches_step(EnvType& env, EnvType& other, const std::vector<ActionType>& actions){
+
+	typename EnvType::batch_time_step_type batch;
+	env.reset_into(42, batch);
+	auto time_step = other.reset(42, std::unordered_map<std::string, std::any>());
+
+	for(uint_t t=0; t<12; ++t){
+
+		const auto n_envs = batch.n_envs();
+		const auto obs_size = batch.obs_size();
+		ASSERT_EQ(n_envs, env.get_n_envs());
+
+		for(uint_t i=0; i<n_envs; ++i){
+			ASSERT_EQ(batch.types()[i], time_step.types()[i]);
+			ASSERT_DOUBLE_EQ(batch.rewards()[i], time_step.rewards()[i]);
+			ASSERT_DOUBLE_EQ(batch.discounts()[i], 1.0);
+
+			for(uint_t j=0; j<obs_size; ++j){
+				ASSERT_DOUBLE_EQ(batch.observation(i)[j], time_step.observation_view(i)[j]);
+			}
+		}
+
+		env.step_into(actions, batch);
+		time_step = other.step(actions);
+	}
+}
+
+}
+
+
+TEST(TestBatchTimeStep, TestLayout) {
+
+	BatchTimeStep<real_t> batch(3, 2);
+	ASSERT_EQ(batch.n_envs(), 3);
+	ASSERT_EQ(batch.obs_size(), 2);
+	ASSERT_EQ(batch.observations().size(), 6);
+	ASSERT_FALSE(batch.done());
+
+	for(uint_t i=0; i<6; ++i){
+		batch.observations()[i] = static_cast<real_t>(i);
+	}
+
+	batch.rewards()[0] = 1.0;
+	batch.rewards()[2] = 2.0;
+	batch.types()[1] = TimeStepTp::LAST;
+	ASSERT_DOUBLE_EQ(batch.reward(), 3.0);
+	ASSERT_TRUE(batch.done());
+
+	// one row per environment
+	auto matrix = batch.observations_matrix();
+	ASSERT_EQ(matrix.rows(), 3);
+	ASSERT_EQ(matrix.cols(), 2);
+	ASSERT_DOUBLE_EQ(matrix(1, 0), 2.0);
+	ASSERT_DOUBLE_EQ(matrix(2, 1), 5.0);
+	ASSERT_DOUBLE_EQ(batch.observation(2)[1], 5.0);
+
+	// one column per environment over the same memory
+	auto columns = batch.observations_columns();
+	ASSERT_EQ(columns.rows(), 2);
+	ASSERT_EQ(columns.cols(), 3);
+	ASSERT_EQ(columns.data(), matrix.data());
+	ASSERT_DOUBLE_EQ(columns(0, 1), 2.0);
+	ASSERT_DOUBLE_EQ(columns(1, 2), 5.0);
+}
+
+TEST(TestBatchTimeStep, TestStepIntoReusesBuffers) {
+
+	AcrobotV env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(16);
+	options["max_episode_steps"] = static_cast<uint_t>(3);
+	env.make("v1", options);
+
+	AcrobotV::batch_time_step_type batch;
+	env.reset_into(42, batch);
+	ASSERT_EQ(batch.n_envs(), 16);
+	ASSERT_EQ(batch.obs_size(), 6);
+
+	const auto* obs = batch.observations().data();
+	const auto* rewards = batch.rewards().data();
+	const auto* types = batch.types().data();
+
+	std::vector<uint_t> actions(16, 2);
+	for(uint_t t=0; t<10; ++t){
+		env.step_into(actions, batch);
+		ASSERT_EQ(batch.observations().data(), obs);
+		ASSERT_EQ(batch.rewards().data(), rewards);
+		ASSERT_EQ(batch.types().data(), types);
+	}
+
+	ASSERT_THROW(env.step_into(std::vector<uint_t>(3, 0), batch), std::logic_error);
+}
+
+TEST(TestBatchTimeStep, TestAcrobotVMatchesStep) {
+
+	AcrobotV env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(8);
+	options["max_episode_steps"] = static_cast<uint_t>(5);
+	env.make("v1", options);
+
+	AcrobotV other = env.make_copy(1);
+
+	std::vector<uint_t> actions(8);
+	for(uint_t i=0; i<8; ++i){
+		actions[i] = i % 3;
+	}
+
+	assert_batch_matches_step(env, other, actions);
+}
+
+TEST(TestBatchTimeStep, TestMountainCarVAndPendulumVMatchStep) {
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(5);
+	options["max_episode_steps"] = static_cast<uint_t>(4);
+
+	MountainCarV car;
+	car.make("v0", options);
+	MountainCarV other_car = car.make_copy(1);
+	assert_batch_matches_step(car, other_car, std::vector<uint_t>({0, 1, 2, 1, 0}));
+
+	PendulumV pendulum;
+	pendulum.make("v1", options);
+	PendulumV other_pendulum = pendulum.make_copy(1);
+	assert_batch_matches_step(pendulum, other_pendulum, std::vector<real_t>({-2.0, -1.0, 0.0, 1.0, 2.0}));
+}
+
+TEST(TestBatchTimeStep, TestPendulumVStepReusesObservationBuffers) {
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(4);
+	options["max_episode_steps"] = static_cast<uint_t>(3);
+
+	PendulumV env;
+	env.make("v1", options);
+
+	const std::vector<real_t> actions({-2.0, -1.0, 1.0, 2.0});
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	time_step = env.step(actions);
+	time_step = env.step(actions);
+
+	// with only the latest time step kept the two buffers alternate
+	const auto* first = time_step.observation_view(0).data();
+	time_step = env.step(actions);
+	const auto* second = time_step.observation_view(0).data();
+	time_step = env.step(actions);
+	ASSERT_EQ(time_step.observation_view(0).data(), first);
+	time_step = env.step(actions);
+	ASSERT_EQ(time_step.observation_view(0).data(), second);
+
+	// a time step that is kept is not overwritten by later steps
+	auto kept = time_step;
+	std::vector<real_t> expected(kept.observation_view(1).begin(), kept.observation_view(1).end());
+	for(uint_t t=0; t<5; ++t){
+		time_step = env.step(actions);
+	}
+
+	for(uint_t j=0; j<expected.size(); ++j){
+		ASSERT_DOUBLE_EQ(kept.observation_view(1)[j], expected[j]);
+	}
+}
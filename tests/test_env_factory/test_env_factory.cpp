@@ -0,0 +1,147 @@
+#include "rlenvs/envs/env_factory.h"
+#include "rlenvs/envs/api_server/mock_server/mock_env_server.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/native/mountain_car_env.h"
+#include "rlenvs/envs/native/frozen_lake_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/rlenvs_types_v2.h"
+#include "rlenvs/extern/nlohmann/json/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::EnvBackend;
+using rlenvscpp::envs::EnvFactoryConfig;
+using rlenvscpp::envs::EnvRegistry;
+using rlenvscpp::envs::CartPoleInterface;
+using rlenvscpp::envs::FrozenLake4x4Interface;
+using rlenvscpp::envs::MockEnvServer;
+using rlenvscpp::envs::env_interface_t;
+using rlenvscpp::envs::make_env;
+
+namespace native = rlenvscpp::envs::native;
+namespace gymnasium = rlenvscpp::envs::gymnasium;
+
+// the same training code for every backend
+uint_t
+run_episode(CartPoleInterface& env){
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+
+	uint_t n_steps = 0;
+	while(!time_step.last()){
+		time_step = env.step(0);
+		n_steps += 1;
+	}
+
+	return n_steps;
+}
+
+}
+
+
+TEST(TestEnvFactory, TestConfig) {
+
+	ASSERT_EQ(rlenvscpp::envs::env_backend_from_string("rest"), EnvBackend::REST);
+	ASSERT_EQ(rlenvscpp::envs::env_backend_from_string("native"), EnvBackend::NATIVE);
+	ASSERT_EQ(rlenvscpp::envs::env_backend_from_string("mock"), EnvBackend::MOCK);
+	ASSERT_THROW(rlenvscpp::envs::env_backend_from_string("python"), std::logic_error);
+	ASSERT_EQ(rlenvscpp::envs::to_string(EnvBackend::NATIVE), "native");
+
+	auto json = nlohmann::json::parse(R"({"rest_url": "http://localhost:9000/api",
+	                                      "backend": "native",
+	                                      "envs": {"Taxi": "rest"}})");
+
+	auto config = EnvFactoryConfig::from_json(json);
+	ASSERT_EQ(config.rest_url, "http://localhost:9000/api");
+	ASSERT_TRUE(config.mock_url.empty());
+	ASSERT_EQ(config.backend("CartPole"), EnvBackend::NATIVE);
+	ASSERT_EQ(config.backend("Taxi"), EnvBackend::REST);
+
+	json["envs"]["Taxi"] = "grpc";
+	ASSERT_THROW(EnvFactoryConfig::from_json(json), std::logic_error);
+}
+
+TEST(TestEnvFactory, TestNativeBackend) {
+
+	auto env = make_env<CartPoleInterface>("CartPole", "v1", EnvBackend::NATIVE);
+	ASSERT_TRUE(env -> is_created());
+	ASSERT_EQ(env -> version(), "v1");
+	ASSERT_NE(dynamic_cast<native::CartPole*>(env.get()), nullptr);
+
+	ASSERT_GT(run_episode(*env), 0);
+
+	// the options are passed to make
+	std::unordered_map<std::string, std::any> options;
+	options["is_slippery"] = false;
+	auto lake = make_env<FrozenLake4x4Interface>("FrozenLake", "v1", EnvBackend::NATIVE, options);
+	ASSERT_FALSE(dynamic_cast<native::FrozenLake<4>*>(lake.get()) -> is_slippery());
+}
+
+TEST(TestEnvFactory, TestSwitchBackendFromConfig) {
+
+	MockEnvServer server;
+
+	EnvFactoryConfig config;
+	config.mock_url = server.url();
+	config.default_backend = EnvBackend::MOCK;
+
+	{
+		auto env = make_env<CartPoleInterface>("CartPole", "v1", config);
+		ASSERT_NE(dynamic_cast<gymnasium::CartPole*>(env.get()), nullptr);
+		ASSERT_GT(run_episode(*env), 0);
+		env -> close();
+	}
+
+	ASSERT_GT(server.n_requests(), 0);
+
+	// the same code now runs in-process
+	config.backends["CartPole"] = EnvBackend::NATIVE;
+	const auto n_requests = server.n_requests();
+
+	auto env = make_env<CartPoleInterface>("CartPole", "v1", config);
+	ASSERT_NE(dynamic_cast<native::CartPole*>(env.get()), nullptr);
+	ASSERT_GT(run_episode(*env), 0);
+	ASSERT_EQ(server.n_requests(), n_requests);
+
+	// the mock backend needs the server url
+	ASSERT_THROW(make_env<CartPoleInterface>("CartPole", "v1", EnvBackend::MOCK), std::logic_error);
+}
+
+TEST(TestEnvFactory, TestRegistry) {
+
+	typedef env_interface_t<native::MountainCar> mountain_car_interface;
+	auto& registry = EnvRegistry<mountain_car_interface>::instance();
+
+	// the REST MountainCar has a different interface
+	ASSERT_TRUE(registry.contains("MountainCar", EnvBackend::NATIVE));
+	ASSERT_FALSE(registry.contains("MountainCar", EnvBackend::REST));
+	ASSERT_THROW(make_env<mountain_car_interface>("MountainCar", "v0", EnvBackend::REST), std::logic_error);
+
+	auto cart_pole_backends = EnvRegistry<CartPoleInterface>::instance().backends("CartPole");
+	ASSERT_EQ(cart_pole_backends.size(), 3);
+
+	// user environments can be registered too
+	registry.add("SlowMountainCar", EnvBackend::NATIVE,
+	             [](uint_t cidx, const EnvFactoryConfig&){
+		             return std::unique_ptr<mountain_car_interface>(std::make_unique<native::MountainCar>(cidx));
+	             });
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(10);
+	auto env = make_env<mountain_car_interface>("SlowMountainCar", "v0", EnvBackend::NATIVE, options, EnvFactoryConfig(), 3);
+	ASSERT_EQ(env -> cidx(), 3);
+	ASSERT_EQ(dynamic_cast<native::MountainCar*>(env.get()) -> max_episode_steps(), 10);
+}
@@ -0,0 +1,150 @@
+#include "rlenvs/envs/with_snapshot_mixin.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/native/frozen_lake_env.h"
+#include "rlenvs/envs/native/black_jack_env.h"
+#include "rlenvs/envs/connect2/connect2_env.h"
+#include "rlenvs/envs/grid_world/grid_world_env.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::has_snapshot_v;
+using rlenvscpp::envs::native::CartPole;
+using rlenvscpp::envs::native::FrozenLake;
+using rlenvscpp::envs::native::BlackJack;
+using rlenvscpp::envs::connect2::Connect2;
+using rlenvscpp::envs::grid_world::Gridworld;
+using rlenvscpp::envs::grid_world::GridWorldInitType;
+
+static_assert(has_snapshot_v<CartPole>);
+static_assert(has_snapshot_v<FrozenLake<4> >);
+static_assert(has_snapshot_v<Connect2>);
+static_assert(has_snapshot_v<Gridworld<4> >);
+
+}
+
+
+TEST(TestEnvSnapshot, TestCartPoleRestore) {
+
+	CartPole env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+	env.step(1);
+
+	const auto snapshot = env.snapshot();
+	ASSERT_EQ(snapshot.n_steps, 1);
+	ASSERT_FALSE(snapshot.is_finished);
+
+	std::vector<std::vector<real_t> > observations;
+	for(uint_t i=0; i<5; ++i){
+		observations.push_back(env.step(i % 2).observation());
+	}
+
+	ASSERT_EQ(env.n_steps(), 6);
+
+	// the snapshot is a plain value that can be copied as bytes
+	CartPole::snapshot_type copy;
+	std::memcpy(&copy, &snapshot, sizeof(copy));
+	env.restore(copy);
+
+	ASSERT_EQ(env.n_steps(), 1);
+	for(uint_t j=0; j<4; ++j){
+		ASSERT_DOUBLE_EQ(env.state()[j], snapshot.state[j]);
+	}
+
+	// CartPole is deterministic so the same actions give the same states
+	for(uint_t i=0; i<5; ++i){
+		ASSERT_EQ(env.step(i % 2).observation(), observations[i]);
+	}
+}
+
+TEST(TestEnvSnapshot, TestFrozenLakeRestore) {
+
+	FrozenLake<4> env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["is_slippery"] = false;
+	env.make("v1", options);
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	const auto snapshot = env.snapshot();
+	ASSERT_EQ(snapshot.state, 0);
+
+	// RIGHT then DOWN into the hole at state 5
+	env.step(2);
+	auto time_step = env.step(1);
+	ASSERT_TRUE(time_step.last());
+	ASSERT_EQ(env.state(), 5);
+
+	env.restore(snapshot);
+	ASSERT_EQ(env.state(), 0);
+
+	// the restored episode is not finished
+	time_step = env.step(1);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_EQ(time_step.observation(), 4);
+}
+
+TEST(TestEnvSnapshot, TestBlackJackRestore) {
+
+	BlackJack env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	const auto state = env.state();
+	const auto snapshot = env.snapshot();
+
+	// stick ends the episode
+	auto time_step = env.step(0);
+	ASSERT_TRUE(time_step.last());
+
+	env.restore(snapshot);
+	ASSERT_EQ(env.state(), state);
+
+	time_step = env.step(0);
+	ASSERT_TRUE(time_step.last());
+}
+
+TEST(TestEnvSnapshot, TestBoardGamesRestore) {
+
+	Connect2 connect2;
+	connect2.make("v1", std::unordered_map<std::string, std::any>());
+	connect2.reset();
+	connect2.move(1, 0);
+
+	const auto connect2_snapshot = connect2.snapshot();
+	connect2.move(2, 1);
+	connect2.move(1, 2);
+
+	connect2.restore(connect2_snapshot);
+	ASSERT_EQ(connect2.get_valid_moves(), std::vector<uint_t>({1, 2, 3}));
+
+	Gridworld<4> grid_world;
+
+	std::unordered_map<std::string, std::any> options;
+	options["mode"] = std::any(GridWorldInitType::STATIC);
+	grid_world.make("v0", options);
+	grid_world.reset();
+
+	const auto grid_world_snapshot = grid_world.snapshot();
+	const auto first = grid_world.step(1);
+	grid_world.step(1);
+
+	grid_world.restore(grid_world_snapshot);
+	const auto second = grid_world.step(1);
+
+	ASSERT_EQ(first.observation(), second.observation());
+	ASSERT_DOUBLE_EQ(first.reward(), second.reward());
+}
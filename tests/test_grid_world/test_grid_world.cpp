@@ -356,6 +356,50 @@ TEST(TestGridworld, TestPLAYERMode ) {
 	
 }
 
+TEST(TestGridworld, TestPackedBoardMatchesBoard) {
 
+    const auto board_size = 4;
+    rlenvscpp::envs::grid_world::detail::board env;
+    env.init_board(board_size, GridWorldInitType::STATIC);
+
+    // every player position and action gives the same move and reward
+    for(int row=0; row<board_size; ++row){
+        for(int col=0; col<board_size; ++col){
+            for(uint_t a=0; a<4; ++a){
+
+                env.move_piece(board_component_type::PLAYER, board_position(row, col));
+
+                packed_board<board_size> packed;
+                packed.pack(env);
+
+                auto state = env.step(static_cast<GridWorldActionType>(a));
+                auto reward = packed.step(static_cast<GridWorldActionType>(a));
 
+                ASSERT_EQ(packed.position(board_component_type::PLAYER),
+                          env.components.find(board_component_type::PLAYER)->second.pos);
+                ASSERT_DOUBLE_EQ(reward, env.get_reward());
+                ASSERT_EQ(packed.get_state(), state);
+            }
+        }
+    }
+}
+
+TEST(TestGridworld, TestStepPacked) {
+
+    rlenvscpp::envs::grid_world::Gridworld<4> env;
 
+    std::unordered_map<std::string, std::any> options;
+    options["mode"] = std::any(GridWorldInitType::STATIC);
+    env.make("v0", options);
+    env.reset();
+
+    // the player starts at (0, 3). LEFT twice reaches the PIT at (0, 1)
+    ASSERT_DOUBLE_EQ(env.step_packed(static_cast<uint_t>(GridWorldActionType::LEFT)), -1.0);
+    ASSERT_DOUBLE_EQ(env.step_packed(static_cast<uint_t>(GridWorldActionType::LEFT)), -10.0);
+    ASSERT_TRUE(env.is_game_lost());
+
+    env.reset();
+    auto time_step = env.step(static_cast<uint_t>(GridWorldActionType::LEFT));
+    ASSERT_TRUE(time_step.mid());
+    ASSERT_EQ(time_step.observation(), env.packed_board().get_state());
+}
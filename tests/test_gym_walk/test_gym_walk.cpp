@@ -0,0 +1,153 @@
+#include "rlenvs/envs/gdrl/gym_walk.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <random>
+#include <cmath>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::gdrl::GymWalk;
+
+}
+
+
+TEST(TestGymWalk, TestMake) {
+
+	GymWalk<7> env;
+	ASSERT_FALSE(env.is_created());
+
+	env.make("v0", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "GymWalk");
+	ASSERT_EQ(env.n_states(), 7);
+	ASSERT_EQ(env.n_actions(), 2);
+	ASSERT_EQ(GymWalk<7>::START_STATE, 3);
+
+	GymWalk<7> env_v1;
+	ASSERT_THROW(env_v1.make("v1", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	GymWalk<7> env_invalid;
+	std::unordered_map<std::string, std::any> options;
+	options["p_stay"] = 0.6;
+	options["p_backward"] = 0.6;
+	ASSERT_THROW(env_invalid.make("v0", options), std::logic_error);
+
+	env.close();
+	ASSERT_FALSE(env.is_created());
+}
+
+TEST(TestGymWalk, TestDynamics) {
+
+	GymWalk<7> env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["p_stay"] = 0.2;
+	options["p_backward"] = 0.3;
+	env.make("v0", options);
+
+	for(uint_t s=0; s<env.n_states(); ++s){
+		for(uint_t a=0; a<env.n_actions(); ++a){
+
+			auto transitions = env.p(s, a);
+			ASSERT_EQ(transitions.size(), 3);
+
+			real_t sum = 0.0;
+			for(const auto& [prob, next_state, reward, done] : transitions){
+				sum += prob;
+			}
+
+			ASSERT_NEAR(sum, 1.0, 1.0e-12);
+		}
+	}
+
+	// moving right from the last non-terminal state reaches the goal
+	const auto& [prob, next_state, reward, done] = env.p(5, GymWalk<7>::RIGHT)[0];
+	ASSERT_DOUBLE_EQ(prob, 0.5);
+	ASSERT_EQ(next_state, 6);
+	ASSERT_DOUBLE_EQ(reward, 1.0);
+	ASSERT_TRUE(done);
+
+	// slipping backward from state 1 ends at the left end without reward
+	const auto& [prob_b, next_state_b, reward_b, done_b] = env.p(1, GymWalk<7>::RIGHT)[2];
+	ASSERT_DOUBLE_EQ(prob_b, 0.3);
+	ASSERT_EQ(next_state_b, 0);
+	ASSERT_DOUBLE_EQ(reward_b, 0.0);
+	ASSERT_TRUE(done_b);
+
+	// the end states are absorbing
+	ASSERT_EQ(std::get<1>(env.p(0, GymWalk<7>::RIGHT)[0]), 0);
+	ASSERT_EQ(std::get<1>(env.p(6, GymWalk<7>::LEFT)[0]), 6);
+}
+
+TEST(TestGymWalk, TestStep) {
+
+	GymWalk<7> env;
+	env.make("v0", std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), 3);
+
+	// without slips the walk is deterministic
+	time_step = env.step(GymWalk<7>::RIGHT);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_EQ(time_step.observation(), 4);
+
+	env.step(GymWalk<7>::RIGHT);
+	time_step = env.step(GymWalk<7>::RIGHT);
+	ASSERT_TRUE(time_step.last());
+	ASSERT_EQ(time_step.observation(), 6);
+	ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+
+	// the next step resets the environment
+	time_step = env.step(GymWalk<7>::LEFT);
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), 3);
+}
+
+TEST(TestGymWalk, TestRandomWalkValues) {
+
+	// Monte Carlo estimate of the values under the uniform random
+	// policy. The true values of the states 1..5 are 1/6..5/6
+	GymWalk<7> env;
+	env.make("v0", std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	std::mt19937 generator(42);
+	std::bernoulli_distribution policy(0.5);
+
+	std::vector<real_t> returns(7, 0.0);
+	std::vector<uint_t> visits(7, 0);
+	std::vector<uint_t> episode;
+
+	const uint_t n_episodes = 20000;
+	for(uint_t e=0; e<n_episodes; ++e){
+
+		auto time_step = env.reset(e, std::unordered_map<std::string, std::any>());
+		episode.clear();
+
+		while(!time_step.last()){
+			episode.push_back(time_step.observation());
+			time_step = env.step(policy(generator) ? GymWalk<7>::RIGHT : GymWalk<7>::LEFT);
+		}
+
+		for(auto s : episode){
+			returns[s] += time_step.reward();
+			visits[s] += 1;
+		}
+	}
+
+	for(uint_t s=1; s<6; ++s){
+		ASSERT_NEAR(returns[s] / static_cast<real_t>(visits[s]), static_cast<real_t>(s) / 6.0, 0.02);
+	}
+}
@@ -0,0 +1,755 @@
+#include "rlenvs/envs/api_server/http_connection.h"
+#include "rlenvs/envs/api_server/http_event_loop.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/api_server/wire_format.h"
+#include "rlenvs/envs/api_server/shard_router.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/vector_time_step.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <future>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+namespace{
+
+using namespace rlenvscpp;
+using rlenvscpp::envs::HTTPConnection;
+using rlenvscpp::envs::HTTPConnectionPool;
+using rlenvscpp::envs::HTTPEndpoint;
+using rlenvscpp::envs::HTTPResponse;
+using rlenvscpp::envs::RESTApiServerWrapper;
+using rlenvscpp::envs::ShardRouter;
+using rlenvscpp::envs::ShardPolicy;
+
+///
+/// \brief Minimal loopback HTTP server that answers every
+/// request with {"n": <number of requests served>} or
+/// with the given body
+///
+class LoopbackServer
+{
+public:
+
+	LoopbackServer(bool close_after_response=false, bool chunked=false,
+	               const std::string& body="",
+				   const std::string& content_type="application/json",
+				   const std::string& socket_path="")
+	:
+	close_after_response_(close_after_response),
+	chunked_(chunked),
+	body_(body),
+	content_type_(content_type),
+	socket_path_(socket_path)
+	{
+		if(!socket_path_.empty()){
+
+			// listen on a Unix domain socket instead
+			::unlink(socket_path_.c_str());
+			listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+			::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+			::listen(listen_fd_, 16);
+
+			thread_ = std::thread([this](){serve_();});
+			return;
+		}
+
+		listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+
+		int flag = 1;
+		::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = ::htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+		::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+		::listen(listen_fd_, 16);
+
+		socklen_t length = sizeof(address);
+		::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+		port_ = ::ntohs(address.sin_port);
+
+		thread_ = std::thread([this](){serve_();});
+	}
+
+	~LoopbackServer(){
+		stop_ = true;
+		::shutdown(listen_fd_, SHUT_RDWR);
+		::close(listen_fd_);
+		thread_.join();
+
+		if(!socket_path_.empty()){
+			::unlink(socket_path_.c_str());
+		}
+	}
+
+	std::string url()const{
+		
+		if(!socket_path_.empty()){
+			return "unix://" + socket_path_ + ":/api";
+		}
+		
+		return "http://127.0.0.1:" + std::to_string(port_) + "/api";
+	}
+	uint_t n_connections()const{return n_connections_;}
+	uint_t n_requests()const{return n_requests_;}
+
+	///
+	/// \brief The n-th request on every connection is read
+	/// but not answered. The connection is closed instead
+	///
+	void set_drop_request(uint_t n){drop_request_ = n;}
+	
+	std::string last_request(){
+		std::lock_guard<std::mutex> lock(mutex_);
+		return last_request_;
+	}
+
+private:
+
+	bool close_after_response_;
+	bool chunked_;
+	std::string body_;
+	std::string content_type_;
+	std::string socket_path_;
+	std::string last_request_;
+	int listen_fd_{-1};
+	int port_{0};
+	std::atomic<bool> stop_{false};
+	std::atomic<uint_t> n_connections_{0};
+	std::atomic<uint_t> n_requests_{0};
+	std::atomic<uint_t> drop_request_{0};
+	std::thread thread_;
+	std::mutex mutex_;
+	std::vector<int> connection_fds_;
+	std::vector<std::thread> connection_threads_;
+
+	void serve_(){
+
+		while(!stop_){
+
+			const auto fd = ::accept(listen_fd_, nullptr, nullptr);
+			if(fd == -1){
+				break;
+			}
+
+			n_connections_ += 1;
+
+			std::lock_guard<std::mutex> lock(mutex_);
+			connection_fds_.push_back(fd);
+			connection_threads_.emplace_back([this, fd](){serve_connection_(fd);});
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		for(auto fd : connection_fds_){
+			::shutdown(fd, SHUT_RDWR);
+		}
+
+		for(auto& thread : connection_threads_){
+			thread.join();
+		}
+
+		for(auto fd : connection_fds_){
+			::close(fd);
+		}
+	}
+
+	void serve_connection_(int fd){
+
+		std::string buffer;
+		char chunk[4096];
+		uint_t n_served = 0;
+
+		while(true){
+
+			const auto header_end = buffer.find("\r\n\r\n");
+			if(header_end == std::string::npos){
+				const auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+				if(n <= 0){
+					break;
+				}
+				buffer.append(chunk, n);
+				continue;
+			}
+
+			std::size_t length = 0;
+			const auto length_pos = buffer.find("Content-Length: ");
+			if(length_pos != std::string::npos && length_pos < header_end){
+				length = std::strtoul(buffer.c_str() + length_pos + 16, nullptr, 10);
+			}
+
+			if(buffer.size() < header_end + 4 + length){
+				const auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+				if(n <= 0){
+					break;
+				}
+				buffer.append(chunk, n);
+				continue;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				last_request_ = buffer.substr(0, header_end + 4 + length);
+			}
+			
+			buffer.erase(0, header_end + 4 + length);
+			const auto n_requests = ++n_requests_;
+
+			if(++n_served == drop_request_){
+				break;
+			}
+
+			const auto body = body_.empty() ? "{\"n\": " + std::to_string(n_requests) + "}" : body_;
+			std::string response = "HTTP/1.1 202 Accepted\r\nContent-Type: " + content_type_ + "\r\n";
+
+			if(chunked_){
+				const auto half = body.size() / 2;
+				std::ostringstream chunks;
+				chunks<<std::hex<<half<<"\r\n"<<body.substr(0, half)<<"\r\n";
+				chunks<<std::hex<<body.size() - half<<"\r\n"<<body.substr(half)<<"\r\n";
+				response += "Transfer-Encoding: chunked\r\n\r\n";
+				response += chunks.str();
+				response += "0\r\n\r\n";
+			}
+			else{
+				response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+			}
+
+			::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+
+			if(close_after_response_){
+				break;
+			}
+		}
+
+		::shutdown(fd, SHUT_RDWR);
+	}
+};
+
+}
+
+TEST(TestHTTPConnection, EndpointParse) {
+
+	auto endpoint = HTTPEndpoint::parse("http://0.0.0.0:8001/api");
+	ASSERT_EQ(endpoint.host, "0.0.0.0");
+	ASSERT_EQ(endpoint.port, "8001");
+	ASSERT_EQ(endpoint.path, "/api");
+
+	endpoint = HTTPEndpoint::parse("http://localhost");
+	ASSERT_EQ(endpoint.host, "localhost");
+	ASSERT_EQ(endpoint.port, "80");
+	ASSERT_EQ(endpoint.path, "");
+
+	EXPECT_THROW(HTTPEndpoint::parse("https://localhost:8001/api"), std::logic_error);
+
+	endpoint = HTTPEndpoint::parse("unix:///tmp/rlenvs.sock:/api");
+	ASSERT_TRUE(endpoint.is_unix());
+	ASSERT_EQ(endpoint.socket_path, "/tmp/rlenvs.sock");
+	ASSERT_EQ(endpoint.path, "/api");
+
+	endpoint = HTTPEndpoint::parse("unix:///tmp/rlenvs.sock");
+	ASSERT_EQ(endpoint.socket_path, "/tmp/rlenvs.sock");
+	ASSERT_EQ(endpoint.path, "");
+
+	EXPECT_THROW(HTTPEndpoint::parse("unix://:/api"), std::logic_error);
+}
+
+TEST(TestHTTPConnection, UnixDomainSocket) {
+
+	const auto socket_path = "/tmp/rlenvs_test_" + std::to_string(::getpid()) + ".sock";
+	LoopbackServer server(false, false, "", "application/json", socket_path);
+	RESTApiServerWrapper api_server(server.url());
+
+	for(uint_t i=0; i<5; ++i){
+		auto response = api_server.step("CartPole", 0, 1);
+		ASSERT_EQ(response["n"], i + 1);
+	}
+
+	ASSERT_NE(server.last_request().find("POST /api/gymnasium/cart-pole-env/step HTTP/1.1"),
+	          std::string::npos);
+
+	auto future = api_server.async_step("CartPole", 1, 0);
+	ASSERT_EQ(future.get()["n"], 6);
+	ASSERT_EQ(server.n_connections(), 2);
+}
+
+TEST(TestHTTPConnection, ReusesConnection) {
+
+	LoopbackServer server;
+	HTTPConnectionPool pool(server.url());
+
+	for(uint_t i=0; i<10; ++i){
+		auto response = pool.request("POST", server.url() + "/step", "{}");
+		ASSERT_EQ(response.status, 202);
+		ASSERT_EQ(response.body, "{\"n\": " + std::to_string(i + 1) + "}");
+	}
+
+	ASSERT_EQ(server.n_connections(), 1);
+	ASSERT_EQ(pool.n_opened_connections(), 1);
+	ASSERT_EQ(pool.n_idle_connections(), 1);
+}
+
+TEST(TestHTTPConnection, NoKeepAlive) {
+
+	LoopbackServer server;
+	HTTPConnectionPool pool(server.url(), false);
+
+	for(uint_t i=0; i<5; ++i){
+		auto response = pool.request("POST", server.url() + "/step", "{}");
+		ASSERT_EQ(response.status, 202);
+	}
+
+	ASSERT_EQ(server.n_connections(), 5);
+	ASSERT_EQ(pool.n_idle_connections(), 0);
+}
+
+TEST(TestHTTPConnection, ResendsOnStaleConnection) {
+
+	// the server closes every connection after the
+	// response without announcing it
+	LoopbackServer server(true);
+	HTTPConnectionPool pool(server.url());
+
+	for(uint_t i=0; i<5; ++i){
+		auto response = pool.request("GET", server.url() + "/is-alive?cidx=0");
+		ASSERT_EQ(response.status, 202);
+	}
+
+	ASSERT_EQ(server.n_requests(), 5);
+}
+
+TEST(TestHTTPConnection, DropsIdleConnectionClosedByServer) {
+
+	LoopbackServer server(true);
+	HTTPConnectionPool pool(server.url());
+
+	auto response = pool.request("POST", server.url() + "/step", "{}");
+	ASSERT_EQ(response.status, 202);
+
+	// give the server time to close the idle connection
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	response = pool.request("POST", server.url() + "/step", "{}");
+	ASSERT_EQ(response.body, "{\"n\": 2}");
+	ASSERT_EQ(pool.n_opened_connections(), 2);
+}
+
+TEST(TestHTTPConnection, DoesNotResendPostAfterClose) {
+
+	// the server reads the second request of the
+	// connection and closes it without answering
+	LoopbackServer server;
+	server.set_drop_request(2);
+	HTTPConnectionPool pool(server.url());
+
+	auto response = pool.request("POST", server.url() + "/step", "{}");
+	ASSERT_EQ(response.status, 202);
+
+	EXPECT_THROW(pool.request("POST", server.url() + "/step", "{}"), rlenvscpp::envs::HTTPConnectionClosed);
+	ASSERT_EQ(server.n_requests(), 2);
+}
+
+TEST(TestHTTPConnection, ResendsGetAfterClose) {
+
+	LoopbackServer server;
+	server.set_drop_request(2);
+	HTTPConnectionPool pool(server.url());
+
+	pool.request("GET", server.url() + "/is-alive?cidx=0");
+
+	auto response = pool.request("GET", server.url() + "/is-alive?cidx=0");
+	ASSERT_EQ(response.body, "{\"n\": 3}");
+	ASSERT_EQ(server.n_requests(), 3);
+}
+
+TEST(TestHTTPConnection, ResendsPostWhenAllowed) {
+
+	LoopbackServer server;
+	server.set_drop_request(2);
+	HTTPConnectionPool pool(server.url());
+	pool.set_retry_non_idempotent(true);
+
+	pool.request("POST", server.url() + "/step", "{}");
+
+	auto response = pool.request("POST", server.url() + "/step", "{}");
+	ASSERT_EQ(response.body, "{\"n\": 3}");
+	ASSERT_EQ(server.n_requests(), 3);
+}
+
+TEST(TestHTTPConnection, ChunkedResponse) {
+
+	LoopbackServer server(false, true);
+	HTTPConnectionPool pool(server.url());
+
+	auto response = pool.request("GET", server.url() + "/is-alive?cidx=0");
+	ASSERT_EQ(response.status, 202);
+	ASSERT_EQ(response.body, "{\"n\": 1}");
+
+	response = pool.request("GET", server.url() + "/is-alive?cidx=0");
+	ASSERT_EQ(response.body, "{\"n\": 2}");
+	ASSERT_EQ(server.n_connections(), 1);
+}
+
+TEST(TestHTTPConnection, PipelinedResponses) {
+
+	LoopbackServer server;
+	HTTPConnection connection(HTTPEndpoint::parse(server.url()));
+
+	for(uint_t i=0; i<3; ++i){
+		connection.write_request("POST", "/api/step", "{}");
+	}
+
+	for(uint_t i=0; i<3; ++i){
+		auto response = connection.read_response();
+		ASSERT_EQ(response.body, "{\"n\": " + std::to_string(i + 1) + "}");
+	}
+
+	ASSERT_EQ(connection.n_requests(), 3);
+}
+
+TEST(TestHTTPConnection, WrapperCopiesSharePool) {
+
+	LoopbackServer server;
+	RESTApiServerWrapper api_server(server.url());
+	RESTApiServerWrapper copy(api_server);
+
+	ASSERT_TRUE(api_server.keep_alive());
+
+	api_server.step("CartPole", 0, 1);
+	copy.step("CartPole", 1, 0);
+
+	ASSERT_EQ(server.n_connections(), 1);
+	ASSERT_EQ(&api_server.connection_pool(), &copy.connection_pool());
+}
+
+TEST(TestHTTPConnection, StepSequence) {
+
+	LoopbackServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	std::vector<uint_t> actions(100, 1);
+	auto time_steps = api_server.step_sequence("CartPole", 0, actions, 8);
+
+	ASSERT_EQ(time_steps.size(), 100);
+	for(uint_t i=0; i<time_steps.size(); ++i){
+		ASSERT_EQ(time_steps[i]["n"], i + 1);
+	}
+
+	ASSERT_EQ(server.n_connections(), 1);
+	ASSERT_EQ(api_server.connection_pool().n_idle_connections(), 1);
+}
+
+TEST(TestHTTPConnection, StepSequenceStopsOnClose) {
+
+	// the server reads the third step and closes the connection
+	// without answering. The step may have been executed so it
+	// must not be sent again
+	LoopbackServer server;
+	server.set_drop_request(3);
+	RESTApiServerWrapper api_server(server.url());
+
+	std::vector<uint_t> actions(5, 0);
+
+	try{
+		api_server.step_sequence("CartPole", 0, actions, 1);
+		FAIL()<<"Expected HTTPSequenceInterrupted";
+	}
+	catch(const rlenvscpp::envs::HTTPSequenceInterrupted& e){
+		ASSERT_EQ(e.n_confirmed(), 2);
+	}
+
+	ASSERT_EQ(server.n_requests(), 3);
+	ASSERT_EQ(server.n_connections(), 1);
+}
+
+TEST(TestHTTPConnection, GetSequenceResendsOnClose) {
+
+	LoopbackServer server;
+	server.set_drop_request(3);
+	HTTPConnectionPool pool(server.url());
+
+	std::vector<std::string> bodies(5);
+	auto responses = pool.request_sequence("GET", server.url() + "/is-alive?cidx=0", bodies, {}, 1);
+
+	// every third request of a connection is dropped and resent
+	ASSERT_EQ(responses.size(), 5);
+	ASSERT_EQ(responses.back().body, "{\"n\": 7}");
+	ASSERT_EQ(server.n_requests(), 7);
+	ASSERT_EQ(server.n_connections(), 3);
+}
+
+TEST(TestHTTPConnection, WrapperRecordsStats) {
+
+	LoopbackServer server;
+	RESTApiServerWrapper api_server(server.url());
+	auto copy = api_server;
+
+	for(uint_t i=0; i<5; ++i){
+		api_server.step("CartPole", 0, 1);
+	}
+
+	copy.step_sequence("CartPole", 0, std::vector<uint_t>(10, 1), 4);
+
+	auto stats = api_server.stats();
+	ASSERT_EQ(stats.size(), 1);
+
+	const auto& step = stats[{"CartPole", "/step"}];
+	ASSERT_EQ(step.n_requests, 15);
+	ASSERT_EQ(step.n_errors, 0);
+	ASSERT_GT(step.bytes_sent, 0);
+	ASSERT_GT(step.bytes_received, 0);
+	ASSERT_EQ(step.latency.count(), 15);
+	ASSERT_EQ(step.wait.count(), 15);
+	ASSERT_EQ(step.parse.count(), 15);
+	ASSERT_GE(step.latency.value_at_quantile(0.99), step.wait.value_at_quantile(0.5));
+}
+
+TEST(TestHTTPConnection, ShardedWrapper) {
+
+	LoopbackServer server_0;
+	LoopbackServer server_1;
+	RESTApiServerWrapper api_server({server_0.url(), server_1.url()});
+
+	ASSERT_EQ(api_server.n_shards(), 2);
+
+	std::vector<uint_t> n_requests(2, 0);
+	for(uint_t cidx=0; cidx<20; ++cidx){
+
+		api_server.step("CartPole", cidx, 1);
+		n_requests[api_server.shard("CartPole", cidx)] += 1;
+	}
+
+	ASSERT_EQ(server_0.n_requests(), n_requests[0]);
+	ASSERT_EQ(server_1.n_requests(), n_requests[1]);
+	ASSERT_GT(n_requests[0], 0);
+	ASSERT_GT(n_requests[1], 0);
+	ASSERT_EQ(api_server.get_env_url("CartPole", 3), 
+	          api_server.get_urls()[api_server.shard("CartPole", 3)] + "/gymnasium/cart-pole-env");
+}
+
+TEST(TestShardRouter, ConsistentHash) {
+
+	std::vector<std::string> urls = {"http://a:8001/api", "http://b:8001/api",
+	                                 "http://c:8001/api", "http://d:8001/api"};
+	ShardRouter router(urls);
+
+	const uint_t n_copies = 1000;
+	std::vector<uint_t> shards(n_copies);
+	std::vector<uint_t> loads(urls.size(), 0);
+
+	for(uint_t cidx=0; cidx<n_copies; ++cidx){
+		shards[cidx] = router.shard("CartPole", cidx);
+		loads[shards[cidx]] += 1;
+	}
+
+	for(auto load : loads){
+		ASSERT_GT(load, n_copies / 8);
+		ASSERT_LT(load, n_copies / 2);
+	}
+
+	// a new server only takes copies from the others
+	urls.push_back("http://e:8001/api");
+	ShardRouter bigger(urls);
+
+	uint_t n_moved = 0;
+	for(uint_t cidx=0; cidx<n_copies; ++cidx){
+
+		const auto shard = bigger.shard("CartPole", cidx);
+		if(shard != shards[cidx]){
+			ASSERT_EQ(shard, 4);
+			n_moved += 1;
+		}
+	}
+
+	ASSERT_GT(n_moved, 0);
+	ASSERT_LT(n_moved, n_copies / 2);
+}
+
+TEST(TestShardRouter, LeastLoaded) {
+
+	ShardRouter router({"http://a:8001/api", "http://b:8001/api", "http://c:8001/api"},
+	                   ShardPolicy::LEAST_LOADED);
+
+	for(uint_t cidx=0; cidx<6; ++cidx){
+		ASSERT_EQ(router.assign("CartPole", cidx), cidx % 3);
+	}
+
+	// an assigned copy keeps its server
+	ASSERT_EQ(router.assign("CartPole", 4), 1);
+	ASSERT_EQ(router.shard("CartPole", 4), 1);
+
+	router.release("CartPole", 4);
+	ASSERT_EQ(router.load(1), 1);
+	ASSERT_EQ(router.assign("Acrobot", 0), 1);
+	ASSERT_EQ(router.load(1), 2);
+}
+
+TEST(TestHTTPConnection, StepBatch) {
+
+	const std::string body = "{\"time_steps\": ["
+	                         "{\"cidx\": 0, \"time_step\": {\"reward\": 1.0}},"
+							 "{\"cidx\": 1, \"time_step\": {\"reward\": 0.0}}]}";
+
+	LoopbackServer server(false, false, body);
+	RESTApiServerWrapper api_server(server.url());
+
+	std::vector<std::pair<uint_t, uint_t> > actions = {{0, 1}, {1, 0}};
+	auto time_steps = api_server.step_batch("CartPole", actions);
+
+	ASSERT_TRUE(time_steps.is_array());
+	ASSERT_EQ(time_steps.size(), 2);
+	ASSERT_EQ(time_steps[1]["cidx"], 1);
+	ASSERT_EQ(server.n_requests(), 1);
+}
+
+TEST(TestHTTPConnection, BinaryTimeStepNegotiation) {
+
+	using rlenvscpp::envs::WireFormat;
+	using rlenvscpp::TimeStep;
+	using rlenvscpp::TimeStepTp;
+	namespace wire_format = rlenvscpp::envs::wire_format;
+
+	const std::vector<real_t> obs = {0.1, -0.2, 0.3, -0.4};
+	const auto body = wire_format::encode_time_step(TimeStepTp::MID, 1.0, 0.99,
+	                                                obs.data(), obs.size());
+
+	LoopbackServer server(false, false, body, rlenvscpp::envs::BINARY_TIME_STEP_MEDIA_TYPE);
+	RESTApiServerWrapper api_server(server.url());
+
+	auto response = api_server.step_raw("CartPole", 0, 1,
+	                                    wire_format::accept_headers(WireFormat::BINARY));
+
+	ASSERT_NE(server.last_request().find("Accept: " + rlenvscpp::envs::BINARY_TIME_STEP_MEDIA_TYPE),
+	          std::string::npos);
+	ASSERT_TRUE(wire_format::is_binary(response));
+
+	auto time_step = wire_format::decode_time_step<TimeStep<std::vector<real_t> > >(response.body);
+	ASSERT_EQ(time_step.type(), TimeStepTp::MID);
+	ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+	ASSERT_DOUBLE_EQ(time_step.discount(), 0.99);
+	ASSERT_EQ(time_step.observation(), obs);
+}
+
+TEST(TestHTTPConnection, BinaryVectorTimeStep) {
+
+	using rlenvscpp::VectorTimeStep;
+	using rlenvscpp::TimeStepTp;
+	namespace wire_format = rlenvscpp::envs::wire_format;
+
+	const std::vector<TimeStepTp> types = {TimeStepTp::MID, TimeStepTp::LAST};
+	const std::vector<real_t> rewards = {-1.0, 0.0};
+	const std::vector<real_t> discounts = {1.0, 1.0};
+	const std::vector<real_t> obs = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+
+	const auto body = wire_format::encode_vector_time_step(types, rewards, discounts, obs.data(), 3);
+	auto time_step = wire_format::decode_time_step<VectorTimeStep<std::vector<real_t> > >(body);
+
+	ASSERT_EQ(time_step.types(), types);
+	ASSERT_EQ(time_step.rewards(), rewards);
+	ASSERT_EQ(time_step.observations().size(), 2);
+	ASSERT_EQ(time_step.observations()[1], std::vector<real_t>({4.0, 5.0, 6.0}));
+	ASSERT_TRUE(time_step.last());
+
+	EXPECT_THROW(wire_format::decode_time_step<VectorTimeStep<std::vector<real_t> > >(body.substr(1)),
+	             std::runtime_error);
+}
+
+TEST(TestHTTPEventLoop, ManyRequestsInFlight) {
+
+	LoopbackServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	std::vector<std::future<nlohmann::json> > responses;
+	for(uint_t i=0; i<200; ++i){
+		responses.push_back(api_server.async_step("CartPole", i, 1));
+	}
+
+	for(auto& response : responses){
+		ASSERT_TRUE(response.get().contains("n"));
+	}
+
+	ASSERT_EQ(server.n_requests(), 200);
+	ASSERT_EQ(api_server.connection_pool().event_loop().n_pending(), 0);
+}
+
+TEST(TestHTTPEventLoop, HandlerRunsOnResponse) {
+
+	LoopbackServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	auto future = api_server.async_reset("CartPole", 0, 42, nlohmann::json(),
+	                                     [](const nlohmann::json& response){return response["n"].get<uint_t>() * 10;});
+
+	ASSERT_EQ(future.get(), 10);
+}
+
+TEST(TestHTTPEventLoop, ResendsOnStaleConnection) {
+
+	LoopbackServer server(true);
+	HTTPConnectionPool pool(server.url());
+
+	for(uint_t i=0; i<5; ++i){
+
+		std::promise<int> status;
+		pool.async_request("GET", server.url() + "/is-alive?cidx=0", "", {},
+		                   [&status](HTTPResponse&& response, std::exception_ptr error){
+							   if(error){
+								   status.set_exception(error);
+								   return;
+							   }
+							   status.set_value(response.status);
+						   });
+
+		ASSERT_EQ(status.get_future().get(), 202);
+	}
+
+	ASSERT_EQ(server.n_requests(), 5);
+}
+
+TEST(TestHTTPEventLoop, DoesNotResendPostAfterClose) {
+
+	LoopbackServer server;
+	server.set_drop_request(2);
+	RESTApiServerWrapper api_server(server.url());
+
+	auto response = api_server.async_step("CartPole", 0, 1).get();
+	ASSERT_TRUE(response.contains("n"));
+
+	auto future = api_server.async_step("CartPole", 0, 1);
+	EXPECT_THROW(future.get(), std::runtime_error);
+	ASSERT_EQ(server.n_requests(), 2);
+}
+
+TEST(TestHTTPEventLoop, FailedConnectionThrows) {
+
+	std::string url;
+	{
+		// a port nobody listens to
+		LoopbackServer server;
+		url = server.url();
+	}
+
+	RESTApiServerWrapper api_server(url);
+	auto future = api_server.async_step("CartPole", 0, 1);
+	EXPECT_THROW(future.get(), std::runtime_error);
+}
@@ -0,0 +1,251 @@
+#include "rlenvs/envs/api_server/mock_server/mock_env_server.h"
+#include "rlenvs/envs/api_server/apiserver.h"
+#include "rlenvs/envs/api_server/wire_format.h"
+#include "rlenvs/envs/gymnasium/classic_control/cart_pole_env.h"
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <any>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::MockEnvServer;
+using rlenvscpp::envs::MockCannedEnv;
+using rlenvscpp::envs::RESTApiServerWrapper;
+using rlenvscpp::envs::WireFormat;
+using rlenvscpp::envs::gymnasium::CartPole;
+
+}
+
+
+TEST(TestMockServer, CartPoleEpisode) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	CartPole env(api_server);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_TRUE(env.is_alive());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.type(), TimeStepTp::FIRST);
+	ASSERT_EQ(time_step.observation().size(), 4);
+
+	// always pushing left terminates the episode quickly
+	uint_t n_steps = 0;
+	while(!time_step.last()){
+		time_step = env.step(0);
+		n_steps += 1;
+		ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+	}
+
+	ASSERT_GT(n_steps, 0);
+	ASSERT_LT(n_steps, rlenvscpp::envs::MockCartPole::MAX_EPISODE_STEPS);
+
+	env.close();
+	ASSERT_FALSE(api_server.is_alive("CartPole", 0)["result"]);
+}
+
+TEST(TestMockServer, CartPoleResetIsSeeded) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	CartPole env(api_server);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto first = env.reset(7, std::unordered_map<std::string, std::any>());
+	auto second = env.reset(7, std::unordered_map<std::string, std::any>());
+	auto third = env.reset(8, std::unordered_map<std::string, std::any>());
+
+	ASSERT_EQ(first.observation(), second.observation());
+	ASSERT_NE(first.observation(), third.observation());
+	env.close();
+}
+
+TEST(TestMockServer, ResetSkipsUnsupportedOptions) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	CartPole env(api_server);
+	env.make("v1", std::unordered_map<std::string, std::any>());
+
+	// options without a JSON form are not sent rather than rejected
+	std::unordered_map<std::string, std::any> options;
+	options["low"] = static_cast<real_t>(-0.05);
+	options["callback"] = std::vector<uint_t>({1, 2});
+
+	auto with_options = env.reset(7, options);
+	auto without_options = env.reset(7, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(with_options.observation(), without_options.observation());
+
+	auto async_step = env.async_reset(7, options).get();
+	ASSERT_EQ(async_step.observation(), without_options.observation());
+	env.close();
+}
+
+TEST(TestMockServer, BinaryWireFormat) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	CartPole json_env(api_server);
+	json_env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto binary_env = json_env.make_copy(1);
+	binary_env.set_wire_format(WireFormat::BINARY);
+
+	auto json_step = json_env.reset(3, std::unordered_map<std::string, std::any>());
+	auto binary_step = binary_env.reset(3, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(json_step.observation().size(), binary_step.observation().size());
+
+	for(uint_t i=0; i<json_step.observation().size(); ++i){
+		ASSERT_NEAR(json_step.observation()[i], binary_step.observation()[i], 1.0e-12);
+	}
+
+	json_step = json_env.step(1);
+	binary_step = binary_env.step(1);
+	ASSERT_EQ(json_step.type(), binary_step.type());
+	ASSERT_DOUBLE_EQ(json_step.reward(), binary_step.reward());
+
+	for(uint_t i=0; i<json_step.observation().size(); ++i){
+		ASSERT_NEAR(json_step.observation()[i], binary_step.observation()[i], 1.0e-12);
+	}
+
+	binary_env.close();
+	json_env.close();
+}
+
+TEST(TestMockServer, AsyncStepUsesWireFormat) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	CartPole json_env(api_server);
+	json_env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto binary_env = json_env.make_copy(1);
+	binary_env.set_wire_format(WireFormat::BINARY);
+
+	auto json_step = json_env.reset(3, std::unordered_map<std::string, std::any>());
+	auto binary_step = binary_env.async_reset(3, std::unordered_map<std::string, std::any>()).get();
+	ASSERT_EQ(binary_step.type(), TimeStepTp::FIRST);
+
+	for(uint_t i=0; i<json_step.observation().size(); ++i){
+		ASSERT_NEAR(json_step.observation()[i], binary_step.observation()[i], 1.0e-12);
+	}
+
+	json_step = json_env.step(1);
+	binary_step = binary_env.async_step(1).get();
+	ASSERT_EQ(json_step.type(), binary_step.type());
+
+	for(uint_t i=0; i<json_step.observation().size(); ++i){
+		ASSERT_NEAR(json_step.observation()[i], binary_step.observation()[i], 1.0e-12);
+	}
+
+	// a future that is dropped never touches the environment
+	{
+		auto dropped = binary_env.async_step(1);
+	}
+
+	binary_env.close();
+	json_env.close();
+}
+
+TEST(TestMockServer, CannedDynamicsAndBatch) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	api_server.make("FrozenLake", 0, "v1", nlohmann::json());
+	api_server.make("FrozenLake", 1, "v1", nlohmann::json());
+
+	auto dynamics = api_server.dynamics("FrozenLake", 0, 5, 2)["dynamics"];
+	ASSERT_EQ(dynamics.size(), 1);
+	ASSERT_DOUBLE_EQ(dynamics[0][0].get<real_t>(), 1.0);
+	ASSERT_EQ(dynamics[0][1].get<uint_t>(), 5);
+
+	api_server.reset("FrozenLake", 0, 42, nlohmann::json());
+	api_server.reset("FrozenLake", 1, 42, nlohmann::json());
+
+	std::vector<std::pair<uint_t, uint_t> > actions = {{0, 1}, {1, 2}};
+	auto time_steps = api_server.step_batch("FrozenLake", actions);
+
+	ASSERT_EQ(time_steps.size(), 2);
+	ASSERT_EQ(time_steps[1]["cidx"], 1);
+	ASSERT_EQ(time_steps[1]["time_step"]["observation"], 0);
+
+	// CartPole has no dynamics and the server answers 404
+	api_server.make("CartPole", 0, "v1", nlohmann::json());
+	ASSERT_FALSE(api_server.dynamics("CartPole", 0, 0, 0).contains("dynamics"));
+
+	api_server.close("FrozenLake", 0);
+	api_server.close("FrozenLake", 1);
+	api_server.close("CartPole", 0);
+}
+
+TEST(TestMockServer, BatchWithInvalidEntryStepsNothing) {
+
+	MockEnvServer server;
+	RESTApiServerWrapper api_server(server.url());
+
+	for(uint_t c=0; c<3; ++c){
+		api_server.make("CartPole", c, "v1", nlohmann::json());
+		api_server.reset("CartPole", c, 42, nlohmann::json());
+	}
+
+	// a batch with an invalid action or copy index is rejected
+	std::vector<std::pair<uint_t, uint_t> > invalid_action = {{0, 1}, {1, 5}};
+	EXPECT_THROW(api_server.step_batch("CartPole", invalid_action), std::runtime_error);
+
+	std::vector<std::pair<uint_t, uint_t> > invalid_copy = {{0, 1}, {7, 1}};
+	EXPECT_THROW(api_server.step_batch("CartPole", invalid_copy), std::runtime_error);
+
+	// copy 0 was not stepped by the rejected batches
+	std::vector<std::pair<uint_t, uint_t> > actions = {{0, 1}, {2, 1}};
+	auto time_steps = api_server.step_batch("CartPole", actions);
+	ASSERT_EQ(time_steps[0]["time_step"]["observation"], time_steps[1]["time_step"]["observation"]);
+
+	for(uint_t c=0; c<3; ++c){
+		api_server.close("CartPole", c);
+	}
+}
+
+TEST(TestMockServer, CustomEnvOverUnixSocket) {
+
+	const std::string path = "/tmp/rlenvs_test_mock_server_" + std::to_string(::getpid()) + ".sock";
+
+	MockEnvServer server(path);
+	ASSERT_EQ(server.port(), 0);
+
+	server.add_env("/gymnasium/taxi-env",
+	               [](){return std::make_unique<MockCannedEnv>(17, 20.0, 2);});
+
+	RESTApiServerWrapper api_server(server.url());
+	api_server.make("Taxi", 0, "v3", nlohmann::json());
+
+	auto response = api_server.reset("Taxi", 0, 42, nlohmann::json());
+	ASSERT_EQ(response["time_step"]["observation"], 17);
+
+	response = api_server.step("Taxi", 0, 1);
+	ASSERT_EQ(response["time_step"]["step_type"], 1);
+	response = api_server.step("Taxi", 0, 1);
+	ASSERT_EQ(response["time_step"]["step_type"], 2);
+	ASSERT_DOUBLE_EQ(response["time_step"]["reward"].get<real_t>(), 20.0);
+
+	// every request went over one kept alive connection
+	ASSERT_EQ(server.n_connections(), 1);
+	api_server.close("Taxi", 0);
+}
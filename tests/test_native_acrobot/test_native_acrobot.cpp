@@ -0,0 +1,197 @@
+#include "rlenvs/envs/native/acrobot_env.h"
+#include "rlenvs/envs/native/acrobot_vec_env.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::native::Acrobot;
+using rlenvscpp::envs::native::AcrobotV;
+using rlenvscpp::envs::native::AcrobotDynamics;
+
+}
+
+
+TEST(TestNativeAcrobot, TestMake) {
+
+	Acrobot env;
+	ASSERT_FALSE(env.is_created());
+
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "Acrobot");
+	ASSERT_EQ(env.max_episode_steps(), 500);
+	ASSERT_EQ(env.n_actions(), 3);
+	ASSERT_EQ(env.dynamics(), AcrobotDynamics::BOOK);
+
+	Acrobot env_nips;
+	std::unordered_map<std::string, std::any> options;
+	options["book_or_nips"] = std::string("nips");
+	env_nips.make("v1", options);
+	ASSERT_EQ(env_nips.dynamics(), AcrobotDynamics::NIPS);
+	ASSERT_EQ(env_nips.make_copy(1).dynamics(), AcrobotDynamics::NIPS);
+
+	Acrobot env_unknown;
+	options["book_or_nips"] = std::string("paper");
+	ASSERT_THROW(env_unknown.make("v1", options), std::logic_error);
+
+	Acrobot env_v0;
+	ASSERT_THROW(env_v0.make("v0", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	// the vector environment needs the number of instances
+	AcrobotV vec_env;
+	ASSERT_THROW(vec_env.make("v1", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	env.close();
+	ASSERT_FALSE(env.is_created());
+}
+
+TEST(TestNativeAcrobot, TestIntegrate) {
+
+	// reference values computed with the RK4 step of the Python implementation
+	const Acrobot::raw_state_type state(0.05, -0.03, 0.02, 0.08);
+
+	auto next = Acrobot::integrate(state, 2, AcrobotDynamics::BOOK);
+	ASSERT_NEAR(next[0], 0.034052138467080488, 1.0e-12);
+	ASSERT_NEAR(next[1], 0.027539970333267196, 1.0e-12);
+	ASSERT_NEAR(next[2], -0.17417025006198744, 1.0e-12);
+	ASSERT_NEAR(next[3], 0.48249323535960276, 1.0e-12);
+
+	next = Acrobot::integrate(state, 2, AcrobotDynamics::NIPS);
+	ASSERT_NEAR(next[0], 0.03405250923564402, 1.0e-12);
+	ASSERT_NEAR(next[3], 0.48250828810202495, 1.0e-12);
+
+	const Acrobot::raw_state_type fast(1.0, 2.0, 3.0, -4.0);
+	next = Acrobot::integrate(fast, 0, AcrobotDynamics::BOOK);
+	ASSERT_NEAR(next[0], 1.4931304811328789, 1.0e-12);
+	ASSERT_NEAR(next[1], 1.2123181134071772, 1.0e-12);
+	ASSERT_NEAR(next[2], 1.9404357737771445, 1.0e-12);
+	ASSERT_NEAR(next[3], -3.8064103377580158, 1.0e-12);
+
+	// the angles are wrapped and the velocities clipped
+	next = Acrobot::integrate(Acrobot::raw_state_type(3.1, 0.0, 100.0, 100.0), 1, AcrobotDynamics::BOOK);
+	ASSERT_GE(next[0], -Acrobot::PI);
+	ASSERT_LT(next[0], Acrobot::PI);
+	ASSERT_DOUBLE_EQ(std::abs(next[2]), Acrobot::MAX_VEL_1);
+	ASSERT_DOUBLE_EQ(std::abs(next[3]), Acrobot::MAX_VEL_2);
+
+	ASSERT_TRUE(Acrobot::is_terminal(Acrobot::PI, 0.0));
+	ASSERT_FALSE(Acrobot::is_terminal(0.0, 0.0));
+}
+
+TEST(TestNativeAcrobot, TestStep) {
+
+	Acrobot env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(10);
+	env.make("v1", options);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation().size(), 6);
+
+	for(uint_t i=0; i<4; ++i){
+		ASSERT_LE(std::abs(env.state()[i]), 0.1);
+	}
+
+	const auto next = Acrobot::integrate(env.state(), 2, env.dynamics());
+
+	time_step = env.step(2);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_DOUBLE_EQ(time_step.reward(), -1.0);
+	ASSERT_DOUBLE_EQ(time_step.observation()[0], std::cos(next[0]));
+	ASSERT_DOUBLE_EQ(time_step.observation()[5], next[3]);
+
+	for(uint_t t=1; t<10; ++t){
+		time_step = env.step(1);
+	}
+
+	ASSERT_TRUE(time_step.last());
+
+	// the next step resets the environment
+	time_step = env.step(1);
+	ASSERT_TRUE(time_step.first());
+}
+
+TEST(TestNativeAcrobot, TestResetMatchesAcrobotV) {
+
+	// both draw the initial state from the same generator in the same order
+	Acrobot env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	AcrobotV vec_env;
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(1);
+	vec_env.make("v1", options);
+	vec_env.reset(42, std::unordered_map<std::string, std::any>());
+
+	ASSERT_DOUBLE_EQ(env.state()[0], vec_env.theta1s()[0]);
+	ASSERT_DOUBLE_EQ(env.state()[1], vec_env.theta2s()[0]);
+	ASSERT_DOUBLE_EQ(env.state()[2], vec_env.dtheta1s()[0]);
+	ASSERT_DOUBLE_EQ(env.state()[3], vec_env.dtheta2s()[0]);
+}
+
+TEST(TestNativeAcrobotV, TestBatchStep) {
+
+	const uint_t n_envs = 8;
+
+	AcrobotV env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs;
+	options["max_episode_steps"] = static_cast<uint_t>(5);
+	env.make("v1", options);
+	ASSERT_EQ(env.get_n_envs(), n_envs);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.types().size(), n_envs);
+
+	std::vector<Acrobot::raw_state_type> states(n_envs);
+	std::vector<uint_t> actions(n_envs);
+	for(uint_t i=0; i<n_envs; ++i){
+		states[i] = Acrobot::raw_state_type(env.theta1s()[i], env.theta2s()[i],
+		                                    env.dtheta1s()[i], env.dtheta2s()[i]);
+		actions[i] = i % 3;
+	}
+
+	// every instance matches the single environment kernel
+	for(uint_t t=0; t<5; ++t){
+
+		time_step = env.step(actions);
+
+		for(uint_t i=0; i<n_envs; ++i){
+
+			states[i] = Acrobot::integrate(states[i], actions[i], AcrobotDynamics::BOOK);
+			ASSERT_DOUBLE_EQ(env.theta1s()[i], states[i][0]);
+			ASSERT_DOUBLE_EQ(env.theta2s()[i], states[i][1]);
+			ASSERT_DOUBLE_EQ(env.dtheta1s()[i], states[i][2]);
+			ASSERT_DOUBLE_EQ(env.dtheta2s()[i], states[i][3]);
+			ASSERT_DOUBLE_EQ(time_step.observation_view(i)[3], std::sin(states[i][1]));
+			ASSERT_DOUBLE_EQ(env.rewards()[i], -1.0);
+		}
+	}
+
+	for(uint_t i=0; i<n_envs; ++i){
+		ASSERT_EQ(env.step_types()[i], TimeStepTp::LAST);
+	}
+
+	env.step(actions);
+	for(uint_t i=0; i<n_envs; ++i){
+		ASSERT_EQ(env.step_types()[i], TimeStepTp::FIRST);
+		ASSERT_DOUBLE_EQ(env.rewards()[i], 0.0);
+	}
+}
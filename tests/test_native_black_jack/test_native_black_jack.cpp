@@ -0,0 +1,141 @@
+#include "rlenvs/envs/native/black_jack_env.h"
+#include "rlenvs/utils/xoshiro256.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::native::BlackJack;
+using rlenvscpp::utils::Xoshiro256;
+
+}
+
+
+TEST(TestXoshiro256, TestBounded) {
+
+	Xoshiro256 generator(7);
+	Xoshiro256 other(7);
+	ASSERT_EQ(generator(), other());
+
+	std::vector<uint_t> counts(13, 0);
+	const uint_t n_samples = 130000;
+
+	for(uint_t i=0; i<n_samples; ++i){
+		const auto value = generator.bounded(13);
+		ASSERT_LT(value, 13);
+		counts[value] += 1;
+	}
+
+	// every value is drawn about 10000 times
+	for(auto count : counts){
+		ASSERT_NEAR(static_cast<real_t>(count), 10000.0, 500.0);
+	}
+
+	for(uint_t i=0; i<1000; ++i){
+		const auto u = generator.uniform();
+		ASSERT_GE(u, 0.0);
+		ASSERT_LT(u, 1.0);
+	}
+}
+
+TEST(TestNativeBlackJack, TestEncoding) {
+
+	for(uint_t sum=0; sum<32; ++sum){
+		for(uint_t card=1; card<11; ++card){
+			for(auto ace : {false, true}){
+
+				const auto sidx = BlackJack::encode(sum, card, ace);
+				ASSERT_LT(sidx, 704);
+
+				const auto state = BlackJack::decode(sidx);
+				ASSERT_EQ(state.player_sum, sum);
+				ASSERT_EQ(state.dealer_card, card);
+				ASSERT_EQ(state.usable_ace, ace);
+			}
+		}
+	}
+}
+
+TEST(TestNativeBlackJack, TestMake) {
+
+	BlackJack env;
+	ASSERT_THROW(env.make("v0", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	std::unordered_map<std::string, std::any> options;
+	options["natural"] = true;
+	env.make("v1", options);
+
+	ASSERT_TRUE(env.is_created());
+	ASSERT_TRUE(env.is_natural());
+	ASSERT_FALSE(env.is_sab());
+	ASSERT_EQ(env.n_actions(), 2);
+
+	auto copy = env.make_copy(1);
+	ASSERT_TRUE(copy.is_natural());
+	ASSERT_EQ(copy.cidx(), 1);
+}
+
+TEST(TestNativeBlackJack, TestEpisodes) {
+
+	BlackJack env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+
+	for(uint_t episode=0; episode<1000; ++episode){
+
+		ASSERT_TRUE(time_step.first());
+
+		auto state = BlackJack::decode(time_step.observation());
+		ASSERT_GE(state.player_sum, 4);
+		ASSERT_LE(state.player_sum, 21);
+		ASSERT_GE(state.dealer_card, 1);
+		ASSERT_LE(state.dealer_card, 10);
+
+		// hit below 17
+		while(!time_step.last()){
+			state = BlackJack::decode(time_step.observation());
+			time_step = env.step(state.player_sum < 17 ? 1 : 0);
+		}
+
+		state = BlackJack::decode(time_step.observation());
+		const auto reward = time_step.reward();
+		ASSERT_TRUE(reward == -1.0 || reward == 0.0 || reward == 1.0);
+
+		if(state.player_sum > 21){
+			ASSERT_DOUBLE_EQ(reward, -1.0);
+		}
+		else{
+			// the dealer played on
+			ASSERT_GE(env.dealer_sum(), 17);
+		}
+
+		time_step = env.step(0);
+	}
+}
+
+TEST(TestNativeBlackJack, TestSeeded) {
+
+	BlackJack env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	auto copy = env.make_copy(1);
+
+	env.reset(3, std::unordered_map<std::string, std::any>());
+	copy.reset(3, std::unordered_map<std::string, std::any>());
+
+	for(uint_t s=0; s<500; ++s){
+		auto step = env.step(s % 2);
+		auto copy_step = copy.step(s % 2);
+		ASSERT_EQ(step.observation(), copy_step.observation());
+		ASSERT_DOUBLE_EQ(step.reward(), copy_step.reward());
+	}
+}
@@ -0,0 +1,175 @@
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <stdexcept>
+#include <cmath>
+#include <type_traits>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::native::CartPole;
+using rlenvscpp::envs::native::FixedCartPole;
+using rlenvscpp::envs::native::EigenCartPole;
+using rlenvscpp::envs::native::KinematicsIntegrator;
+
+}
+
+
+TEST(TestNativeCartPole, TestMake) {
+
+	CartPole env;
+	ASSERT_FALSE(env.is_created());
+
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "CartPole");
+	ASSERT_EQ(env.max_episode_steps(), 500);
+	ASSERT_EQ(env.n_actions(), 2);
+
+	CartPole env_v0;
+	env_v0.make("v0", std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(env_v0.max_episode_steps(), 200);
+
+	CartPole env_v5;
+	ASSERT_THROW(env_v5.make("v5", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	env.close();
+	ASSERT_FALSE(env.is_created());
+}
+
+TEST(TestNativeCartPole, TestReset) {
+
+	CartPole env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_DOUBLE_EQ(time_step.reward(), 0.0);
+	ASSERT_EQ(time_step.observation().size(), 4);
+
+	for(auto value : time_step.observation()){
+		ASSERT_LE(std::abs(value), 0.05);
+	}
+
+	// the same seed gives the same initial state
+	auto other = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.observation(), other.observation());
+}
+
+TEST(TestNativeCartPole, TestEulerStep) {
+
+	// a single step from rest with the pole upright
+	CartPole::raw_state_type state = {0.0, 0.0, 0.0, 0.0};
+	CartPole::integrate(state, 1, KinematicsIntegrator::EULER);
+
+	const real_t temp = CartPole::FORCE_MAG / CartPole::TOTAL_MASS;
+	const real_t theta_acc = -temp / (CartPole::LENGTH * (4.0 / 3.0 - CartPole::MASS_POLE / CartPole::TOTAL_MASS));
+	const real_t x_acc = temp - CartPole::POLE_MASS_LENGTH * theta_acc / CartPole::TOTAL_MASS;
+
+	// Euler updates the positions with the old velocities
+	ASSERT_DOUBLE_EQ(state[0], 0.0);
+	ASSERT_DOUBLE_EQ(state[1], CartPole::TAU * x_acc);
+	ASSERT_DOUBLE_EQ(state[2], 0.0);
+	ASSERT_DOUBLE_EQ(state[3], CartPole::TAU * theta_acc);
+
+	// semi-implicit Euler uses the new ones
+	CartPole::raw_state_type semi_implicit = {0.0, 0.0, 0.0, 0.0};
+	CartPole::integrate(semi_implicit, 1, KinematicsIntegrator::SEMI_IMPLICIT_EULER);
+	ASSERT_DOUBLE_EQ(semi_implicit[1], state[1]);
+	ASSERT_DOUBLE_EQ(semi_implicit[0], CartPole::TAU * state[1]);
+	ASSERT_DOUBLE_EQ(semi_implicit[2], CartPole::TAU * state[3]);
+}
+
+TEST(TestNativeCartPole, TestTermination) {
+
+	CartPole env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	// always pushing right lets the pole fall
+	uint_t n_steps = 0;
+	auto time_step = env.step(1);
+	n_steps += 1;
+
+	while(!time_step.last()){
+		ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+		time_step = env.step(1);
+		n_steps += 1;
+	}
+
+	ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+	ASSERT_LT(n_steps, env.max_episode_steps());
+	ASSERT_TRUE(CartPole::is_terminal(env.state()));
+
+	// stepping after the end starts a new episode
+	time_step = env.step(1);
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(env.n_steps(), 0);
+}
+
+TEST(TestNativeCartPole, TestTruncation) {
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(5);
+	options["kinematics_integrator"] = std::string("semi-implicit euler");
+
+	CartPole env;
+	env.make("v1", options);
+	ASSERT_EQ(env.kinematics_integrator(), KinematicsIntegrator::SEMI_IMPLICIT_EULER);
+
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	for(uint_t s=0; s<4; ++s){
+		ASSERT_EQ(env.step_state(s % 2), TimeStepTp::MID);
+	}
+
+	ASSERT_EQ(env.step_state(0), TimeStepTp::LAST);
+
+	auto copy = env.make_copy(1);
+	ASSERT_EQ(copy.cidx(), 1);
+	ASSERT_EQ(copy.max_episode_steps(), 5);
+	ASSERT_EQ(copy.kinematics_integrator(), KinematicsIntegrator::SEMI_IMPLICIT_EULER);
+}
+
+TEST(TestNativeCartPole, TestFixedSizeObservations) {
+
+	static_assert(std::is_same_v<FixedCartPole::state_type, std::array<real_t, 4> >);
+	static_assert(std::is_same_v<EigenCartPole::state_type, Eigen::Matrix<real_t, 4, 1> >);
+
+	CartPole env;
+	FixedCartPole fixed_env;
+	EigenCartPole eigen_env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	fixed_env.make("v1", std::unordered_map<std::string, std::any>());
+	eigen_env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	auto fixed_time_step = fixed_env.reset(42, std::unordered_map<std::string, std::any>());
+	auto eigen_time_step = eigen_env.reset(42, std::unordered_map<std::string, std::any>());
+
+	// the three observation types follow the same trajectory
+	for(uint_t t=0; t<50; ++t){
+
+		for(uint_t i=0; i<4; ++i){
+			ASSERT_DOUBLE_EQ(fixed_time_step.observation()[i], time_step.observation()[i]);
+			ASSERT_DOUBLE_EQ(eigen_time_step.observation()[i], time_step.observation()[i]);
+		}
+
+		ASSERT_EQ(fixed_time_step.type(), time_step.type());
+		ASSERT_EQ(eigen_time_step.type(), time_step.type());
+		ASSERT_DOUBLE_EQ(fixed_time_step.reward(), time_step.reward());
+
+		time_step = env.step(t % 2);
+		fixed_env.step_into(t % 2, fixed_time_step);
+		eigen_time_step = eigen_env.step(t % 2);
+	}
+}
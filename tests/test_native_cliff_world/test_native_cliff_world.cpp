@@ -0,0 +1,108 @@
+#include "rlenvs/envs/native/cliff_world_env.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <stdexcept>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::native::CliffWorld;
+
+}
+
+
+TEST(TestNativeCliffWorld, TestMake) {
+
+	CliffWorld env;
+	ASSERT_THROW(env.make("v5", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	env.make("v0", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "CliffWalking");
+	ASSERT_EQ(env.n_states(), 48);
+	ASSERT_EQ(env.n_actions(), 4);
+
+	auto time_step = env.reset();
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), CliffWorld::START_STATE);
+}
+
+TEST(TestNativeCliffWorld, TestDynamics) {
+
+	CliffWorld env;
+	env.make("v0", std::unordered_map<std::string, std::any>());
+
+	// moving right from the start falls off the cliff
+	auto [probability, next_state, reward, done] = env.p(CliffWorld::START_STATE, 1)[0];
+	ASSERT_DOUBLE_EQ(probability, 1.0);
+	ASSERT_EQ(next_state, CliffWorld::START_STATE);
+	ASSERT_DOUBLE_EQ(reward, -100.0);
+	ASSERT_FALSE(done);
+
+	// moving down from above the goal ends the episode
+	std::tie(probability, next_state, reward, done) = env.p(35, 2)[0];
+	ASSERT_EQ(next_state, CliffWorld::GOAL_STATE);
+	ASSERT_DOUBLE_EQ(reward, -1.0);
+	ASSERT_TRUE(done);
+
+	// the walls keep the agent in the grid
+	ASSERT_EQ(std::get<1>(env.p(0, 0)[0]), 0);
+	ASSERT_EQ(std::get<1>(env.p(0, 3)[0]), 0);
+	ASSERT_EQ(std::get<1>(env.p(11, 1)[0]), 11);
+}
+
+TEST(TestNativeCliffWorld, TestEpisode) {
+
+	CliffWorld env;
+	env.make("v0", std::unordered_map<std::string, std::any>());
+	env.reset();
+
+	// up, eleven times right and down
+	std::vector<uint_t> actions(1, 0);
+	actions.insert(actions.end(), 11, 1);
+	actions.push_back(2);
+
+	real_t total_reward = 0.0;
+	auto time_step = env.step(actions[0]);
+	total_reward += time_step.reward();
+
+	for(uint_t a=1; a<actions.size(); ++a){
+		ASSERT_FALSE(time_step.last());
+		time_step = env.step(actions[a]);
+		total_reward += time_step.reward();
+	}
+
+	ASSERT_TRUE(time_step.last());
+	ASSERT_EQ(time_step.observation(), CliffWorld::GOAL_STATE);
+	ASSERT_DOUBLE_EQ(total_reward, -13.0);
+
+	// stepping after the end starts a new episode
+	time_step = env.step(0);
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), CliffWorld::START_STATE);
+}
+
+TEST(TestNativeCliffWorld, TestTruncation) {
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(3);
+
+	CliffWorld env;
+	env.make("v0", options);
+
+	auto copy = env.make_copy(2);
+	ASSERT_EQ(copy.cidx(), 2);
+
+	copy.reset();
+	ASSERT_TRUE(copy.step(0).mid());
+	ASSERT_TRUE(copy.step(0).mid());
+	ASSERT_TRUE(copy.step(0).last());
+}
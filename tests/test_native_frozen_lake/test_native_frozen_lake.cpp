@@ -0,0 +1,127 @@
+#include "rlenvs/envs/native/frozen_lake_env.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <tuple>
+#include <stdexcept>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::native::FrozenLake;
+
+}
+
+
+TEST(TestNativeFrozenLake, TestMake) {
+
+	FrozenLake<4> env;
+	ASSERT_THROW(env.make("v0", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_TRUE(env.is_slippery());
+	ASSERT_EQ(env.n_states(), 16);
+	ASSERT_EQ(env.n_actions(), 4);
+	ASSERT_EQ(env.max_episode_steps(), 100);
+	ASSERT_EQ(env.tile(0), 'S');
+	ASSERT_EQ(env.tile(5), 'H');
+	ASSERT_EQ(env.tile(15), 'G');
+
+	FrozenLake<8> env_8;
+	env_8.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(env_8.n_states(), 64);
+	ASSERT_EQ(env_8.max_episode_steps(), 200);
+	ASSERT_EQ(env_8.tile(63), 'G');
+}
+
+TEST(TestNativeFrozenLake, TestSlipperyDynamics) {
+
+	FrozenLake<4> env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+
+	// every state and action sums to one
+	for(uint_t s=0; s<env.n_states(); ++s){
+		for(uint_t a=0; a<env.n_actions(); ++a){
+
+			real_t sum = 0.0;
+			for(const auto& transition : env.p(s, a)){
+				sum += std::get<0>(transition);
+			}
+
+			ASSERT_NEAR(sum, 1.0, 1.0e-12);
+		}
+	}
+
+	// moving right from state 14 reaches the goal with 1/3
+	auto dynamics = env.p(14, 2);
+	ASSERT_EQ(dynamics.size(), 3);
+
+	// DOWN, RIGHT and UP
+	ASSERT_EQ(std::get<1>(dynamics[0]), 14);
+	ASSERT_EQ(std::get<1>(dynamics[1]), 15);
+	ASSERT_DOUBLE_EQ(std::get<2>(dynamics[1]), 1.0);
+	ASSERT_TRUE(std::get<3>(dynamics[1]));
+	ASSERT_EQ(std::get<1>(dynamics[2]), 10);
+
+	// holes are absorbing
+	dynamics = env.p(5, 0);
+	ASSERT_EQ(dynamics.size(), 1);
+	ASSERT_EQ(std::get<1>(dynamics[0]), 5);
+	ASSERT_TRUE(std::get<3>(dynamics[0]));
+}
+
+TEST(TestNativeFrozenLake, TestDeterministicEpisode) {
+
+	std::unordered_map<std::string, std::any> options;
+	options["is_slippery"] = false;
+
+	FrozenLake<4> env;
+	env.make("v1", options);
+	ASSERT_EQ(env.p(0, 1).size(), 1);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), 0);
+
+	// DOWN, DOWN, RIGHT, RIGHT, DOWN, RIGHT reaches the goal
+	const std::vector<uint_t> actions = {1, 1, 2, 2, 1, 2};
+	for(auto action : actions){
+		ASSERT_FALSE(time_step.last());
+		time_step = env.step(action);
+	}
+
+	ASSERT_TRUE(time_step.last());
+	ASSERT_EQ(time_step.observation(), 15);
+	ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+
+	// stepping after the end starts a new episode
+	time_step = env.step(0);
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), 0);
+}
+
+TEST(TestNativeFrozenLake, TestSeededSlipperyEpisode) {
+
+	FrozenLake<8> env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	auto copy = env.make_copy(1);
+	ASSERT_EQ(copy.cidx(), 1);
+	ASSERT_TRUE(copy.is_slippery());
+
+	env.reset(7, std::unordered_map<std::string, std::any>());
+	copy.reset(7, std::unordered_map<std::string, std::any>());
+
+	// the same seed gives the same trajectory
+	for(uint_t s=0; s<200; ++s){
+		auto step = env.step(s % 4);
+		auto copy_step = copy.step(s % 4);
+		ASSERT_EQ(step.observation(), copy_step.observation());
+		ASSERT_EQ(step.type(), copy_step.type());
+	}
+}
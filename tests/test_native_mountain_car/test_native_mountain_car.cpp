@@ -0,0 +1,158 @@
+#include "rlenvs/envs/native/mountain_car_env.h"
+#include "rlenvs/envs/native/mountain_car_vec_env.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::native::MountainCar;
+using rlenvscpp::envs::native::MountainCarV;
+
+}
+
+
+TEST(TestNativeMountainCar, TestMake) {
+
+	MountainCar env;
+	ASSERT_FALSE(env.is_created());
+
+	env.make("v0", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "MountainCar");
+	ASSERT_EQ(env.max_episode_steps(), 200);
+	ASSERT_EQ(env.n_actions(), 3);
+
+	MountainCar env_v1;
+	ASSERT_THROW(env_v1.make("v1", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	// the vector environment needs the number of instances
+	MountainCarV vec_env;
+	ASSERT_THROW(vec_env.make("v0", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(4);
+	vec_env.make("v0", options);
+	ASSERT_EQ(vec_env.get_n_envs(), 4);
+
+	env.close();
+	ASSERT_FALSE(env.is_created());
+}
+
+TEST(TestNativeMountainCar, TestStep) {
+
+	MountainCar env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(10);
+	env.make("v0", options);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation().size(), 2);
+	ASSERT_GE(time_step.observation()[0], -0.6);
+	ASSERT_LE(time_step.observation()[0], -0.4);
+	ASSERT_DOUBLE_EQ(time_step.observation()[1], 0.0);
+
+	// the single environment uses the same kernel as the batch
+	auto state = env.state();
+	const uint_t action = 2;
+	MountainCar::integrate(&state[0], &state[1], &action, 1);
+
+	time_step = env.step(action);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_DOUBLE_EQ(time_step.reward(), -1.0);
+	ASSERT_DOUBLE_EQ(time_step.observation()[0], state[0]);
+	ASSERT_DOUBLE_EQ(time_step.observation()[1], state[1]);
+
+	for(uint_t t=1; t<10; ++t){
+		time_step = env.step(1);
+	}
+
+	ASSERT_TRUE(time_step.last());
+
+	// the next step resets the environment
+	time_step = env.step(1);
+	ASSERT_TRUE(time_step.first());
+}
+
+TEST(TestNativeMountainCar, TestIntegrateWalls) {
+
+	std::vector<real_t> positions = {MountainCar::MIN_POSITION, 0.59, -0.5};
+	std::vector<real_t> velocities = {-0.01, 0.07, 0.0};
+	std::vector<uint_t> actions = {0, 2, 1};
+
+	MountainCar::integrate(positions.data(), velocities.data(), actions.data(), 3);
+
+	// the car stops at the left wall
+	ASSERT_DOUBLE_EQ(positions[0], MountainCar::MIN_POSITION);
+	ASSERT_DOUBLE_EQ(velocities[0], 0.0);
+
+	// the speed and the position are clipped
+	ASSERT_DOUBLE_EQ(velocities[1], MountainCar::MAX_SPEED);
+	ASSERT_DOUBLE_EQ(positions[1], MountainCar::MAX_POSITION);
+
+	ASSERT_LT(velocities[2], 0.07);
+	ASSERT_LT(positions[2], MountainCar::MAX_POSITION);
+}
+
+TEST(TestNativeMountainCarV, TestBatchStep) {
+
+	const uint_t n_envs = 8;
+
+	MountainCarV env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs;
+	options["max_episode_steps"] = static_cast<uint_t>(5);
+	env.make("v0", options);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.types().size(), n_envs);
+
+	std::vector<real_t> positions(env.positions().begin(), env.positions().end());
+	std::vector<real_t> velocities(env.velocities().begin(), env.velocities().end());
+
+	std::vector<uint_t> actions(n_envs);
+	for(uint_t i=0; i<n_envs; ++i){
+		actions[i] = i % 3;
+		ASSERT_EQ(env.step_types()[i], TimeStepTp::FIRST);
+	}
+
+	for(uint_t t=0; t<5; ++t){
+
+		MountainCar::integrate(positions.data(), velocities.data(), actions.data(), n_envs);
+		time_step = env.step(actions);
+
+		for(uint_t i=0; i<n_envs; ++i){
+			ASSERT_DOUBLE_EQ(env.positions()[i], positions[i]);
+			ASSERT_DOUBLE_EQ(env.velocities()[i], velocities[i]);
+			ASSERT_DOUBLE_EQ(time_step.observation_view(i)[0], positions[i]);
+			ASSERT_DOUBLE_EQ(env.rewards()[i], -1.0);
+		}
+	}
+
+	// every instance is truncated and then reset
+	for(uint_t i=0; i<n_envs; ++i){
+		ASSERT_EQ(env.step_types()[i], TimeStepTp::LAST);
+	}
+
+	env.step(actions);
+	for(uint_t i=0; i<n_envs; ++i){
+		ASSERT_EQ(env.step_types()[i], TimeStepTp::FIRST);
+		ASSERT_DOUBLE_EQ(env.velocities()[i], 0.0);
+		ASSERT_DOUBLE_EQ(env.rewards()[i], 0.0);
+	}
+
+	ASSERT_THROW(env.step(std::vector<uint_t>(n_envs + 1, 0)), std::logic_error);
+}
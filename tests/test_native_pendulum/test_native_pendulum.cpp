@@ -0,0 +1,187 @@
+#include "rlenvs/envs/native/pendulum_env.h"
+#include "rlenvs/envs/native/pendulum_vec_env.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::envs::native::Pendulum;
+using rlenvscpp::envs::native::FixedPendulum;
+using rlenvscpp::envs::native::PendulumV;
+
+}
+
+
+TEST(TestNativePendulum, TestMake) {
+
+	Pendulum env;
+	ASSERT_FALSE(env.is_created());
+
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(env.is_created());
+	ASSERT_EQ(env.env_name(), "Pendulum");
+	ASSERT_EQ(env.max_episode_steps(), 200);
+
+	Pendulum env_v0;
+	ASSERT_THROW(env_v0.make("v0", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	// the vector environment needs the number of instances
+	PendulumV vec_env;
+	ASSERT_THROW(vec_env.make("v1", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = static_cast<uint_t>(4);
+	options["g"] = 9.81;
+	vec_env.make("v1", options);
+	ASSERT_EQ(vec_env.get_n_envs(), 4);
+	ASSERT_DOUBLE_EQ(vec_env.g(), 9.81);
+
+	env.close();
+	ASSERT_FALSE(env.is_created());
+}
+
+TEST(TestNativePendulum, TestStep) {
+
+	Pendulum env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(10);
+	env.make("v1", options);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation().size(), 3);
+
+	auto state = env.state();
+	ASSERT_DOUBLE_EQ(time_step.observation()[0], std::cos(state[0]));
+	ASSERT_DOUBLE_EQ(time_step.observation()[1], std::sin(state[0]));
+	ASSERT_LE(std::abs(state[1]), 1.0);
+
+	// the single environment uses the same kernel as the batch
+	const real_t torque = 1.5;
+	real_t reward = 0.0;
+	Pendulum::integrate(&state[0], &state[1], &torque, &reward, 1);
+
+	time_step = env.step(torque);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_DOUBLE_EQ(time_step.reward(), reward);
+	ASSERT_DOUBLE_EQ(time_step.observation()[2], state[1]);
+
+	for(uint_t t=1; t<10; ++t){
+		time_step = env.step(0.0);
+	}
+
+	// the episode is only truncated
+	ASSERT_TRUE(time_step.last());
+
+	time_step = env.step(0.0);
+	ASSERT_TRUE(time_step.first());
+}
+
+TEST(TestNativePendulum, TestFixedSizeObservations) {
+
+	Pendulum env;
+	FixedPendulum fixed_env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	fixed_env.make("v1", std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	auto fixed_time_step = fixed_env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(fixed_time_step.observation().size(), 3);
+
+	for(uint_t t=0; t<20; ++t){
+
+		for(uint_t i=0; i<3; ++i){
+			ASSERT_DOUBLE_EQ(fixed_time_step.observation()[i], time_step.observation()[i]);
+		}
+
+		ASSERT_DOUBLE_EQ(fixed_time_step.reward(), time_step.reward());
+
+		time_step = env.step(1.0);
+		fixed_time_step = fixed_env.step(1.0);
+	}
+}
+
+TEST(TestNativePendulum, TestIntegrate) {
+
+	constexpr real_t PI = 3.14159265358979323846;
+
+	// upright and at rest with no torque is an equilibrium with zero cost
+	std::vector<real_t> thetas = {0.0, 2.0 * PI, PI, 0.0};
+	std::vector<real_t> theta_dots = {0.0, 0.0, 0.0, 7.9};
+	std::vector<real_t> torques = {0.0, 0.0, 0.0, 10.0};
+	std::vector<real_t> rewards(4, 1.0);
+
+	Pendulum::integrate(thetas.data(), theta_dots.data(), torques.data(), rewards.data(), 4);
+
+	ASSERT_DOUBLE_EQ(rewards[0], 0.0);
+	ASSERT_DOUBLE_EQ(thetas[0], 0.0);
+	ASSERT_NEAR(rewards[1], 0.0, 1.0e-12);
+
+	// hanging down is the worst angle
+	ASSERT_NEAR(rewards[2], -PI * PI, 1.0e-12);
+
+	// the torque is clipped in the cost and the speed is clipped
+	ASSERT_DOUBLE_EQ(rewards[3], -(0.1 * 7.9 * 7.9 + 0.001 * 4.0));
+	ASSERT_DOUBLE_EQ(theta_dots[3], Pendulum::MAX_SPEED);
+}
+
+TEST(TestNativePendulumV, TestBatchStep) {
+
+	const uint_t n_envs = 8;
+
+	PendulumV env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["num_envs"] = n_envs;
+	options["max_episode_steps"] = static_cast<uint_t>(5);
+	env.make("v1", options);
+
+	auto time_step = env.reset(42, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.types().size(), n_envs);
+
+	std::vector<real_t> thetas(env.thetas().begin(), env.thetas().end());
+	std::vector<real_t> theta_dots(env.theta_dots().begin(), env.theta_dots().end());
+	std::vector<real_t> rewards(n_envs, 0.0);
+
+	std::vector<real_t> actions(n_envs);
+	for(uint_t i=0; i<n_envs; ++i){
+		actions[i] = -2.0 + 0.5 * static_cast<real_t>(i);
+	}
+
+	for(uint_t t=0; t<5; ++t){
+
+		Pendulum::integrate(thetas.data(), theta_dots.data(), actions.data(), rewards.data(), n_envs);
+		time_step = env.step(actions);
+
+		for(uint_t i=0; i<n_envs; ++i){
+			ASSERT_DOUBLE_EQ(env.thetas()[i], thetas[i]);
+			ASSERT_DOUBLE_EQ(env.theta_dots()[i], theta_dots[i]);
+			ASSERT_DOUBLE_EQ(env.rewards()[i], rewards[i]);
+			ASSERT_DOUBLE_EQ(time_step.observation_view(i)[1], std::sin(thetas[i]));
+		}
+	}
+
+	// the same seed gives the same batch
+	PendulumV other = env.make_copy(1);
+	other.reset(42, std::unordered_map<std::string, std::any>());
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	for(uint_t i=0; i<n_envs; ++i){
+		ASSERT_DOUBLE_EQ(env.thetas()[i], other.thetas()[i]);
+	}
+
+	ASSERT_THROW(env.step(std::vector<real_t>(n_envs - 1, 0.0)), std::logic_error);
+}
@@ -0,0 +1,116 @@
+#include "rlenvs/envs/native/taxi_env.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <tuple>
+#include <stdexcept>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::envs::native::Taxi;
+
+}
+
+
+TEST(TestNativeTaxi, TestEncoding) {
+
+	for(uint_t s=0; s<500; ++s){
+		const auto [row, col, passenger, destination] = Taxi::decode(s);
+		ASSERT_EQ(Taxi::encode(row, col, passenger, destination), s);
+	}
+
+	const auto state = Taxi::decode(Taxi::encode(3, 1, 2, 0));
+	ASSERT_EQ(state.taxi_row, 3);
+	ASSERT_EQ(state.taxi_col, 1);
+	ASSERT_EQ(state.passenger_location, 2);
+	ASSERT_EQ(state.destination, 0);
+}
+
+TEST(TestNativeTaxi, TestMakeAndReset) {
+
+	Taxi env;
+	ASSERT_THROW(env.make("v1", std::unordered_map<std::string, std::any>()), std::logic_error);
+
+	env.make("v3", std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(env.n_states(), 500);
+	ASSERT_EQ(env.n_actions(), 6);
+
+	for(uint_t seed=0; seed<50; ++seed){
+
+		auto time_step = env.reset(seed, std::unordered_map<std::string, std::any>());
+		ASSERT_TRUE(time_step.first());
+
+		const auto state = Taxi::decode(time_step.observation());
+		ASSERT_LT(state.passenger_location, Taxi::IN_TAXI);
+		ASSERT_NE(state.passenger_location, state.destination);
+	}
+}
+
+TEST(TestNativeTaxi, TestDynamics) {
+
+	Taxi env;
+	env.make("v3", std::unordered_map<std::string, std::any>());
+
+	// the wall east of (0, 1) blocks the taxi
+	const auto s = Taxi::encode(0, 1, 2, 3);
+	ASSERT_EQ(std::get<1>(env.p(s, 2)[0]), s);
+	ASSERT_DOUBLE_EQ(std::get<2>(env.p(s, 2)[0]), -1.0);
+	ASSERT_FALSE(env.action_mask(s)[2]);
+	ASSERT_TRUE(env.action_mask(s)[3]);
+
+	// illegal pickup
+	ASSERT_DOUBLE_EQ(std::get<2>(env.p(s, 4)[0]), -10.0);
+	ASSERT_FALSE(env.action_mask(s)[4]);
+
+	// pickup at Y and drop off at B
+	const auto at_y = Taxi::encode(4, 0, 2, 3);
+	ASSERT_TRUE(env.action_mask(at_y)[4]);
+	ASSERT_EQ(std::get<1>(env.p(at_y, 4)[0]), Taxi::encode(4, 0, Taxi::IN_TAXI, 3));
+
+	const auto at_b = Taxi::encode(4, 3, Taxi::IN_TAXI, 3);
+	ASSERT_TRUE(env.action_mask(at_b)[5]);
+
+	const auto& [probability, next_state, reward, done] = env.p(at_b, 5)[0];
+	ASSERT_DOUBLE_EQ(probability, 1.0);
+	ASSERT_EQ(next_state, Taxi::encode(4, 3, 3, 3));
+	ASSERT_DOUBLE_EQ(reward, 20.0);
+	ASSERT_TRUE(done);
+}
+
+TEST(TestNativeTaxi, TestEpisode) {
+
+	Taxi env;
+	env.make("v3", std::unordered_map<std::string, std::any>());
+
+	auto copy = env.make_copy(1);
+	ASSERT_EQ(copy.cidx(), 1);
+
+	auto time_step = env.reset(3, std::unordered_map<std::string, std::any>());
+	auto copy_step = copy.reset(3, std::unordered_map<std::string, std::any>());
+	ASSERT_EQ(time_step.observation(), copy_step.observation());
+
+	// follow the transition model
+	for(uint_t a=0; a<6; ++a){
+
+		const auto expected = env.p(env.state(), a)[0];
+		time_step = env.step(a);
+
+		ASSERT_EQ(time_step.observation(), std::get<1>(expected));
+		ASSERT_DOUBLE_EQ(time_step.reward(), std::get<2>(expected));
+	}
+
+	// the episode is truncated after 200 steps
+	uint_t n_steps = 6;
+	while(!time_step.last()){
+		time_step = env.step(1);
+		n_steps += 1;
+	}
+
+	ASSERT_EQ(n_steps, env.max_episode_steps());
+}
@@ -0,0 +1,101 @@
+#include "rlenvs/envs/api_server/shm_channel.h"
+#include "rlenvs/envs/vector_time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::VectorTimeStep;
+using rlenvscpp::envs::SharedMemoryChannel;
+
+typedef VectorTimeStep<std::vector<real_t> > time_step_type;
+
+std::string
+channel_name(const std::string& test){
+	return "/rlenvs_test_" + test + "_" + std::to_string(::getpid());
+}
+
+}
+
+TEST(TestSharedMemoryChannel, WriteRead) {
+
+	const auto name = channel_name("write_read");
+	auto writer = SharedMemoryChannel::create(name, 2, 3, 4);
+	auto reader = SharedMemoryChannel::open(name);
+
+	ASSERT_EQ(reader -> n_envs(), 2);
+	ASSERT_EQ(reader -> obs_size(), 3);
+	ASSERT_EQ(reader -> n_slots(), 4);
+
+	const std::vector<real_t> obs = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+	const auto seq = writer -> write({TimeStepTp::MID, TimeStepTp::LAST}, {-1.0, 0.5}, {1.0, 0.9}, obs);
+
+	ASSERT_EQ(seq, 1);
+	ASSERT_EQ(reader -> last_seq(), 1);
+
+	auto time_step = reader -> read<std::vector<real_t> >(seq);
+
+	ASSERT_TRUE(time_step.is_view());
+	ASSERT_TRUE(time_step.last());
+	ASSERT_EQ(time_step.rewards(), std::vector<real_t>({-1.0, 0.5}));
+	ASSERT_EQ(time_step.discounts(), std::vector<real_t>({1.0, 0.9}));
+	ASSERT_DOUBLE_EQ(time_step.observation_view(1)[2], 6.0);
+
+	// the observations were copied out of the slot
+	for(uint_t i=0; i<4; ++i){
+		writer -> write({TimeStepTp::MID, TimeStepTp::MID}, {0.0, 0.0}, {1.0, 1.0}, std::vector<real_t>(6, 0.0));
+	}
+
+	EXPECT_THROW(reader -> read<std::vector<real_t> >(seq), std::runtime_error);
+	ASSERT_DOUBLE_EQ(time_step.observation_view(0)[0], 1.0);
+	ASSERT_TRUE(time_step.last());
+
+	ASSERT_EQ(time_step.observations().size(), 2);
+	ASSERT_EQ(time_step.observations()[0], std::vector<real_t>({1.0, 2.0, 3.0}));
+}
+
+TEST(TestSharedMemoryChannel, ViewOutlivesChannel) {
+
+	const auto name = channel_name("outlives");
+	auto writer = SharedMemoryChannel::create(name, 1, 2, 2);
+
+	time_step_type time_step;
+	{
+		auto reader = SharedMemoryChannel::open(name);
+		const auto seq = writer -> write({TimeStepTp::FIRST}, {0.0}, {1.0}, std::vector<real_t>({7.0, 8.0}));
+		time_step = reader -> read<std::vector<real_t> >(seq);
+	}
+
+	// the time step owns a copy of the observations
+	ASSERT_DOUBLE_EQ(time_step.observation_view(0)[1], 8.0);
+}
+
+TEST(TestSharedMemoryChannel, OverwrittenSlotThrows) {
+
+	const auto name = channel_name("overwritten");
+	auto writer = SharedMemoryChannel::create(name, 1, 1, 2);
+	auto reader = SharedMemoryChannel::open(name);
+
+	for(uint_t i=0; i<3; ++i){
+		writer -> write({TimeStepTp::MID}, {0.0}, {1.0}, std::vector<real_t>({1.0}));
+	}
+
+	EXPECT_THROW(reader -> read<std::vector<real_t> >(1), std::runtime_error);
+	EXPECT_NO_THROW(reader -> read<std::vector<real_t> >(3));
+	EXPECT_THROW(writer -> write({TimeStepTp::MID}, {0.0}, {1.0}, std::vector<real_t>({1.0, 2.0})), std::logic_error);
+}
+
+TEST(TestSharedMemoryChannel, OpenMissingThrows) {
+	EXPECT_THROW(SharedMemoryChannel::open(channel_name("missing")), std::runtime_error);
+}
@@ -0,0 +1,130 @@
+#include "rlenvs/envs/space_type.h"
+#include "rlenvs/envs/env_types.h"
+#include "rlenvs/utils/sampling_engine.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::RealRange;
+using rlenvscpp::utils::sampling_engine_type;
+using rlenvscpp::utils::seed_thread_sampling_engine;
+using rlenvscpp::envs::ScalarDiscreteSpace;
+using rlenvscpp::envs::BoundedContinuousScalarSpace;
+using rlenvscpp::envs::ContinuousVectorSpace;
+using rlenvscpp::envs::FixedContinuousVectorSpace;
+using rlenvscpp::envs::ScalarDiscreteEnv;
+using rlenvscpp::envs::ContinuousVectorStateDiscreteActionEnv;
+using rlenvscpp::envs::ContinuousVectorStateContinuousScalarBoundedActionEnv;
+
+}
+
+
+TEST(TestSpaceSampling, TestScalarDiscreteRange) {
+
+	typedef ScalarDiscreteSpace<2, 6> space_type;
+
+	std::vector<uint_t> values(10000);
+	space_type::sample_n(values, false);
+	ASSERT_EQ(*std::min_element(values.begin(), values.end()), 2);
+	ASSERT_EQ(*std::max_element(values.begin(), values.end()), 5);
+
+	// the end of the range is included on request
+	space_type::sample_n(values, true);
+	ASSERT_EQ(*std::min_element(values.begin(), values.end()), 2);
+	ASSERT_EQ(*std::max_element(values.begin(), values.end()), 6);
+
+	const auto value = space_type::sample(false);
+	ASSERT_GE(value, 2);
+	ASSERT_LT(value, 6);
+}
+
+TEST(TestSpaceSampling, TestReproducibleFromSeed) {
+
+	typedef ScalarDiscreteSpace<0, 4> space_type;
+
+	ASSERT_EQ(space_type::sample(42, 100, false), space_type::sample(42, 100, false));
+	ASSERT_NE(space_type::sample(42, 100, false), space_type::sample(43, 100, false));
+	ASSERT_EQ(space_type::sample(42, false), space_type::sample(42, 1, false)[0]);
+
+	// the batch draws the same sequence as single samples
+	sampling_engine_type engine(7);
+	sampling_engine_type batch_engine(7);
+
+	std::vector<uint_t> batch(64);
+	space_type::sample_n(batch_engine, batch, false);
+	for(auto value : batch){
+		ASSERT_EQ(space_type::sample(engine, false), value);
+	}
+
+	// so does the thread engine once it is seeded
+	std::vector<uint_t> first(64);
+	std::vector<uint_t> second(64);
+	seed_thread_sampling_engine(11);
+	space_type::sample_n(first, false);
+	seed_thread_sampling_engine(11);
+	space_type::sample_n(second, false);
+	ASSERT_EQ(first, second);
+}
+
+TEST(TestSpaceSampling, TestContinuousSpaces) {
+
+	typedef BoundedContinuousScalarSpace<-2.0, 2.0> bounded_space_type;
+
+	sampling_engine_type engine(42);
+	std::vector<real_t> values(1000);
+	bounded_space_type::sample_n(engine, values);
+	for(auto value : values){
+		ASSERT_GE(value, -2.0);
+		ASSERT_LT(value, 2.0);
+	}
+
+	ASSERT_DOUBLE_EQ(bounded_space_type::sample(3), bounded_space_type::sample(3));
+
+	// the vector items are sized whatever their type
+	std::vector<std::vector<real_t> > items(5);
+	ContinuousVectorSpace<4>::sample_n(engine, items);
+	for(const auto& item : items){
+		ASSERT_EQ(item.size(), 4);
+	}
+
+	const auto fixed_item = FixedContinuousVectorSpace<3>::sample(engine);
+	ASSERT_EQ(fixed_item.size(), 3);
+}
+
+TEST(TestSpaceSampling, TestSampleActions) {
+
+	sampling_engine_type engine(42);
+
+	// ScalarDiscreteEnv samples from [action_start, action_end)
+	std::vector<uint_t> actions(1000);
+	ScalarDiscreteEnv<16, 4>::sample_actions(engine, actions);
+	ASSERT_EQ(*std::max_element(actions.begin(), actions.end()), 3);
+
+	const auto seeded = ScalarDiscreteEnv<16, 4>::sample_action(42, 1000);
+	ASSERT_EQ(*std::max_element(seeded.begin(), seeded.end()), 3);
+
+	typedef ContinuousVectorStateDiscreteActionEnv<4, 2> cart_pole_env_type;
+
+	cart_pole_env_type::sample_actions(engine, actions);
+	ASSERT_EQ(*std::max_element(actions.begin(), actions.end()), 1);
+	ASSERT_LT(cart_pole_env_type::sample_action(), 2);
+
+	typedef ContinuousVectorStateContinuousScalarBoundedActionEnv<3, 1, RealRange<-2.0, 2.0> > pendulum_env_type;
+
+	std::array<real_t, 100> torques;
+	pendulum_env_type::sample_actions(torques);
+	for(auto torque : torques){
+		ASSERT_GE(torque, -2.0);
+		ASSERT_LT(torque, 2.0);
+	}
+
+	ASSERT_DOUBLE_EQ(pendulum_env_type::sample_action(5), pendulum_env_type::sample_action(5));
+}
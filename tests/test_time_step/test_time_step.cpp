@@ -0,0 +1,166 @@
+#include "rlenvs/envs/time_step.h"
+#include "rlenvs/envs/time_step_type.h"
+#include "rlenvs/envs/native/cart_pole_env.h"
+#include "rlenvs/envs/connect2/connect2_env.h"
+#include "rlenvs/envs/gdrl/gym_walk.h"
+#include "rlenvs/rlenvs_types_v2.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <any>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace{
+
+using rlenvscpp::uint_t;
+using rlenvscpp::real_t;
+using rlenvscpp::TimeStep;
+using rlenvscpp::TimeStepTp;
+using rlenvscpp::TruncationInfo;
+using rlenvscpp::envs::native::CartPole;
+using rlenvscpp::envs::connect2::Connect2;
+using rlenvscpp::envs::gdrl::GymWalk;
+
+}
+
+
+TEST(TestTimeStep, TestMoveDoesNotCopy) {
+
+	TimeStep<std::vector<real_t> > time_step(TimeStepTp::MID, 1.0, std::vector<real_t>({1.0, 2.0, 3.0}), 0.9);
+	const auto* data = time_step.observation().data();
+
+	TimeStep<std::vector<real_t> > moved(std::move(time_step));
+	ASSERT_EQ(moved.observation().data(), data);
+	ASSERT_TRUE(moved.mid());
+	ASSERT_DOUBLE_EQ(moved.discount(), 0.9);
+
+	// the moved-from time step is cleared
+	ASSERT_EQ(time_step.type(), TimeStepTp::INVALID_TYPE);
+	ASSERT_TRUE(time_step.observation().empty());
+
+	TimeStep<std::vector<real_t> > assigned;
+	assigned = std::move(moved);
+	ASSERT_EQ(assigned.observation().data(), data);
+
+	// a temporary gives up its observation
+	auto observation = std::move(assigned).observation();
+	ASSERT_EQ(observation.data(), data);
+}
+
+TEST(TestTimeStep, TestLazyInfo) {
+
+	TimeStep<uint_t> time_step(TimeStepTp::FIRST, 0.0, 3);
+	ASSERT_TRUE(std::as_const(time_step).info().empty());
+	ASSERT_THROW(time_step.get_extra<uint_t>("lives"), std::logic_error);
+
+	time_step.info()["lives"] = std::any(static_cast<uint_t>(2));
+	ASSERT_EQ(time_step.get_extra<uint_t>("lives"), 2);
+
+	// copies own their info
+	auto copy = time_step;
+	copy.info()["lives"] = std::any(static_cast<uint_t>(1));
+	ASSERT_EQ(time_step.get_extra<uint_t>("lives"), 2);
+	ASSERT_EQ(copy.get_extra<uint_t>("lives"), 1);
+
+	time_step.clear();
+	ASSERT_TRUE(std::as_const(time_step).info().empty());
+}
+
+TEST(TestTimeStep, TestCartPoleStepInto) {
+
+	CartPole env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	CartPole env_copy = env.make_copy(1);
+
+	env.reset(42, std::unordered_map<std::string, std::any>());
+	env_copy.reset(42, std::unordered_map<std::string, std::any>());
+
+	CartPole::time_step_type time_step;
+	for(uint_t s=0; s<600; ++s){
+
+		const auto expected = env.step(s % 3 == 0);
+		env_copy.step_into(s % 3 == 0, time_step);
+
+		ASSERT_EQ(time_step.type(), expected.type());
+		ASSERT_DOUBLE_EQ(time_step.reward(), expected.reward());
+		ASSERT_EQ(time_step.observation(), expected.observation());
+	}
+}
+
+TEST(TestTimeStep, TestConnect2StepInto) {
+
+	Connect2 env;
+	env.make("v1", std::unordered_map<std::string, std::any>());
+	env.reset();
+
+	Connect2::time_step_type time_step;
+	env.step_into(0, time_step);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_EQ(time_step.observation(), std::vector<uint_t>({1, 0, 0, 0}));
+	ASSERT_EQ(time_step.typed_info().action_mask.to_ulong(), 0b1110);
+
+	// an info map written before does not survive
+	Connect2 other;
+	other.make("v1", std::unordered_map<std::string, std::any>());
+	other.reset();
+
+	auto reused = other.step(3);
+	reused.info()["valid_moves"] = std::any(other.get_valid_moves());
+	ASSERT_FALSE(reused.info().empty());
+
+	other.step_into(2, reused);
+	ASSERT_TRUE(reused.info().empty());
+	ASSERT_EQ(reused.typed_info().action_mask.to_ulong(), 0b0011);
+
+	// player 1 wins with a second piece
+	env.step_into(1, time_step);
+	ASSERT_TRUE(time_step.last());
+	ASSERT_DOUBLE_EQ(time_step.reward(), 1.0);
+
+	// the next step starts a new game
+	env.step_into(0, time_step);
+	ASSERT_TRUE(time_step.first());
+	ASSERT_EQ(time_step.observation(), std::vector<uint_t>({0, 0, 0, 0}));
+	ASSERT_TRUE(time_step.typed_info().action_mask.all());
+
+	ASSERT_THROW(env.step_into(4, time_step), std::logic_error);
+}
+
+TEST(TestTimeStep, TestTypedInfo) {
+
+	// step() reports the valid moves in the action mask only
+	Connect2 connect2;
+	connect2.make("v1", std::unordered_map<std::string, std::any>());
+	connect2.reset();
+
+	auto connect2_step = connect2.step(2);
+	ASSERT_EQ(connect2_step.typed_info().action_mask.to_ulong(), 0b1011);
+	ASSERT_TRUE(connect2_step.info().empty());
+
+	// GymWalk tells apart the time limit from the end states
+	GymWalk<7> env;
+
+	std::unordered_map<std::string, std::any> options;
+	options["max_episode_steps"] = static_cast<uint_t>(2);
+	env.make("v0", options);
+	env.reset(42, std::unordered_map<std::string, std::any>());
+
+	auto time_step = env.step(GymWalk<7>::LEFT);
+	ASSERT_TRUE(time_step.mid());
+	ASSERT_FALSE(time_step.typed_info().truncated);
+
+	time_step = env.step(GymWalk<7>::RIGHT);
+	ASSERT_TRUE(time_step.last());
+	ASSERT_TRUE(time_step.typed_info().truncated);
+
+	// the typed info follows copies and moves
+	auto copy = time_step;
+	ASSERT_TRUE(copy.typed_info().truncated);
+
+	auto moved = std::move(copy);
+	ASSERT_TRUE(moved.typed_info().truncated);
+	ASSERT_FALSE(copy.typed_info().truncated);
+}